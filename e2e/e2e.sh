@@ -81,5 +81,16 @@ echo "Waiting for ServerMain to launch and open port"
 while ! curl --max-time 1 --output /dev/null --silent http://localhost:9099/; do
 	sleep 1
 done
-$PYTHON_BINARY "$PROJECT_DIR/e2e/queryit.py" "$PROJECT_DIR/e2e/scientists_queries.yaml" "http://localhost:9099" &> $BINARY_DIR/query_log.txt || bail "Querying Server failed"
+# The q-errors of the size estimates are compared with the baseline
+# e2e/scientists_size_estimates.json, which should be created with the size
+# estimator before the per-predicate statistics. Without the baseline the
+# comparison is skipped with a warning. To create it, run this script on that
+# version of the estimator with WRITE_SIZE_ESTIMATE_BASELINE=1 and commit the
+# file.
+SIZE_ESTIMATE_BASELINE="$PROJECT_DIR/e2e/scientists_size_estimates.json"
+WRITE_BASELINE=""
+if [ "$WRITE_SIZE_ESTIMATE_BASELINE" == "1" ]; then
+	WRITE_BASELINE="write-baseline"
+fi
+$PYTHON_BINARY "$PROJECT_DIR/e2e/queryit.py" "$PROJECT_DIR/e2e/scientists_queries.yaml" "http://localhost:9099" "$SIZE_ESTIMATE_BASELINE" $WRITE_BASELINE &> $BINARY_DIR/query_log.txt || bail "Querying Server failed"
 popd
@@ -3,6 +3,8 @@
 QLever Query Tool for End2End Testing
 """
 
+import math
+import os
 import sys
 import urllib.parse
 import urllib.request
@@ -203,6 +205,73 @@ def query_checks(query: Dict[str, Any],
             passed = False
     return passed
 
+def size_estimate_error(runtime_info: Dict[str, Any]) -> float:
+    """
+    The largest q-error (the factor between the size estimate and the actual
+    number of rows, at least 1) of the operations in the runtime information
+    of a QLever Result.
+    """
+    error = 1.0
+    details = runtime_info.get('details') or {}
+    if 'size_estimate' in details:
+        estimate = max(1, details['size_estimate'])
+        actual = max(1, runtime_info['result_rows'])
+        error = max(estimate, actual) / min(estimate, actual)
+    for child in runtime_info.get('children', []):
+        error = max(error, size_estimate_error(child))
+    return error
+
+def geometric_mean(values: List[float]) -> float:
+    """
+    The geometric mean of the values (1 for no values)
+    """
+    return math.exp(sum(math.log(v) for v in values) / max(1, len(values)))
+
+def write_size_estimates(errors: Dict[str, float], baseline_path: str) -> None:
+    """
+    Writes the q-errors of the size estimates to the baseline file (to create
+    the baseline with the estimator that later changes are compared with).
+    """
+    with open(baseline_path, 'w') as baseline_file:
+        json.dump(errors, baseline_file, indent=2, sort_keys=True)
+        baseline_file.write('\n')
+    print('Wrote the size estimate baseline to', baseline_path)
+
+def check_size_estimates(errors: Dict[str, float], baseline_path: str,
+                         tolerance: float = 2.0) -> bool:
+    """
+    Compares the q-errors of the size estimates with those stored in the
+    baseline file. Returns False if the estimates became worse (the geometric
+    mean of the q-errors or the q-error of a single query by more than the
+    tolerance). Without a baseline file there is nothing to compare with, the
+    check is skipped with a warning.
+    """
+    print('Size estimate q-error: geometric mean %.2f, max %.2f' %
+          (geometric_mean(list(errors.values())),
+           max(errors.values(), default=1.0)))
+    if not os.path.exists(baseline_path):
+        eprint('WARNING: The size estimate baseline', baseline_path,
+               'does not exist, skipping the comparison (see e2e/e2e.sh for '
+               'how to create it)')
+        return True
+    with open(baseline_path) as baseline_file:
+        baseline = json.load(baseline_file)
+    common = [name for name in errors if name in baseline]
+    passed = True
+    for name in common:
+        if errors[name] > tolerance * baseline[name]:
+            eprint('Size estimate of "%s" became worse: q-error %.2f, '
+                   'baseline %.2f' % (name, errors[name], baseline[name]))
+            passed = False
+    mean = geometric_mean([errors[name] for name in common])
+    baseline_mean = geometric_mean([baseline[name] for name in common])
+    print('Size estimate q-error on %d queries: geometric mean %.2f, '
+          'baseline %.2f' % (len(common), mean, baseline_mean))
+    if mean > baseline_mean:
+        eprint('The size estimates became worse than the baseline')
+        passed = False
+    return passed
+
 def print_qlever_result(result: Dict[str, Any]) -> None:
     """
     Prints a QLever Result to stdout
@@ -214,13 +283,18 @@ def main() -> None:
     """
     Run QLever queries stored in a YAML file against a QLever instance
     """
-    if len(sys.argv) != 3:
-        eprint("Usage: ", sys.argv[0], "<yaml_in> <qlever_endpoint_url>")
+    if len(sys.argv) not in (3, 4, 5) or (len(sys.argv) == 5 and
+                                          sys.argv[4] != 'write-baseline'):
+        eprint("Usage: ", sys.argv[0], "<yaml_in> <qlever_endpoint_url>",
+               "[<size_estimates_baseline.json> [write-baseline]]")
         sys.exit(1)
 
     inpath = sys.argv[1]
     endpoint_url = sys.argv[2]
+    baseline_path = sys.argv[3] if len(sys.argv) > 3 else None
+    write_baseline = len(sys.argv) > 4
     error_detected = False
+    size_estimate_errors = {}
     with open(inpath, 'rb') if inpath != '-' else sys.stdin as infile:
         yaml_tree = yaml.safe_load(infile)
         queries = yaml_tree['queries']
@@ -251,10 +325,20 @@ def main() -> None:
                 print_qlever_result(result)
                 continue
 
+            if 'runtimeInformation' in result:
+                size_estimate_errors[query_name] = size_estimate_error(
+                    result['runtimeInformation'])
+
             if not query_checks(query, result):
                 error_detected = True
                 continue
 
+    if baseline_path and write_baseline:
+        write_size_estimates(size_estimate_errors, baseline_path)
+    elif baseline_path and not check_size_estimates(size_estimate_errors,
+                                                    baseline_path):
+        error_detected = True
+
     if error_detected:
         print(Color.FAIL+'Query tool found errors!'+Color.ENDC)
         sys.exit(2)
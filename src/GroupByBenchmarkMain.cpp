@@ -0,0 +1,95 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include "./engine/CallFixedSize.h"
+#include "./engine/GroupBy.h"
+#include "./util/Timer.h"
+
+using std::string;
+
+namespace {
+// _____________________________________________________________________________
+void printTime(const string& name, const ad_utility::Timer& timer,
+               size_t nofRows) {
+  std::cout << std::setw(40) << name << ": " << std::setw(8) << timer.msecs()
+            << " ms (" << nofRows << " rows)" << std::endl;
+}
+
+// Groups a table with a group column (with nofGroups random values) and a
+// VERBATIM value column by the first column and computes the COUNT, SUM, MIN,
+// MAX and AVG of the value column. The sort-based grouping (the sort that
+// the planner adds and doGroupBy) is compared with doHashGroupBy on 1 and
+// NOF_HASH_GROUP_BY_THREADS threads.
+// _____________________________________________________________________________
+void benchmarkGroupBy(const Index& index, size_t nofRows, size_t nofGroups) {
+  std::cout << nofGroups << " groups:" << std::endl;
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<Id> groupDist(0, nofGroups - 1);
+  std::uniform_int_distribution<Id> valueDist(0, 1000);
+  IdTable input(2);
+  input.resize(nofRows);
+  for (size_t i = 0; i < nofRows; ++i) {
+    input(i, 0) = groupDist(gen);
+    input(i, 1) = valueDist(gen);
+  }
+  std::vector<ResultTable::ResultType> inputTypes = {
+      ResultTable::ResultType::KB, ResultTable::ResultType::VERBATIM};
+  std::vector<size_t> groupByCols = {0};
+  std::vector<GroupBy::Aggregate> aggregates = {
+      // type                                in out userdata
+      {ParsedQuery::AggregateType::SAMPLE, 0, 0, nullptr},
+      {ParsedQuery::AggregateType::COUNT, 1, 1, nullptr},
+      {ParsedQuery::AggregateType::SUM, 1, 2, nullptr},
+      {ParsedQuery::AggregateType::MIN, 1, 3, nullptr},
+      {ParsedQuery::AggregateType::MAX, 1, 4, nullptr},
+      {ParsedQuery::AggregateType::AVG, 1, 5, nullptr}};
+  const int inWidth = 2;
+  const int outWidth = aggregates.size();
+  ad_utility::Timer timer;
+
+  timer.start();
+  IdTable sorted = input;
+  std::sort(sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return a[0] < b[0]; });
+  timer.stop();
+  printTime("sort", timer, sorted.size());
+  timer.cont();
+  ResultTable inTable;
+  ResultTable outTable;
+  outTable._data.setCols(outWidth);
+  CALL_FIXED_SIZE_2(inWidth, outWidth, doGroupBy, sorted, inputTypes,
+                    groupByCols, aggregates, &outTable._data, &inTable,
+                    &outTable, index);
+  timer.stop();
+  printTime("sort + doGroupBy", timer, outTable._data.size());
+
+  for (size_t nofThreads : {size_t(1), NOF_HASH_GROUP_BY_THREADS}) {
+    timer.start();
+    IdTable result(outWidth);
+    CALL_FIXED_SIZE_2(inWidth, outWidth, doHashGroupBy, input, inputTypes,
+                      groupByCols, aggregates, &result, index, nofThreads);
+    timer.stop();
+    printTime("doHashGroupBy, " + std::to_string(nofThreads) + " threads",
+              timer, result.size());
+  }
+}
+}  // namespace
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc > 2) {
+    std::cerr << "Usage: ./GroupByBenchmarkMain [nofRows (default 100M)]\n";
+    exit(1);
+  }
+  size_t nofRows = argc > 1 ? std::stoull(argv[1]) : 100 * 1000 * 1000;
+  // The values are only VERBATIM, the index is not needed.
+  Index index;
+  for (size_t nofGroups : {10, 1000, 1000 * 1000}) {
+    benchmarkGroupBy(index, nofRows, nofGroups);
+  }
+}
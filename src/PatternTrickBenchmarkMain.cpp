@@ -0,0 +1,146 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include "./engine/CountAvailablePredicates.h"
+#include "./global/Pattern.h"
+#include "./util/HashMap.h"
+#include "./util/Timer.h"
+
+using std::string;
+using std::vector;
+
+namespace {
+// The pattern trick with one hash map for the patterns and one for the
+// predicates on a single thread (the implementation before the parallel one).
+ad_utility::HashMap<Id, size_t> countWithHashMaps(
+    const vector<Id>& subjects, const vector<PatternID>& hasPattern,
+    const CompactStringVector<Id, Id>& hasPredicate,
+    const CompactStringVector<size_t, Id>& patterns) {
+  ad_utility::HashMap<Id, size_t> predicateCounts;
+  ad_utility::HashMap<size_t, size_t> patternCounts;
+  Id lastSubject = ID_NO_VALUE;
+  for (Id subject : subjects) {
+    if (subject == lastSubject) {
+      continue;
+    }
+    lastSubject = subject;
+    if (subject < hasPattern.size() && hasPattern[subject] != NO_PATTERN) {
+      patternCounts[hasPattern[subject]]++;
+    } else if (subject < hasPredicate.size()) {
+      auto [predicateData, numPredicates] = hasPredicate[subject];
+      for (size_t i = 0; i < numPredicates; i++) {
+        predicateCounts[predicateData[i]]++;
+      }
+    }
+  }
+  for (const auto& it : patternCounts) {
+    std::pair<Id*, size_t> pattern = patterns[it.first];
+    for (size_t i = 0; i < pattern.second; i++) {
+      predicateCounts[pattern.first[i]] += it.second;
+    }
+  }
+  return predicateCounts;
+}
+
+// _____________________________________________________________________________
+void printTime(const string& name, const ad_utility::Timer& timer,
+               size_t nofPredicates) {
+  std::cout << std::setw(30) << name << ": " << std::setw(8) << timer.msecs()
+            << " ms (" << nofPredicates << " predicates)" << std::endl;
+}
+}  // namespace
+
+// Compares the pattern trick for all entities and for a sorted subset of the
+// entities with the hash map based counting on a single thread and with the
+// counting of CountAvailablePredicates on 1 to NOF_PATTERN_TRICK_THREADS
+// threads. The patterns and predicates are random, 90 % of the entities have
+// a pattern.
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc > 3) {
+    std::cerr << "Usage: ./PatternTrickBenchmarkMain "
+                 "[nofEntities (default 20M)] [nofPatterns (default 1M)]\n";
+    exit(1);
+  }
+  size_t nofEntities = argc > 1 ? std::stoull(argv[1]) : 20 * 1000 * 1000;
+  size_t nofPatterns = argc > 2 ? std::stoull(argv[2]) : 1000 * 1000;
+  const size_t nofPredicates = 10 * 1000;
+
+  std::mt19937_64 gen(42);
+  // A few patterns and predicates are very frequent.
+  std::geometric_distribution<size_t> pattern(10.0 / nofPatterns);
+  std::geometric_distribution<Id> predicate(10.0 / nofPredicates);
+  std::uniform_int_distribution<size_t> patternSize(1, 20);
+  std::bernoulli_distribution hasNoPattern(0.1);
+
+  vector<vector<Id>> patternsSrc(nofPatterns);
+  for (auto& p : patternsSrc) {
+    p.resize(patternSize(gen));
+    for (auto& pred : p) {
+      pred = predicate(gen) % nofPredicates;
+    }
+  }
+  vector<PatternID> hasPattern(nofEntities);
+  vector<vector<Id>> hasPredicateSrc(nofEntities);
+  for (size_t i = 0; i < nofEntities; ++i) {
+    if (hasNoPattern(gen)) {
+      hasPattern[i] = NO_PATTERN;
+      hasPredicateSrc[i] = patternsSrc[pattern(gen) % nofPatterns];
+    } else {
+      hasPattern[i] = pattern(gen) % nofPatterns;
+    }
+  }
+  CompactStringVector<size_t, Id> patterns(patternsSrc);
+  CompactStringVector<Id, Id> hasPredicate(hasPredicateSrc);
+  patternsSrc.clear();
+  hasPredicateSrc.clear();
+
+  // Every tenth entity, once or twice.
+  vector<Id> subjects;
+  IdTable input(1);
+  for (Id i = 0; i < nofEntities; i += 10) {
+    for (size_t j = 0; j < 1 + i % 2; ++j) {
+      subjects.push_back(i);
+      input.push_back({i});
+    }
+  }
+  vector<Id> allEntities(nofEntities);
+  std::iota(allEntities.begin(), allEntities.end(), 0);
+
+  ad_utility::Timer timer;
+  RuntimeInformation runtimeInfo;
+  for (const auto* s : {&allEntities, &subjects}) {
+    bool all = s == &allEntities;
+    std::cout << (all ? "All " : "Every tenth of the ") << nofEntities
+              << " entities:" << std::endl;
+    timer.start();
+    auto counts = countWithHashMaps(*s, hasPattern, hasPredicate, patterns);
+    timer.stop();
+    printTime("HashMap", timer, counts.size());
+
+    for (size_t nofThreads = 1; nofThreads <= NOF_PATTERN_TRICK_THREADS;
+         nofThreads *= 2) {
+      IdTable result(2);
+      timer.start();
+      if (all) {
+        CountAvailablePredicates::computePatternTrickAllEntities(
+            &result, hasPattern, hasPredicate, patterns, nofThreads);
+      } else {
+        CountAvailablePredicates::computePatternTrick<1>(
+            input, &result, hasPattern, hasPredicate, patterns, 0,
+            &runtimeInfo, nofThreads);
+      }
+      timer.stop();
+      printTime("CountAvailablePredicates (" + std::to_string(nofThreads) +
+                    (nofThreads == 1 ? " thread)" : " threads)"),
+                timer, result.size());
+    }
+  }
+}
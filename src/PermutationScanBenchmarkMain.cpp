@@ -0,0 +1,147 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "./engine/IdTable.h"
+#include "./index/CompressedRelation.h"
+#include "./util/File.h"
+#include "./util/Timer.h"
+
+using std::string;
+using std::vector;
+
+namespace {
+struct Relation {
+  off_t _offset;
+  size_t _nofElements;
+};
+
+// _____________________________________________________________________________
+vector<vector<array<Id, 2>>> createRelations(size_t nofPairs) {
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<Id> smallSize(1, 20);
+  std::uniform_int_distribution<Id> largeSize(100 * 1000, 1000 * 1000);
+  std::uniform_int_distribution<Id> gap(0, 30);
+  std::geometric_distribution<Id> skewed(0.01);
+  vector<vector<array<Id, 2>>> res;
+  size_t pairsDone = 0;
+  size_t i = 0;
+  while (pairsDone < nofPairs) {
+    bool large = i++ % 1000 == 0;
+    size_t size =
+        std::min(nofPairs - pairsDone, large ? largeSize(gen) : smallSize(gen));
+    vector<array<Id, 2>> relation(size);
+    Id lhs = 1000 * 1000 + gap(gen);
+    for (auto& pair : relation) {
+      lhs += gap(gen) / 10;
+      pair = {lhs, large ? 5000 + skewed(gen) : gap(gen) * 1000 * 1000};
+    }
+    std::sort(relation.begin(), relation.end());
+    pairsDone += size;
+    res.push_back(std::move(relation));
+  }
+  return res;
+}
+
+// _____________________________________________________________________________
+template <class ScanFunction>
+void benchmarkScans(const string& name, const vector<Relation>& relations,
+                    off_t nofBytesOnDisk, ScanFunction scan) {
+  ad_utility::Timer timer;
+  timer.start();
+  size_t nofPairs = 0;
+  IdTable result(2);
+  for (const auto& relation : relations) {
+    result.clear();
+    result.resize(relation._nofElements);
+    scan(relation, &result);
+    nofPairs += result.size();
+  }
+  timer.stop();
+  double uncompressedMB = nofPairs * 2 * sizeof(Id) / (1024.0 * 1024.0);
+  std::cout << std::setw(12) << name << ": " << std::setw(8)
+            << nofBytesOnDisk / (1024 * 1024) << " MB on disk, "
+            << std::setw(8) << timer.msecs() << " ms, " << std::setw(8)
+            << static_cast<size_t>(uncompressedMB / timer.secs()) << " MB/s, "
+            << std::setw(10) << static_cast<size_t>(nofPairs / timer.secs())
+            << " pairs/s" << std::endl;
+}
+}  // namespace
+
+// Compares the scan throughput of the plain permutation format (all pairs of
+// a relation stored as uncompressed Ids) and the compressed format
+// (CompressedRelation) on synthetic relations. The relations mimic the
+// permutations of a real index: many small relations (e.g. one subject in
+// SPO) and some large ones with a skewed second column (e.g. one predicate in
+// PSO). Both files are written to <tmpFilePrefix>.{plain,compressed} and are
+// removed afterwards. Note that the files are typically still in the page
+// cache when they are scanned, so this measures the in-memory throughput.
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: ./PermutationScanBenchmarkMain <tmpFilePrefix> "
+                 "[nofPairs (default 100M)]\n";
+    exit(1);
+  }
+  string prefix = argv[1];
+  size_t nofPairs = argc == 3 ? std::stoull(argv[2]) : 100 * 1000 * 1000;
+
+  std::cout << "Creating " << nofPairs << " pairs of synthetic relations..."
+            << std::endl;
+  auto data = createRelations(nofPairs);
+
+  string plainFile = prefix + ".plain";
+  string compressedFile = prefix + ".compressed";
+  vector<Relation> plain;
+  vector<Relation> compressed;
+  {
+    ad_utility::File out(plainFile, "w");
+    off_t offset = 0;
+    for (const auto& relation : data) {
+      plain.push_back({offset, relation.size()});
+      out.write(relation.data(), relation.size() * sizeof(relation[0]));
+      offset += relation.size() * sizeof(relation[0]);
+    }
+  }
+  {
+    ad_utility::File out(compressedFile, "w");
+    off_t offset = 0;
+    for (const auto& relation : data) {
+      compressed.push_back({offset, relation.size()});
+      offset = CompressedRelation::writePairs(out, offset, relation, nullptr);
+    }
+  }
+  data.clear();
+
+  ad_utility::File plainIn(plainFile, "r");
+  ad_utility::File compressedIn(compressedFile, "r");
+  std::cout << "Scanning " << plain.size() << " relations" << std::endl;
+  // Run everything twice, the first run also warms up the page cache.
+  for (size_t run = 0; run < 2; ++run) {
+    benchmarkScans("plain", plain, plainIn.sizeOfFile(),
+                   [&](const Relation& rel, IdTable* result) {
+                     plainIn.read(result->data(),
+                                  rel._nofElements * 2 * sizeof(Id),
+                                  rel._offset);
+                   });
+    benchmarkScans("compressed", compressed, compressedIn.sizeOfFile(),
+                   [&](const Relation& rel, IdTable* result) {
+                     CompressedRelation::readPairs(compressedIn, rel._offset,
+                                                   rel._nofElements,
+                                                   result->data());
+                   });
+  }
+  std::cout << "Compression ratio: "
+            << static_cast<double>(plainIn.sizeOfFile()) /
+                   compressedIn.sizeOfFile()
+            << std::endl;
+  plainIn.close();
+  compressedIn.close();
+  remove(plainFile.c_str());
+  remove(compressedFile.c_str());
+}
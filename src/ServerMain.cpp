@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "engine/ParallelMergeJoin.h"
 #include "engine/Server.h"
 #include "util/ReadableNumberFact.h"
 
@@ -29,8 +30,23 @@ struct option options[] = {{"help", no_argument, NULL, 'h'},
                            {"worker-threads", required_argument, NULL, 'j'},
                            {"on-disk-literals", no_argument, NULL, 'l'},
                            {"port", required_argument, NULL, 'p'},
+                           {"max-queued-queries", required_argument, NULL, 'q'},
+                           {"cache-max-num-entries", required_argument, NULL,
+                            'k'},
+                           {"cache-max-size-gb", required_argument, NULL, 'c'},
+                           {"cache-max-size-single-entry-gb", required_argument,
+                            NULL, 'e'},
+                           {"sort-memory-limit-gb", required_argument, NULL,
+                            's'},
+                           {"memory-limit-gb", required_argument, NULL, 'm'},
+                           {"query-timeout-seconds", required_argument, NULL,
+                            'o'},
+                           {"join-threads", required_argument, NULL, 'J'},
+                           {"join-min-partition-size", required_argument, NULL,
+                            'N'},
                            {"no-patterns", no_argument, NULL, 'P'},
                            {"no-pattern-trick", no_argument, NULL, 'T'},
+                           {"on-disk-vocabulary", no_argument, NULL, 'v'},
                            {"text", no_argument, NULL, 't'},
                            {NULL, 0, NULL, 0}};
 
@@ -55,10 +71,62 @@ void printUsage(char* execName) {
        << "Disable the use of the pattern trick. This disables \n"
        << std::setw(26) << " " << std::setw(1)
        << "certain optimizations related to ql:has-predicate" << endl;
+  cout << "  " << std::setw(20) << "v, on-disk-vocabulary" << std::setw(1)
+       << "    "
+       << "Keep the vocabulary on disk (memory-mapped) and only a\n"
+       << std::setw(26) << " " << std::setw(1)
+       << "small sample of it in RAM." << endl;
   cout << "  " << std::setw(20) << "t, text" << std::setw(1) << "    "
        << "Enables the usage of text." << endl;
   cout << "  " << std::setw(20) << "j, worker-threads" << std::setw(1) << "    "
        << "Sets the number of worker threads to use" << endl;
+  cout << "  " << std::setw(20) << "q, max-queued-queries" << std::setw(1)
+       << "    "
+       << "The number of queries that may wait for a free worker\n"
+       << std::setw(26) << " " << std::setw(1)
+       << "thread, further queries are rejected with 503 (default "
+       << DEFAULT_MAX_NOF_QUEUED_QUERIES << ")." << endl;
+  cout << "  " << std::setw(20) << "k, cache-max-num-entries" << std::setw(1)
+       << "    "
+       << "The maximal number of results in the cache (default "
+       << NOF_SUBTREES_TO_CACHE << ")." << endl;
+  cout << "  " << std::setw(20) << "c, cache-max-size-gb" << std::setw(1)
+       << "    "
+       << "The maximal total size of the cached results in GB\n"
+       << std::setw(26) << " " << std::setw(1) << "(default "
+       << DEFAULT_CACHE_MAX_SIZE_GB << ")." << endl;
+  cout << "  " << std::setw(20) << "e, cache-max-size-single-entry-gb"
+       << std::setw(1) << "    "
+       << "Results that are larger (in GB) are not cached\n"
+       << std::setw(26) << " " << std::setw(1) << "(default "
+       << DEFAULT_CACHE_MAX_SIZE_SINGLE_ENTRY_GB << ")." << endl;
+  cout << "  " << std::setw(20) << "s, sort-memory-limit-gb" << std::setw(1)
+       << "    "
+       << "The memory (in GB) a single sort may use, larger inputs\n"
+       << std::setw(26) << " " << std::setw(1)
+       << "are sorted using temporary files (default "
+       << DEFAULT_SORT_MEMORY_LIMIT_PER_QUERY_GB << ")." << endl;
+  cout << "  " << std::setw(20) << "m, memory-limit-gb" << std::setw(1)
+       << "    "
+       << "The memory (in GB) a single query may allocate for its\n"
+       << std::setw(26) << " " << std::setw(1)
+       << "results, queries that need more are aborted (default "
+       << DEFAULT_MEMORY_LIMIT_PER_QUERY_GB << ")." << endl;
+  cout << "  " << std::setw(20) << "o, query-timeout-seconds" << std::setw(1)
+       << "    "
+       << "Queries are aborted after this time unless they set the\n"
+       << std::setw(26) << " " << std::setw(1)
+       << "parameter \"timeout\", 0 means no timeout (default "
+       << DEFAULT_QUERY_TIMEOUT_SECONDS << ")." << endl;
+  cout << "  " << std::setw(20) << "J, join-threads" << std::setw(1) << "    "
+       << "The maximal number of threads of a single merge join\n"
+       << std::setw(26) << " " << std::setw(1) << "(default "
+       << DEFAULT_NOF_JOIN_THREADS << ")." << endl;
+  cout << "  " << std::setw(20) << "N, join-min-partition-size" << std::setw(1)
+       << "    "
+       << "The minimal number of rows per thread of a merge join\n"
+       << std::setw(26) << " " << std::setw(1) << "(default "
+       << DEFAULT_JOIN_MIN_PARTITION_SIZE << ")." << endl;
   cout.copyfmt(coutState);
 }
 
@@ -77,13 +145,22 @@ int main(int argc, char** argv) {
   bool text = false;
   int port = -1;
   int numThreads = 1;
+  size_t maxNofQueuedQueries = DEFAULT_MAX_NOF_QUEUED_QUERIES;
+  size_t cacheMaxNumEntries = NOF_SUBTREES_TO_CACHE;
+  size_t cacheMaxSizeGB = DEFAULT_CACHE_MAX_SIZE_GB;
+  size_t cacheMaxSizeSingleEntryGB = DEFAULT_CACHE_MAX_SIZE_SINGLE_ENTRY_GB;
+  size_t sortMemoryLimitGB = DEFAULT_SORT_MEMORY_LIMIT_PER_QUERY_GB;
+  size_t memoryLimitGB = DEFAULT_MEMORY_LIMIT_PER_QUERY_GB;
+  size_t queryTimeoutSeconds = DEFAULT_QUERY_TIMEOUT_SECONDS;
   bool usePatterns = true;
   bool enablePatternTrick = true;
+  bool onDiskVocabulary = false;
 
   optind = 1;
   // Process command line arguments.
   while (true) {
-    int c = getopt_long(argc, argv, "i:p:j:tauhmlT", options, NULL);
+    int c = getopt_long(argc, argv, "i:p:j:q:k:c:e:s:m:o:J:N:tauhlTv",
+                        options, NULL);
     if (c == -1) break;
     switch (c) {
       case 'i':
@@ -101,9 +178,41 @@ int main(int argc, char** argv) {
       case 't':
         text = true;
         break;
+      case 'v':
+        onDiskVocabulary = true;
+        break;
       case 'j':
         numThreads = atoi(optarg);
         break;
+      case 'q':
+        maxNofQueuedQueries = static_cast<size_t>(atol(optarg));
+        break;
+      case 'k':
+        cacheMaxNumEntries = static_cast<size_t>(atol(optarg));
+        break;
+      case 'c':
+        cacheMaxSizeGB = static_cast<size_t>(atol(optarg));
+        break;
+      case 'e':
+        cacheMaxSizeSingleEntryGB = static_cast<size_t>(atol(optarg));
+        break;
+      case 's':
+        sortMemoryLimitGB = static_cast<size_t>(atol(optarg));
+        break;
+      case 'm':
+        memoryLimitGB = static_cast<size_t>(atol(optarg));
+        break;
+      case 'o':
+        queryTimeoutSeconds = static_cast<size_t>(atol(optarg));
+        break;
+      case 'J':
+        ad_utility::ParallelJoinSettings::setNofThreads(
+            static_cast<size_t>(atol(optarg)));
+        break;
+      case 'N':
+        ad_utility::ParallelJoinSettings::setMinPartitionSize(
+            static_cast<size_t>(atol(optarg)));
+        break;
       case 'h':
         printUsage(argv[0]);
         exit(0);
@@ -142,8 +251,11 @@ int main(int argc, char** argv) {
   cout << "Set locale LC_CTYPE to: " << locale << endl;
 
   try {
-    Server server(port, numThreads);
-    server.initialize(index, text, usePatterns, enablePatternTrick);
+    Server server(port, numThreads, maxNofQueuedQueries, cacheMaxNumEntries,
+                  cacheMaxSizeGB, cacheMaxSizeSingleEntryGB, sortMemoryLimitGB,
+                  memoryLimitGB, queryTimeoutSeconds);
+    server.initialize(index, text, usePatterns, enablePatternTrick,
+                      onDiskVocabulary);
     server.run();
   } catch (const std::exception& e) {
     // This code should never be reached as all exceptions should be handled
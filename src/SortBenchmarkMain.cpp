@@ -0,0 +1,61 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include "./engine/ExternalSort.h"
+#include "./engine/IdTable.h"
+#include "./util/Timer.h"
+
+using std::string;
+
+namespace {
+// _____________________________________________________________________________
+template <int WIDTH>
+void benchmarkSort(const string& prefix, size_t nofRows,
+                   size_t memoryLimitInBytes) {
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<Id> dist(0, nofRows);
+  IdTable input(WIDTH);
+  input.resize(nofRows);
+  for (size_t i = 0; i < nofRows; ++i) {
+    for (size_t j = 0; j < WIDTH; ++j) {
+      input(i, j) = dist(gen);
+    }
+  }
+  auto comp = [](const auto& a, const auto& b) { return a[0] < b[0]; };
+  double inputMB = nofRows * WIDTH * sizeof(Id) / (1024.0 * 1024.0);
+  for (size_t limit : {nofRows * WIDTH * sizeof(Id), memoryLimitInBytes}) {
+    ad_utility::Timer timer;
+    timer.start();
+    IdTable result(WIDTH);
+    ad_utility::externalSort<WIDTH>(input, &result, comp, limit, prefix);
+    timer.stop();
+    std::cout << "width " << WIDTH << ", " << std::setw(8)
+              << limit / (1024 * 1024) << " MB memory limit: " << std::setw(8)
+              << timer.msecs() << " ms, " << std::setw(8)
+              << static_cast<size_t>(inputMB / timer.secs()) << " MB/s"
+              << std::endl;
+  }
+}
+}  // namespace
+
+// Compares sorting a table in memory with the external sort (sorted runs that
+// are written to <tmpFilePrefix>.sort-tmp.* and merged) for tables of width 2
+// and 5 with random Ids. The input table itself always lives in memory.
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 4) {
+    std::cerr << "Usage: ./SortBenchmarkMain <tmpFilePrefix> "
+                 "[nofRows (default 100M)] [memoryLimitMB (default 1024)]\n";
+    exit(1);
+  }
+  string prefix = argv[1];
+  size_t nofRows = argc >= 3 ? std::stoull(argv[2]) : 100 * 1000 * 1000;
+  size_t memoryLimit =
+      (argc == 4 ? std::stoull(argv[3]) : 1024) * 1024 * 1024;
+  benchmarkSort<2>(prefix, nofRows, memoryLimit);
+  benchmarkSort<5>(prefix, nofRows, memoryLimit);
+}
@@ -0,0 +1,160 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "./global/Id.h"
+#include "./index/TextMetaData.h"
+#include "./util/File.h"
+#include "./util/Simple8bCode.h"
+#include "./util/StreamVByteCode.h"
+#include "./util/Timer.h"
+
+using std::string;
+using std::vector;
+
+namespace {
+// _____________________________________________________________________________
+// Synthetic context lists: small gaps with a geometric distribution (most
+// words occur in nearby contexts) and a few large jumps.
+vector<vector<Id>> createLists(size_t nofElements) {
+  std::mt19937_64 gen(42);
+  std::geometric_distribution<Id> gap(0.05);
+  std::uniform_int_distribution<Id> jump(1000, 1000 * 1000);
+  std::uniform_int_distribution<size_t> listSize(10, 100 * 1000);
+  vector<vector<Id>> res;
+  size_t done = 0;
+  while (done < nofElements) {
+    vector<Id> list(std::min(nofElements - done, listSize(gen)));
+    for (size_t i = 0; i < list.size(); ++i) {
+      list[i] = i % 100 == 0 ? jump(gen) : gap(gen);
+    }
+    done += list.size();
+    res.push_back(std::move(list));
+  }
+  return res;
+}
+
+// _____________________________________________________________________________
+// The (gap encoded) context lists of all blocks of an existing text index.
+vector<vector<Id>> readLists(const string& indexBasename) {
+  ad_utility::File in(indexBasename + ".text.index", "r");
+  off_t metaFrom;
+  off_t metaTo = in.getLastOffset(&metaFrom);
+  vector<unsigned char> buf(metaTo - metaFrom);
+  in.read(buf.data(), buf.size(), metaFrom);
+  TextMetaData meta;
+  meta.createFromByteBuffer(buf.data());
+  vector<vector<Id>> res;
+  for (size_t i = 0; i < meta.getBlockCount(); ++i) {
+    const auto& block = meta.getBlockById(i);
+    for (const auto* cl : {&block._cl, &block._entityCl}) {
+      if (cl->_nofElements == 0) {
+        continue;
+      }
+      size_t nofBytes =
+          static_cast<size_t>(cl->_startWordlist - cl->_startContextlist);
+      vector<uint64_t> encoded((nofBytes + 7) / 8);
+      in.read(encoded.data(), nofBytes, cl->_startContextlist);
+      vector<Id> list(cl->_nofElements + 239);
+      if (cl->_codec == TextListCodec::StreamVByte) {
+        ad_utility::StreamVByteCode::decode(
+            reinterpret_cast<unsigned char*>(encoded.data()), nofBytes,
+            cl->_nofElements, list.data());
+      } else {
+        ad_utility::Simple8bCode::decode(encoded.data(), cl->_nofElements,
+                                         list.data());
+      }
+      list.resize(cl->_nofElements);
+      res.push_back(std::move(list));
+    }
+  }
+  return res;
+}
+
+// _____________________________________________________________________________
+template <class DecodeFunction>
+void benchmarkDecode(const string& name, const vector<vector<Id>>& lists,
+                     size_t nofEncodedBytes, DecodeFunction decode) {
+  vector<Id> decoded;
+  size_t nofElements = 0;
+  ad_utility::Timer timer;
+  timer.start();
+  for (size_t i = 0; i < lists.size(); ++i) {
+    decoded.resize(lists[i].size() + 239);
+    decode(i, decoded.data());
+    nofElements += lists[i].size();
+    // make sure that the decoder is not optimized away.
+    if (decoded[0] != lists[i][0]) {
+      std::cerr << name << " decoded a wrong value" << std::endl;
+      exit(1);
+    }
+  }
+  timer.stop();
+  double decodedGB = nofElements * sizeof(Id) / (1024.0 * 1024.0 * 1024.0);
+  std::cout << std::setw(20) << name << ": " << std::setw(8)
+            << nofEncodedBytes / (1024 * 1024) << " MB encoded, "
+            << std::setw(8) << timer.msecs() << " ms, " << std::setw(6)
+            << std::fixed << std::setprecision(2) << decodedGB / timer.secs()
+            << " GB/s (decoded Ids)" << std::endl;
+}
+}  // namespace
+
+// Compares the decode throughput of the codecs for the lists of the text
+// index: Simple8b with the straightforward decoder, Simple8b with the
+// per-selector decoder and StreamVByte. Uses the context lists of an existing
+// text index or synthetic lists. All lists are encoded in memory first.
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc > 2) {
+    std::cerr << "Usage: ./TextListDecodeBenchmarkMain [indexBasename]\n"
+                 "Without an index, 200M synthetic postings are used.\n";
+    exit(1);
+  }
+  auto lists = argc == 2 ? readLists(argv[1]) : createLists(200 * 1000 * 1000);
+  std::cout << "Encoding " << lists.size() << " lists" << std::endl;
+
+  vector<vector<uint64_t>> simple8b;
+  vector<vector<unsigned char>> streamVByte;
+  size_t simple8bBytes = 0;
+  size_t streamVByteBytes = 0;
+  for (const auto& list : lists) {
+    simple8b.emplace_back(list.size());
+    size_t nofBytes = ad_utility::Simple8bCode::encode(
+        list.data(), list.size(), simple8b.back().data());
+    simple8b.back().resize(nofBytes / sizeof(uint64_t));
+    simple8bBytes += simple8b.back().size() * sizeof(uint64_t);
+    if (!ad_utility::StreamVByteCode::canEncode(list.data(), list.size())) {
+      std::cerr << "A list has values that do not fit into 32 bits\n";
+      exit(1);
+    }
+    streamVByte.emplace_back(
+        ad_utility::StreamVByteCode::maxEncodedBytes(list.size()));
+    streamVByte.back().resize(ad_utility::StreamVByteCode::encode(
+        list.data(), list.size(), streamVByte.back().data()));
+    streamVByteBytes += streamVByte.back().size();
+  }
+
+  // Run everything twice, the first run also warms up the caches.
+  for (size_t run = 0; run < 2; ++run) {
+    benchmarkDecode("Simple8b (scalar)", lists, simple8bBytes,
+                    [&](size_t i, Id* decoded) {
+                      ad_utility::Simple8bCode::decodeScalar(
+                          simple8b[i].data(), lists[i].size(), decoded);
+                    });
+    benchmarkDecode("Simple8b", lists, simple8bBytes,
+                    [&](size_t i, Id* decoded) {
+                      ad_utility::Simple8bCode::decode(
+                          simple8b[i].data(), lists[i].size(), decoded);
+                    });
+    benchmarkDecode("StreamVByte", lists, streamVByteBytes,
+                    [&](size_t i, Id* decoded) {
+                      ad_utility::StreamVByteCode::decode(
+                          streamVByte[i].data(), streamVByte[i].size(),
+                          lists[i].size(), decoded);
+                    });
+  }
+}
@@ -0,0 +1,64 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "./parser/TurtleParser.h"
+#include "./util/Timer.h"
+
+using std::string;
+
+namespace {
+// _____________________________________________________________________________
+template <class Parser>
+size_t parseAll(Parser* parser) {
+  size_t nofTriples = 0;
+  std::array<string, 3> triple;
+  while (parser->getLine(triple)) {
+    ++nofTriples;
+  }
+  return nofTriples;
+}
+
+// _____________________________________________________________________________
+void printThroughput(const string& name, const ad_utility::Timer& timer,
+                     size_t nofTriples) {
+  std::cout << std::setw(24) << name << ": " << std::setw(8) << timer.msecs()
+            << " ms, " << std::setw(10)
+            << static_cast<size_t>(nofTriples / timer.secs()) << " triples/s"
+            << std::endl;
+}
+}  // namespace
+
+// Compares the throughput of the TurtleStreamParser with the
+// TurtleParallelParser for different numbers of threads on an uncompressed
+// .ttl or .nt file. Both use the CTRE tokenizer, so the file must only use
+// ascii prefixes.
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: ./TurtleParserBenchmarkMain <ttlFile> "
+                 "[maxNumThreads (default 16)]\n";
+    exit(1);
+  }
+  string filename = argv[1];
+  size_t maxNumThreads = argc == 3 ? std::stoull(argv[2]) : 16;
+
+  ad_utility::Timer timer;
+  timer.start();
+  TurtleStreamParser<TokenizerCtre> streamParser(filename);
+  size_t nofTriples = parseAll(&streamParser);
+  timer.stop();
+  printThroughput("stream parser", timer, nofTriples);
+
+  for (size_t numThreads = 1; numThreads <= maxNumThreads; numThreads *= 2) {
+    timer.reset();
+    timer.start();
+    TurtleParallelParser<TokenizerCtre> parallelParser(filename, numThreads);
+    nofTriples = parseAll(&parallelParser);
+    timer.stop();
+    printThroughput("parallel, " + std::to_string(numThreads) + " threads",
+                    timer, nofTriples);
+  }
+}
@@ -0,0 +1,122 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "./global/ValueId.h"
+#include "./util/Conversions.h"
+#include "./util/Timer.h"
+
+using std::string;
+using std::vector;
+
+namespace {
+// The result of "FILTER (?x >= threshold)" followed by "SUM(?x)".
+struct FilterAndSum {
+  size_t _nofRows = 0;
+  double _sum = 0;
+};
+
+// _____________________________________________________________________________
+void printTime(const string& name, const ad_utility::Timer& timer,
+               const FilterAndSum& result) {
+  std::cout << std::setw(30) << name << ": " << std::setw(8) << timer.msecs()
+            << " ms (" << result._nofRows << " rows, sum " << result._sum
+            << ")" << std::endl;
+}
+}  // namespace
+
+// Compares a numeric filter with a SUM over the remaining rows on a column
+// of random numbers, once with the numbers in a (sorted) vocabulary of index
+// words and once with the numbers stored in their Ids (see ValueId.h).
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  if (argc > 3) {
+    std::cerr << "Usage: ./ValueFilterBenchmarkMain "
+                 "[nofRows (default 10M)] [selectivity (default 0.5)]\n";
+    exit(1);
+  }
+  size_t nofRows = argc >= 2 ? std::stoull(argv[1]) : 10 * 1000 * 1000;
+  double selectivity = argc == 3 ? std::stod(argv[2]) : 0.5;
+
+  // Half of the values are integers, half of them decimals.
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<int64_t> intDist(-1000000, 1000000);
+  std::uniform_int_distribution<int> fractionDist(0, 99);
+  vector<string> literals;
+  literals.reserve(nofRows);
+  for (size_t i = 0; i < nofRows; ++i) {
+    if (i % 2 == 0) {
+      literals.push_back("\"" + std::to_string(intDist(gen)) +
+                         "\"^^<http://www.w3.org/2001/XMLSchema#int>");
+    } else {
+      literals.push_back("\"" + std::to_string(intDist(gen)) + "." +
+                         std::to_string(fractionDist(gen)) +
+                         "\"^^<http://www.w3.org/2001/XMLSchema#decimal>");
+    }
+  }
+  auto thresholdValue = static_cast<int64_t>(2000000 * (0.5 - selectivity));
+  string threshold = "\"" + std::to_string(thresholdValue) +
+                     "\"^^<http://www.w3.org/2001/XMLSchema#int>";
+  string thresholdWord = ad_utility::convertValueLiteralToIndexWord(threshold);
+
+  // The column as Ids of a vocabulary of index words.
+  vector<string> vocabulary;
+  vocabulary.reserve(nofRows);
+  for (const auto& literal : literals) {
+    vocabulary.push_back(ad_utility::convertValueLiteralToIndexWord(literal));
+  }
+  vector<string> indexWords = vocabulary;
+  std::sort(vocabulary.begin(), vocabulary.end());
+  vocabulary.erase(std::unique(vocabulary.begin(), vocabulary.end()),
+                   vocabulary.end());
+  vector<Id> vocabularyColumn;
+  vocabularyColumn.reserve(nofRows);
+  for (const auto& word : indexWords) {
+    vocabularyColumn.push_back(
+        std::lower_bound(vocabulary.begin(), vocabulary.end(), word) -
+        vocabulary.begin());
+  }
+
+  // The column as Ids with the values inline.
+  vector<Id> inlineColumn;
+  inlineColumn.reserve(nofRows);
+  for (const auto& word : indexWords) {
+    inlineColumn.push_back(ValueId::fromIndexWord(word).value());
+  }
+
+  ad_utility::Timer timer;
+  timer.start();
+  FilterAndSum vocabularyResult;
+  Id lowerBound =
+      std::lower_bound(vocabulary.begin(), vocabulary.end(), thresholdWord) -
+      vocabulary.begin();
+  for (Id id : vocabularyColumn) {
+    if (id >= lowerBound) {
+      ++vocabularyResult._nofRows;
+      vocabularyResult._sum += ad_utility::convertIndexWordToFloat(
+          vocabulary[static_cast<size_t>(id)]);
+    }
+  }
+  timer.stop();
+  printTime("vocabulary of index words", timer, vocabularyResult);
+
+  timer.reset();
+  timer.start();
+  FilterAndSum inlineResult;
+  Id valueId = ValueId::fromIndexWord(thresholdWord).value();
+  Id first = ValueId::sameValueRange(valueId).first;
+  Id last = ValueId::maxId(ValueId::datatype(valueId));
+  for (Id id : inlineColumn) {
+    if (id >= first && id <= last) {
+      ++inlineResult._nofRows;
+      inlineResult._sum += ValueId::toDouble(id);
+    }
+  }
+  timer.stop();
+  printTime("values inline in the Ids", timer, inlineResult);
+}
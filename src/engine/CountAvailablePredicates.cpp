@@ -3,6 +3,7 @@
 // Author: Florian Kramer (florian.kramer@neptun.uni-freiburg.de)
 
 #include "CountAvailablePredicates.h"
+#include "../index/PatternTrickCounts.h"
 #include "CallFixedSize.h"
 
 // _____________________________________________________________________________
@@ -100,6 +101,9 @@ float CountAvailablePredicates::getMultiplicity(size_t col) {
 
 // _____________________________________________________________________________
 size_t CountAvailablePredicates::getSizeEstimate() {
+  if (_precomputedResult != nullptr) {
+    return _precomputedResult->size();
+  }
   if (_subtree.get() != nullptr) {
     // Predicates are only computed for entities in the subtrees result.
 
@@ -119,6 +123,10 @@ size_t CountAvailablePredicates::getSizeEstimate() {
 
 // _____________________________________________________________________________
 size_t CountAvailablePredicates::getCostEstimate() {
+  if (_precomputedResult != nullptr) {
+    // the subtree is not computed, the result only has to be copied.
+    return _precomputedResult->size();
+  }
   if (_subtree.get() != nullptr) {
     // Without knowing the ratio of elements that will have a pattern assuming
     // constant cost per entry should be reasonable (altough non distinct
@@ -138,6 +146,19 @@ void CountAvailablePredicates::computeResult(ResultTable* result) {
   result->_resultTypes.push_back(ResultTable::ResultType::KB);
   result->_resultTypes.push_back(ResultTable::ResultType::VERBATIM);
 
+  if (_precomputedResult != nullptr) {
+    LOG(DEBUG) << "Using the precomputed pattern trick result." << std::endl;
+    _nofPrecomputedResults++;
+    IdTableStatic<2> table = result->_data.moveToStatic<2>();
+    table.reserve(_precomputedResult->size());
+    for (const auto& row : *_precomputedResult) {
+      table.push_back({row[0], row[1]});
+    }
+    result->_data = table.moveToDynamic();
+    return;
+  }
+  _nofComputedResults++;
+
   RuntimeInformation& runtimeInfo = getRuntimeInfo();
 
   const std::vector<PatternID>& hasPattern =
@@ -179,120 +200,73 @@ void CountAvailablePredicates::computeResult(ResultTable* result) {
              << std::endl;
 }
 
+// _____________________________________________________________________________
 void CountAvailablePredicates::computePatternTrickAllEntities(
     IdTable* dynResult, const vector<PatternID>& hasPattern,
     const CompactStringVector<Id, Id>& hasPredicate,
-    const CompactStringVector<size_t, Id>& patterns) {
+    const CompactStringVector<size_t, Id>& patterns, size_t nofThreads,
+    size_t minEntitiesPerThread) {
   IdTableStatic<2> result = dynResult->moveToStatic<2>();
   LOG(DEBUG) << "For all entities." << std::endl;
-  ad_utility::HashMap<Id, size_t> predicateCounts;
-  ad_utility::HashMap<size_t, size_t> patternCounts;
-
   size_t maxId = std::max(hasPattern.size(), hasPredicate.size());
-  for (size_t i = 0; i < maxId; i++) {
-    if (i < hasPattern.size() && hasPattern[i] != NO_PATTERN) {
-      patternCounts[hasPattern[i]]++;
-    } else if (i < hasPredicate.size()) {
-      size_t numPredicates;
-      Id* predicateData;
-      std::tie(predicateData, numPredicates) = hasPredicate[i];
-      if (numPredicates > 0) {
-        for (size_t i = 0; i < numPredicates; i++) {
-          auto it = predicateCounts.find(predicateData[i]);
-          if (it == predicateCounts.end()) {
-            predicateCounts[predicateData[i]] = 1;
-          } else {
-            it->second++;
-          }
-        }
-      }
-    }
-  }
-
-  LOG(DEBUG) << "Using " << patternCounts.size()
+  PredicateCounts counts = countPredicates(
+      [](size_t i) -> std::optional<Id> { return i; }, maxId, hasPattern,
+      hasPredicate, patterns.size(), nofThreads, minEntitiesPerThread);
+  LOG(DEBUG) << "Using " << counts._patternCounts.size()
              << " patterns for computing the result." << std::endl;
-  for (const auto& it : patternCounts) {
-    std::pair<Id*, size_t> pattern = patterns[it.first];
-    for (size_t i = 0; i < pattern.second; i++) {
-      predicateCounts[pattern.first[i]] += it.second;
-    }
-  }
-  result.reserve(predicateCounts.size());
-  for (const auto& it : predicateCounts) {
-    result.push_back({it.first, static_cast<Id>(it.second)});
+  vector<array<Id, 2>> table = predicateCountTable(counts, patterns);
+  result.reserve(table.size());
+  for (const auto& row : table) {
+    result.push_back({row[0], row[1]});
   }
   *dynResult = result.moveToDynamic();
 }
 
+// _____________________________________________________________________________
 template <int WIDTH>
 void CountAvailablePredicates::computePatternTrick(
     const IdTable& dynInput, IdTable* dynResult,
     const vector<PatternID>& hasPattern,
     const CompactStringVector<Id, Id>& hasPredicate,
     const CompactStringVector<size_t, Id>& patterns, const size_t subjectColumn,
-    RuntimeInformation* runtimeInfo) {
+    RuntimeInformation* runtimeInfo, size_t nofThreads,
+    size_t minEntitiesPerThread) {
   const IdTableView<WIDTH> input = dynInput.asStaticView<WIDTH>();
   IdTableStatic<2> result = dynResult->moveToStatic<2>();
   LOG(DEBUG) << "For " << input.size() << " entities in column "
              << subjectColumn << std::endl;
 
-  ad_utility::HashMap<Id, size_t> predicateCounts;
-  ad_utility::HashMap<size_t, size_t> patternCounts;
-  size_t inputIdx = 0;
+  // Skip over elements with the same subject (don't count them twice)
+  auto subjectAt = [&input, subjectColumn](size_t i) -> std::optional<Id> {
+    Id subject = input(i, subjectColumn);
+    if (i > 0 && input(i - 1, subjectColumn) == subject) {
+      return std::nullopt;
+    }
+    return subject;
+  };
+  PredicateCounts counts =
+      countPredicates(subjectAt, input.size(), hasPattern, hasPredicate,
+                      patterns.size(), nofThreads, minEntitiesPerThread);
+  ad_utility::HashMap<Id, size_t>& predicateCounts = counts._predicateCounts;
   // These variables are used to gather additional statistics
-  size_t numEntitiesWithPatterns = 0;
+  size_t numEntitiesWithPatterns = counts._numEntitiesWithPatterns;
   // the number of distinct predicates in patterns
   size_t numPatternPredicates = 0;
   // the number of predicates counted without patterns
-  size_t numListPredicates = 0;
-  Id lastSubject = ID_NO_VALUE;
-  while (inputIdx < input.size()) {
-    // Skip over elements with the same subject (don't count them twice)
-    Id subject = input(inputIdx, subjectColumn);
-    if (subject == lastSubject) {
-      inputIdx++;
-      continue;
-    }
-    lastSubject = subject;
-    if (subject < hasPattern.size() && hasPattern[subject] != NO_PATTERN) {
-      // The subject matches a pattern
-      patternCounts[hasPattern[subject]]++;
-      numEntitiesWithPatterns++;
-    } else if (subject < hasPredicate.size()) {
-      // The subject does not match a pattern
-      size_t numPredicates;
-      Id* predicateData;
-      std::tie(predicateData, numPredicates) = hasPredicate[subject];
-      numListPredicates += numPredicates;
-      if (numPredicates > 0) {
-        for (size_t i = 0; i < numPredicates; i++) {
-          predicateCounts[predicateData[i]]++;
-        }
-      } else {
-        LOG(TRACE) << "No pattern or has-relation entry found for entity "
-                   << std::to_string(subject) << std::endl;
-      }
-    } else {
-      LOG(TRACE) << "Subject " << subject
-                 << " does not appear to be an entity "
-                    "(its id is to high)."
-                 << std::endl;
-    }
-    inputIdx++;
-  }
-  LOG(DEBUG) << "Using " << patternCounts.size()
+  size_t numListPredicates = counts._numListPredicates;
+  LOG(DEBUG) << "Using " << counts._patternCounts.size()
              << " patterns for computing the result." << std::endl;
   // the number of predicates counted with patterns
   size_t numPredicatesSubsumedInPatterns = 0;
   // resolve the patterns to predicate counts
-  for (const auto& it : patternCounts) {
-    std::pair<Id*, size_t> pattern = patterns[it.first];
+  counts._patternCounts.forEach([&](size_t patternId, size_t count) {
+    std::pair<Id*, size_t> pattern = patterns[patternId];
     numPatternPredicates += pattern.second;
     for (size_t i = 0; i < pattern.second; i++) {
-      predicateCounts[pattern.first[i]] += it.second;
-      numPredicatesSubsumedInPatterns += it.second;
+      predicateCounts[pattern.first[i]] += count;
+      numPredicatesSubsumedInPatterns += count;
     }
-  }
+  });
   // write the predicate counts to the result
   result.reserve(predicateCounts.size());
   for (const auto& it : predicateCounts) {
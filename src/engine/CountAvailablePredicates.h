@@ -3,12 +3,15 @@
 // Author: Florian Kramer (florian.kramer@mail.uni-freiburg.de)
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "../global/Constants.h"
 #include "../global/Pattern.h"
+#include "../index/PatternTrickTables.h"
 #include "../parser/ParsedQuery.h"
 #include "./Operation.h"
 #include "./QueryExecutionTree.h"
@@ -84,6 +87,20 @@ class CountAvailablePredicates : public Operation {
   void setVarNames(const std::string& predicateVarName,
                    const std::string& countVarName);
 
+  // Use a precomputed result (see PatternTrickTables) instead of computing
+  // it. The table has to match the entities of this operation and must live
+  // as long as this operation. Does nothing for nullptr.
+  void setPrecomputedResult(const PatternTrickTables::Table* table) {
+    _precomputedResult = table;
+  }
+
+  bool hasPrecomputedResult() const { return _precomputedResult != nullptr; }
+
+  // The number of results of this operation that were taken from a
+  // precomputed table and that were computed since the start of the program.
+  static size_t getNofPrecomputedResults() { return _nofPrecomputedResults; }
+  static size_t getNofComputedResults() { return _nofComputedResults; }
+
   // This method is declared here solely for unit testing purposes
   /**
    * @brief Computes all relations that have one of input[inputCol]'s entities
@@ -96,6 +113,9 @@ class CountAvailablePredicates : public Operation {
    * @param patterns A mapping from pattern ids to patterns
    * @param subjectColumn The column containing the entities for which the
    *                      relations should be counted.
+   * @param nofThreads The input is split into at most this many parts which
+   *                   are counted concurrently.
+   * @param minEntitiesPerThread The minimal number of input rows per part.
    */
   template <int I>
   static void computePatternTrick(
@@ -103,12 +123,20 @@ class CountAvailablePredicates : public Operation {
       const vector<PatternID>& hasPattern,
       const CompactStringVector<Id, Id>& hasPredicate,
       const CompactStringVector<size_t, Id>& patterns,
-      const size_t subjectColumn, RuntimeInformation* runtimeInfo);
+      const size_t subjectColumn, RuntimeInformation* runtimeInfo,
+      size_t nofThreads = NOF_PATTERN_TRICK_THREADS,
+      size_t minEntitiesPerThread = PATTERN_TRICK_MIN_ENTITIES_PER_THREAD);
 
+  /**
+   * @brief Computes all relations and the number of entities they occur with
+   *        as a subject, like computePatternTrick with all entities as input.
+   */
   static void computePatternTrickAllEntities(
       IdTable* result, const vector<PatternID>& hasPattern,
       const CompactStringVector<Id, Id>& hasPredicate,
-      const CompactStringVector<size_t, Id>& patterns);
+      const CompactStringVector<size_t, Id>& patterns,
+      size_t nofThreads = NOF_PATTERN_TRICK_THREADS,
+      size_t minEntitiesPerThread = PATTERN_TRICK_MIN_ENTITIES_PER_THREAD);
 
  private:
   std::shared_ptr<QueryExecutionTree> _subtree;
@@ -117,6 +145,10 @@ class CountAvailablePredicates : public Operation {
   std::optional<std::string> _subjectEntityName;
   std::string _predicateVarName;
   std::string _countVarName;
+  const PatternTrickTables::Table* _precomputedResult = nullptr;
+
+  static inline std::atomic<size_t> _nofPrecomputedResults = 0;
+  static inline std::atomic<size_t> _nofComputedResults = 0;
 
   virtual void computeResult(ResultTable* result) override;
 };
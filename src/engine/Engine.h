@@ -10,6 +10,7 @@
 
 #include "../global/Constants.h"
 #include "../global/Id.h"
+#include "../util/CancellationHandle.h"
 #include "../util/Exception.h"
 #include "../util/Log.h"
 #include "./IndexSequence.h"
@@ -23,7 +24,9 @@ class Engine {
     AD_CHECK(result);
     AD_CHECK(result->size() == 0);
     LOG(DEBUG) << "Filtering " << v.size() << " elements.\n";
+    size_t i = 0;
     for (const auto& e : v) {
+      ad_utility::checkCancellation(i++);
       if (comp(e)) {
         result->push_back(e);
       }
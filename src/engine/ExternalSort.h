@@ -0,0 +1,221 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+#include "../util/File.h"
+#include "../util/Log.h"
+#include "./Engine.h"
+#include "./IdTable.h"
+#include "./LazyResult.h"
+
+using std::string;
+using std::vector;
+
+namespace ad_utility {
+
+namespace detail {
+// Used to create unique names for the temporary files of concurrent sorts.
+inline std::atomic<size_t> nofExternalSorts = 0;
+}  // namespace detail
+
+namespace detail {
+// Sorts the rows that nextBlock writes to its (empty) argument block by block
+// until it returns false, see the overloads of externalSort below. nextBlock
+// is destroyed (and thus releases its input) before the sorted runs are
+// merged.
+template <int WIDTH, typename Comparator>
+void externalSort(size_t cols, std::function<bool(IdTable*)> nextBlock,
+                  IdTable* result, Comparator comp, size_t memoryLimitInBytes,
+                  const string& tmpFilePrefix) {
+  const size_t bytesPerRow = std::max<size_t>(1, cols) * sizeof(Id);
+  // Rows without columns need no memory.
+  const size_t rowsPerRun =
+      cols == 0 ? std::numeric_limits<size_t>::max()
+                : std::max<size_t>(1, memoryLimitInBytes / bytesPerRow);
+  result->setCols(cols);
+
+  // Collect the rows of a run. The table only grows by exactly the missing
+  // rows, so its capacity is doubled here.
+  IdTable run(cols);
+  size_t runCapacity = 0;
+  IdTable block(cols);
+  bool hasMoreRows = true;
+  auto readRun = [&]() {
+    run.clear();
+    while (run.size() < rowsPerRun && (hasMoreRows = nextBlock(&block))) {
+      if (run.size() + block.size() > runCapacity) {
+        runCapacity = std::max(2 * runCapacity, run.size() + block.size());
+        run.reserve(runCapacity);
+      }
+      run.insert(run.end(), block.begin(), block.end());
+      block.clear();
+    }
+  };
+
+  readRun();
+  if (!hasMoreRows) {
+    // The input fits into memory.
+    Engine::sort<WIDTH>(&run, comp);
+    *result = std::move(run);
+    return;
+  }
+
+  string fileName = tmpFilePrefix + ".sort-tmp." +
+                    std::to_string(detail::nofExternalSorts++);
+  LOG(INFO) << "Sorting at least " << run.size() << " rows (" << cols
+            << " columns) externally, using " << memoryLimitInBytes / 1000000
+            << " MB and the temporary file " << fileName << endl;
+
+  // Create the sorted runs.
+  vector<off_t> runStarts;
+  {
+    ad_utility::File out(fileName, "w");
+    off_t offset = 0;
+    while (run.size() > 0) {
+      Engine::sort<WIDTH>(&run, comp);
+      runStarts.push_back(offset);
+      out.write(run.data(), run.size() * bytesPerRow);
+      offset += run.size() * bytesPerRow;
+      readRun();
+    }
+    runStarts.push_back(offset);
+  }
+  // Release the input and the memory of the runs before the merge.
+  nextBlock = nullptr;
+  run = IdTable(cols);
+  block = IdTable(cols);
+  LOG(DEBUG) << "Created " << runStarts.size() - 1 << " sorted runs." << endl;
+
+  // Merge the runs. Each run gets an equal share of the memory for its buffer.
+  ad_utility::File in(fileName, "r");
+  const size_t nofRuns = runStarts.size() - 1;
+  const size_t rowsPerBuffer = std::max<size_t>(1, rowsPerRun / nofRuns);
+  struct Run {
+    IdTableStatic<WIDTH> _buffer;
+    size_t _pos = 0;
+    off_t _next;
+    off_t _end;
+  };
+  vector<Run> runs(nofRuns);
+  // Read the next part of a run into its buffer.
+  auto refill = [&](Run* run) {
+    size_t nofRows = std::min<size_t>(rowsPerBuffer,
+                                      (run->_end - run->_next) / bytesPerRow);
+    run->_buffer.resize(nofRows);
+    in.read(run->_buffer.data(), nofRows * bytesPerRow, run->_next);
+    run->_next += nofRows * bytesPerRow;
+    run->_pos = 0;
+  };
+  // The run with the smallest current row is at the top.
+  auto greater = [&runs, &comp](size_t a, size_t b) {
+    return comp(runs[b]._buffer[runs[b]._pos], runs[a]._buffer[runs[a]._pos]);
+  };
+  std::priority_queue<size_t, vector<size_t>, decltype(greater)> queue(
+      greater);
+  for (size_t i = 0; i < nofRuns; ++i) {
+    IdTable buffer(cols);
+    runs[i]._buffer = buffer.moveToStatic<WIDTH>();
+    runs[i]._next = runStarts[i];
+    runs[i]._end = runStarts[i + 1];
+    refill(&runs[i]);
+    queue.push(i);
+  }
+
+  IdTableStatic<WIDTH> res = result->moveToStatic<WIDTH>();
+  res.reserve(runStarts.back() / bytesPerRow);
+  while (!queue.empty()) {
+    size_t i = queue.top();
+    queue.pop();
+    Run& run = runs[i];
+    // Copy all rows of the run that are not larger than the smallest current
+    // row of the other runs at once.
+    const Run* next = queue.empty() ? nullptr : &runs[queue.top()];
+    auto isNotLarger = [&run, next, &comp](size_t pos) {
+      return next == nullptr ||
+             !comp(next->_buffer[next->_pos], run._buffer[pos]);
+    };
+    while (run._pos < run._buffer.size() && isNotLarger(run._pos)) {
+      size_t end = run._pos + 1;
+      while (end < run._buffer.size() && isNotLarger(end)) {
+        ++end;
+      }
+      res.insert(res.end(), run._buffer.begin() + run._pos,
+                 run._buffer.begin() + end);
+      run._pos = end;
+      if (run._pos == run._buffer.size()) {
+        refill(&run);
+      }
+    }
+    if (run._pos < run._buffer.size()) {
+      queue.push(i);
+    }
+  }
+  *result = res.moveToDynamic();
+  in.close();
+  remove(fileName.c_str());
+}
+}  // namespace detail
+
+/**
+ * @brief Sort the rows of input according to comp and write them to result.
+ * If input is larger than memoryLimitInBytes, the sort does not need more than
+ * this amount of additional memory: sorted runs of at most memoryLimitInBytes
+ * are created with Engine::sort and written to a temporary file whose name
+ * starts with tmpFilePrefix. Then the runs are merged directly into result.
+ * Otherwise input is copied to result and sorted in place.
+ *
+ * @tparam WIDTH The static width of the tables or 0 (see CALL_FIXED_SIZE_1)
+ * @param comp (row, row) -> bool, as for Engine::sort
+ */
+template <int WIDTH, typename Comparator>
+void externalSort(const IdTable& input, IdTable* result, Comparator comp,
+                  size_t memoryLimitInBytes, const string& tmpFilePrefix) {
+  const size_t cols = input.cols();
+  const size_t bytesPerRow = std::max<size_t>(1, cols) * sizeof(Id);
+  if (input.size() <= memoryLimitInBytes / bytesPerRow || cols == 0) {
+    result->setCols(cols);
+    result->insert(result->end(), input.begin(), input.end());
+    Engine::sort<WIDTH>(result, comp);
+    return;
+  }
+  size_t nextRow = 0;
+  auto nextBlock = [&input, nextRow](IdTable* block) mutable {
+    if (nextRow >= input.size()) {
+      return false;
+    }
+    size_t endRow = std::min(input.size(), nextRow + LAZY_RESULT_BLOCK_SIZE);
+    block->insert(block->end(), input.begin() + nextRow,
+                  input.begin() + endRow);
+    nextRow = endRow;
+    return true;
+  };
+  detail::externalSort<WIDTH>(cols, nextBlock, result, comp,
+                              memoryLimitInBytes, tmpFilePrefix);
+}
+
+/**
+ * @brief The same, but for a lazily computed input. The input is read block by
+ * block and released once the sorted runs are written, so it is never in
+ * memory at the same time as the result. Only if it fits into
+ * memoryLimitInBytes, it is sorted in memory.
+ */
+template <int WIDTH, typename Comparator>
+void externalSort(std::unique_ptr<LazyResult> input, IdTable* result,
+                  Comparator comp, size_t memoryLimitInBytes,
+                  const string& tmpFilePrefix) {
+  const size_t cols = input->width();
+  auto nextBlock = [input = std::shared_ptr<LazyResult>(std::move(input))](
+                       IdTable* block) { return input->nextBlock(block); };
+  detail::externalSort<WIDTH>(cols, nextBlock, result, comp,
+                              memoryLimitInBytes, tmpFilePrefix);
+}
+}  // namespace ad_utility
@@ -3,11 +3,18 @@
 // Author: Björn Buchhold (buchhold@informatik.uni-freiburg.de)
 
 #include "Filter.h"
+#include <re2/re2.h>
 #include <algorithm>
+#include <cstdlib>
+#include <future>
 #include <optional>
-#include <regex>
 #include <sstream>
+#include <tuple>
+#include "../global/ValueId.h"
+#include "../index/NumberOrder.h"
+#include "../util/CancellationHandle.h"
 #include "CallFixedSize.h"
+#include "IndexScan.h"
 #include "QueryExecutionTree.h"
 
 using std::string;
@@ -244,6 +251,35 @@ void Filter::computeResult(ResultTable* result) {
   RuntimeInformation& runtimeInfo = getRuntimeInfo();
   runtimeInfo.setDescriptor(getDescriptor());
   runtimeInfo.addChild(_subtree->getRootOperation()->getRuntimeInfo());
+  computeResultForSubResult(result, subRes);
+}
+
+// _____________________________________________________________________________
+std::unique_ptr<LazyResult> Filter::computeLazyResult() {
+  std::shared_ptr<LazyResult> subResult = _subtree->getLazyResult();
+  // Each block of the subtree is filtered like a complete sub result.
+  auto generator = [this, subResult](IdTable* block) {
+    auto subRes = std::make_shared<ResultTable>();
+    subRes->_sortedBy = subResult->_sortedBy;
+    subRes->_resultTypes = subResult->_resultTypes;
+    subRes->_localVocab = subResult->_localVocab;
+    subRes->_data.setCols(subResult->width());
+    if (!subResult->nextBlock(&subRes->_data)) {
+      return false;
+    }
+    ResultTable result;
+    computeResultForSubResult(&result, subRes);
+    *block = std::move(result._data);
+    return true;
+  };
+  return std::make_unique<LazyResult>(
+      subResult->width(), subResult->_sortedBy, subResult->_resultTypes,
+      subResult->_localVocab, std::move(generator));
+}
+
+// _____________________________________________________________________________
+void Filter::computeResultForSubResult(ResultTable* result,
+                                       shared_ptr<const ResultTable> subRes) {
   LOG(DEBUG) << "Filter result computation..." << endl;
   result->_data.setCols(subRes->_data.cols());
   result->_resultTypes.insert(result->_resultTypes.end(),
@@ -267,38 +303,46 @@ void Filter::computeResult(ResultTable* result) {
 // _____________________________________________________________________________
 template <ResultTable::ResultType T, int WIDTH, bool INVERSE>
 void Filter::computeFilterRange(IdTableStatic<WIDTH>* res, size_t lhs,
-                                Id rhs_lower, Id rhs_upper,
+                                const vector<pair<Id, Id>>& ranges,
                                 const IdTableView<WIDTH>& input,
                                 shared_ptr<const ResultTable> subRes) const {
   bool lhs_is_sorted =
       subRes->_sortedBy.size() > 0 && subRes->_sortedBy[0] == lhs;
   if (lhs_is_sorted) {
     // The input data is sorted, use binary search to locate the first
-    // and last element that match rhs and copy the range.
-
-    const auto& lower = std::lower_bound(input.begin(), input.end(), rhs_lower,
-                                         [lhs](const auto& l, const auto& r) {
-                                           return ValueReader<T>::get(l[lhs]) <
-                                                  ValueReader<T>::get(r);
-                                         });
-    const auto& upper = std::lower_bound(
-        lower, input.end(), rhs_upper, [lhs](const auto& l, const auto& r) {
-          return ValueReader<T>::get(l[lhs]) < ValueReader<T>::get(r);
-        });
-    if constexpr (!INVERSE) {
-      res->insert(res->end(), lower, upper);
-    } else {
-      res->insert(res->end(), input.begin(), lower);
-      res->insert(res->end(), upper, res->end());
+    // and last element that match each range and copy the ranges (or the
+    // rows between them).
+    auto begin = input.begin();
+    for (const auto& [rhs_lower, rhs_upper] : ranges) {
+      const auto& lower = std::lower_bound(
+          begin, input.end(), rhs_lower, [lhs](const auto& l, const auto& r) {
+            return ValueReader<T>::get(l[lhs]) < ValueReader<T>::get(r);
+          });
+      const auto& upper = std::lower_bound(
+          lower, input.end(), rhs_upper, [lhs](const auto& l, const auto& r) {
+            return ValueReader<T>::get(l[lhs]) < ValueReader<T>::get(r);
+          });
+      if constexpr (!INVERSE) {
+        res->insert(res->end(), lower, upper);
+      } else {
+        res->insert(res->end(), begin, lower);
+      }
+      begin = upper;
+    }
+    if constexpr (INVERSE) {
+      res->insert(res->end(), begin, input.end());
     }
   } else {
     const auto inv = [&](const bool b) { return INVERSE ? !b : b; };
     getEngine().filter(
         input,
-        [lhs, rhs_lower, rhs_upper, &inv](const auto& e) {
-          return inv(
-              ValueReader<T>::get(e[lhs]) >= ValueReader<T>::get(rhs_lower) &&
-              ValueReader<T>::get(e[lhs]) < ValueReader<T>::get(rhs_upper));
+        [lhs, &ranges, &inv](const auto& e) {
+          auto value = ValueReader<T>::get(e[lhs]);
+          return inv(std::any_of(
+              ranges.begin(), ranges.end(), [value](const auto& range) {
+                return value >= ValueReader<T>::get(range.first) &&
+                       value < ValueReader<T>::get(range.second);
+              }));
         },
         res);
   }
@@ -577,35 +621,81 @@ void Filter::computeFilterFixedValue(
             "Encountered multiple prefix filters concatenated with ||, but "
             "their input was not of type KB, this is not supported as of now");
       }
-      std::regex self_regex;
-      try {
-        if (_regexIgnoreCase) {
-          self_regex.assign(_rhs, std::regex_constants::ECMAScript |
-                                      std::regex_constants::icase);
-        } else {
-          self_regex.assign(_rhs, std::regex_constants::ECMAScript);
-        }
-      } catch (const std::regex_error& e) {
-        // Rethrow the regex error with more information. Can't use the
-        // regex_error here as the constructor does not allow setting the
-        // error message.
+      re2::RE2::Options options;
+      options.set_case_sensitive(!_regexIgnoreCase);
+      options.set_log_errors(false);
+      const re2::RE2 regex(_rhs, options);
+      if (!regex.ok()) {
         throw std::runtime_error(
-            "The regex '" + _rhs +
-            "'is not an ECMAScript regex: " + std::string(e.what()));
+            "The regex '" + _rhs + "' is not a valid RE2 regex: " +
+            regex.error() +
+            " (backreferences and lookarounds are not supported)");
+      }
+      // Every word of the vocabulary that matches the regex starts with its
+      // literal prefix, so all other vocabulary Ids can be rejected without
+      // looking up their words.
+      std::optional<std::pair<Id, Id>> prefixRange;
+      Id vocabSize = 0;
+      if constexpr (T == ResultTable::ResultType::KB) {
+        string prefix = ad_utility::getLiteralPrefixOfRegex(_rhs);
+        if (!prefix.empty()) {
+          prefixRange = getIndex().getVocab().prefix_range(prefix);
+          vocabSize = getIndex().getVocab().size();
+        }
+      }
+      auto matches = [this, &regex, &prefixRange, vocabSize,
+                      &subRes](Id id) -> bool {
+        if (prefixRange && !ValueId::isValue(id) && id < vocabSize &&
+            (id < prefixRange->first || id >= prefixRange->second)) {
+          return false;
+        }
+        std::optional<string> entity;
+        if constexpr (T == ResultTable::ResultType::KB) {
+          entity = getIndex().idToOptionalString(id);
+        } else if (T == ResultTable::ResultType::LOCAL_VOCAB) {
+          entity = subRes->idToOptionalString(id);
+        }
+        if (!entity) {
+          return true;
+        }
+        return re2::RE2::PartialMatch(entity.value(), regex);
+      };
+
+      // Match every distinct Id of the column only once, in parallel for
+      // large inputs.
+      vector<Id> ids;
+      ids.reserve(input.size());
+      for (size_t i = 0; i < input.size(); ++i) {
+        ids.push_back(input(i, lhs));
       }
+      std::sort(ids.begin(), ids.end());
+      ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+      vector<char> idMatches(ids.size());
+      const size_t numThreads = std::clamp<size_t>(
+          ids.size() / REGEX_FILTER_MIN_IDS_PER_THREAD, 1,
+          NOF_REGEX_FILTER_THREADS);
+      vector<std::future<void>> futures;
+      for (size_t t = 0; t < numThreads; ++t) {
+        futures.push_back(std::async(
+            std::launch::async,
+            [&, t, handle = ad_utility::CancellationHandle::current()]() {
+              ad_utility::CancellationHandle::Scope scope(handle);
+              size_t end = ids.size() * (t + 1) / numThreads;
+              for (size_t i = ids.size() * t / numThreads; i < end; ++i) {
+                ad_utility::checkCancellation(i);
+                idMatches[i] = matches(ids[i]);
+              }
+            }));
+      }
+      for (auto& f : futures) {
+        f.get();
+      }
+
       getEngine().filter(
           input,
-          [this, self_regex, &lhs, &subRes](const auto& e) {
-            std::optional<string> entity;
-            if constexpr (T == ResultTable::ResultType::KB) {
-              entity = getIndex().idToOptionalString(e[lhs]);
-            } else if (T == ResultTable::ResultType::LOCAL_VOCAB) {
-              entity = subRes->idToOptionalString(e[lhs]);
-            }
-            if (!entity) {
-              return true;
-            }
-            return std::regex_search(entity.value(), self_regex);
+          [&ids, &idMatches, lhs](const auto& e) {
+            auto it = std::lower_bound(ids.begin(), ids.end(), e[lhs]);
+            return idMatches[it - ids.begin()] != 0;
           },
           res);
     } break;
@@ -613,6 +703,192 @@ void Filter::computeFilterFixedValue(
   delete[] rhs_array;
 }
 
+// _____________________________________________________________________________
+size_t Filter::getSizeEstimate() {
+  if (_type == SparqlFilter::FilterType::REGEX) {
+    // TODO(jbuerklin): return a better estimate
+    return std::numeric_limits<Id>::max();
+  }
+  if (auto selectivity = getSelectivityFromStatistics()) {
+    return std::max(size_t(1), static_cast<size_t>(
+                                   *selectivity * _subtree->getSizeEstimate()));
+  }
+  // TODO(schnelle): return a better estimate
+  if (_rhs[0] == '?') {
+    if (_type == SparqlFilter::FilterType::EQ) {
+      return _subtree->getSizeEstimate() / 1000;
+    }
+    if (_type == SparqlFilter::FilterType::NE) {
+      return _subtree->getSizeEstimate() / 4;
+    } else {
+      return _subtree->getSizeEstimate() / 2;
+    }
+  } else {
+    if (_type == SparqlFilter::FilterType::EQ) {
+      return _subtree->getSizeEstimate() / 1000;
+    }
+    if (_type == SparqlFilter::FilterType::NE) {
+      return _subtree->getSizeEstimate();
+    } else {
+      return _subtree->getSizeEstimate() / 50;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+const PredicateStatistics* Filter::getLhsObjectStatistics() const {
+  const PredicateStatistics* stats = nullptr;
+  auto visit = [this, &stats](QueryExecutionTree* tree) {
+    if (stats || tree->getType() != QueryExecutionTree::SCAN) {
+      return;
+    }
+    const auto& scan =
+        static_cast<const IndexScan&>(*tree->getRootOperation());
+    if ((scan.getType() != IndexScan::PSO_FREE_S &&
+         scan.getType() != IndexScan::POS_FREE_O) ||
+        scan.getObject() != _lhs) {
+      return;
+    }
+    Id predicateId;
+    if (getIndex().getVocab().getId(scan.getPredicate(), &predicateId)) {
+      stats = getIndex().getRelationStatistics().get(predicateId);
+    }
+  };
+  visit(_subtree.get());
+  _subtree->forAllDescendants(visit);
+  return stats;
+}
+
+// _____________________________________________________________________________
+std::optional<double> Filter::getSelectivityFromStatistics() const {
+  bool isComparison =
+      _type == SparqlFilter::EQ || _type == SparqlFilter::NE ||
+      _type == SparqlFilter::LT || _type == SparqlFilter::LE ||
+      _type == SparqlFilter::GT || _type == SparqlFilter::GE;
+  if (!isComparison || _rhs[0] == '?' || _lhsAsString ||
+      getIndex().getRelationStatistics().empty()) {
+    return std::nullopt;
+  }
+  const PredicateStatistics* stats = getLhsObjectStatistics();
+  if (!stats) {
+    return std::nullopt;
+  }
+  KbRhs kbRhs = getKbRhs();
+  if (kbRhs._isRange) {
+    double selectivity = kbRhs._rhsUpper == kbRhs._rhs + 1
+                             ? stats->objectSelectivity(kbRhs._rhs)
+                             : stats->objectRangeSelectivity(kbRhs._rhs,
+                                                             kbRhs._rhsUpper);
+    selectivity += stats->objectRangeSelectivity(kbRhs._vocabRhs,
+                                                 kbRhs._vocabRhsUpper);
+    return _type == SparqlFilter::NE ? 1 - selectivity : selectivity;
+  }
+  // A comparison with an Id of the vocabulary.
+  switch (_type) {
+    case SparqlFilter::LT:
+      return stats->objectRangeSelectivity(0, kbRhs._rhs);
+    case SparqlFilter::LE:
+      return stats->objectRangeSelectivity(0, kbRhs._rhs + 1);
+    case SparqlFilter::GT:
+      return stats->objectRangeSelectivity(kbRhs._rhs + 1, ID_NO_VALUE);
+    default:
+      return stats->objectRangeSelectivity(kbRhs._rhs, ID_NO_VALUE);
+  }
+}
+
+// _____________________________________________________________________________
+Filter::KbRhs Filter::getKbRhs() const {
+  KbRhs result;
+  std::string rhs_string = _rhs;
+  if (ad_utility::isXsdValue(rhs_string)) {
+    rhs_string = ad_utility::convertValueLiteralToIndexWord(rhs_string);
+  } else if (ad_utility::isNumeric(_rhs)) {
+    rhs_string = ad_utility::convertNumericToIndexWord(rhs_string);
+  } else {
+    // TODO: This is not standard conform, but currently required due to
+    // our vocabulary storing iris with the greater than and
+    // literals with their quotation marks.
+    if (rhs_string.size() > 2 && rhs_string[1] == '<' &&
+        rhs_string[0] == '"' && rhs_string.back() == '"') {
+      // Remove the quotation marks surrounding the string.
+      rhs_string = rhs_string.substr(1, rhs_string.size() - 2);
+    } else if (std::count(rhs_string.begin(), rhs_string.end(), '"') > 2 &&
+               rhs_string.back() == '"') {
+      // Remove the quotation marks surrounding the string.
+      rhs_string = rhs_string.substr(1, rhs_string.size() - 2);
+    }
+  }
+
+  // TODO<joka921> which level do we want for these filters
+  auto level = TripleComponentComparator::Level::QUARTERNARY;
+  auto valueId = ValueId::fromIndexWord(rhs_string);
+  bool isComparison =
+      _type == SparqlFilter::EQ || _type == SparqlFilter::NE ||
+      _type == SparqlFilter::LT || _type == SparqlFilter::LE ||
+      _type == SparqlFilter::GT || _type == SparqlFilter::GE;
+  if (isComparison && ad_utility::startsWith(rhs_string, VALUE_FLOAT_PREFIX)) {
+    // Compare to the numbers by value, the inline ones (whose Ids are
+    // ordered like the values) and the ones in the vocabulary.
+    double value =
+        valueId ? ValueId::toDouble(*valueId)
+                : std::strtod(
+                      ad_utility::convertIndexWordToFloatString(rhs_string)
+                          .c_str(),
+                      nullptr);
+    auto relation = NumberOrder::Relation::EQ;
+    if (_type == SparqlFilter::LT) {
+      relation = NumberOrder::Relation::LT;
+    } else if (_type == SparqlFilter::LE) {
+      relation = NumberOrder::Relation::LE;
+    } else if (_type == SparqlFilter::GT) {
+      relation = NumberOrder::Relation::GT;
+    } else if (_type == SparqlFilter::GE) {
+      relation = NumberOrder::Relation::GE;
+    }
+    result._isRange = true;
+    std::tie(result._rhs, result._rhsUpper) =
+        NumberOrder::inlineRange(relation, value);
+    std::tie(result._vocabRhs, result._vocabRhsUpper) =
+        getIndex().getNumberOrder().vocabRange(relation, value);
+  } else if (valueId && isComparison) {
+    // Dates are stored in their Ids, which are ordered like the values. Only
+    // compare to values of the same datatype.
+    auto datatype = ValueId::datatype(*valueId);
+    auto [first, last] = ValueId::sameValueRange(*valueId);
+    result._isRange = true;
+    if (_type == SparqlFilter::EQ || _type == SparqlFilter::NE) {
+      result._rhs = first;
+      result._rhsUpper = last + 1;
+    } else if (_type == SparqlFilter::LT) {
+      result._rhs = ValueId::minId(datatype);
+      result._rhsUpper = first;
+    } else if (_type == SparqlFilter::LE) {
+      result._rhs = ValueId::minId(datatype);
+      result._rhsUpper = last + 1;
+    } else if (_type == SparqlFilter::GT) {
+      result._rhs = last + 1;
+      result._rhsUpper = ValueId::maxId(datatype) + 1;
+    } else {
+      result._rhs = first;
+      result._rhsUpper = ValueId::maxId(datatype) + 1;
+    }
+  } else if (_type == SparqlFilter::EQ || _type == SparqlFilter::NE) {
+    result._rhs = getIndex().getVocab().lower_bound(rhs_string, level);
+    result._rhsUpper = getIndex().getVocab().upper_bound(rhs_string, level);
+    result._isRange = true;
+  } else if (_type == SparqlFilter::GE) {
+    result._rhs = getIndex().getVocab().getValueIdForGE(rhs_string, level);
+  } else if (_type == SparqlFilter::GT) {
+    result._rhs = getIndex().getVocab().getValueIdForGT(rhs_string, level);
+  } else if (_type == SparqlFilter::LT) {
+    result._rhs = getIndex().getVocab().getValueIdForLT(rhs_string, level);
+  } else if (_type == SparqlFilter::LE) {
+    result._rhs = getIndex().getVocab().getValueIdForLE(rhs_string, level);
+  }
+  // All other types of filters do not use the Ids and work on _rhs directly.
+  return result;
+}
+
 // _____________________________________________________________________________
 template <int WIDTH>
 void Filter::computeResultFixedValue(
@@ -630,49 +906,19 @@ void Filter::computeResultFixedValue(
   // interpret the filters right hand side
   size_t lhs = _subtree->getVariableColumn(_lhs);
   Id rhs;
-  Id rhs_upper_for_range;
+  vector<pair<Id, Id>> ranges;
   bool apply_range_filter = false;
   bool range_filter_inverse = false;
   switch (subRes->getResultType(lhs)) {
     case ResultTable::ResultType::KB: {
-      std::string rhs_string = _rhs;
-      if (ad_utility::isXsdValue(rhs_string)) {
-        rhs_string = ad_utility::convertValueLiteralToIndexWord(rhs_string);
-      } else if (ad_utility::isNumeric(_rhs)) {
-        rhs_string = ad_utility::convertNumericToIndexWord(rhs_string);
-      } else {
-        // TODO: This is not standard conform, but currently required due to
-        // our vocabulary storing iris with the greater than and
-        // literals with their quotation marks.
-        if (rhs_string.size() > 2 && rhs_string[1] == '<' &&
-            rhs_string[0] == '"' && rhs_string.back() == '"') {
-          // Remove the quotation marks surrounding the string.
-          rhs_string = rhs_string.substr(1, rhs_string.size() - 2);
-        } else if (std::count(rhs_string.begin(), rhs_string.end(), '"') > 2 &&
-                   rhs_string.back() == '"') {
-          // Remove the quotation marks surrounding the string.
-          rhs_string = rhs_string.substr(1, rhs_string.size() - 2);
-        }
-      }
-
-      // TODO<joka921> which level do we want for these filters
-      auto level = TripleComponentComparator::Level::QUARTERNARY;
-      if (_type == SparqlFilter::EQ || _type == SparqlFilter::NE) {
-        rhs = getIndex().getVocab().lower_bound(rhs_string, level);
-        rhs_upper_for_range =
-            getIndex().getVocab().upper_bound(rhs_string, level);
-        apply_range_filter = true;
-        range_filter_inverse = _type == SparqlFilter::NE;
-      } else if (_type == SparqlFilter::GE) {
-        rhs = getIndex().getVocab().getValueIdForGE(rhs_string, level);
-      } else if (_type == SparqlFilter::GT) {
-        rhs = getIndex().getVocab().getValueIdForGT(rhs_string, level);
-      } else if (_type == SparqlFilter::LT) {
-        rhs = getIndex().getVocab().getValueIdForLT(rhs_string, level);
-      } else if (_type == SparqlFilter::LE) {
-        rhs = getIndex().getVocab().getValueIdForLE(rhs_string, level);
+      KbRhs kbRhs = getKbRhs();
+      rhs = kbRhs._rhs;
+      if (kbRhs._vocabRhs < kbRhs._vocabRhsUpper) {
+        ranges.emplace_back(kbRhs._vocabRhs, kbRhs._vocabRhsUpper);
       }
-      // All other types of filters do not use r and work on _rhs directly
+      ranges.emplace_back(kbRhs._rhs, kbRhs._rhsUpper);
+      apply_range_filter = kbRhs._isRange;
+      range_filter_inverse = kbRhs._isRange && _type == SparqlFilter::NE;
       break;
     }
     case ResultTable::ResultType::VERBATIM:
@@ -751,10 +997,10 @@ void Filter::computeResultFixedValue(
     }
     if (range_filter_inverse) {
       computeFilterRange<ResultTable::ResultType::KB, WIDTH, true>(
-          &result, lhs, rhs, rhs_upper_for_range, input, subRes);
+          &result, lhs, ranges, input, subRes);
     } else {
       computeFilterRange<ResultTable::ResultType::KB, WIDTH, false>(
-          &result, lhs, rhs, rhs_upper_for_range, input, subRes);
+          &result, lhs, ranges, input, subRes);
     }
   } else {
     switch (resultType) {
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <list>
+#include <optional>
 #include <utility>
 #include <vector>
 #include "../parser/ParsedQuery.h"
@@ -36,32 +37,9 @@ class Filter : public Operation {
     _subtree->setTextLimit(limit);
   }
 
-  virtual size_t getSizeEstimate() override {
-    if (_type == SparqlFilter::FilterType::REGEX) {
-      // TODO(jbuerklin): return a better estimate
-      return std::numeric_limits<Id>::max();
-    }
-    // TODO(schnelle): return a better estimate
-    if (_rhs[0] == '?') {
-      if (_type == SparqlFilter::FilterType::EQ) {
-        return _subtree->getSizeEstimate() / 1000;
-      }
-      if (_type == SparqlFilter::FilterType::NE) {
-        return _subtree->getSizeEstimate() / 4;
-      } else {
-        return _subtree->getSizeEstimate() / 2;
-      }
-    } else {
-      if (_type == SparqlFilter::FilterType::EQ) {
-        return _subtree->getSizeEstimate() / 1000;
-      }
-      if (_type == SparqlFilter::FilterType::NE) {
-        return _subtree->getSizeEstimate();
-      } else {
-        return _subtree->getSizeEstimate() / 50;
-      }
-    }
-  }
+  // Uses the relation statistics of the index if the filter compares the
+  // object of a scan with a constant.
+  virtual size_t getSizeEstimate() override;
 
   virtual size_t getCostEstimate() override {
     if (_type == SparqlFilter::FilterType::REGEX) {
@@ -108,6 +86,30 @@ class Filter : public Operation {
   bool _regexIgnoreCase;
   bool _lhsAsString;
 
+  // The right hand side of a comparison filter on a KB column in Id space:
+  // either the range [_rhs, _rhsUpper) (of the Ids that do not pass a NE
+  // filter) or the Id that the column is compared to. For a comparison with a
+  // number, the numbers in the vocabulary (see NumberOrder) that pass are the
+  // additional range [_vocabRhs, _vocabRhsUpper), which is before the range of
+  // the inline numbers.
+  struct KbRhs {
+    Id _rhs = 0;
+    Id _rhsUpper = 0;
+    bool _isRange = false;
+    Id _vocabRhs = 0;
+    Id _vocabRhsUpper = 0;
+  };
+  KbRhs getKbRhs() const;
+
+  // The statistics of the predicate of a scan in the subtree whose object is
+  // _lhs, nullptr if there is no such scan or no statistics.
+  const PredicateStatistics* getLhsObjectStatistics() const;
+
+  // The fraction of the rows of the subtree that pass a comparison of _lhs
+  // with a constant according to the relation statistics, std::nullopt if it
+  // cannot be determined this way.
+  std::optional<double> getSelectivityFromStatistics() const;
+
   [[nodiscard]] bool isLhsSorted() const {
     const auto& subresSortedOn = _subtree->resultSortedOn();
     size_t lhsInd = _subtree->getVariableColumn(_lhs);
@@ -138,13 +140,15 @@ class Filter : public Operation {
                                shared_ptr<const ResultTable> subRes) const;
   /**
    * @brief Uses the result type and applies a range filter
-   * ( input[lhs] >= rhs_lower && input[rhs] < rhs_upper)
-   * to subRes and store it in res.
+   * ( input[lhs] >= range.first && input[lhs] < range.second for one of the
+   * ranges) to subRes and store it in res. The ranges must be sorted and
+   * must not overlap.
    *
    */
   template <ResultTable::ResultType T, int WIDTH, bool INVERSE = false>
-  void computeFilterRange(IdTableStatic<WIDTH>* res, size_t lhs, Id rhs_lower,
-                          Id rhs_upper, const IdTableView<WIDTH>& input,
+  void computeFilterRange(IdTableStatic<WIDTH>* res, size_t lhs,
+                          const vector<pair<Id, Id>>& ranges,
+                          const IdTableView<WIDTH>& input,
                           shared_ptr<const ResultTable> subRes) const;
 
   template <int WIDTH>
@@ -153,6 +157,13 @@ class Filter : public Operation {
       const std::shared_ptr<const ResultTable> subRes) const;
   virtual void computeResult(ResultTable* result) override;
 
+  // Filters the blocks of the lazy result of the subtree one by one.
+  virtual std::unique_ptr<LazyResult> computeLazyResult() override;
+
+  // Apply the filter to the (complete or partial) result of the subtree.
+  void computeResultForSubResult(ResultTable* result,
+                                 shared_ptr<const ResultTable> subRes);
+
   /**
    * @brief This struct handles the extraction of the data from an id based upon
    *        the result type of the id's column.
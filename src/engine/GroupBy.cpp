@@ -4,7 +4,13 @@
 
 #include "GroupBy.h"
 
+#include <array>
+#include <cstring>
+#include <future>
+
+#include "../global/ValueId.h"
 #include "../index/Index.h"
+#include "../util/CancellationHandle.h"
 #include "../util/Conversions.h"
 #include "../util/HashSet.h"
 #include "CallFixedSize.h"
@@ -52,7 +58,7 @@ string GroupBy::asString(size_t indent) const {
   for (size_t i = 0; i < indent; ++i) {
     os << " ";
   }
-  os << "GROUP_BY ";
+  os << (_hashAggregation ? "HASH_GROUP_BY " : "GROUP_BY ");
   for (const std::string var : _groupByVariables) {
     os << varMap.at(var) << ", ";
   }
@@ -71,12 +77,16 @@ string GroupBy::asString(size_t indent) const {
 }
 
 string GroupBy::getDescriptor() const {
-  return "GroupBy on " + ad_utility::join(_groupByVariables, ' ');
+  return (_hashAggregation ? "HashGroupBy on " : "GroupBy on ") +
+         ad_utility::join(_groupByVariables, ' ');
 }
 
 size_t GroupBy::getResultWidth() const { return _varColMap.size(); }
 
 vector<size_t> GroupBy::resultSortedOn() const {
+  if (_hashAggregation) {
+    return {};
+  }
   auto varCols = getVariableColumns();
   vector<size_t> sortedOn;
   sortedOn.reserve(_groupByVariables.size());
@@ -118,6 +128,45 @@ vector<pair<size_t, bool>> GroupBy::computeSortColumns(
   return cols;
 }
 
+bool GroupBy::supportsHashAggregation() const {
+  if (_groupByVariables.empty() ||
+      _groupByVariables.size() > MAX_HASH_GROUP_BY_COLUMNS) {
+    return false;
+  }
+  for (const ParsedQuery::Alias& a : _aliases) {
+    if (a._isDistinct) {
+      return false;
+    }
+    switch (a._type) {
+      case ParsedQuery::AggregateType::COUNT:
+      case ParsedQuery::AggregateType::SUM:
+      case ParsedQuery::AggregateType::AVG:
+      case ParsedQuery::AggregateType::MIN:
+      case ParsedQuery::AggregateType::MAX:
+      case ParsedQuery::AggregateType::SAMPLE:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+size_t GroupBy::getNofGroupsEstimate(
+    const QueryExecutionTree* inputTree) const {
+  ad_utility::HashMap<string, size_t> inVarColMap =
+      inputTree->getVariableColumns();
+  // There are at most as many groups as rows, and at most as many as there
+  // are combinations of the distinct values of the group by columns.
+  double nofGroups = 1;
+  for (const string& var : _groupByVariables) {
+    nofGroups *=
+        std::max<size_t>(1, inputTree->getDistinctEstimate(inVarColMap[var]));
+  }
+  size_t inputSize = inputTree->getRootOperation()->getSizeEstimate();
+  return static_cast<size_t>(std::min<double>(nofGroups, inputSize));
+}
+
 ad_utility::HashMap<string, size_t> GroupBy::getVariableColumns() const {
   return _varColMap;
 }
@@ -155,6 +204,23 @@ struct resizeIfVec<vector<C>, C> {
   static void resize(vector<C>& t, int size) { t.resize(size); }
 };
 
+/**
+ * @brief The numeric value of an entry of a KB column or NaN if it is not a
+ *        number. Numbers are stored in their Id (see ValueId.h), the
+ *        vocabulary is only needed for all other entries.
+ */
+static float kbEntryToFloat(const Index& index, Id id) {
+  if (ValueId::datatype(id) == ValueId::Datatype::NUMBER) {
+    return ValueId::toDouble(id);
+  }
+  // TODO(schnelle): What's the correct way to handle OPTIONAL here
+  std::string entity = index.idToOptionalString(id).value_or("");
+  if (!ad_utility::startsWith(entity, VALUE_FLOAT_PREFIX)) {
+    return std::numeric_limits<float>::quiet_NaN();
+  }
+  return ad_utility::convertIndexWordToFloat(entity);
+}
+
 /**
  * @brief This method takes a single group and computes the output for the
  *        given aggregate.
@@ -180,7 +246,7 @@ void processGroup(const GroupBy::Aggregate& a, size_t blockStart,
                   IdTableStatic<OUT_WIDTH>* result, size_t resultRow,
                   const ResultTable* inTable, ResultTable* outTable,
                   const Index& index,
-                  ad_utility::HashSet<size_t>& distinctHashSet) {
+                  ad_utility::TrackedHashSet<size_t>& distinctHashSet) {
   switch (a._type) {
     case ParsedQuery::AggregateType::AVG: {
       float res = 0;
@@ -227,31 +293,23 @@ void processGroup(const GroupBy::Aggregate& a, size_t blockStart,
             const auto it = distinctHashSet.find(input(i, a._inCol));
             if (it == distinctHashSet.end()) {
               distinctHashSet.insert(input(i, a._inCol));
-              // TODO(schnelle): What's the correct way to handle OPTIONAL here
-              // load the string, parse it as an xsd::int or float
-              std::string entity =
-                  index.idToOptionalString(input(i, a._inCol)).value_or("");
-              if (!ad_utility::startsWith(entity, VALUE_FLOAT_PREFIX)) {
-                res = std::numeric_limits<float>::quiet_NaN();
+              float value = kbEntryToFloat(index, input(i, a._inCol));
+              if (std::isnan(value)) {
+                res = value;
                 break;
-              } else {
-                res += ad_utility::convertIndexWordToFloat(entity);
               }
+              res += value;
             }
           }
           distinctHashSet.clear();
         } else {
           for (size_t i = blockStart; i <= blockEnd; i++) {
-            // load the string, parse it as an xsd::int or float
-            // TODO(schnelle): What's the correct way to handle OPTIONAL here
-            std::string entity =
-                index.idToOptionalString(input(i, a._inCol)).value_or("");
-            if (!ad_utility::startsWith(entity, VALUE_FLOAT_PREFIX)) {
-              res = std::numeric_limits<float>::quiet_NaN();
+            float value = kbEntryToFloat(index, input(i, a._inCol));
+            if (std::isnan(value)) {
+              res = value;
               break;
-            } else {
-              res += ad_utility::convertIndexWordToFloat(entity);
             }
+            res += value;
           }
         }
       }
@@ -537,31 +595,23 @@ void processGroup(const GroupBy::Aggregate& a, size_t blockStart,
             const auto it = distinctHashSet.find(input(i, a._inCol));
             if (it == distinctHashSet.end()) {
               distinctHashSet.insert(input(i, a._inCol));
-              // load the string, parse it as an xsd::int or float
-              // TODO(schnelle): What's the correct way to handle OPTIONAL here
-              std::string entity =
-                  index.idToOptionalString(input(i, a._inCol)).value_or("");
-              if (!ad_utility::startsWith(entity, VALUE_FLOAT_PREFIX)) {
-                res = std::numeric_limits<float>::quiet_NaN();
+              float value = kbEntryToFloat(index, input(i, a._inCol));
+              if (std::isnan(value)) {
+                res = value;
                 break;
-              } else {
-                res += ad_utility::convertIndexWordToFloat(entity);
               }
+              res += value;
             }
           }
           distinctHashSet.clear();
         } else {
           for (size_t i = blockStart; i <= blockEnd; i++) {
-            // load the string, parse it as an xsd::int or float
-            // TODO(schnelle): What's the correct way to handle OPTIONAL here
-            std::string entity =
-                index.idToOptionalString(input(i, a._inCol)).value_or("");
-            if (!ad_utility::startsWith(entity, VALUE_FLOAT_PREFIX)) {
-              res = std::numeric_limits<float>::quiet_NaN();
+            float value = kbEntryToFloat(index, input(i, a._inCol));
+            if (std::isnan(value)) {
+              res = value;
               break;
-            } else {
-              res += ad_utility::convertIndexWordToFloat(entity);
             }
+            res += value;
           }
         }
       }
@@ -595,7 +645,7 @@ void doGroupBy(const IdTable& dynInput,
   }
   const IdTableView<IN_WIDTH> input = dynInput.asStaticView<IN_WIDTH>();
   IdTableStatic<OUT_WIDTH> result = dynResult->moveToStatic<OUT_WIDTH>();
-  ad_utility::HashSet<size_t> distinctHashSet;
+  ad_utility::TrackedHashSet<size_t> distinctHashSet;
 
   if (groupByCols.empty()) {
     // The entire input is a single group
@@ -621,6 +671,7 @@ void doGroupBy(const IdTable& dynInput,
   size_t blockStart = 0;
   size_t blockEnd = 0;
   for (size_t pos = 1; pos < input.size(); pos++) {
+    ad_utility::checkCancellation(pos);
     bool rowMatchesCurrentBlock = true;
     for (size_t i = 0; i < currentGroupBlock.size(); i++) {
       if (input(pos, currentGroupBlock[i].first) !=
@@ -657,6 +708,308 @@ void doGroupBy(const IdTable& dynInput,
   *dynResult = result.moveToDynamic();
 }
 
+namespace {
+// How an aggregate of the hash-based GROUP BY is computed. This depends on the
+// type of the aggregate and of its input column (see processGroup).
+enum class HashAggregateOp {
+  COUNT,
+  SAMPLE,
+  MIN_ID,
+  MAX_ID,
+  MIN_FLOAT,
+  MAX_FLOAT,
+  SUM_VERBATIM,
+  SUM_FLOAT,
+  SUM_KB,
+  NAN_RESULT,
+  NO_VALUE
+};
+
+HashAggregateOp getHashAggregateOp(const GroupBy::Aggregate& a,
+                                   ResultTable::ResultType inputType) {
+  using ResultType = ResultTable::ResultType;
+  using AggregateType = ParsedQuery::AggregateType;
+  AD_CHECK(!a._distinct);
+  bool isText = inputType == ResultType::TEXT ||
+                inputType == ResultType::LOCAL_VOCAB;
+  switch (a._type) {
+    case AggregateType::COUNT:
+      return HashAggregateOp::COUNT;
+    case AggregateType::SAMPLE:
+      return HashAggregateOp::SAMPLE;
+    case AggregateType::MIN:
+      if (isText) {
+        return HashAggregateOp::NO_VALUE;
+      }
+      return inputType == ResultType::FLOAT ? HashAggregateOp::MIN_FLOAT
+                                            : HashAggregateOp::MIN_ID;
+    case AggregateType::MAX:
+      if (isText) {
+        return HashAggregateOp::NO_VALUE;
+      }
+      return inputType == ResultType::FLOAT ? HashAggregateOp::MAX_FLOAT
+                                            : HashAggregateOp::MAX_ID;
+    case AggregateType::SUM:
+    case AggregateType::AVG:
+      if (isText) {
+        return HashAggregateOp::NAN_RESULT;
+      }
+      if (inputType == ResultType::VERBATIM) {
+        return HashAggregateOp::SUM_VERBATIM;
+      }
+      return inputType == ResultType::FLOAT ? HashAggregateOp::SUM_FLOAT
+                                            : HashAggregateOp::SUM_KB;
+    default:
+      AD_THROW(ad_semsearch::Exception::CHECK_FAILED,
+               "The hash-based GROUP BY does not support the aggregate "
+                   << ParsedQuery::AggregateTypeAsString(a._type));
+  }
+}
+
+// The value of an aggregate for the rows of a group seen so far. The sums
+// are floats as in processGroup.
+struct HashAggregateState {
+  Id _id;
+  float _float;
+};
+
+float idToFloat(Id id) {
+  float f;
+  std::memcpy(&f, &id, sizeof(float));
+  return f;
+}
+
+// The state of an aggregate after the first row of a group.
+HashAggregateState initHashAggregate(HashAggregateOp op, Id id,
+                                     const Index& index) {
+  HashAggregateState state{id, 0};
+  switch (op) {
+    case HashAggregateOp::MIN_FLOAT:
+    case HashAggregateOp::MAX_FLOAT:
+    case HashAggregateOp::SUM_FLOAT:
+      state._float = idToFloat(id);
+      break;
+    case HashAggregateOp::SUM_VERBATIM:
+      state._float = id;
+      break;
+    case HashAggregateOp::SUM_KB:
+      state._float = kbEntryToFloat(index, id);
+      break;
+    default:
+      break;
+  }
+  return state;
+}
+
+// Merges the state of the same aggregate of other rows of the group into
+// state.
+void mergeHashAggregate(HashAggregateOp op, const HashAggregateState& other,
+                        HashAggregateState* state) {
+  switch (op) {
+    case HashAggregateOp::MIN_ID:
+      state->_id = std::min(state->_id, other._id);
+      break;
+    case HashAggregateOp::MAX_ID:
+      state->_id = std::max(state->_id, other._id);
+      break;
+    case HashAggregateOp::MIN_FLOAT:
+      state->_float = std::min(state->_float, other._float);
+      break;
+    case HashAggregateOp::MAX_FLOAT:
+      state->_float = std::max(state->_float, other._float);
+      break;
+    case HashAggregateOp::SUM_VERBATIM:
+    case HashAggregateOp::SUM_FLOAT:
+    case HashAggregateOp::SUM_KB:
+      state->_float += other._float;
+      break;
+    default:
+      break;
+  }
+}
+
+// The groups of a part of the input (or of a partition of all groups): the
+// keys of the groups (their values in the group by columns, padded with
+// zeros) and for each group its number of rows and the states of all
+// aggregates.
+struct HashGroups {
+  using Key = std::array<Id, MAX_HASH_GROUP_BY_COLUMNS>;
+
+  explicit HashGroups(size_t nofAggregates) : _nofAggregates(nofAggregates) {}
+
+  // Adds a group with the given aggregate states or merges them into the
+  // states of the existing group.
+  template <typename InitStates>
+  void add(const Key& key, size_t count, InitStates initStates) {
+    auto [it, isNew] = _groupIndex.try_emplace(key, _counts.size());
+    if (isNew) {
+      _counts.push_back(count);
+      _states.resize(_states.size() + _nofAggregates);
+      initStates(&_states[_states.size() - _nofAggregates], true);
+    } else {
+      _counts[it->second] += count;
+      initStates(&_states[it->second * _nofAggregates], false);
+    }
+  }
+
+  size_t _nofAggregates;
+  ad_utility::TrackedHashMap<Key, size_t> _groupIndex;
+  vector<size_t, ad_utility::TrackingAllocator<size_t>> _counts;
+  vector<HashAggregateState, ad_utility::TrackingAllocator<HashAggregateState>>
+      _states;
+};
+}  // namespace
+
+template <int IN_WIDTH, int OUT_WIDTH>
+void doHashGroupBy(const IdTable& dynInput,
+                   const vector<ResultTable::ResultType>& inputTypes,
+                   const vector<size_t>& groupByCols,
+                   const vector<GroupBy::Aggregate>& aggregates,
+                   IdTable* dynResult, const Index& index, size_t nofThreads) {
+  LOG(DEBUG) << "Hash group by input size " << dynInput.size() << std::endl;
+  AD_CHECK(!groupByCols.empty());
+  AD_CHECK(groupByCols.size() <= MAX_HASH_GROUP_BY_COLUMNS);
+  const IdTableView<IN_WIDTH> input = dynInput.asStaticView<IN_WIDTH>();
+  vector<HashAggregateOp> ops;
+  for (const GroupBy::Aggregate& a : aggregates) {
+    ops.push_back(getHashAggregateOp(a, inputTypes[a._inCol]));
+  }
+  nofThreads = std::clamp<size_t>(nofThreads, 1, input.size() / 2 + 1);
+  const size_t nofAggregates = aggregates.size();
+
+  // The groups of part t of the input with a hash in partition p are
+  // partialGroups[t * nofThreads + p]. They are created by this thread such
+  // that their memory is charged to the query.
+  vector<HashGroups> partialGroups(nofThreads * nofThreads,
+                                   HashGroups(nofAggregates));
+  // The groups of partition p.
+  vector<HashGroups> groups(nofThreads, HashGroups(nofAggregates));
+  auto partitionOf = [nofThreads](const HashGroups::Key& key) -> size_t {
+    if (nofThreads == 1) {
+      return 0;
+    }
+    return absl::container_internal::hash_default_hash<HashGroups::Key>()(
+               key) %
+           nofThreads;
+  };
+
+  // Runs f(t) for t = 0, ..., nofThreads - 1 on separate threads.
+  auto runOnThreads = [nofThreads](auto f) {
+    if (nofThreads == 1) {
+      f(0);
+      return;
+    }
+    vector<std::future<void>> futures;
+    for (size_t t = 0; t < nofThreads; ++t) {
+      futures.push_back(std::async(
+          std::launch::async,
+          [f, t, handle = ad_utility::CancellationHandle::current()]() {
+            ad_utility::CancellationHandle::Scope scope(handle);
+            f(t);
+          }));
+    }
+    for (auto& future : futures) {
+      future.get();
+    }
+  };
+
+  // Aggregate the rows of each part.
+  runOnThreads([&](size_t t) {
+    size_t end = input.size() * (t + 1) / nofThreads;
+    HashGroups::Key key{};
+    for (size_t i = input.size() * t / nofThreads; i < end; ++i) {
+      ad_utility::checkCancellation(i);
+      for (size_t c = 0; c < groupByCols.size(); ++c) {
+        key[c] = input(i, groupByCols[c]);
+      }
+      partialGroups[t * nofThreads + partitionOf(key)].add(
+          key, 1, [&](HashAggregateState* states, bool isNew) {
+            for (size_t j = 0; j < nofAggregates; ++j) {
+              HashAggregateState state =
+                  initHashAggregate(ops[j], input(i, aggregates[j]._inCol),
+                                    index);
+              if (isNew) {
+                states[j] = state;
+              } else {
+                mergeHashAggregate(ops[j], state, &states[j]);
+              }
+            }
+          });
+    }
+  });
+
+  // Merge the partial groups of each partition.
+  runOnThreads([&](size_t p) {
+    for (size_t t = 0; t < nofThreads; ++t) {
+      HashGroups& partial = partialGroups[t * nofThreads + p];
+      if (groups[p]._counts.empty()) {
+        groups[p] = std::move(partial);
+        continue;
+      }
+      for (const auto& [key, group] : partial._groupIndex) {
+        const HashAggregateState* partialStates =
+            &partial._states[group * nofAggregates];
+        groups[p].add(key, partial._counts[group],
+                      [&](HashAggregateState* states, bool isNew) {
+                        for (size_t j = 0; j < nofAggregates; ++j) {
+                          if (isNew) {
+                            states[j] = partialStates[j];
+                          } else {
+                            mergeHashAggregate(ops[j], partialStates[j],
+                                               &states[j]);
+                          }
+                        }
+                      });
+      }
+      partial = HashGroups(nofAggregates);
+    }
+  });
+
+  // Write one row per group.
+  IdTableStatic<OUT_WIDTH> result = dynResult->moveToStatic<OUT_WIDTH>();
+  for (const HashGroups& partition : groups) {
+    for (size_t g = 0; g < partition._counts.size(); ++g) {
+      size_t row = result.size();
+      result.emplace_back();
+      size_t count = partition._counts[g];
+      for (size_t j = 0; j < nofAggregates; ++j) {
+        const HashAggregateState& state =
+            partition._states[g * nofAggregates + j];
+        size_t col = aggregates[j]._outCol;
+        float value = state._float;
+        bool isFloat = false;
+        switch (ops[j]) {
+          case HashAggregateOp::COUNT:
+            result(row, col) = count;
+            break;
+          case HashAggregateOp::SAMPLE:
+          case HashAggregateOp::MIN_ID:
+          case HashAggregateOp::MAX_ID:
+            result(row, col) = state._id;
+            break;
+          case HashAggregateOp::NO_VALUE:
+            result(row, col) = ID_NO_VALUE;
+            break;
+          case HashAggregateOp::NAN_RESULT:
+            value = std::numeric_limits<float>::quiet_NaN();
+            isFloat = true;
+            break;
+          default:
+            isFloat = true;
+        }
+        if (isFloat) {
+          if (aggregates[j]._type == ParsedQuery::AggregateType::AVG) {
+            value /= count;
+          }
+          result(row, col) = 0;
+          std::memcpy(&result(row, col), &value, sizeof(float));
+        }
+      }
+    }
+  }
+  *dynResult = result.moveToDynamic();
+}
+
 void GroupBy::computeResult(ResultTable* result) {
   LOG(DEBUG) << "GroupBy result computation..." << std::endl;
   std::vector<size_t> groupByColumns;
@@ -764,9 +1117,19 @@ void GroupBy::computeResult(ResultTable* result) {
 
   int inWidth = subresult->_data.cols();
   int outWidth = result->_data.cols();
-  CALL_FIXED_SIZE_2(inWidth, outWidth, doGroupBy, subresult->_data,
-                    inputResultTypes, groupByCols, aggregates, &result->_data,
-                    subresult.get(), result, getIndex());
+  if (_hashAggregation) {
+    size_t nofThreads = std::clamp<size_t>(
+        subresult->_data.size() / HASH_GROUP_BY_MIN_ROWS_PER_THREAD, 1,
+        NOF_HASH_GROUP_BY_THREADS);
+    runtimeInfo.addDetail("hash_aggregation_threads", nofThreads);
+    CALL_FIXED_SIZE_2(inWidth, outWidth, doHashGroupBy, subresult->_data,
+                      inputResultTypes, groupByCols, aggregates,
+                      &result->_data, getIndex(), nofThreads);
+  } else {
+    CALL_FIXED_SIZE_2(inWidth, outWidth, doGroupBy, subresult->_data,
+                      inputResultTypes, groupByCols, aggregates,
+                      &result->_data, subresult.get(), result, getIndex());
+  }
 
   // Free the user data used by GROUP_CONCAT aggregates.
   for (Aggregate& a : aggregates) {
@@ -87,6 +87,30 @@ class GroupBy : public Operation {
   vector<pair<size_t, bool>> computeSortColumns(
       const QueryExecutionTree* inputTree);
 
+  /**
+   * @return True iff the groups can be aggregated with hash tables instead of
+   *         sorting the input: there are between 1 and
+   *         MAX_HASH_GROUP_BY_COLUMNS group by variables and all aggregates
+   *         are COUNT, SUM, AVG, MIN, MAX or SAMPLE without DISTINCT.
+   */
+  bool supportsHashAggregation() const;
+
+  /**
+   * @return The estimated number of groups for the given input, based on the
+   *         number of distinct values of the group by columns.
+   */
+  size_t getNofGroupsEstimate(const QueryExecutionTree* inputTree) const;
+
+  /**
+   * @brief If set, the input is not required to be sorted and the groups are
+   *        aggregated in hash tables on multiple threads (see doHashGroupBy).
+   *        The result is then not sorted. Must be supported (see
+   *        supportsHashAggregation) and set before the subtree.
+   */
+  void setHashAggregation(bool hashAggregation) {
+    _hashAggregation = hashAggregation;
+  }
+
   vector<QueryExecutionTree*> getChildren() override {
     return {_subtree.get()};
   }
@@ -96,6 +120,7 @@ class GroupBy : public Operation {
   vector<string> _groupByVariables;
   std::vector<ParsedQuery::Alias> _aliases;
   ad_utility::HashMap<string, size_t> _varColMap;
+  bool _hashAggregation = false;
 
   virtual void computeResult(ResultTable* result) override;
 };
@@ -108,3 +133,17 @@ void doGroupBy(const IdTable& dynInput,
                const vector<GroupBy::Aggregate>& aggregates, IdTable* dynResult,
                const ResultTable* inTable, ResultTable* outTable,
                const Index& index);
+
+// Computes the same groups as doGroupBy for an unsorted input, but only
+// supports the aggregates of GroupBy::supportsHashAggregation (the group by
+// columns are passed as SAMPLE aggregates). The input is split into
+// nofThreads parts, each of which is aggregated into hash tables by its own
+// thread. The partial aggregates are partitioned by the hash of the group,
+// each partition is merged by one thread. The order of the result rows is
+// unspecified.
+template <int IN_WIDTH, int OUT_WIDTH>
+void doHashGroupBy(const IdTable& dynInput,
+                   const vector<ResultTable::ResultType>& inputTypes,
+                   const vector<size_t>& groupByCols,
+                   const vector<GroupBy::Aggregate>& aggregates,
+                   IdTable* dynResult, const Index& index, size_t nofThreads);
@@ -0,0 +1,263 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "./HashJoin.h"
+#include <limits>
+#include <sstream>
+#include "../util/HashMap.h"
+#include "./QueryExecutionTree.h"
+#include "CallFixedSize.h"
+
+using std::string;
+
+// _____________________________________________________________________________
+HashJoin::HashJoin(QueryExecutionContext* qec,
+                   std::shared_ptr<QueryExecutionTree> t1,
+                   std::shared_ptr<QueryExecutionTree> t2, size_t t1JoinCol,
+                   size_t t2JoinCol)
+    : Operation(qec) {
+  // Use the same order of the subtrees as Join, such that the columns of the
+  // result match those of _estimates.
+  if (t1.get()->asString() < t2.get()->asString()) {
+    _left = t1;
+    _leftJoinCol = t1JoinCol;
+    _right = t2;
+    _rightJoinCol = t2JoinCol;
+  } else {
+    _left = t2;
+    _leftJoinCol = t2JoinCol;
+    _right = t1;
+    _rightJoinCol = t1JoinCol;
+  }
+  _estimates = std::make_shared<Join>(qec, _left, _right, _leftJoinCol,
+                                      _rightJoinCol);
+}
+
+// _____________________________________________________________________________
+string HashJoin::asString(size_t indent) const {
+  std::ostringstream os;
+  for (size_t i = 0; i < indent; ++i) {
+    os << " ";
+  }
+  os << "HASH_JOIN\n"
+     << _left->asString(indent) << " join-column: [" << _leftJoinCol << "]\n";
+  for (size_t i = 0; i < indent; ++i) {
+    os << " ";
+  }
+  os << "|X|\n"
+     << _right->asString(indent) << " join-column: [" << _rightJoinCol << "]";
+  return os.str();
+}
+
+// _____________________________________________________________________________
+string HashJoin::getDescriptor() const {
+  return "Hash" + _estimates->getDescriptor();
+}
+
+// _____________________________________________________________________________
+size_t HashJoin::getResultWidth() const {
+  return _left->getResultWidth() + _right->getResultWidth() - 1;
+}
+
+// _____________________________________________________________________________
+size_t HashJoin::getCostEstimate() {
+  double buildCost =
+      _executionContext
+          ? _executionContext->getCostFactor("HASH_JOIN_BUILD_COST_PER_ROW")
+          : 4;
+  double probeCost =
+      _executionContext
+          ? _executionContext->getCostFactor("HASH_JOIN_PROBE_COST_PER_ROW")
+          : 2;
+  size_t leftSize = _left->getSizeEstimate();
+  size_t rightSize = _right->getSizeEstimate();
+  size_t costJoin =
+      static_cast<size_t>(std::min(leftSize, rightSize) * buildCost +
+                          std::max(leftSize, rightSize) * probeCost);
+  return getSizeEstimate() + _left->getCostEstimate() +
+         _right->getCostEstimate() + costJoin;
+}
+
+// _____________________________________________________________________________
+void HashJoin::computeResult(ResultTable* result) {
+  RuntimeInformation& runtimeInfo = getRuntimeInfo();
+  result->_data.setCols(getResultWidth());
+  result->_sortedBy = {};
+
+  if (_left->knownEmptyResult() || _right->knownEmptyResult()) {
+    LOG(TRACE) << "Either side is empty thus join result is empty" << endl;
+    runtimeInfo.addDetail("Either side was empty", "");
+    result->_resultTypes.resize(result->_data.cols());
+    return;
+  }
+
+  LOG(DEBUG) << "Getting sub-results for hash join result computation..."
+             << endl;
+  shared_ptr<const ResultTable> leftRes = _left->getResult();
+  runtimeInfo.addChild(_left->getRootOperation()->getRuntimeInfo());
+  if (leftRes->size() == 0) {
+    LOG(TRACE) << "Left side empty thus join result is empty" << endl;
+    runtimeInfo.addDetail("The left side was empty", "");
+    result->_resultTypes.resize(result->_data.cols());
+    return;
+  }
+  shared_ptr<const ResultTable> rightRes = _right->getResult();
+  runtimeInfo.addChild(_right->getRootOperation()->getRuntimeInfo());
+
+  LOG(DEBUG) << "Computing hash join result..." << endl;
+  result->_resultTypes.reserve(result->_data.cols());
+  result->_resultTypes.insert(result->_resultTypes.end(),
+                              leftRes->_resultTypes.begin(),
+                              leftRes->_resultTypes.end());
+  for (size_t i = 0; i < rightRes->_data.cols(); i++) {
+    if (i != _rightJoinCol) {
+      result->_resultTypes.push_back(rightRes->_resultTypes[i]);
+    }
+  }
+
+  int lwidth = leftRes->_data.cols();
+  int rwidth = rightRes->_data.cols();
+  int reswidth = result->_data.cols();
+  CALL_FIXED_SIZE_3(lwidth, rwidth, reswidth, join, leftRes->_data,
+                    _leftJoinCol, rightRes->_data, _rightJoinCol,
+                    &result->_data);
+  LOG(DEBUG) << "Hash join result computation done." << endl;
+}
+
+// _____________________________________________________________________________
+template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
+void HashJoin::join(const IdTable& dynA, size_t jc1, const IdTable& dynB,
+                    size_t jc2, IdTable* dynRes, size_t nofPartitions) {
+  const IdTableView<L_WIDTH> a = dynA.asStaticView<L_WIDTH>();
+  const IdTableView<R_WIDTH> b = dynB.asStaticView<R_WIDTH>();
+
+  LOG(DEBUG) << "Performing hash join between two tables.\n";
+  LOG(DEBUG) << "A: width = " << a.cols() << ", size = " << a.size() << "\n";
+  LOG(DEBUG) << "B: width = " << b.cols() << ", size = " << b.size() << "\n";
+
+  if (a.size() == 0 || b.size() == 0) {
+    return;
+  }
+
+  if (nofPartitions == 0) {
+    nofPartitions = std::min(a.size(), b.size()) / HASH_JOIN_ROWS_PER_PARTITION;
+  }
+  size_t nofBits = 0;
+  while ((size_t(1) << nofBits) < nofPartitions) {
+    ++nofBits;
+  }
+
+  IdTableStatic<OUT_WIDTH> result = dynRes->moveToStatic<OUT_WIDTH>();
+  if (nofBits == 0) {
+    auto allRows = [](size_t i) { return i; };
+    joinRows(a, jc1, allRows, a.size(), b, jc2, allRows, b.size(), &result);
+  } else {
+    LOG(DEBUG) << "Using " << (size_t(1) << nofBits) << " partitions.\n";
+    // The partition of an id, the highest bits of a multiplicative hash.
+    auto partition = [nofBits](Id id) -> size_t {
+      return (id * 0x9E3779B97F4A7C15ull) >> (64 - nofBits);
+    };
+    // Sort the indices of the rows of a table by their partition (counting
+    // sort). The rows of partition p are rows[starts[p]..starts[p + 1]).
+    auto partitionRows = [nofBits, &partition](const auto& table, size_t jc,
+                                               vector<size_t>* rows,
+                                               vector<size_t>* starts) {
+      starts->assign((size_t(1) << nofBits) + 1, 0);
+      for (size_t i = 0; i < table.size(); ++i) {
+        ++(*starts)[partition(table(i, jc)) + 1];
+      }
+      for (size_t p = 1; p < starts->size(); ++p) {
+        (*starts)[p] += (*starts)[p - 1];
+      }
+      vector<size_t> positions(starts->begin(), starts->end() - 1);
+      rows->resize(table.size());
+      for (size_t i = 0; i < table.size(); ++i) {
+        (*rows)[positions[partition(table(i, jc))]++] = i;
+      }
+    };
+    vector<size_t> aRows;
+    vector<size_t> aStarts;
+    partitionRows(a, jc1, &aRows, &aStarts);
+    vector<size_t> bRows;
+    vector<size_t> bStarts;
+    partitionRows(b, jc2, &bRows, &bStarts);
+    for (size_t p = 0; p + 1 < aStarts.size(); ++p) {
+      const size_t* aPart = aRows.data() + aStarts[p];
+      const size_t* bPart = bRows.data() + bStarts[p];
+      joinRows(
+          a, jc1, [aPart](size_t i) { return aPart[i]; },
+          aStarts[p + 1] - aStarts[p], b, jc2,
+          [bPart](size_t i) { return bPart[i]; }, bStarts[p + 1] - bStarts[p],
+          &result);
+    }
+  }
+  *dynRes = result.moveToDynamic();
+
+  LOG(DEBUG) << "Hash join done.\n";
+  LOG(DEBUG) << "Result: width = " << dynRes->cols()
+             << ", size = " << dynRes->size() << "\n";
+}
+
+// _____________________________________________________________________________
+template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH, typename ARows,
+          typename BRows>
+void HashJoin::joinRows(const IdTableView<L_WIDTH>& a, size_t jc1, ARows aRows,
+                        size_t nofARows, const IdTableView<R_WIDTH>& b,
+                        size_t jc2, BRows bRows, size_t nofBRows,
+                        IdTableStatic<OUT_WIDTH>* result) {
+  if (nofARows == 0 || nofBRows == 0) {
+    return;
+  }
+  auto addRow = [&a, &b, jc2, result](size_t i, size_t j) {
+    result->push_back();
+    const size_t backIndex = result->size() - 1;
+    for (size_t h = 0; h < a.cols(); h++) {
+      (*result)(backIndex, h) = a(i, h);
+    }
+    // Copy bs columns before the join column
+    for (size_t h = 0; h < jc2; h++) {
+      (*result)(backIndex, h + a.cols()) = b(j, h);
+    }
+    // Copy bs columns after the join column
+    for (size_t h = jc2 + 1; h < b.cols(); h++) {
+      (*result)(backIndex, h + a.cols() - 1) = b(j, h);
+    }
+  };
+
+  // Build a hash table on the rows of build and look up each row of probe.
+  // Rows with equal join ids are chained via next, the hash table contains
+  // the first row of each chain.
+  auto buildAndProbe = [](const auto& build, size_t buildCol, auto buildRows,
+                          size_t nofBuildRows, const auto& probe,
+                          size_t probeCol, auto probeRows, size_t nofProbeRows,
+                          auto onMatch) {
+    constexpr size_t END_OF_CHAIN = std::numeric_limits<size_t>::max();
+    ad_utility::HashMap<Id, size_t> firstRow;
+    firstRow.reserve(nofBuildRows);
+    vector<size_t> next(nofBuildRows);
+    // Insert in reverse order, such that the chains are in the input order.
+    for (size_t k = nofBuildRows; k-- > 0;) {
+      auto [it, inserted] =
+          firstRow.try_emplace(build(buildRows(k), buildCol), k);
+      next[k] = inserted ? END_OF_CHAIN : it->second;
+      it->second = k;
+    }
+    for (size_t l = 0; l < nofProbeRows; ++l) {
+      size_t probeRow = probeRows(l);
+      auto it = firstRow.find(probe(probeRow, probeCol));
+      if (it == firstRow.end()) {
+        continue;
+      }
+      for (size_t k = it->second; k != END_OF_CHAIN; k = next[k]) {
+        onMatch(buildRows(k), probeRow);
+      }
+    }
+  };
+
+  if (nofARows <= nofBRows) {
+    buildAndProbe(a, jc1, aRows, nofARows, b, jc2, bRows, nofBRows, addRow);
+  } else {
+    buildAndProbe(b, jc2, bRows, nofBRows, a, jc1, aRows, nofARows,
+                  [&addRow](size_t j, size_t i) { addRow(i, j); });
+  }
+}
@@ -0,0 +1,99 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "./Join.h"
+#include "./Operation.h"
+#include "./QueryExecutionTree.h"
+
+/**
+ * @brief Joins two sub results on a single column without requiring them to
+ * be sorted on it. A hash table is built on the smaller input and probed with
+ * the larger one. If the smaller input is large, both inputs are first
+ * partitioned on the hash of the join column (radix partitioning) such that
+ * the hash table of each partition fits into the cache.
+ *
+ * The columns of the result are the same as for a Join on the same subtrees,
+ * but the result is not sorted.
+ */
+class HashJoin : public Operation {
+ public:
+  HashJoin(QueryExecutionContext* qec, std::shared_ptr<QueryExecutionTree> t1,
+           std::shared_ptr<QueryExecutionTree> t2, size_t t1JoinCol,
+           size_t t2JoinCol);
+
+  virtual string asString(size_t indent = 0) const override;
+
+  virtual string getDescriptor() const override;
+
+  virtual size_t getResultWidth() const override;
+
+  virtual vector<size_t> resultSortedOn() const override { return {}; }
+
+  ad_utility::HashMap<string, size_t> getVariableColumns() const {
+    return _estimates->getVariableColumns();
+  }
+
+  std::unordered_set<string> getContextVars() const {
+    return _estimates->getContextVars();
+  }
+
+  virtual void setTextLimit(size_t limit) override {
+    _estimates->setTextLimit(limit);
+  }
+
+  virtual size_t getSizeEstimate() override {
+    return _estimates->getSizeEstimate();
+  }
+
+  virtual float getMultiplicity(size_t col) override {
+    return _estimates->getMultiplicity(col);
+  }
+
+  virtual size_t getCostEstimate() override;
+
+  virtual bool knownEmptyResult() override {
+    return _left->knownEmptyResult() || _right->knownEmptyResult();
+  }
+
+  vector<QueryExecutionTree*> getChildren() override {
+    return {_left.get(), _right.get()};
+  }
+
+  /**
+   * @brief Joins dynA and dynB on the columns jc1 and jc2. The result has the
+   * same columns as for Join::join (all columns of a, then all columns of b
+   * except for jc2) but its order is unspecified. Both inputs are partitioned
+   * into nofPartitions (rounded up to a power of two) partitions first, if
+   * nofPartitions is 0 this is decided based on the size of the smaller input.
+   **/
+  template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
+  static void join(const IdTable& dynA, size_t jc1, const IdTable& dynB,
+                   size_t jc2, IdTable* dynRes, size_t nofPartitions = 0);
+
+ private:
+  std::shared_ptr<QueryExecutionTree> _left;
+  std::shared_ptr<QueryExecutionTree> _right;
+
+  size_t _leftJoinCol;
+  size_t _rightJoinCol;
+
+  // A merge join on the same subtrees. Its result has the same columns and
+  // size, so it is used for all estimates.
+  std::shared_ptr<Join> _estimates;
+
+  virtual void computeResult(ResultTable* result) override;
+
+  // Join the rows aRows[0..nofARows) of a with the rows bRows[0..nofBRows) of
+  // b. aRows and bRows map a position to the index of the row in the table.
+  template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH, typename ARows,
+            typename BRows>
+  static void joinRows(const IdTableView<L_WIDTH>& a, size_t jc1,
+                       ARows aRows, size_t nofARows,
+                       const IdTableView<R_WIDTH>& b, size_t jc2,
+                       BRows bRows, size_t nofBRows,
+                       IdTableStatic<OUT_WIDTH>* result);
+};
@@ -12,13 +12,15 @@
 #include <ostream>
 #include "../global/Id.h"
 #include "../util/Log.h"
+#include "../util/MemoryTracker.h"
 
 namespace detail {
 // The actual data storage of the Id Tables, basically a wrapper around a
-// std::vector<Id>
+// std::vector<Id>. Its memory is charged to the query of the thread that
+// created it (see MemoryTracker.h).
 struct IdTableVectorWrapper {
   static constexpr bool ManagesStorage = true;  // is able to grow/allocate
-  std::vector<Id> _data;
+  std::vector<Id, ad_utility::TrackingAllocator<Id>> _data;
 
   IdTableVectorWrapper() = default;
 
@@ -40,7 +42,7 @@ struct IdTableViewWrapper {
   static constexpr bool ManagesStorage =
       false;  // is not able to grow and allocate
   const Id* _data;
-  const size_t _size;
+  size_t _size;
 
   IdTableViewWrapper() = delete;
 
@@ -50,6 +52,10 @@ struct IdTableViewWrapper {
   explicit IdTableViewWrapper(const IdTableVectorWrapper& rhs) noexcept
       : _data(rhs.data()), _size(rhs._data.size()) {}
 
+  // construct as a view into size Ids starting at data
+  IdTableViewWrapper(const Id* data, size_t size) noexcept
+      : _data(data), _size(size) {}
+
   // convert to an owning VectorWrapper by making a copy. Explicit since
   // expensive
   explicit operator IdTableVectorWrapper() const {
@@ -1020,6 +1026,23 @@ class IdTableTemplated : private IdTableImpl<COLS, DATA> {
         *static_cast<const IdTableTemplated<COLS, DATA>*>(this));
   };
 
+  /**
+   * @brief Create a non-owning and readOnly view into the rows
+   * [beginRow, endRow) of this table that has a static width.
+   */
+  template <int NEW_COLS>
+  const IdTableTemplated<NEW_COLS, IdTableViewWrapper> asStaticView(
+      size_t beginRow, size_t endRow) const {
+    assert(beginRow <= endRow && endRow <= size());
+    IdTableTemplated<NEW_COLS, IdTableViewWrapper> view =
+        asStaticView<NEW_COLS>();
+    view._data = IdTableViewWrapper(data() + beginRow * cols(),
+                                    (endRow - beginRow) * cols());
+    view._size = endRow - beginRow;
+    view._capacity = view._size;
+    return view;
+  };
+
   /**
    * @brief Create a copy of a non-owning view that copies all the data and thus
    * is owning again.
@@ -264,6 +264,122 @@ void IndexScan::computeResult(ResultTable* result) {
   LOG(DEBUG) << "IndexScan result computation done.\n";
 }
 
+// _____________________________________________________________________________
+std::unique_ptr<LazyResult> IndexScan::computeLazyResult() {
+  const auto& idx = _executionContext->getIndex();
+  std::optional<CompressedRelation::PairReader> reader;
+  switch (_type) {
+    case PSO_FREE_S:
+      reader = idx.lazyScan(_predicate, idx._PSO);
+      break;
+    case POS_FREE_O:
+      reader = idx.lazyScan(_predicate, idx._POS);
+      break;
+    case SPO_FREE_P:
+      reader = idx.lazyScan(_subject, idx._SPO);
+      break;
+    case SOP_FREE_O:
+      reader = idx.lazyScan(_subject, idx._SOP);
+      break;
+    case OPS_FREE_P:
+      reader = idx.lazyScan(_object, idx._OPS);
+      break;
+    case OSP_FREE_S:
+      reader = idx.lazyScan(_object, idx._OSP);
+      break;
+    default:
+      return nullptr;
+  }
+  auto generator = [reader](IdTable* block) mutable {
+    if (!reader) {
+      return false;
+    }
+    // Decompress whole blocks of the relation directly into the result.
+    block->resize(LAZY_RESULT_BLOCK_SIZE);
+    size_t nofRows = 0;
+    while (nofRows + NOF_PAIRS_PER_COMPRESSED_BLOCK <= block->size()) {
+      size_t nofPairs = reader->readNextBlock(block->data() + 2 * nofRows);
+      if (nofPairs == 0) {
+        break;
+      }
+      nofRows += nofPairs;
+    }
+    block->resize(nofRows);
+    return nofRows > 0;
+  };
+  return std::make_unique<LazyResult>(
+      2, vector<size_t>{0, 1},
+      vector<ResultTable::ResultType>(2, ResultTable::ResultType::KB), nullptr,
+      std::move(generator));
+}
+
+// _____________________________________________________________________________
+bool IndexScan::supportsKeyFilter() const {
+  switch (_type) {
+    case PSO_FREE_S:
+    case POS_FREE_O:
+    case SPO_FREE_P:
+    case SOP_FREE_O:
+    case OPS_FREE_P:
+    case OSP_FREE_S:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// _____________________________________________________________________________
+void IndexScan::computeResultWithKeyFilter(const vector<Id>& keys,
+                                           ResultTable* result) {
+  AD_CHECK(supportsKeyFilter());
+  ad_utility::Timer timer;
+  timer.start();
+  result->_data.setCols(2);
+  result->_resultTypes.push_back(ResultTable::ResultType::KB);
+  result->_resultTypes.push_back(ResultTable::ResultType::KB);
+  result->_sortedBy = {0, 1};
+  const auto& idx = _executionContext->getIndex();
+  size_t nofSkippedBlocks = 0;
+  switch (_type) {
+    case PSO_FREE_S:
+      nofSkippedBlocks =
+          idx.scanWithKeyFilter(_predicate, keys, &result->_data, idx._PSO);
+      break;
+    case POS_FREE_O:
+      nofSkippedBlocks =
+          idx.scanWithKeyFilter(_predicate, keys, &result->_data, idx._POS);
+      break;
+    case SPO_FREE_P:
+      nofSkippedBlocks =
+          idx.scanWithKeyFilter(_subject, keys, &result->_data, idx._SPO);
+      break;
+    case SOP_FREE_O:
+      nofSkippedBlocks =
+          idx.scanWithKeyFilter(_subject, keys, &result->_data, idx._SOP);
+      break;
+    case OPS_FREE_P:
+      nofSkippedBlocks =
+          idx.scanWithKeyFilter(_object, keys, &result->_data, idx._OPS);
+      break;
+    case OSP_FREE_S:
+      nofSkippedBlocks =
+          idx.scanWithKeyFilter(_object, keys, &result->_data, idx._OSP);
+      break;
+    default:
+      break;
+  }
+  timer.stop();
+  RuntimeInformation& runtimeInfo = getRuntimeInfo();
+  runtimeInfo.setRows(result->size());
+  runtimeInfo.setCols(getResultWidth());
+  runtimeInfo.setDescriptor(getDescriptor());
+  runtimeInfo.setColumnNames(getVariableColumns());
+  runtimeInfo.setTime(timer.msecs());
+  runtimeInfo.setWasCached(false);
+  runtimeInfo.addDetail("key_filter_size", keys.size());
+  runtimeInfo.addDetail("skipped_blocks", nofSkippedBlocks);
+}
+
 // _____________________________________________________________________________
 void IndexScan::computePSOboundS(ResultTable* result) const {
   result->_data.setCols(1);
@@ -86,7 +86,22 @@ class IndexScan : public Operation {
   virtual ad_utility::HashMap<string, size_t> getVariableColumns()
       const override;
 
+  // True iff the result has two columns and can be restricted to the rows
+  // with certain Ids in the first column (see computeResultWithKeyFilter).
+  bool supportsKeyFilter() const;
+
+  // Compute only the rows of the result whose first column is one of keys
+  // (sorted and distinct). Only the blocks of the relation that can contain
+  // such a row are read. The result is a part of the scan and thus not
+  // cached. Used by Join to pass the join column of a much smaller side
+  // into the scan (sideways information passing).
+  void computeResultWithKeyFilter(const vector<Id>& keys,
+                                  ResultTable* result);
+
   ScanType getType() const { return _type; }
+  const string& getSubject() const { return _subject; }
+  const string& getPredicate() const { return _predicate; }
+  const string& getObject() const { return _object; }
 
  protected:
   ScanType _type;
@@ -98,6 +113,10 @@ class IndexScan : public Operation {
 
   virtual void computeResult(ResultTable* result) override;
 
+  // The scans with two result columns read the blocks of the relation on
+  // demand, scans with one result column are computed completely.
+  virtual std::unique_ptr<LazyResult> computeLazyResult() override;
+
   vector<QueryExecutionTree*> getChildren() override { return {}; }
 
   void computePSOboundS(ResultTable* result) const;
@@ -3,12 +3,15 @@
 // Author: Björn Buchhold (buchhold@informatik.uni-freiburg.de)
 
 #include "./Join.h"
+#include <algorithm>
 #include <functional>
 #include <sstream>
 #include <type_traits>
 #include <unordered_set>
+#include "../util/CancellationHandle.h"
 #include "./QueryExecutionTree.h"
 #include "CallFixedSize.h"
+#include "ParallelMergeJoin.h"
 
 using std::string;
 
@@ -90,14 +93,31 @@ void Join::computeResult(ResultTable* result) {
     return;
   }
 
-  LOG(TRACE) << "Computing left side..." << endl;
-  shared_ptr<const ResultTable> leftRes = _left->getResult();
-  runtimeInfo.addChild(_left->getRootOperation()->getRuntimeInfo());
+  // If the left side is a much larger scan, the right side is computed first
+  // and the scan only reads the rows with its join Ids.
+  shared_ptr<const ResultTable> leftRes;
+  shared_ptr<const ResultTable> rightRes;
+  if (canUseKeyFilter(_left, _leftJoinCol, _right)) {
+    LOG(TRACE) << "Computing right side..." << endl;
+    rightRes = _right->getResult();
+    if (rightRes->size() > 0) {
+      LOG(TRACE) << "Computing left side with the join Ids of the right side"
+                 << endl;
+      leftRes = computeScanWithKeyFilter(_left, *rightRes, _rightJoinCol);
+      runtimeInfo.addChild(_left->getRootOperation()->getRuntimeInfo());
+    }
+    runtimeInfo.addChild(_right->getRootOperation()->getRuntimeInfo());
+  } else {
+    LOG(TRACE) << "Computing left side..." << endl;
+    leftRes = _left->getResult();
+    runtimeInfo.addChild(_left->getRootOperation()->getRuntimeInfo());
+  }
 
   // Check if we can stop early.
-  if (leftRes->size() == 0) {
-    LOG(TRACE) << "Left side empty thus join result is empty" << endl;
-    runtimeInfo.addDetail("The left side was empty", "");
+  if (!leftRes || leftRes->size() == 0) {
+    LOG(TRACE) << "One side empty thus join result is empty" << endl;
+    runtimeInfo.addDetail(
+        leftRes ? "The left side was empty" : "The right side was empty", "");
     size_t resWidth = leftWidth + rightWidth - 1;
     result->_data.setCols(resWidth);
     result->_resultTypes.resize(result->_data.cols());
@@ -105,9 +125,17 @@ void Join::computeResult(ResultTable* result) {
     return;
   }
 
-  LOG(TRACE) << "Computing right side..." << endl;
-  shared_ptr<const ResultTable> rightRes = _right->getResult();
-  runtimeInfo.addChild(_right->getRootOperation()->getRuntimeInfo());
+  if (!rightRes) {
+    if (canUseKeyFilter(_right, _rightJoinCol, _left)) {
+      LOG(TRACE) << "Computing right side with the join Ids of the left side"
+                 << endl;
+      rightRes = computeScanWithKeyFilter(_right, *leftRes, _leftJoinCol);
+    } else {
+      LOG(TRACE) << "Computing right side..." << endl;
+      rightRes = _right->getResult();
+    }
+    runtimeInfo.addChild(_right->getRootOperation()->getRuntimeInfo());
+  }
 
   LOG(DEBUG) << "Computing Join result..." << endl;
 
@@ -135,6 +163,97 @@ void Join::computeResult(ResultTable* result) {
   LOG(DEBUG) << "Join result computation done." << endl;
 }
 
+// _____________________________________________________________________________
+bool Join::canUseKeyFilter(const std::shared_ptr<QueryExecutionTree>& scanTree,
+                           size_t scanJoinCol,
+                           const std::shared_ptr<QueryExecutionTree>& other) {
+  if (scanTree->getType() != QueryExecutionTree::SCAN || scanJoinCol != 0) {
+    return false;
+  }
+  const auto& scan =
+      *static_cast<const IndexScan*>(scanTree->getRootOperation().get());
+  if (!scan.supportsKeyFilter()) {
+    return false;
+  }
+  // The filtered scan is not cached, so pinned subtrees need the complete
+  // scan. A complete scan that is already cached is cheaper anyway.
+  if (_executionContext->_pinSubtrees ||
+      _executionContext->getQueryTreeCache().contains(scan.asString())) {
+    return false;
+  }
+  return scanTree->getSizeEstimate() / JOIN_KEY_FILTER_MIN_SIZE_RATIO >=
+         other->getSizeEstimate();
+}
+
+// _____________________________________________________________________________
+shared_ptr<const ResultTable> Join::computeScanWithKeyFilter(
+    const std::shared_ptr<QueryExecutionTree>& scanTree,
+    const ResultTable& other, size_t otherJoinCol) {
+  // The other side is sorted on its join column.
+  vector<Id> keys;
+  const IdTable& data = other._data;
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (keys.empty() || keys.back() != data(i, otherJoinCol)) {
+      keys.push_back(data(i, otherJoinCol));
+    }
+  }
+  auto& scan = *static_cast<IndexScan*>(scanTree->getRootOperation().get());
+  auto result = std::make_shared<ResultTable>();
+  scan.computeResultWithKeyFilter(keys, result.get());
+  result->finish();
+  getRuntimeInfo().addDetail("sideways_information_passing", true);
+  return result;
+}
+
+// _____________________________________________________________________________
+std::unique_ptr<LazyResult> Join::computeLazyResult() {
+  if (_left->knownEmptyResult() || _right->knownEmptyResult() ||
+      isFullScanDummy(_left) || isFullScanDummy(_right)) {
+    return nullptr;
+  }
+  // Both sides are sorted on the join column, so the result of each block is
+  // sorted on the join column, too, and the concatenation of the blocks is
+  // sorted.
+  bool leftIsLazy = _left->getSizeEstimate() >= _right->getSizeEstimate();
+  shared_ptr<const ResultTable> completeRes =
+      (leftIsLazy ? _right : _left)->getResult();
+  std::shared_ptr<LazyResult> lazyRes =
+      (leftIsLazy ? _left : _right)->getLazyResult();
+
+  const auto& leftTypes =
+      leftIsLazy ? lazyRes->_resultTypes : completeRes->_resultTypes;
+  const auto& rightTypes =
+      leftIsLazy ? completeRes->_resultTypes : lazyRes->_resultTypes;
+  vector<ResultTable::ResultType> resultTypes = leftTypes;
+  for (size_t i = 0; i < rightTypes.size(); i++) {
+    if (i != _rightJoinCol) {
+      resultTypes.push_back(rightTypes[i]);
+    }
+  }
+
+  int lwidth = _left->getResultWidth();
+  int rwidth = _right->getResultWidth();
+  int reswidth = lwidth + rwidth - 1;
+  auto generator = [this, leftIsLazy, completeRes, lazyRes, lwidth, rwidth,
+                    reswidth](IdTable* block) {
+    if (completeRes->size() == 0) {
+      return false;
+    }
+    IdTable input(lazyRes->width());
+    if (!lazyRes->nextBlock(&input)) {
+      return false;
+    }
+    const IdTable& leftInput = leftIsLazy ? input : completeRes->_data;
+    const IdTable& rightInput = leftIsLazy ? completeRes->_data : input;
+    CALL_FIXED_SIZE_3(lwidth, rwidth, reswidth, joinBlock, leftInput,
+                      _leftJoinCol, rightInput, _rightJoinCol, block);
+    return true;
+  };
+  return std::make_unique<LazyResult>(reswidth, vector<size_t>{_leftJoinCol},
+                                      std::move(resultTypes), nullptr,
+                                      std::move(generator));
+}
+
 // _____________________________________________________________________________
 ad_utility::HashMap<string, size_t> Join::getVariableColumns() const {
   ad_utility::HashMap<string, size_t> retVal;
@@ -483,6 +602,7 @@ void Join::appendCrossProduct(const IdTable::const_iterator& leftBegin,
       const auto& r = *itr;
       res->push_back();
       size_t backIdx = res->size() - 1;
+      ad_utility::checkCancellation(backIdx);
       for (size_t i = 0; i < itl.cols(); i++) {
         (*res)(backIdx, i) = l[i];
       }
@@ -511,6 +631,62 @@ void Join::join(const IdTable& dynA, size_t jc1, const IdTable& dynB,
   }
 
   IdTableStatic<OUT_WIDTH> result = dynRes->moveToStatic<OUT_WIDTH>();
+  ad_utility::parallelMergeJoin(
+      a, jc1, b, jc2, &result,
+      [jc1, jc2](const IdTableView<L_WIDTH>& aPart,
+                 const IdTableView<R_WIDTH>& bPart,
+                 IdTableStatic<OUT_WIDTH>* res) {
+        joinPartition(aPart, jc1, bPart, jc2, res);
+      });
+  *dynRes = result.moveToDynamic();
+
+  LOG(DEBUG) << "Join done.\n";
+  LOG(DEBUG) << "Result: width = " << dynRes->cols()
+             << ", size = " << dynRes->size() << "\n";
+}
+
+// _____________________________________________________________________________
+template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
+void Join::joinBlock(const IdTable& dynA, size_t jc1, const IdTable& dynB,
+                     size_t jc2, IdTable* dynRes) {
+  const IdTableView<L_WIDTH> a = dynA.asStaticView<L_WIDTH>();
+  const IdTableView<R_WIDTH> b = dynB.asStaticView<R_WIDTH>();
+  if (a.size() == 0 || b.size() == 0) {
+    return;
+  }
+  Id lower = std::max(a(0, jc1), b(0, jc2));
+  Id upper = std::min(a(a.size() - 1, jc1), b(b.size() - 1, jc2));
+  if (lower > upper) {
+    return;
+  }
+  // The rows with a join id in [lower, upper].
+  auto range = [lower, upper](const auto& table, size_t jc) {
+    auto begin = std::lower_bound(
+        table.begin(), table.end(), lower,
+        [jc](const auto& row, Id id) { return row[jc] < id; });
+    auto end = std::upper_bound(
+        begin, table.end(), upper,
+        [jc](Id id, const auto& row) { return id < row[jc]; });
+    return std::pair<size_t, size_t>(begin - table.begin(),
+                                     end - table.begin());
+  };
+  auto [aBegin, aEnd] = range(a, jc1);
+  auto [bBegin, bEnd] = range(b, jc2);
+  IdTableStatic<OUT_WIDTH> result = dynRes->moveToStatic<OUT_WIDTH>();
+  joinPartition(a.template asStaticView<L_WIDTH>(aBegin, aEnd), jc1,
+                b.template asStaticView<R_WIDTH>(bBegin, bEnd), jc2, &result);
+  *dynRes = result.moveToDynamic();
+}
+
+// _____________________________________________________________________________
+template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
+void Join::joinPartition(const IdTableView<L_WIDTH>& a, size_t jc1,
+                         const IdTableView<R_WIDTH>& b, size_t jc2,
+                         IdTableStatic<OUT_WIDTH>* resultPtr) {
+  if (a.size() == 0 || b.size() == 0) {
+    return;
+  }
+  IdTableStatic<OUT_WIDTH>& result = *resultPtr;
   // Cannot just switch l1 and l2 around because the order of
   // items in the result tuples is important.
   if (a.size() / b.size() > GALLOP_THRESHOLD) {
@@ -544,6 +720,7 @@ void Join::join(const IdTable& dynA, size_t jc1, const IdTable& dynB,
         while (a(i, jc1) == b(j, jc2)) {
           result.push_back();
           const size_t backIndex = result.size() - 1;
+          ad_utility::checkCancellation(backIndex);
           for (size_t h = 0; h < a.cols(); h++) {
             result(backIndex, h) = a(i, h);
           }
@@ -583,11 +760,7 @@ void Join::join(const IdTable& dynA, size_t jc1, const IdTable& dynB,
     }
   }
 finish:
-  *dynRes = result.moveToDynamic();
-
-  LOG(DEBUG) << "Join done.\n";
-  LOG(DEBUG) << "Result: width = " << dynRes->cols()
-             << ", size = " << dynRes->size() << "\n";
+  return;
 }
 
 // _____________________________________________________________________________
@@ -679,6 +852,7 @@ void Join::doGallopInnerJoin(const TagType, const IdTableView<L_WIDTH>& l1,
       const size_t keepJ = j;
       while (l1(i, jc1) == l2(j, jc2)) {
         size_t rowIndex = result->size();
+        ad_utility::checkCancellation(rowIndex);
         result->push_back();
         for (size_t h = 0; h < l1.cols(); h++) {
           (*result)(rowIndex, h) = l1(i, h);
@@ -60,12 +60,33 @@ class Join : public Operation {
 
   /**
    * @brief Joins IdTables dynA and dynB on join column jc2, returning
-   * the result in dynRes. Creates a cross product for matching rows
+   * the result in dynRes. Creates a cross product for matching rows.
+   * Large inputs are split into partitions that are joined in parallel (see
+   * ParallelMergeJoin.h).
    **/
   template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
   static void join(const IdTable& dynA, size_t jc1, const IdTable& dynB,
                    size_t jc2, IdTable* dynRes);
 
+  /**
+   * @brief The sequential join of join(), applied to each partition of the
+   * inputs. Appends the result to result.
+   **/
+  template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
+  static void joinPartition(const IdTableView<L_WIDTH>& a, size_t jc1,
+                            const IdTableView<R_WIDTH>& b, size_t jc2,
+                            IdTableStatic<OUT_WIDTH>* result);
+
+  /**
+   * @brief Joins a block of one side of a lazy join with the complete other
+   * side (see computeLazyResult). Only the rows of both tables in the range of
+   * join ids that occur in both tables are considered. Appends the result to
+   * dynRes.
+   **/
+  template <int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
+  static void joinBlock(const IdTable& dynA, size_t jc1, const IdTable& dynB,
+                        size_t jc2, IdTable* dynRes);
+
   class RightLargerTag {};
   class LeftLargerTag {};
   template <typename TagType, int L_WIDTH, int R_WIDTH, int OUT_WIDTH>
@@ -89,11 +110,28 @@ class Join : public Operation {
 
   virtual void computeResult(ResultTable* result) override;
 
+  // The side with the larger size estimate is computed lazily and joined
+  // block by block with the complete result of the other side.
+  virtual std::unique_ptr<LazyResult> computeLazyResult() override;
+
   static bool isFullScanDummy(std::shared_ptr<QueryExecutionTree> tree) {
     return tree->getType() == QueryExecutionTree::SCAN &&
            tree->getResultWidth() == 3;
   }
 
+  // True iff the scanTree side of the join is a scan that can be restricted
+  // to the join Ids of the other side (see
+  // IndexScan::computeResultWithKeyFilter) and is much larger than the other
+  // side.
+  bool canUseKeyFilter(const std::shared_ptr<QueryExecutionTree>& scanTree,
+                       size_t scanJoinCol,
+                       const std::shared_ptr<QueryExecutionTree>& other);
+
+  // The rows of the scan of scanTree with one of the join Ids of other.
+  shared_ptr<const ResultTable> computeScanWithKeyFilter(
+      const std::shared_ptr<QueryExecutionTree>& scanTree,
+      const ResultTable& other, size_t otherJoinCol);
+
   void computeResultForJoinWithFullScanDummy(ResultTable* result) const;
 
   using ScanMethodType = std::function<void(Id, IdTable*)>;
@@ -0,0 +1,100 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../global/Constants.h"
+#include "./ResultTable.h"
+
+using std::string;
+using std::vector;
+
+// The result of an Operation that is computed block by block when the
+// consumer asks for the next block (pull based, see Operation::getLazyResult).
+// The members _sortedBy, _resultTypes and _localVocab have the same meaning
+// as in ResultTable and are known before the first block is computed.
+class LazyResult {
+ public:
+  // Writes the next rows of the result to its argument (which is empty and
+  // has the width of the result). May write no rows at all (e.g. a filter
+  // that removed all rows of an input block). Returns false iff the result is
+  // exhausted, the argument then stays empty.
+  using BlockGenerator = std::function<bool(IdTable*)>;
+
+  LazyResult(size_t width, vector<size_t> sortedBy,
+             vector<ResultTable::ResultType> resultTypes,
+             std::shared_ptr<ResultTable::LocalVocab> localVocab,
+             BlockGenerator generator)
+      : _width(width),
+        _sortedBy(std::move(sortedBy)),
+        _resultTypes(std::move(resultTypes)),
+        _localVocab(std::move(localVocab)),
+        _generator(std::move(generator)) {
+    if (!_localVocab) {
+      _localVocab = std::make_shared<ResultTable::LocalVocab>();
+    }
+  }
+
+  // A LazyResult whose blocks are slices of the materialized result.
+  static std::unique_ptr<LazyResult> fromResultTable(
+      std::shared_ptr<const ResultTable> result) {
+    size_t nextRow = 0;
+    auto generator = [result, nextRow](IdTable* block) mutable {
+      const IdTable& data = result->_data;
+      if (nextRow >= data.size()) {
+        return false;
+      }
+      size_t endRow = std::min(data.size(), nextRow + LAZY_RESULT_BLOCK_SIZE);
+      block->insert(block->end(), data.begin() + nextRow,
+                    data.begin() + endRow);
+      nextRow = endRow;
+      return true;
+    };
+    return std::make_unique<LazyResult>(
+        result->width(), result->_sortedBy, result->_resultTypes,
+        result->_localVocab, std::move(generator));
+  }
+
+  // Get the next non-empty block of the result. The block has to have the
+  // width of the result, its previous content is discarded.
+  // Returns false iff the result is exhausted (and block is empty).
+  bool nextBlock(IdTable* block) {
+    AD_CHECK(block->cols() == _width);
+    while (!_exhausted) {
+      block->clear();
+      if (!_generator(block)) {
+        _exhausted = true;
+      } else if (block->size() > 0) {
+        return true;
+      }
+    }
+    block->clear();
+    return false;
+  }
+
+  size_t width() const { return _width; }
+
+  ResultTable::ResultType getResultType(size_t col) const {
+    if (col < _resultTypes.size()) {
+      return _resultTypes[col];
+    }
+    return ResultTable::ResultType::KB;
+  }
+
+  const size_t _width;
+  vector<size_t> _sortedBy;
+  vector<ResultTable::ResultType> _resultTypes;
+  std::shared_ptr<ResultTable::LocalVocab> _localVocab;
+
+  // Public such that Operation::getLazyResult can wrap it (e.g. to measure
+  // the time spent in the operation).
+  BlockGenerator _generator;
+
+ private:
+  bool _exhausted = false;
+};
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "./Operation.h"
+#include "./ParallelMergeJoin.h"
 #include "./QueryExecutionTree.h"
 
 class MultiColumnJoin : public Operation {
@@ -50,12 +51,21 @@ class MultiColumnJoin : public Operation {
    *        result in result. R should have width resultWidth (or be a vector
    *        that should have resultWidth entries).
    *        This method is made public here for unit testing purposes.
+   *        Large inputs are split into partitions (on the first join column)
+   *        that are joined in parallel.
    **/
   template <int A_WIDTH, int B_WIDTH, int OUT_WIDTH>
   static void computeMultiColumnJoin(const IdTable& a, const IdTable& b,
                                      const vector<array<Id, 2>>& joinColumns,
                                      IdTable* result);
 
+  // The sequential join of one partition, appends to result.
+  template <int A_WIDTH, int B_WIDTH, int OUT_WIDTH>
+  static void joinPartition(const IdTableView<A_WIDTH>& a,
+                            const IdTableView<B_WIDTH>& b,
+                            const vector<array<Id, 2>>& joinColumns,
+                            IdTableStatic<OUT_WIDTH>* result);
+
  private:
   void computeSizeEstimateAndMultiplicities();
 
@@ -80,6 +90,29 @@ void MultiColumnJoin::computeMultiColumnJoin(
     return;
   }
 
+  IdTableView<A_WIDTH> a = dynA.asStaticView<A_WIDTH>();
+  IdTableView<B_WIDTH> b = dynB.asStaticView<B_WIDTH>();
+  IdTableStatic<OUT_WIDTH> result = dynResult->moveToStatic<OUT_WIDTH>();
+  ad_utility::parallelMergeJoin(
+      a, joinColumns[0][0], b, joinColumns[0][1], &result,
+      [&joinColumns](const IdTableView<A_WIDTH>& aPart,
+                     const IdTableView<B_WIDTH>& bPart,
+                     IdTableStatic<OUT_WIDTH>* res) {
+        joinPartition(aPart, bPart, joinColumns, res);
+      });
+  *dynResult = result.moveToDynamic();
+}
+
+template <int A_WIDTH, int B_WIDTH, int OUT_WIDTH>
+void MultiColumnJoin::joinPartition(const IdTableView<A_WIDTH>& a,
+                                    const IdTableView<B_WIDTH>& b,
+                                    const vector<array<Id, 2>>& joinColumns,
+                                    IdTableStatic<OUT_WIDTH>* resultPtr) {
+  if (a.size() == 0 || b.size() == 0) {
+    return;
+  }
+  IdTableStatic<OUT_WIDTH>& result = *resultPtr;
+
   // Marks the columns in b that are join columns. Used to skip these
   // when computing the result of the join
   int joinColumnBitmap_b = 0;
@@ -87,10 +120,6 @@ void MultiColumnJoin::computeMultiColumnJoin(
     joinColumnBitmap_b |= (1 << jc[1]);
   }
 
-  IdTableView<A_WIDTH> a = dynA.asStaticView<A_WIDTH>();
-  IdTableView<B_WIDTH> b = dynB.asStaticView<B_WIDTH>();
-  IdTableStatic<OUT_WIDTH> result = dynResult->moveToStatic<OUT_WIDTH>();
-
   bool matched = false;
   size_t ia = 0, ib = 0;
   while (ia < a.size() && ib < b.size()) {
@@ -174,5 +203,5 @@ void MultiColumnJoin::computeMultiColumnJoin(
     }
   }
 finish:
-  *dynResult = result.moveToDynamic();
+  return;
 }
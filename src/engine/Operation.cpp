@@ -3,6 +3,8 @@
 // Author: Johannes Kalmbach  (johannes.kalmbach@gmail.com)
 
 #include "Operation.h"
+#include <utility>
+#include "../util/CancellationHandle.h"
 #include "QueryExecutionTree.h"
 
 template <typename F>
@@ -48,6 +50,7 @@ vector<string> Operation::collectWarnings() const {
 // Use existing results if they are already available, otherwise
 // trigger computation.
 shared_ptr<const ResultTable> Operation::getResult(bool isRoot) {
+  ad_utility::checkCancellation();
   ad_utility::Timer timer;
   timer.start();
   auto& cache = _executionContext->getQueryTreeCache();
@@ -77,6 +80,16 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot) {
     // in scope
     try {
       computeResult(newResult->_resTable.get());
+    } catch (const ReplanQueryException& e) {
+      // A child was computed, but the query is planned again. This operation
+      // did not fail, so don't print it.
+      abort(newResult, false);
+      throw;
+    } catch (const ad_utility::CancellationException& e) {
+      // The query timed out or was cancelled, this is not an error of this
+      // Operation.
+      abort(newResult, false);
+      throw;
     } catch (const ad_semsearch::AbortException& e) {
       // A child Operation was aborted, abort this Operation
       // as well. The child already printed
@@ -111,14 +124,26 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot) {
     // Only now we can let other threads access the result
     // and runtime information
     newResult->_resTable->finish();
+    // The size and the cost of the result are only known now.
+    cache.recomputeSizeAndScore(cacheKey);
+    if (auto* observedSizes = _executionContext->getObservedSizes()) {
+      observedSizes->tryEmplace(cacheKey, newResult->_resTable->size());
+    }
     return newResult->_resTable;
   }
 
-  existingResult->_resTable->awaitFinished();
+  // The result is computed by another query, wait for it until this query
+  // times out.
+  while (!existingResult->_resTable->awaitFinished(
+      std::chrono::milliseconds(CANCELLATION_WAIT_INTERVAL_MS))) {
+    ad_utility::checkCancellation();
+  }
   if (existingResult->_resTable->status() == ResultTable::ABORTED) {
-    LOG(ERROR) << "Operation aborted while awaiting result" << endl;
-    AD_THROW(ad_semsearch::Exception::BAD_QUERY,
-             "Operation aborted while awaiting result");
+    // The other query has failed or was cancelled (e.g. because it timed out)
+    // and has removed the result from the cache. Compute it for this query.
+    LOG(INFO) << "Operation aborted while awaiting result, computing it again"
+              << endl;
+    return getResult(isRoot);
   }
   timer.stop();
   _runtimeInfo = existingResult->_runtimeInfo;
@@ -134,3 +159,49 @@ shared_ptr<const ResultTable> Operation::getResult(bool isRoot) {
                          existingResult->_runtimeInfo.getOperationTime());
   return existingResult->_resTable;
 }
+
+// _____________________________________________________________________________
+std::unique_ptr<LazyResult> Operation::getLazyResult() {
+  std::unique_ptr<LazyResult> lazyResult;
+  // Results that are already in the cache (or are being computed by another
+  // query) are reused. Pinned subtrees have to be cached and thus computed
+  // completely.
+  if (!_executionContext->_pinSubtrees &&
+      !_executionContext->getQueryTreeCache().contains(asString())) {
+    lazyResult = computeLazyResult();
+  }
+  if (!lazyResult) {
+    return LazyResult::fromResultTable(getResult());
+  }
+
+  LOG(DEBUG) << "Computing the result of " << getDescriptor() << " lazily"
+             << endl;
+  _runtimeInfo.setCols(getResultWidth());
+  _runtimeInfo.setDescriptor(getDescriptor());
+  _runtimeInfo.setColumnNames(getVariableColumns());
+  _runtimeInfo.setWasCached(false);
+  _runtimeInfo.addDetail("lazy", true);
+  // The rows and time of the runtime information are the ones of the blocks
+  // that were actually requested.
+  ad_utility::Timer timer;
+  size_t nofRows = 0;
+  lazyResult->_generator = [this, timer, nofRows,
+                            generator = std::move(lazyResult->_generator)](
+                               IdTable* block) mutable {
+    ad_utility::checkCancellation();
+    timer.cont();
+    bool hasMoreRows = generator(block);
+    timer.stop();
+    nofRows += block->size();
+    _runtimeInfo.setRows(nofRows);
+    _runtimeInfo.setTime(timer.msecs());
+    _runtimeInfo.clearChildren();
+    for (const QueryExecutionTree* child : std::as_const(*this).getChildren()) {
+      if (child) {
+        _runtimeInfo.addChild(child->getRootOperation()->getRuntimeInfo());
+      }
+    }
+    return hasMoreRows;
+  };
+  return lazyResult;
+}
@@ -11,6 +11,7 @@
 #include "../util/Exception.h"
 #include "../util/Log.h"
 #include "../util/Timer.h"
+#include "LazyResult.h"
 #include "QueryExecutionContext.h"
 #include "ResultTable.h"
 #include "RuntimeInformation.h"
@@ -108,6 +109,14 @@ class Operation {
   // trigger computation.
   shared_ptr<const ResultTable> getResult(bool isRoot = false);
 
+  // Get the result for the subtree rooted at this element block by block.
+  // Operations that implement computeLazyResult only compute the next block
+  // when it is requested, such that a consumer that stops early (e.g. because
+  // of a LIMIT) avoids computing the rest. These partial results are never
+  // cached. For all other operations (and for results that are already in the
+  // cache) the blocks are slices of the materialized result of getResult().
+  std::unique_ptr<LazyResult> getLazyResult();
+
  protected:
   QueryExecutionContext* getExecutionContext() const {
     return _executionContext;
@@ -143,6 +152,11 @@ class Operation {
   //! Computes both, an EntityList and a HitList.
   virtual void computeResult(ResultTable* result) = 0;
 
+  //! Compute the result of the query-subtree rooted at this element lazily.
+  //! Returns nullptr if this operation can only compute its complete result
+  //! at once (the default, e.g. for blocking operations like Sort or GroupBy).
+  virtual std::unique_ptr<LazyResult> computeLazyResult() { return nullptr; }
+
   vector<size_t> _resultSortedColumns;
   RuntimeInformation _runtimeInfo;
 
@@ -5,6 +5,7 @@
 
 #include "OptionalJoin.h"
 #include "CallFixedSize.h"
+#include "ParallelMergeJoin.h"
 
 using std::string;
 
@@ -337,6 +338,27 @@ void OptionalJoin::optionalJoin(const IdTable& dynA, const IdTable& dynB,
   const IdTableView<A_WIDTH> a = dynA.asStaticView<A_WIDTH>();
   const IdTableView<B_WIDTH> b = dynB.asStaticView<B_WIDTH>();
   IdTableStatic<OUT_WIDTH> result = dynResult->moveToStatic<OUT_WIDTH>();
+  ad_utility::parallelMergeJoin(
+      a, joinColumns[0][0], b, joinColumns[0][1], &result,
+      [aOptional, bOptional, &joinColumns](const IdTableView<A_WIDTH>& aPart,
+                                           const IdTableView<B_WIDTH>& bPart,
+                                           IdTableStatic<OUT_WIDTH>* res) {
+        optionalJoinPartition(aPart, bPart, aOptional, bOptional, joinColumns,
+                              res);
+      });
+  *dynResult = result.moveToDynamic();
+}
+
+template <int A_WIDTH, int B_WIDTH, int OUT_WIDTH>
+void OptionalJoin::optionalJoinPartition(
+    const IdTableView<A_WIDTH>& a, const IdTableView<B_WIDTH>& b,
+    bool aOptional, bool bOptional, const vector<array<Id, 2>>& joinColumns,
+    IdTableStatic<OUT_WIDTH>* resultPtr) {
+  if ((a.size() == 0 && b.size() == 0) || (a.size() == 0 && !aOptional) ||
+      (b.size() == 0 && !bOptional)) {
+    return;
+  }
+  IdTableStatic<OUT_WIDTH>& result = *resultPtr;
 
   int joinColumnBitmap_a = 0;
   int joinColumnBitmap_b = 0;
@@ -367,14 +389,12 @@ void OptionalJoin::optionalJoin(const IdTable& dynA, const IdTable& dynB,
       createOptionalResult(a, 0, true, b, ib, false, joinColumnBitmap_a,
                            joinColumnBitmap_b, joinColumnAToB, &result);
     }
-    *dynResult = result.moveToDynamic();
     return;
   } else if (b.size() == 0 && bOptional) {
     for (size_t ia = 0; ia < a.size(); ia++) {
       createOptionalResult(a, ia, false, b, 0, true, joinColumnBitmap_a,
                            joinColumnBitmap_b, joinColumnAToB, &result);
     }
-    *dynResult = result.moveToDynamic();
     return;
   }
 
@@ -482,5 +502,4 @@ finish:
       ++ia;
     }
   }
-  *dynResult = result.moveToDynamic();
 }
@@ -68,6 +68,15 @@ class OptionalJoin : public Operation {
  private:
   void computeSizeEstimateAndMultiplicities();
 
+  // The sequential optional join of one partition of the inputs (see
+  // ParallelMergeJoin.h), appends to result.
+  template <int A_WIDTH, int B_WIDTH, int OUT_WIDTH>
+  static void optionalJoinPartition(const IdTableView<A_WIDTH>& a,
+                                    const IdTableView<B_WIDTH>& b,
+                                    bool aOptional, bool bOptional,
+                                    const vector<array<Id, 2>>& joinColumns,
+                                    IdTableStatic<OUT_WIDTH>* result);
+
   /**
    * @brief Takes a row from each of the input tables and creates a result row
    * @param a A row from table a.
@@ -6,6 +6,7 @@
 
 #include "CallFixedSize.h"
 #include "Comparators.h"
+#include "ExternalSort.h"
 #include "OrderBy.h"
 #include "QueryExecutionTree.h"
 
@@ -17,10 +18,12 @@ size_t OrderBy::getResultWidth() const { return _subtree->getResultWidth(); }
 // _____________________________________________________________________________
 OrderBy::OrderBy(QueryExecutionContext* qec,
                  std::shared_ptr<QueryExecutionTree> subtree,
-                 vector<pair<size_t, bool>> sortIndices)
+                 vector<pair<size_t, bool>> sortIndices,
+                 bool orderNumbersByValue)
     : Operation(qec),
       _subtree(std::move(subtree)),
-      _sortIndices(std::move(sortIndices)) {}
+      _sortIndices(std::move(sortIndices)),
+      _orderNumbersByValue(orderNumbersByValue) {}
 
 // _____________________________________________________________________________
 string OrderBy::asString(size_t indent) const {
@@ -36,7 +39,8 @@ string OrderBy::asString(size_t indent) const {
   for (auto ind : _sortIndices) {
     columns << (ind.second ? "desc(" : "asc(") << ind.first << ") ";
   }
-  os << "SORT / ORDER BY on columns:" << columns.str() << "\n"
+  os << "SORT / ORDER BY on columns:" << columns.str()
+     << (_orderNumbersByValue ? "numbers by value" : "") << "\n"
      << _subtree->asString(indent);
   return os.str();
 }
@@ -60,6 +64,9 @@ string OrderBy::getDescriptor() const {
 
 // _____________________________________________________________________________
 vector<size_t> OrderBy::resultSortedOn() const {
+  if (_orderNumbersByValue) {
+    return {};
+  }
   std::vector<size_t> sortedOn;
   sortedOn.reserve(_sortIndices.size());
   for (const pair<size_t, bool>& p : _sortIndices) {
@@ -75,34 +82,65 @@ vector<size_t> OrderBy::resultSortedOn() const {
 void OrderBy::computeResult(ResultTable* result) {
   LOG(DEBUG) << "Gettign sub-result for OrderBy result computation..." << endl;
   AD_CHECK(!_sortIndices.empty());
-  shared_ptr<const ResultTable> subRes = _subtree->getResult();
-
-  RuntimeInformation& runtimeInfo = getRuntimeInfo();
-  runtimeInfo.addChild(_subtree->getRootOperation()->getRuntimeInfo());
+  // The input is read lazily if possible, such that it is never in memory
+  // at the same time as the sorted result (see externalSort).
+  std::unique_ptr<LazyResult> subRes = _subtree->getLazyResult();
   LOG(DEBUG) << "OrderBy result computation..." << endl;
-  result->_data.setCols(subRes->_data.cols());
+  result->_data.setCols(subRes->width());
   result->_resultTypes.insert(result->_resultTypes.end(),
                               subRes->_resultTypes.begin(),
                               subRes->_resultTypes.end());
   result->_localVocab = subRes->_localVocab;
-  result->_data.insert(result->_data.end(), subRes->_data.begin(),
-                       subRes->_data.end());
 
-  int width = result->_data.cols();
-  // TODO(florian): Check if the lambda is a performance problem
-  CALL_FIXED_SIZE_1(width, getEngine().sort, &result->_data,
-                    [this](const auto& a, const auto& b) {
-                      for (auto& entry : _sortIndices) {
-                        if (a[entry.first] < b[entry.first]) {
-                          return !entry.second;
+  int width = subRes->width();
+  if (_orderNumbersByValue) {
+    // Only the Ids of KB columns can be numbers.
+    vector<bool> isKb;
+    for (const auto& entry : _sortIndices) {
+      isKb.push_back(subRes->getResultType(entry.first) ==
+                     ResultTable::ResultType::KB);
+    }
+    const NumberOrder& numberOrder = getIndex().getNumberOrder();
+    CALL_FIXED_SIZE_1(width, ad_utility::externalSort, std::move(subRes),
+                      &result->_data,
+                      [this, &isKb, &numberOrder](const auto& a,
+                                                  const auto& b) {
+                        for (size_t i = 0; i < _sortIndices.size(); ++i) {
+                          auto [col, desc] = _sortIndices[i];
+                          Id x = a[col];
+                          Id y = b[col];
+                          if (isKb[i] ? numberOrder.less(x, y) : x < y) {
+                            return !desc;
+                          }
+                          if (isKb[i] ? numberOrder.less(y, x) : y < x) {
+                            return desc;
+                          }
                         }
-                        if (a[entry.first] > b[entry.first]) {
-                          return entry.second;
+                        return a[0] < b[0];
+                      },
+                      getExecutionContext()->getSortMemoryLimit(),
+                      getIndex().getOnDiskBase());
+  } else {
+    // TODO(florian): Check if the lambda is a performance problem
+    CALL_FIXED_SIZE_1(width, ad_utility::externalSort, std::move(subRes),
+                      &result->_data,
+                      [this](const auto& a, const auto& b) {
+                        for (auto& entry : _sortIndices) {
+                          if (a[entry.first] < b[entry.first]) {
+                            return !entry.second;
+                          }
+                          if (a[entry.first] > b[entry.first]) {
+                            return entry.second;
+                          }
                         }
-                      }
-                      return a[0] < b[0];
-                    });
+                        return a[0] < b[0];
+                      },
+                      getExecutionContext()->getSortMemoryLimit(),
+                      getIndex().getOnDiskBase());
+  }
   result->_sortedBy = resultSortedOn();
+  // The runtime information of the child is complete once it is read.
+  getRuntimeInfo().addChild(_subtree->getRootOperation()->getRuntimeInfo());
 
   LOG(DEBUG) << "OrderBy result computation done." << endl;
 }
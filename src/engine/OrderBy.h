@@ -18,9 +18,13 @@ using std::vector;
 
 class OrderBy : public Operation {
  public:
+  // With orderNumbersByValue, numbers are ordered by their value also if
+  // some of them are in the vocabulary (see NumberOrder). The result is then
+  // not sorted by Id, which the ORDER BY of a query does not need.
   OrderBy(QueryExecutionContext* qec,
           std::shared_ptr<QueryExecutionTree> subtree,
-          vector<pair<size_t, bool>> sortIndices);
+          vector<pair<size_t, bool>> sortIndices,
+          bool orderNumbersByValue = false);
 
   virtual string asString(size_t indent = 0) const override;
 
@@ -68,6 +72,7 @@ class OrderBy : public Operation {
  private:
   std::shared_ptr<QueryExecutionTree> _subtree;
   vector<pair<size_t, bool>> _sortIndices;
+  bool _orderNumbersByValue;
 
   virtual void computeResult(ResultTable* result) override;
 };
@@ -0,0 +1,153 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <utility>
+#include <vector>
+#include "../global/Constants.h"
+#include "../global/Id.h"
+#include "../util/CancellationHandle.h"
+#include "./IdTable.h"
+
+using std::vector;
+
+namespace ad_utility {
+
+//! Settings of the parallel merge joins, changed by ServerMain at startup.
+class ParallelJoinSettings {
+ public:
+  //! The maximal number of threads used by a single join.
+  static size_t nofThreads() { return _nofThreads; }
+  static void setNofThreads(size_t nofThreads) {
+    _nofThreads = std::max<size_t>(1, nofThreads);
+  }
+
+  //! Inputs are only split into partitions with at least this many rows of
+  //! the larger input.
+  static size_t minPartitionSize() { return _minPartitionSize; }
+  static void setMinPartitionSize(size_t minPartitionSize) {
+    _minPartitionSize = std::max<size_t>(1, minPartitionSize);
+  }
+
+ private:
+  static inline std::atomic<size_t> _nofThreads = DEFAULT_NOF_JOIN_THREADS;
+  static inline std::atomic<size_t> _minPartitionSize =
+      DEFAULT_JOIN_MIN_PARTITION_SIZE;
+};
+
+/**
+ * @brief Split a and b, which are sorted on the columns jcA and jcB, into at
+ * most nofPartitions partitions such that all rows with the same join id are
+ * in the same partition. The split ids are taken from the larger table.
+ * Partition i consists of the rows [aBounds[i], aBounds[i + 1]) of a and the
+ * rows [bBounds[i], bBounds[i + 1]) of b.
+ *
+ * @return The pair (aBounds, bBounds)
+ */
+template <typename A, typename B>
+std::pair<vector<size_t>, vector<size_t>> splitAtJoinIds(const A& a,
+                                                         size_t jcA,
+                                                         const B& b,
+                                                         size_t jcB,
+                                                         size_t nofPartitions) {
+  vector<Id> splitIds;
+  auto addSplitIds = [&splitIds, nofPartitions](const auto& table, size_t jc) {
+    for (size_t i = 1; i < nofPartitions; ++i) {
+      splitIds.push_back(table(i * table.size() / nofPartitions, jc));
+    }
+  };
+  if (a.size() >= b.size()) {
+    addSplitIds(a, jcA);
+  } else {
+    addSplitIds(b, jcB);
+  }
+  splitIds.erase(std::unique(splitIds.begin(), splitIds.end()),
+                 splitIds.end());
+
+  // The first row with a join id >= id.
+  auto lowerBound = [](const auto& table, size_t jc, Id id) -> size_t {
+    return std::lower_bound(table.begin(), table.end(), id,
+                            [jc](const auto& row, Id id) {
+                              return row[jc] < id;
+                            }) -
+           table.begin();
+  };
+  vector<size_t> aBounds{0};
+  vector<size_t> bBounds{0};
+  for (Id id : splitIds) {
+    aBounds.push_back(lowerBound(a, jcA, id));
+    bBounds.push_back(lowerBound(b, jcB, id));
+  }
+  aBounds.push_back(a.size());
+  bBounds.push_back(b.size());
+  return {std::move(aBounds), std::move(bBounds)};
+}
+
+/**
+ * @brief Compute a merge join of a and b (sorted on the primary join columns
+ * jcA and jcB) in parallel. Both inputs are split via splitAtJoinIds, the
+ * partitions are joined by joinPartition on separate threads and the results
+ * are appended to result in the order of the partitions (which is the order
+ * of the sequential join).
+ *
+ * @param joinPartition (const IdTableView<A_WIDTH>&,
+ *                       const IdTableView<B_WIDTH>&,
+ *                       IdTableStatic<OUT_WIDTH>*) -> void, the sequential
+ *                      join. Called only once with the complete inputs if they
+ *                      are too small to be split.
+ */
+template <int A_WIDTH, int B_WIDTH, int OUT_WIDTH, typename JoinPartition>
+void parallelMergeJoin(const IdTableView<A_WIDTH>& a, size_t jcA,
+                       const IdTableView<B_WIDTH>& b, size_t jcB,
+                       IdTableStatic<OUT_WIDTH>* result,
+                       JoinPartition joinPartition) {
+  size_t nofPartitions =
+      std::min(ParallelJoinSettings::nofThreads(),
+               std::max(a.size(), b.size()) /
+                   ParallelJoinSettings::minPartitionSize());
+  if (nofPartitions <= 1) {
+    joinPartition(a, b, result);
+    return;
+  }
+  auto bounds = splitAtJoinIds(a, jcA, b, jcB, nofPartitions);
+  const vector<size_t>& aBounds = bounds.first;
+  const vector<size_t>& bBounds = bounds.second;
+  nofPartitions = aBounds.size() - 1;
+  LOG(DEBUG) << "Joining in " << nofPartitions << " partitions.\n";
+
+  vector<IdTableStatic<OUT_WIDTH>> partialResults;
+  for (size_t i = 0; i < nofPartitions; ++i) {
+    partialResults.emplace_back(result->cols());
+  }
+  vector<std::future<void>> futures;
+  for (size_t i = 0; i < nofPartitions; ++i) {
+    futures.push_back(std::async(
+        std::launch::async,
+        [&, i, cancellationHandle = CancellationHandle::current()] {
+          // The partitions check for the cancellation of the query.
+          CancellationHandle::Scope scope(cancellationHandle);
+          joinPartition(
+              a.template asStaticView<A_WIDTH>(aBounds[i], aBounds[i + 1]),
+              b.template asStaticView<B_WIDTH>(bBounds[i], bBounds[i + 1]),
+              &partialResults[i]);
+        }));
+  }
+  size_t nofRows = result->size();
+  for (size_t i = 0; i < nofPartitions; ++i) {
+    // Rethrows the exceptions of the partitions.
+    futures[i].get();
+    nofRows += partialResults[i].size();
+  }
+  result->reserve(nofRows);
+  for (auto& partialResult : partialResults) {
+    result->insert(result->end(), partialResult.cbegin(),
+                   partialResult.cend());
+    // Free the memory as early as possible.
+    partialResult = IdTableStatic<OUT_WIDTH>(result->cols());
+  }
+}
+}  // namespace ad_utility
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <shared_mutex>
 #include <string>
@@ -29,12 +30,66 @@ struct CacheValue {
   [[nodiscard]] size_t size() const {
     return _resTable ? _resTable->size() * _resTable->width() : 0;
   }
+
+  // The number of bytes of the result (the Ids and the local vocabulary).
+  // Note that the local vocabulary may be shared with other results. Results
+  // that are still computed have size 0, their table is written by the
+  // computing thread (the cache recomputes the size once they are finished).
+  struct SizeInBytesGetter {
+    size_t operator()(const CacheValue& value) const {
+      if (!value._resTable ||
+          value._resTable->status() != ResultTable::FINISHED) {
+        return 0;
+      }
+      size_t res = value.size() * sizeof(Id);
+      if (value._resTable && value._resTable->_localVocab) {
+        for (const auto& word : *value._resTable->_localVocab) {
+          res += sizeof(word) + word.size();
+        }
+      }
+      return res;
+    }
+  };
+
+  // The cost of recomputing the result, this is the time it took to compute
+  // it in ms (+ 1 to also rank results that were computed very fast by their
+  // size). Results that are still computed can not be evicted.
+  struct CostGetter {
+    double operator()(const CacheValue& value) const {
+      if (!value._resTable ||
+          value._resTable->status() != ResultTable::FINISHED) {
+        return std::numeric_limits<double>::infinity();
+      }
+      return value._runtimeInfo.getTime() + 1.0;
+    }
+  };
 };
 
-typedef ad_utility::LRUCache<string, CacheValue> SubtreeCache;
+// The capacity of the cache is the number of elements, the maximal total size
+// in bytes is set via setMaxSize.
+typedef ad_utility::GreedyDualSizeCache<string, CacheValue,
+                                        CacheValue::CostGetter,
+                                        CacheValue::SizeInBytesGetter>
+    SubtreeCache;
 using PinnedSizes =
     ad_utility::Synchronized<ad_utility::HashMap<std::string, size_t>,
                              std::shared_mutex>;
+// The result sizes of the subtrees of earlier queries, keyed by
+// Operation::asString().
+using ObservedSizes = ad_utility::HeapBasedLRUCache<string, size_t>;
+
+// Thrown by QueryExecutionTree::getResult if the size of a computed subtree
+// was estimated so badly that the query should be planned again (see
+// QueryExecutionContext::setMaxNofReplans).
+class ReplanQueryException : public std::exception {
+ public:
+  explicit ReplanQueryException(string what) : _what(std::move(what)) {}
+
+  const char* what() const noexcept override { return _what.c_str(); }
+
+ private:
+  string _what;
+};
 
 // Execution context for queries.
 // Holds references to index and engine, implements caching.
@@ -71,6 +126,37 @@ class QueryExecutionContext {
     return _costFactors.getCostFactor(key);
   };
 
+  // The memory (in bytes) that a single sort may use, see externalSort.
+  size_t getSortMemoryLimit() const { return _sortMemoryLimit; }
+
+  void setSortMemoryLimit(size_t sortMemoryLimit) {
+    _sortMemoryLimit = sortMemoryLimit;
+  }
+
+  // The sizes of the computed results are stored in observedSizes, and the
+  // sizes in there are used instead of the size estimates.
+  void setObservedSizes(ObservedSizes* observedSizes) {
+    _observedSizes = observedSizes;
+  }
+
+  // nullptr if the sizes of the results are not stored.
+  ObservedSizes* getObservedSizes() const { return _observedSizes; }
+
+  // The query may be planned again at most this many times because the size
+  // of a subtree was estimated badly (0 by default).
+  void setMaxNofReplans(size_t maxNofReplans) {
+    _nofReplansLeft = maxNofReplans;
+  }
+
+  // Returns true (and counts this) iff the query may be planned again.
+  bool tryStartReplan() {
+    size_t left = _nofReplansLeft;
+    while (left > 0 &&
+           !_nofReplansLeft.compare_exchange_weak(left, left - 1)) {
+    }
+    return left > 0;
+  }
+
   const bool _pinSubtrees;
   const bool _pinResult;
 
@@ -80,4 +166,7 @@ class QueryExecutionContext {
   SubtreeCache* const _subtreeCache;
   PinnedSizes* const _pinnedSizes;
   QueryPlanningCostFactors _costFactors;
+  size_t _sortMemoryLimit = DEFAULT_SORT_MEMORY_LIMIT_PER_QUERY_GB * (1ull << 30);
+  ObservedSizes* _observedSizes = nullptr;
+  std::atomic<size_t> _nofReplansLeft{0};
 };
@@ -4,8 +4,11 @@
 
 #include "./QueryExecutionTree.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include "./Distinct.h"
 #include "./Filter.h"
 #include "./IndexScan.h"
@@ -85,14 +88,9 @@ void QueryExecutionTree::setVariableColumns(
 }
 
 // _____________________________________________________________________________
-void QueryExecutionTree::writeResultToStream(std::ostream& out,
-                                             const vector<string>& selectVars,
-                                             size_t limit, size_t offset,
-                                             char sep) const {
-  // They may trigger computation (but does not have to).
-  shared_ptr<const ResultTable> res = getResult();
-  LOG(DEBUG) << "Resolving strings for finished binary result...\n";
-  vector<std::optional<pair<size_t, ResultTable::ResultType>>> validIndices;
+QueryExecutionTree::ColumnIndicesAndTypes QueryExecutionTree::selectedColumns(
+    const ResultTable& res, const vector<string>& selectVars) const {
+  ColumnIndicesAndTypes validIndices;
   for (auto var : selectVars) {
     if (ad_utility::startsWith(var, "TEXT(")) {
       var = var.substr(5, var.rfind(')') - 5);
@@ -100,47 +98,48 @@ void QueryExecutionTree::writeResultToStream(std::ostream& out,
     auto it = getVariableColumns().find(var);
     if (it != getVariableColumns().end()) {
       validIndices.push_back(pair<size_t, ResultTable::ResultType>(
-          it->second, res->getResultType(it->second)));
+          it->second, res.getResultType(it->second)));
     } else {
       validIndices.push_back(std::nullopt);
     }
   }
+  return validIndices;
+}
+
+// _____________________________________________________________________________
+void QueryExecutionTree::writeResultToStream(std::ostream& out,
+                                             const vector<string>& selectVars,
+                                             size_t limit, size_t offset,
+                                             char sep) const {
+  // They may trigger computation (but does not have to).
+  shared_ptr<const ResultTable> res = getResult();
+  LOG(DEBUG) << "Resolving strings for finished binary result...\n";
+  ColumnIndicesAndTypes validIndices = selectedColumns(*res, selectVars);
   if (validIndices.size() == 0) {
     return;
   }
 
-  const IdTable& data = res->_data;
-  size_t upperBound = std::min<size_t>(offset + limit, data.size());
-  writeTable(data, sep, offset, upperBound, validIndices, out);
+  size_t upperBound = std::min<size_t>(offset + limit, res->size());
+  writeTable(*res, sep, offset, upperBound, validIndices, out);
 
   LOG(DEBUG) << "Done creating readable result.\n";
 }
 
 // _____________________________________________________________________________
-nlohmann::json QueryExecutionTree::writeResultAsJson(
-    const vector<string>& selectVars, size_t limit, size_t offset) const {
+void QueryExecutionTree::writeResultAsJson(std::ostream& out,
+                                           const vector<string>& selectVars,
+                                           size_t limit, size_t offset) const {
   // They may trigger computation (but does not have to).
   shared_ptr<const ResultTable> res = getResult();
   LOG(DEBUG) << "Resolving strings for finished binary result...\n";
-  vector<std::optional<pair<size_t, ResultTable::ResultType>>> validIndices;
-  for (auto var : selectVars) {
-    if (ad_utility::startsWith(var, "TEXT(")) {
-      var = var.substr(5, var.rfind(')') - 5);
-    }
-    auto vc = getVariableColumns().find(var);
-    if (vc != getVariableColumns().end()) {
-      validIndices.push_back(pair<size_t, ResultTable::ResultType>(
-          vc->second, res->getResultType(vc->second)));
-    } else {
-      validIndices.push_back(std::nullopt);
-    }
-  }
+  ColumnIndicesAndTypes validIndices = selectedColumns(*res, selectVars);
   if (validIndices.size() == 0) {
-    return nlohmann::json(std::vector<std::string>());
+    out << "[]";
+    return;
   }
 
-  const IdTable& data = res->_data;
-  return writeJsonTable(data, offset, limit, validIndices);
+  size_t upperBound = std::min(res->size(), limit + offset);
+  writeJsonTable(*res, offset, upperBound, validIndices, out);
 }
 
 // _____________________________________________________________________________
@@ -161,6 +160,8 @@ size_t QueryExecutionTree::getSizeEstimate() {
   if (_sizeEstimate == std::numeric_limits<size_t>::max()) {
     if (_cachedResult && _cachedResult->status() == ResultTable::FINISHED) {
       _sizeEstimate = _cachedResult->size();
+    } else if (auto observedSize = getObservedSize()) {
+      _sizeEstimate = *observedSize;
     } else {
       // if we are in a unit test setting and there is no QueryExecutionContest
       // specified it is the _rootOperation's obligation to handle this case
@@ -171,6 +172,45 @@ size_t QueryExecutionTree::getSizeEstimate() {
   return _sizeEstimate;
 }
 
+// _____________________________________________________________________________
+std::optional<size_t> QueryExecutionTree::getObservedSize() const {
+  if (!_qec || !_qec->getObservedSizes()) {
+    return std::nullopt;
+  }
+  auto observedSize = (*_qec->getObservedSizes())[_rootOperation->asString()];
+  if (!observedSize) {
+    return std::nullopt;
+  }
+  return *observedSize;
+}
+
+// _____________________________________________________________________________
+void QueryExecutionTree::checkSizeEstimate(const ResultTable& result) const {
+  // Only the estimates that were used for planning matter. Replanning after
+  // the root was computed does not help.
+  if (!_qec || isRoot() ||
+      _sizeEstimate == std::numeric_limits<size_t>::max()) {
+    return;
+  }
+  size_t larger = std::max(result.size(), _sizeEstimate);
+  size_t smaller = std::max<size_t>(1, std::min(result.size(), _sizeEstimate));
+  if (larger < REPLAN_MIN_SIZE ||
+      larger / smaller < REPLAN_MIN_ESTIMATE_ERROR) {
+    return;
+  }
+  // The new plan has to find the result in the cache, otherwise it would be
+  // computed again.
+  const string key = _rootOperation->asString();
+  if (!_qec->getQueryTreeCache().contains(key) || !_qec->tryStartReplan()) {
+    return;
+  }
+  std::ostringstream os;
+  os << "The size of the result of " << _rootOperation->getDescriptor()
+     << " was estimated as " << _sizeEstimate << " but is " << result.size()
+     << ", the query is planned again";
+  throw ReplanQueryException(os.str());
+}
+
 // _____________________________________________________________________________
 bool QueryExecutionTree::knownEmptyResult() {
   if (_cachedResult && _cachedResult->status() == ResultTable::FINISHED) {
@@ -196,118 +236,197 @@ void QueryExecutionTree::readFromCache() {
   }
 }
 
-// __________________________________________________________________________________________________________
-nlohmann::json QueryExecutionTree::writeJsonTable(
-    const IdTable& data, size_t from, size_t limit,
-    const vector<std::optional<pair<size_t, ResultTable::ResultType>>>&
-        validIndices) const {
-  shared_ptr<const ResultTable> res = getResult();
-  nlohmann::json json = nlohmann::json::parse("[]");
-  auto optToJson = [](const auto& opt) -> nlohmann::json {
-    if (opt) {
-      return opt.value();
+// _____________________________________________________________________________
+std::shared_ptr<const ResultTable> QueryExecutionTree::computeResultPrefix()
+    const {
+  std::unique_ptr<LazyResult> lazyResult = getLazyResult();
+  auto result = std::make_shared<ResultTable>();
+  result->_sortedBy = lazyResult->_sortedBy;
+  result->_resultTypes = lazyResult->_resultTypes;
+  result->_localVocab = lazyResult->_localVocab;
+  result->_data.setCols(lazyResult->width());
+  IdTable block(lazyResult->width());
+  _resultPrefixIsComplete = false;
+  while (result->size() < _rowLimit) {
+    if (!lazyResult->nextBlock(&block)) {
+      _resultPrefixIsComplete = true;
+      break;
     }
-    return nullptr;
-  };
-
-  const auto upperBound = std::min(data.size(), limit + from);
+    result->_data.insert(result->_data.end(), block.begin(), block.end());
+  }
+  if (result->size() > _rowLimit) {
+    result->_data.resize(_rowLimit);
+  }
+  LOG(DEBUG) << "Computed the first " << result->size()
+             << " rows of the result.\n";
+  result->finish();
+  return result;
+}
 
-  for (size_t i = from; i < upperBound; ++i) {
-    json.emplace_back();
-    auto& row = json.back();
-    for (const auto& opt : validIndices) {
-      if (!opt) {
-        row.emplace_back(nullptr);
-        continue;
+namespace {
+// Write s as a json string (including the quotes).
+void writeJsonString(std::ostream& out, std::string_view s) {
+  out << '"';
+  size_t begin = 0;
+  for (size_t i = 0; i < s.size(); ++i) {
+    auto c = static_cast<unsigned char>(s[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    out.write(s.data() + begin, i - begin);
+    begin = i + 1;
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      case '\r':
+        out << "\\r";
+        break;
+      case '\b':
+        out << "\\b";
+        break;
+      case '\f':
+        out << "\\f";
+        break;
+      default: {
+        char escaped[7];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        out << escaped;
       }
-      const auto& idx = *opt;
-      const auto& currentId = data(i, idx.first);
-      switch (idx.second) {
-        case ResultTable::ResultType::KB: {
+    }
+  }
+  out.write(s.data() + begin, s.size() - begin);
+  out << '"';
+}
+}  // namespace
+
+// _____________________________________________________________________________
+vector<vector<std::optional<string>>> QueryExecutionTree::resolveStrings(
+    const ResultTable& res, size_t from, size_t to,
+    const ColumnIndicesAndTypes& validIndices) const {
+  const IdTable& data = res._data;
+  vector<vector<std::optional<string>>> strings(validIndices.size());
+  vector<pair<Id, size_t>> idsAndRows;
+  std::ostringstream floatStream;
+  for (size_t j = 0; j < validIndices.size(); ++j) {
+    auto& column = strings[j];
+    column.resize(to - from);
+    if (!validIndices[j]) {
+      continue;
+    }
+    const auto& [col, type] = *validIndices[j];
+    switch (type) {
+      case ResultTable::ResultType::KB: {
+        // Neighboring ids are close to each other in the vocabulary, and
+        // repeated ids (e.g. the subject of many rows) are only looked up
+        // once.
+        idsAndRows.clear();
+        for (size_t i = from; i < to; ++i) {
+          idsAndRows.emplace_back(data(i, col), i - from);
+        }
+        std::sort(idsAndRows.begin(), idsAndRows.end());
+        for (size_t k = 0; k < idsAndRows.size(); ++k) {
+          const auto& [id, row] = idsAndRows[k];
+          if (k > 0 && idsAndRows[k - 1].first == id) {
+            column[row] = column[idsAndRows[k - 1].second];
+            continue;
+          }
           std::optional<string> entity =
-              _qec->getIndex().idToOptionalString(currentId);
-          if (entity) {
-            string entitystr = entity.value();
-            if (ad_utility::startsWith(entitystr, VALUE_PREFIX)) {
-              entity = ad_utility::convertIndexWordToValueLiteral(entitystr);
-            }
+              _qec->getIndex().idToOptionalString(id);
+          if (entity && ad_utility::startsWith(*entity, VALUE_PREFIX)) {
+            entity = ad_utility::convertIndexWordToValueLiteral(*entity);
           }
-          row.emplace_back(optToJson(entity));
-          break;
+          column[row] = std::move(entity);
+        }
+        break;
+      }
+      case ResultTable::ResultType::VERBATIM:
+        for (size_t i = from; i < to; ++i) {
+          column[i - from] = std::to_string(data(i, col));
+        }
+        break;
+      case ResultTable::ResultType::TEXT:
+        for (size_t i = from; i < to; ++i) {
+          column[i - from] = _qec->getIndex().getTextExcerpt(data(i, col));
         }
-        case ResultTable::ResultType::VERBATIM:
-          row.emplace_back(std::to_string(currentId));
-          break;
-        case ResultTable::ResultType::TEXT:
-          row.emplace_back(_qec->getIndex().getTextExcerpt(currentId));
-          break;
-        case ResultTable::ResultType::FLOAT: {
+        break;
+      case ResultTable::ResultType::FLOAT:
+        for (size_t i = from; i < to; ++i) {
           float f;
-          std::memcpy(&f, &currentId, sizeof(float));
-          std::stringstream s;
-          s << f;
-          row.push_back(s.str());
-          break;
+          std::memcpy(&f, &data(i, col), sizeof(float));
+          floatStream.str("");
+          floatStream << f;
+          column[i - from] = floatStream.str();
         }
-        case ResultTable::ResultType::LOCAL_VOCAB: {
-          std::optional<string> entity = res->idToOptionalString(currentId);
-          row.emplace_back(optToJson(entity));
-          break;
+        break;
+      case ResultTable::ResultType::LOCAL_VOCAB:
+        for (size_t i = from; i < to; ++i) {
+          column[i - from] = res.idToOptionalString(data(i, col));
+        }
+        break;
+      default:
+        AD_THROW(ad_semsearch::Exception::INVALID_PARAMETER_VALUE,
+                 "Cannot deduce output type.");
+    }
+  }
+  return strings;
+}
+
+// _____________________________________________________________________________
+void QueryExecutionTree::writeJsonTable(
+    const ResultTable& res, size_t from, size_t upperBound,
+    const ColumnIndicesAndTypes& validIndices, std::ostream& out) const {
+  out << '[';
+  for (size_t batchBegin = from; batchBegin < upperBound && out;
+       batchBegin += RESULT_EXPORT_BATCH_SIZE) {
+    size_t batchEnd =
+        std::min(upperBound, batchBegin + RESULT_EXPORT_BATCH_SIZE);
+    auto strings = resolveStrings(res, batchBegin, batchEnd, validIndices);
+    for (size_t i = 0; i < batchEnd - batchBegin; ++i) {
+      out << (batchBegin + i == from ? "[" : ",[");
+      for (size_t j = 0; j < strings.size(); ++j) {
+        if (j > 0) {
+          out << ',';
+        }
+        if (strings[j][i]) {
+          writeJsonString(out, *strings[j][i]);
+        } else {
+          out << "null";
         }
-        default:
-          AD_THROW(ad_semsearch::Exception::INVALID_PARAMETER_VALUE,
-                   "Cannot deduce output type.");
       }
+      out << ']';
     }
   }
-  return json;
+  out << ']';
 }
 
-// _________________________________________________________________________________________________________
-void QueryExecutionTree::writeTable(
-    const IdTable& data, char sep, size_t from, size_t upperBound,
-    const vector<std::optional<pair<size_t, ResultTable::ResultType>>>&
-        validIndices,
-    std::ostream& out) const {
-  shared_ptr<const ResultTable> res = getResult();
-  for (size_t i = from; i < upperBound; ++i) {
-    for (size_t j = 0; j < validIndices.size(); ++j) {
-      if (validIndices[j]) {
-        const auto& val = *validIndices[j];
-        switch (val.second) {
-          case ResultTable::ResultType::KB: {
-            string entity = _qec->getIndex()
-                                .idToOptionalString(data(i, val.first))
-                                .value_or("");
-            if (ad_utility::startsWith(entity, VALUE_PREFIX)) {
-              out << ad_utility::convertIndexWordToValueLiteral(entity);
-            } else {
-              out << entity;
-            }
-            break;
-          }
-          case ResultTable::ResultType::VERBATIM:
-            out << data(i, val.first);
-            break;
-          case ResultTable::ResultType::TEXT:
-            out << _qec->getIndex().getTextExcerpt(data(i, val.first));
-            break;
-          case ResultTable::ResultType::FLOAT: {
-            float f;
-            std::memcpy(&f, &data(i, val.first), sizeof(float));
-            out << f;
-            break;
-          }
-          case ResultTable::ResultType::LOCAL_VOCAB: {
-            out << res->idToOptionalString(data(i, val.first)).value_or("");
-            break;
-          }
-          default:
-            AD_THROW(ad_semsearch::Exception::INVALID_PARAMETER_VALUE,
-                     "Cannot deduce output type.");
+// _____________________________________________________________________________
+void QueryExecutionTree::writeTable(const ResultTable& res, char sep,
+                                    size_t from, size_t upperBound,
+                                    const ColumnIndicesAndTypes& validIndices,
+                                    std::ostream& out) const {
+  // Stop early if out went bad (e.g. the client has disconnected).
+  for (size_t batchBegin = from; batchBegin < upperBound && out;
+       batchBegin += RESULT_EXPORT_BATCH_SIZE) {
+    size_t batchEnd =
+        std::min(upperBound, batchBegin + RESULT_EXPORT_BATCH_SIZE);
+    auto strings = resolveStrings(res, batchBegin, batchEnd, validIndices);
+    for (size_t i = 0; i < batchEnd - batchBegin; ++i) {
+      for (size_t j = 0; j < strings.size(); ++j) {
+        if (strings[j][i]) {
+          out << *strings[j][i];
         }
+        out << (j + 1 < strings.size() ? sep : '\n');
       }
-      out << (j + 1 < validIndices.size() ? sep : '\n');
     }
   }
 }
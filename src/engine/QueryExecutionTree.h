@@ -3,8 +3,10 @@
 // Author: Björn Buchhold (buchhold@informatik.uni-freiburg.de)
 #pragma once
 
+#include <limits>
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -42,7 +44,8 @@ class QueryExecutionTree {
     UNION = 15,
     MULTICOLUMN_JOIN = 16,
     TRANSITIVE_PATH = 17,
-    VALUES = 18
+    VALUES = 18,
+    HASH_JOIN = 19
   };
 
   void setOperation(OperationType type, std::shared_ptr<Operation> op);
@@ -79,16 +82,57 @@ class QueryExecutionTree {
 
   size_t getResultWidth() const { return _rootOperation->getResultWidth(); }
 
+  // If a row limit is set, this is only a prefix of the result with at most
+  // this many rows, see setRowLimit.
+  // Throws a ReplanQueryException if the size of the result differs too much
+  // from the size estimate that was used for planning (see
+  // checkSizeEstimate).
   shared_ptr<const ResultTable> getResult() const {
-    return _rootOperation->getResult(isRoot());
+    if (_rowLimit == std::numeric_limits<size_t>::max()) {
+      auto result = _rootOperation->getResult(isRoot());
+      if (_sizeEstimate != std::numeric_limits<size_t>::max()) {
+        // To compare the estimate with the actual size (see e2e/queryit.py).
+        _rootOperation->getRuntimeInfo().addDetail("size_estimate",
+                                                   _sizeEstimate);
+      }
+      checkSizeEstimate(*result);
+      return result;
+    }
+    if (!_resultPrefix) {
+      _resultPrefix = computeResultPrefix();
+    }
+    return _resultPrefix;
+  }
+
+  std::unique_ptr<LazyResult> getLazyResult() const {
+    return _rootOperation->getLazyResult();
+  }
+
+  // Only the first rowLimit rows of the result are needed (LIMIT + OFFSET).
+  // If the root operation can compute its result lazily, its computation
+  // stops once that many rows are produced. Then getResult() returns only
+  // these rows and they are not cached.
+  void setRowLimit(size_t rowLimit) {
+    _rowLimit = rowLimit;
+    _resultPrefix = nullptr;
+    _resultPrefixIsComplete = false;
+  }
+
+  // True iff getResult() returned only a prefix of the result because of the
+  // row limit and the result might have more rows, its size is then only a
+  // lower bound for the size of the result. Must be called after getResult().
+  bool resultSizeIsLowerBound() const {
+    return _resultPrefix != nullptr && !_resultPrefixIsComplete;
   }
 
   void writeResultToStream(std::ostream& out, const vector<string>& selectVars,
                            size_t limit = MAX_NOF_ROWS_IN_RESULT,
                            size_t offset = 0, char sep = '\t') const;
 
-  nlohmann::json writeResultAsJson(const vector<string>& selectVars,
-                                   size_t limit, size_t offset) const;
+  // Write the selected columns of the result as a compact json array (one
+  // array of strings per row, null for unbound values).
+  void writeResultAsJson(std::ostream& out, const vector<string>& selectVars,
+                         size_t limit, size_t offset) const;
 
   const std::vector<size_t>& resultSortedOn() const {
     return _rootOperation->getResultSortedOn();
@@ -178,23 +222,54 @@ class QueryExecutionTree {
 
   std::shared_ptr<const ResultTable> _cachedResult = nullptr;
 
+  size_t _rowLimit = std::numeric_limits<size_t>::max();
+  mutable std::shared_ptr<const ResultTable> _resultPrefix = nullptr;
+  // True iff all blocks of the lazy result were pulled for _resultPrefix.
+  mutable bool _resultPrefixIsComplete = false;
+
+  // The size of the result of an earlier query with this subtree (see
+  // QueryExecutionContext::setObservedSizes).
+  std::optional<size_t> getObservedSize() const;
+
+  // Throw a ReplanQueryException if the query may be planned again, the
+  // result (of a subtree) is cached and its size differs by at least a factor
+  // of REPLAN_MIN_ESTIMATE_ERROR from the size estimate.
+  void checkSizeEstimate(const ResultTable& result) const;
+
+  // Pull blocks of the lazy result of the root operation until _rowLimit rows
+  // are computed.
+  std::shared_ptr<const ResultTable> computeResultPrefix() const;
+
+  using ColumnIndicesAndTypes =
+      vector<std::optional<pair<size_t, ResultTable::ResultType>>>;
+
+  // The columns of the result that correspond to the selected variables,
+  // std::nullopt for variables that are not part of the result.
+  ColumnIndicesAndTypes selectedColumns(const ResultTable& res,
+                                        const vector<string>& selectVars) const;
+
+  // The strings of the rows [from, to) of res for each of the given columns
+  // (std::nullopt if there is none, e.g. for unbound variables). The ids of a
+  // KB column are looked up in sorted order and each distinct id only once.
+  vector<vector<std::optional<string>>> resolveStrings(
+      const ResultTable& res, size_t from, size_t to,
+      const ColumnIndicesAndTypes& validIndices) const;
+
   /**
-   * @brief Convert an IdTable (typically from a query result) to a json array
-   * @param data the IdTable from which we read
+   * @brief Write an IdTable (typically from a query result) as a json array
+   * @param res the result from which we read
    * @param from the first <from> entries of the idTable are skipped
-   * @param limit at most <limit> entries are written, starting at <from>
+   * @param upperBound entries are written up to (excluding) this index
    * @param validIndices each pair of <columnInIdTable, correspondingType> tells
    * us which columns are to be serialized in which order
-   * @return a 2D-Json array corresponding to the IdTable given the arguments
+   * @param out a 2D-Json array corresponding to the IdTable given the
+   * arguments is written to this stream
    */
-  nlohmann::json writeJsonTable(
-      const IdTable& data, size_t from, size_t limit,
-      const vector<std::optional<pair<size_t, ResultTable::ResultType>>>&
-          validIndices) const;
-
-  void writeTable(
-      const IdTable& data, char sep, size_t from, size_t upperBound,
-      const vector<std::optional<pair<size_t, ResultTable::ResultType>>>&
-          validIndices,
-      std::ostream& out) const;
+  void writeJsonTable(const ResultTable& res, size_t from, size_t upperBound,
+                      const ColumnIndicesAndTypes& validIndices,
+                      std::ostream& out) const;
+
+  void writeTable(const ResultTable& res, char sep, size_t from,
+                  size_t upperBound, const ColumnIndicesAndTypes& validIndices,
+                  std::ostream& out) const;
 };
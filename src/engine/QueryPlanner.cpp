@@ -14,6 +14,7 @@
 #include "Filter.h"
 #include "GroupBy.h"
 #include "HasPredicateScan.h"
+#include "HashJoin.h"
 #include "IndexScan.h"
 #include "Join.h"
 #include "MultiColumnJoin.h"
@@ -824,10 +825,14 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::getPatternTrickRow(
                      "trick.");
       }
       size_t subjectColumn = it->second;
+      const PatternTrickTables::Table* precomputed =
+          getPrecomputedPatternTrickResult(parent, patternTrickTriple._s);
       const std::vector<size_t>& resultSortedOn =
           parent._qet->getRootOperation()->getResultSortedOn();
-      bool isSorted =
-          resultSortedOn.size() > 0 && resultSortedOn[0] == subjectColumn;
+      // the precomputed result does not need the sorted subtree.
+      bool isSorted = precomputed != nullptr ||
+                      (resultSortedOn.size() > 0 &&
+                       resultSortedOn[0] == subjectColumn);
       // a and b need to be ordered properly first
       vector<pair<size_t, bool>> sortIndices = {
           std::make_pair(subjectColumn, false)};
@@ -842,6 +847,7 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::getPatternTrickRow(
       SubtreePlan patternTrickPlan(_qec);
       auto countPred = std::make_shared<CountAvailablePredicates>(
           _qec, isSorted ? parent._qet : orderByPlan._qet, subjectColumn);
+      countPred->setPrecomputedResult(precomputed);
 
       countPred->setVarNames(patternTrickTriple._o, pq._aliases[0]._outVarName);
       QueryExecutionTree& tree = *patternTrickPlan._qet;
@@ -866,6 +872,10 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::getPatternTrickRow(
     // Use the pattern trick without a subtree
     SubtreePlan patternTrickPlan(_qec);
     auto countPred = std::make_shared<CountAvailablePredicates>(_qec);
+    if (_qec != nullptr) {
+      countPred->setPrecomputedResult(
+          _qec->getIndex().getPatternTrickTables().getAllEntities());
+    }
 
     if (pq._aliases.size() > 0) {
       countPred->setVarNames(patternTrickTriple._o, pq._aliases[0]._outVarName);
@@ -881,6 +891,29 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::getPatternTrickRow(
   return added;
 }
 
+// _____________________________________________________________________________
+const PatternTrickTables::Table* QueryPlanner::getPrecomputedPatternTrickResult(
+    const SubtreePlan& plan, const string& subjectVar) const {
+  // Only a single triple ?x <type predicate> <type> can be precomputed.
+  if (_qec == nullptr || plan._qet->getType() != QueryExecutionTree::SCAN) {
+    return nullptr;
+  }
+  auto scan =
+      std::dynamic_pointer_cast<IndexScan>(plan._qet->getRootOperation());
+  if (scan == nullptr || scan->getType() != IndexScan::POS_BOUND_O ||
+      scan->getSubject() != subjectVar) {
+    return nullptr;
+  }
+  const Index& index = _qec->getIndex();
+  Id predicate;
+  Id type;
+  if (!index.getVocab().getId(scan->getPredicate(), &predicate) ||
+      !index.getVocab().getId(scan->getObject(), &type)) {
+    return nullptr;
+  }
+  return index.getPatternTrickTables().getType(predicate, type);
+}
+
 // _____________________________________________________________________________
 vector<QueryPlanner::SubtreePlan> QueryPlanner::getHavingRow(
     const ParsedQuery& pq, const vector<vector<SubtreePlan>>& dpTab) const {
@@ -932,9 +965,16 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::getGroupByRow(
     for (size_t i = 0; inputSorted && i < sortColumns.size(); i++) {
       inputSorted = sortColumns[i].first == inputSortedOn[i];
     }
+    // Aggregate the groups in hash tables instead of sorting the input if
+    // there are only few of them.
+    bool hashAggregation = !inputSorted &&
+                           groupBy->supportsHashAggregation() &&
+                           groupBy->getNofGroupsEstimate(parent->_qet.get()) <=
+                               HASH_GROUP_BY_MAX_GROUPS;
+    groupBy->setHashAggregation(hashAggregation);
     // Create the plan here to avoid it falling out of context early
     SubtreePlan orderByPlan(_qec);
-    if (!sortColumns.empty() && !inputSorted) {
+    if (!sortColumns.empty() && !inputSorted && !hashAggregation) {
       // Create an order by operation as required by the group by
       auto orderBy = std::make_shared<OrderBy>(_qec, parent->_qet, sortColumns);
       QueryExecutionTree& orderByTree = *orderByPlan._qet;
@@ -957,12 +997,28 @@ vector<QueryPlanner::SubtreePlan> QueryPlanner::getOrderByRow(
   const vector<SubtreePlan>& previous = dpTab[dpTab.size() - 1];
   vector<SubtreePlan> added;
   added.reserve(previous.size());
+  // If some numbers are in the vocabulary, sorting by Id does not sort the
+  // numbers by value (see NumberOrder).
+  bool orderNumbersByValue =
+      _qec && !_qec->getIndex().getNumberOrder().empty();
   for (size_t i = 0; i < previous.size(); ++i) {
     SubtreePlan plan(_qec);
     auto& tree = *plan._qet;
     plan._idsOfIncludedNodes = previous[i]._idsOfIncludedNodes;
     plan._idsOfIncludedFilters = previous[i]._idsOfIncludedFilters;
-    if (pq._orderBy.size() == 1 && !pq._orderBy[0]._desc) {
+    if (orderNumbersByValue) {
+      vector<pair<size_t, bool>> sortIndices;
+      for (auto& ord : pq._orderBy) {
+        sortIndices.emplace_back(pair<size_t, bool>{
+            previous[i]._qet->getVariableColumn(ord._key), ord._desc});
+      }
+      auto ob = std::make_shared<OrderBy>(_qec, previous[i]._qet, sortIndices,
+                                          true);
+      tree.setVariableColumns(previous[i]._qet->getVariableColumns());
+      tree.setOperation(QueryExecutionTree::ORDER_BY, ob);
+      tree.setContextVars(previous[i]._qet->getContextVars());
+      added.push_back(plan);
+    } else if (pq._orderBy.size() == 1 && !pq._orderBy[0]._desc) {
       size_t col = previous[i]._qet->getVariableColumn(pq._orderBy[0]._key);
       const std::vector<size_t>& previousSortedOn =
           previous[i]._qet->resultSortedOn();
@@ -1906,6 +1962,23 @@ QueryPlanner::SubtreePlan QueryPlanner::multiColumnJoin(
   return plan;
 }
 
+// _____________________________________________________________________________
+QueryPlanner::SubtreePlan QueryPlanner::hashJoin(const SubtreePlan& a,
+                                                 const SubtreePlan& b,
+                                                 const array<Id, 2>& jc) const {
+  SubtreePlan plan{_qec};
+  auto& tree = *plan._qet;
+  auto join = std::make_shared<HashJoin>(_qec, a._qet, b._qet, jc[0], jc[1]);
+  tree.setVariableColumns(join->getVariableColumns());
+  tree.setContextVars(join->getContextVars());
+  tree.setOperation(QueryExecutionTree::HASH_JOIN, join);
+  plan._idsOfIncludedNodes = a._idsOfIncludedNodes;
+  plan.addAllNodes(b._idsOfIncludedNodes);
+  plan._idsOfIncludedFilters = a._idsOfIncludedFilters;
+  plan._idsOfIncludedFilters |= b._idsOfIncludedFilters;
+  return plan;
+}
+
 // _____________________________________________________________________________
 string QueryPlanner::TripleGraph::asString() const {
   std::ostringstream os;
@@ -2948,12 +3021,23 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::createJoinCandidates(
 
     // "NORMAL" CASE:
     // Check if a sub-result has to be re-sorted
-    // TODO: replace with HashJoin maybe (or add variant to possible
-    // plans).
+    const vector<size_t>& aSortedOn = a._qet->resultSortedOn();
+    const vector<size_t>& bSortedOn = b._qet->resultSortedOn();
+    bool aSorted = aSortedOn.size() > 0 && aSortedOn[0] == jcs[0][0];
+    bool bSorted = bSortedOn.size() > 0 && bSortedOn[0] == jcs[0][1];
+    // If a sort is needed, also consider a hash join, which needs no sorted
+    // input. The cost estimates decide between the two. A join with a full
+    // scan dummy is always computed via scans (see Join).
+    auto isFullScanDummy = [](const SubtreePlan& plan) {
+      return plan._qet->getType() == QueryExecutionTree::SCAN &&
+             plan._qet->getResultWidth() == 3;
+    };
+    if ((!aSorted || !bSorted) && !isFullScanDummy(a) && !isFullScanDummy(b)) {
+      candidates.push_back(hashJoin(a, b, jcs[0]));
+    }
     auto left = std::make_shared<QueryExecutionTree>(_qec);
     auto right = std::make_shared<QueryExecutionTree>(_qec);
-    const vector<size_t>& aSortedOn = a._qet->resultSortedOn();
-    if (aSortedOn.size() > 0 && aSortedOn[0] == jcs[0][0]) {
+    if (aSorted) {
       left = a._qet;
     } else {
       // Create a sort operation.
@@ -2967,8 +3051,7 @@ std::vector<QueryPlanner::SubtreePlan> QueryPlanner::createJoinCandidates(
       left->setContextVars(a._qet->getContextVars());
       left->setOperation(QueryExecutionTree::SORT, sort);
     }
-    const vector<size_t>& bSortedOn = b._qet->resultSortedOn();
-    if (bSortedOn.size() > 0 && bSortedOn[0] == jcs[0][1]) {
+    if (bSorted) {
       right = b._qet;
     } else {
       // Create a sort operation.
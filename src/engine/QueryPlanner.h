@@ -278,6 +278,11 @@ class QueryPlanner {
       const ParsedQuery& pq, const vector<vector<SubtreePlan>>& dpTab,
       const SparqlTriple& patternTrickTriple);
 
+  // The precomputed result of the pattern trick for the entities in the
+  // column subjectVar of plan or nullptr if there is none.
+  const PatternTrickTables::Table* getPrecomputedPatternTrickResult(
+      const SubtreePlan& plan, const string& subjectVar) const;
+
   vector<SubtreePlan> getHavingRow(
       const ParsedQuery& pq, const vector<vector<SubtreePlan>>& dpTab) const;
 
@@ -364,6 +369,10 @@ class QueryPlanner {
 
   SubtreePlan optionalJoin(const SubtreePlan& a, const SubtreePlan& b) const;
   SubtreePlan multiColumnJoin(const SubtreePlan& a, const SubtreePlan& b) const;
+  // Join a and b on the single column jc using a HashJoin (no sorted inputs
+  // needed).
+  SubtreePlan hashJoin(const SubtreePlan& a, const SubtreePlan& b,
+                       const array<Id, 2>& jc) const;
 
   /**
    * @brief Determines if the pattern trick (and in turn the
@@ -15,6 +15,8 @@ QueryPlanningCostFactors::QueryPlanningCostFactors() : _factors() {
   _factors["NO_FILTER_PUNISH"] = 1.0;
   _factors["FILTER_SELECTIVITY"] = 0.1;
   _factors["HASH_MAP_OPERATION_COST"] = 50.0;
+  _factors["HASH_JOIN_BUILD_COST_PER_ROW"] = 4.0;
+  _factors["HASH_JOIN_PROBE_COST_PER_ROW"] = 2.0;
   _factors["JOIN_SIZE_ESTIMATE_CORRECTION_FACTOR"] = 0.7;
   _factors["DUMMY_JOIN_SIZE_ESTIMATE_CORRECTION_FACTOR"] = 1000.0;
   _factors["DISK_RANDOM_ACCESS_COST"] = 1000;
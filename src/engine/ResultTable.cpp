@@ -9,7 +9,7 @@
 ResultTable::ResultTable()
     : _sortedBy(),
       _resultTypes(),
-      _localVocab(std::make_shared<std::vector<std::string>>()),
+      _localVocab(std::make_shared<LocalVocab>()),
       _status(ResultTable::IN_PROGRESS) {}
 
 // _____________________________________________________________________________
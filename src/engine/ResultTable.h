@@ -4,12 +4,14 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <optional>
 #include <vector>
 #include "../global/Id.h"
 #include "../util/Exception.h"
+#include "../util/MemoryTracker.h"
 #include "IdTable.h"
 
 using std::array;
@@ -63,7 +65,10 @@ class ResultTable {
   // due to later use.
   // WARNING: Currently only operations that can run after a GroupBy copy
   //          the _localVocab of a subresult.
-  std::shared_ptr<vector<string>> _localVocab;
+  // The vector (but not the strings) is charged to the query of the thread
+  // that created it, see MemoryTracker.h.
+  using LocalVocab = vector<string, ad_utility::TrackingAllocator<string>>;
+  std::shared_ptr<LocalVocab> _localVocab;
 
   ResultTable();
 
@@ -100,6 +105,14 @@ class ResultTable {
     _cond_var.wait(lk, [&] { return _status != ResultTable::IN_PROGRESS; });
   }
 
+  // Returns false if the result is still in progress after the timeout.
+  template <class Rep, class Period>
+  bool awaitFinished(const std::chrono::duration<Rep, Period>& timeout) const {
+    unique_lock<mutex> lk(_cond_var_m);
+    return _cond_var.wait_for(
+        lk, timeout, [&] { return _status != ResultTable::IN_PROGRESS; });
+  }
+
   std::optional<std::string> idToOptionalString(Id id) const {
     if (id < _localVocab->size()) {
       return (*_localVocab)[id];
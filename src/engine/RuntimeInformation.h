@@ -141,6 +141,8 @@ class RuntimeInformation {
 
   void addChild(const RuntimeInformation& r) { _children.push_back(r); }
 
+  void clearChildren() { _children.clear(); }
+
   template <typename T>
   void addDetail(const std::string& key, const T& value) {
     _details[key] = value;
@@ -2,20 +2,42 @@
 // Chair of Algorithms and Data Structures.
 // Author: Björn Buchhold <buchholb>
 
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstring>
+#include <deque>
+#include <fstream>
 #include <nlohmann/json.hpp>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <unistd.h>
 #include <vector>
 
 #include "../parser/ParseException.h"
+#include "../util/HttpRequestParser.h"
 #include "../util/Log.h"
+#include "../util/MemoryTracker.h"
 #include "../util/StringUtils.h"
+#include "./CountAvailablePredicates.h"
 #include "./Server.h"
 #include "QueryPlanner.h"
 
+// _____________________________________________________________________________
+size_t Server::getResidentSetSizeInBytes() {
+  // The second entry of /proc/self/statm is the number of resident pages.
+  std::ifstream statm("/proc/self/statm");
+  size_t totalPages = 0;
+  size_t residentPages = 0;
+  if (!(statm >> totalPages >> residentPages)) {
+    return 0;
+  }
+  return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
 // _____________________________________________________________________________
 Server::~Server() {
   if (_initialized) {
@@ -25,17 +47,25 @@ Server::~Server() {
 
 // _____________________________________________________________________________
 void Server::initialize(const string& ontologyBaseName, bool useText,
-                        bool usePatterns, bool usePatternTrick) {
+                        bool usePatterns, bool usePatternTrick,
+                        bool onDiskVocabulary) {
   LOG(INFO) << "Initializing server..." << std::endl;
+  ad_utility::Timer timer;
+  timer.start();
 
   _enablePatternTrick = usePatternTrick;
   _index.setUsePatterns(usePatterns);
+  _index.setOnDiskVocabulary(onDiskVocabulary);
 
   // Init the index.
   _index.createFromOnDiskIndex(ontologyBaseName);
   if (useText) {
     _index.addTextFromOnDiskIndex();
   }
+  timer.stop();
+  LOG(INFO) << "Loaded the index in " << timer.msecs() << " ms, resident set "
+            << "size is now " << getResidentSetSizeInBytes() / (1024 * 1024)
+            << " MB" << std::endl;
 
   // Init the server socket.
   bool ret = _serverSocket.create() && _serverSocket.bind(_port) &&
@@ -51,55 +81,367 @@ void Server::initialize(const string& ontologyBaseName, bool useText,
   LOG(INFO) << "Done initializing server." << std::endl;
 }
 
+// _____________________________________________________________________________
+struct Server::Connection {
+  int _fd;
+  uint64_t _id;
+  ad_utility::HttpRequestParser _parser;
+  // The responses to all requests that have not been sent completely yet, in
+  // the order of the requests. They are written by the workers.
+  std::deque<std::shared_ptr<ad_utility::HttpResponseStream>> _responses;
+  // Data that is ready to be sent, starting at _outOffset.
+  string _outBuffer;
+  size_t _outOffset = 0;
+  // Set if a request asked to close the connection or could not be parsed.
+  // Later requests are ignored.
+  bool _ignoreFurtherRequests = false;
+  // Set if the client has closed its side of the connection.
+  bool _readClosed = false;
+  // The events we are currently registered for at the epoll instance.
+  uint32_t _epollEvents = EPOLLIN;
+  std::chrono::steady_clock::time_point _lastActivity;
+  // The last time data was sent or _outBuffer was refilled. A client that
+  // does not read its responses is detected by this.
+  std::chrono::steady_clock::time_point _lastSendProgress;
+};
+
+namespace {
+// The maximal number of events handled by one call to epoll_wait.
+constexpr int MAX_EPOLL_EVENTS = 64;
+// The timeout of epoll_wait, idle connections are checked this often.
+constexpr int EPOLL_TIMEOUT_MILLISECONDS = 1000;
+constexpr size_t READ_BUFFER_SIZE = 1 << 16;
+
+// (Re-)register fd with the epoll instance.
+void registerFd(int epollFd, int fd, uint32_t events, bool modify) {
+  epoll_event event{};
+  event.events = events;
+  event.data.fd = fd;
+  if (epoll_ctl(epollFd, modify ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event) <
+      0) {
+    LOG(ERROR) << "epoll_ctl failed: " << std::strerror(errno) << std::endl;
+  }
+}
+}  // namespace
+
 // _____________________________________________________________________________
 void Server::run() {
   if (!_initialized) {
     LOG(ERROR) << "Cannot start an uninitialized server!" << std::endl;
     exit(1);
   }
-  std::vector<std::thread> threads;
-  for (int i = 0; i < _numThreads; ++i) {
-    threads.emplace_back(&Server::runAcceptLoop, this);
+  int epollFd = epoll_create1(0);
+  // Used by the workers to wake up the event loop when a response is ready.
+  int wakeupFd = eventfd(0, EFD_NONBLOCK);
+  if (epollFd < 0 || wakeupFd < 0 || !_serverSocket.setNonBlocking()) {
+    LOG(ERROR) << "Could not set up the event loop: " << std::strerror(errno)
+               << std::endl;
+    exit(1);
   }
-  for (std::thread& worker : threads) {
-    worker.join();
+  registerFd(epollFd, _serverSocket.getFd(), EPOLLIN, false);
+  registerFd(epollFd, wakeupFd, EPOLLIN, false);
+
+  ad_utility::TaskQueue workers(_numThreads, _maxNofQueuedQueries);
+  ReadyQueue ready;
+  ad_utility::HashMap<int, Connection> connections;
+
+  auto closeConnection = [&connections](int fd) {
+    // Workers that still write responses to this connection must not block.
+    for (auto& response : connections[fd]._responses) {
+      response->close();
+    }
+    // Closing the fd also removes it from the epoll instance.
+    ::close(fd);
+    connections.erase(fd);
+  };
+
+  LOG(INFO) << "---------- WAITING FOR QUERIES AT PORT \"" << _port << "\" ("
+            << _numThreads << " worker threads, at most "
+            << _maxNofQueuedQueries << " queued queries) ..." << std::endl;
+  std::array<epoll_event, MAX_EPOLL_EVENTS> events;
+  while (true) {
+    int nofEvents = epoll_wait(epollFd, events.data(), events.size(),
+                               EPOLL_TIMEOUT_MILLISECONDS);
+    if (nofEvents < 0) {
+      if (errno != EINTR) {
+        LOG(ERROR) << "epoll_wait failed: " << std::strerror(errno)
+                   << std::endl;
+      }
+      continue;
+    }
+    for (int i = 0; i < nofEvents; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == _serverSocket.getFd()) {
+        acceptClients(epollFd, &connections);
+        continue;
+      }
+      if (fd == wakeupFd) {
+        eventfd_t dummy;
+        eventfd_read(wakeupFd, &dummy);
+        vector<ReadyResponse> readyResponses;
+        std::swap(readyResponses, *ready.wlock());
+        for (const auto& response : readyResponses) {
+          auto it = connections.find(response._fd);
+          if (it == connections.end() ||
+              it->second._id != response._connectionId) {
+            // The client has closed the connection in the meantime.
+            continue;
+          }
+          Connection& conn = it->second;
+          if (!sendToClient(&conn, epollFd)) {
+            closeConnection(conn._fd);
+          }
+        }
+        continue;
+      }
+      auto it = connections.find(fd);
+      if (it == connections.end()) {
+        continue;
+      }
+      Connection& conn = it->second;
+      conn._lastActivity = std::chrono::steady_clock::now();
+      if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+        closeConnection(fd);
+        continue;
+      }
+      if (events[i].events & EPOLLIN) {
+        readFromClient(&conn, &workers, &ready, wakeupFd);
+      }
+      if (!sendToClient(&conn, epollFd)) {
+        closeConnection(fd);
+      }
+    }
+
+    // Close keep-alive connections that have been idle for too long and
+    // connections whose client does not take the response.
+    auto now = std::chrono::steady_clock::now();
+    vector<int> idle;
+    vector<int> stalled;
+    for (const auto& [fd, conn] : connections) {
+      if (conn._responses.empty() && conn._outBuffer.empty() &&
+          now - conn._lastActivity >
+              std::chrono::seconds(HTTP_KEEP_ALIVE_TIMEOUT_SECONDS)) {
+        idle.push_back(fd);
+      } else if (!conn._outBuffer.empty() &&
+                 now - conn._lastSendProgress >
+                     std::chrono::seconds(HTTP_SEND_TIMEOUT_SECONDS)) {
+        stalled.push_back(fd);
+      }
+    }
+    for (int fd : idle) {
+      LOG(DEBUG) << "Closing idle connection" << std::endl;
+      closeConnection(fd);
+    }
+    for (int fd : stalled) {
+      LOG(INFO) << "Closing connection whose client does not read the response"
+                << std::endl;
+      closeConnection(fd);
+    }
   }
 }
+
 // _____________________________________________________________________________
-void Server::runAcceptLoop() {
-  // Loop and wait for queries. Run forever, for now.
+void Server::acceptClients(int epollFd,
+                           ad_utility::HashMap<int, Connection>* connections) {
+  static uint64_t nextConnectionId = 0;
   while (true) {
-    // Wait for new query
-    LOG(INFO) << "---------- WAITING FOR QUERY AT PORT \"" << _port << "\" ... "
-              << std::endl;
-
-    ad_utility::Socket client;
-    // Concurrent accept used to be problematic because of the Thundering Herd
-    // problem but this should be fixed on modern OSs
-    bool success = _serverSocket.acceptClient(&client);
-    if (!success) {
-      LOG(ERROR) << "Socket error in acceot" << std::strerror(errno)
-                 << std::endl;
+    int fd = accept4(_serverSocket.getFd(), nullptr, nullptr, SOCK_NONBLOCK);
+    if (fd < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        LOG(ERROR) << "Socket error in accept: " << std::strerror(errno)
+                   << std::endl;
+      }
+      return;
+    }
+    int keepAlive = 1;
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &keepAlive, sizeof(keepAlive));
+    LOG(DEBUG) << "Incoming connection" << std::endl;
+    Connection& conn = (*connections)[fd];
+    conn._fd = fd;
+    conn._id = nextConnectionId++;
+    conn._lastActivity = std::chrono::steady_clock::now();
+    registerFd(epollFd, fd, EPOLLIN, false);
+  }
+}
+
+// _____________________________________________________________________________
+void Server::readFromClient(Connection* conn, ad_utility::TaskQueue* workers,
+                            ReadyQueue* ready, int wakeupFd) {
+  std::array<char, READ_BUFFER_SIZE> buffer;
+  while (true) {
+    ssize_t nofBytes = ::recv(conn->_fd, buffer.data(), buffer.size(), 0);
+    if (nofBytes > 0) {
+      // Data after a rejected (e.g. too large) request is never parsed, so
+      // don't buffer it.
+      if (!conn->_ignoreFurtherRequests) {
+        conn->_parser.append(buffer.data(), nofBytes);
+      }
+      continue;
+    }
+    if (nofBytes == 0) {
+      // The client will not send any more requests, but still answer the
+      // ones we already have.
+      conn->_readClosed = true;
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      LOG(WARN) << "Error during recv: " << std::strerror(errno) << std::endl;
+      conn->_readClosed = true;
+    }
+    break;
+  }
+
+  ad_utility::HttpRequest request;
+  while (!conn->_ignoreFurtherRequests) {
+    auto status = conn->_parser.next(&request);
+    if (status == ad_utility::HttpRequestParser::Status::INCOMPLETE) {
+      break;
+    }
+    if (status == ad_utility::HttpRequestParser::Status::INVALID) {
+      auto& response = conn->_responses.emplace_back(
+          std::make_shared<ad_utility::HttpResponseStream>());
+      if (conn->_parser.requestTooLarge()) {
+        LOG(INFO) << "Got too large request, responding with 413 Payload Too "
+                     "Large.\n";
+        response->write(create413HttpResponse(false));
+      } else {
+        LOG(INFO) << "Got invalid request, responding with 400 Bad Request.\n";
+        response->write(create400HttpResponse(false));
+      }
+      response->finish();
+      conn->_ignoreFurtherRequests = true;
+      break;
+    }
+    if (request._httpVersion == "HTTP/1.0" &&
+        needsWorker(request._requestLine)) {
+      // Query results are streamed, without chunked transfer encoding (which
+      // HTTP/1.0 does not support) the end of the connection ends the body.
+      request._keepAlive = false;
+    }
+    // Requests after a "Connection: close" are ignored.
+    conn->_ignoreFurtherRequests = !request._keepAlive;
+    LOG(DEBUG) << "Got request from client with size: "
+               << request._requestLine.size()
+               << " and headers with total size: " << request._headers.size()
+               << endl;
+    if (!needsWorker(request._requestLine)) {
+      // The response is complete before it is sent, so it must not be
+      // limited in size.
+      auto& response = conn->_responses.emplace_back(
+          std::make_shared<ad_utility::HttpResponseStream>());
+      process(request, response.get());
+      response->finish();
       continue;
     }
-    client.setKeepAlive(true);
-    LOG(INFO) << "Incoming connection, processing..." << std::endl;
-    process(&client);
-    client.close();
+    auto notify = [ready, wakeupFd, fd = conn->_fd, id = conn->_id]() {
+      ready->wlock()->push_back({fd, id});
+      eventfd_write(wakeupFd, 1);
+    };
+    auto& response = conn->_responses.emplace_back(
+        std::make_shared<ad_utility::HttpResponseStream>(
+            HTTP_MAX_BUFFERED_RESPONSE_BYTES, std::move(notify)));
+    bool queued = workers->push([this, response, request]() {
+      process(request, response.get());
+      response->finish();
+    });
+    if (!queued) {
+      LOG(WARN) << "Too many queued queries, responding with 503 Service "
+                   "Unavailable."
+                << std::endl;
+      response->write(create503HttpResponse(request._keepAlive));
+      response->finish();
+    }
+  }
+}
+
+// _____________________________________________________________________________
+bool Server::sendToClient(Connection* conn, int epollFd) {
+  using Status = ad_utility::HttpResponseStream::Status;
+  while (true) {
+    if (conn->_outOffset == conn->_outBuffer.size()) {
+      conn->_outBuffer.clear();
+      conn->_outOffset = 0;
+      // Only take more data when everything else has been sent. This way a
+      // slow client blocks the worker that writes its response instead of
+      // making us buffer all of it.
+      while (!conn->_responses.empty()) {
+        auto status =
+            conn->_responses.front()->takeAvailable(&conn->_outBuffer);
+        if (status == Status::PENDING) {
+          break;
+        }
+        conn->_responses.pop_front();
+        if (status == Status::ABORTED) {
+          // The client can only detect the incomplete response if we close
+          // the connection after it.
+          for (auto& response : conn->_responses) {
+            response->close();
+          }
+          conn->_responses.clear();
+          conn->_ignoreFurtherRequests = true;
+        }
+      }
+      conn->_lastSendProgress = std::chrono::steady_clock::now();
+    }
+    if (conn->_outOffset == conn->_outBuffer.size()) {
+      break;
+    }
+    ssize_t nofBytes =
+        ::send(conn->_fd, conn->_outBuffer.data() + conn->_outOffset,
+               conn->_outBuffer.size() - conn->_outOffset, MSG_NOSIGNAL);
+    if (nofBytes < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      LOG(DEBUG) << "Error during send: " << std::strerror(errno) << std::endl;
+      return false;
+    }
+    LOG(DEBUG) << "Sent " << nofBytes << " bytes." << std::endl;
+    conn->_outOffset += nofBytes;
+    conn->_lastSendProgress = std::chrono::steady_clock::now();
+  }
+  bool allSent = conn->_outOffset == conn->_outBuffer.size();
+  if (allSent) {
+    conn->_outBuffer.clear();
+    conn->_outOffset = 0;
+  }
+  bool closeAfterResponses =
+      conn->_ignoreFurtherRequests || conn->_readClosed;
+  if (allSent && conn->_responses.empty() && closeAfterResponses) {
+    return false;
   }
+  // Only wait for the socket to become readable (writable) while we still
+  // expect (have) data, otherwise epoll would report it all the time.
+  uint32_t events = 0;
+  if (!conn->_readClosed) {
+    events |= EPOLLIN;
+  }
+  if (!allSent) {
+    events |= EPOLLOUT;
+  }
+  if (events != conn->_epollEvents) {
+    conn->_epollEvents = events;
+    registerFd(epollFd, conn->_fd, events, true);
+  }
+  return true;
 }
 
 // _____________________________________________________________________________
-void Server::process(Socket* client) {
+bool Server::needsWorker(const string& requestLine) {
+  // Only the computation of queries can take long, the other commands (stats,
+  // static files, errors) are answered directly by the event loop.
+  size_t indexOfHTTP = requestLine.find("HTTP");
+  size_t indexOfQuery = requestLine.find("query=");
+  return indexOfQuery != string::npos && indexOfQuery < indexOfHTTP;
+}
+
+// _____________________________________________________________________________
+void Server::process(const ad_utility::HttpRequest& httpRequest,
+                     ad_utility::HttpResponseStream* response) {
+  const string& request = httpRequest._requestLine;
+  const bool keepAlive = httpRequest._keepAlive;
   string contentType;
-  LOG(DEBUG) << "Waiting for receive call to complete." << endl;
-  string request;
-  string response;
-  string headers;
   string query;
-  client->getHTTPRequest(request, headers);
-  LOG(DEBUG) << "Got request from client with size: " << request.size()
-             << " and headers with total size: " << headers.size() << endl;
+  string errorResponse;
+  bool headerSent = false;
 
   size_t indexOfGET = request.find("GET");
   size_t indexOfHTTP = request.find("HTTP");
@@ -121,14 +463,12 @@ void Server::process(Socket* client) {
     if (file.size() > 0) {
       LOG(DEBUG) << "file: " << file << '\n';
       if (file == "index.html" || file == "style.css" || file == "script.js") {
-        serveFile(client, file);
-        return;
+        response->write(serveFile(file, keepAlive));
       } else {
         LOG(INFO) << "Responding with 404 for file " << file << '\n';
-        auto bytesSent = client->send(create404HttpResponse());
-        LOG(DEBUG) << "Sent " << bytesSent << " bytes." << std::endl;
-        return;
+        response->write(create404HttpResponse(keepAlive));
       }
+      return;
     }
 
     try {
@@ -138,10 +478,7 @@ void Server::process(Socket* client) {
         LOG(INFO) << "Supplying index stats..." << std::endl;
         auto statsJson = composeStatsJson();
         contentType = "application/json";
-        string httpResponse = createHttpResponse(statsJson, contentType);
-        auto bytesSent = client->send(httpResponse);
-        LOG(DEBUG) << "Sent " << bytesSent << " bytes." << std::endl;
-        LOG(INFO) << "Sent stats to client." << std::endl;
+        response->write(createHttpResponse(statsJson, contentType, keepAlive));
         return;
       }
 
@@ -149,10 +486,17 @@ void Server::process(Socket* client) {
         LOG(INFO) << "Supplying cache stats..." << std::endl;
         auto statsJson = composeCacheStatsJson();
         contentType = "application/json";
-        string httpResponse = createHttpResponse(statsJson.dump(), contentType);
-        auto bytesSent = client->send(httpResponse);
-        LOG(DEBUG) << "Sent " << bytesSent << " bytes." << std::endl;
-        LOG(INFO) << "Sent cache stats to client." << std::endl;
+        response->write(
+            createHttpResponse(statsJson.dump(), contentType, keepAlive));
+        return;
+      }
+
+      if (ad_utility::getLowercase(params["cmd"]) == "patterntrickstats") {
+        LOG(INFO) << "Supplying pattern trick stats..." << std::endl;
+        auto statsJson = composePatternTrickStatsJson();
+        contentType = "application/json";
+        response->write(
+            createHttpResponse(statsJson.dump(), contentType, keepAlive));
         return;
       }
 
@@ -186,50 +530,113 @@ void Server::process(Socket* client) {
       LOG(INFO) << "Query" << ((pinSubtrees) ? " (Cache pinned)" : "")
                 << ((pinResult) ? " (Result pinned)" : "") << ": " << query
                 << '\n';
-      ParsedQuery pq = SparqlParser(query).parse();
-      pq.expandPrefixes();
+      ParsedQuery parsedQuery = SparqlParser(query).parse();
+      parsedQuery.expandPrefixes();
 
+      // The operations check whether the query has timed out and abort it.
+      ad_utility::CancellationHandle::Scope cancellationScope(
+          createCancellationHandle(params));
+      // The IdTables, local vocabularies and hash tables that this thread
+      // allocates for the query are charged to its memory tracker. If the
+      // limit is exceeded, the operation that allocates is aborted.
+      auto memoryTracker =
+          std::make_shared<ad_utility::MemoryTracker>(_memoryLimit);
+      ad_utility::MemoryTracker::Scope memoryTrackerScope(memoryTracker);
       QueryExecutionContext qec(_index, _engine, &_cache, &_pinnedSizes,
                                 pinSubtrees, pinResult);
-      QueryPlanner qp(&qec);
-      qp.setEnablePatternTrick(_enablePatternTrick);
-      QueryExecutionTree qet = qp.createExecutionTree(pq);
-      qet.isRoot() = true;  // allow pinning of the final result
-      LOG(TRACE) << qet.asString() << std::endl;
-
-      if (ad_utility::getLowercase(params["action"]) == "csv_export") {
-        // CSV export
-        response = composeResponseSepValues(pq, qet, ',');
+      qec.setSortMemoryLimit(_sortMemoryLimit);
+      qec.setObservedSizes(&_observedSizes);
+      // Pinned subtrees are planned once, all of them are cached.
+      qec.setMaxNofReplans(pinSubtrees ? 0 : MAX_NOF_REPLANS_PER_QUERY);
+      // The planner modifies the query (e.g. for the pattern trick), so each
+      // plan starts from a copy.
+      ParsedQuery pq;
+      QueryExecutionTree qet(&qec);
+      while (true) {
+        pq = parsedQuery;
+        QueryPlanner qp(&qec);
+        qp.setEnablePatternTrick(_enablePatternTrick);
+        qet = qp.createExecutionTree(pq);
+        qet.isRoot() = true;  // allow pinning of the final result
+        if (!pq._limit.empty() && !pinResult) {
+          // Only compute the rows that are sent (if the root operation
+          // supports lazy evaluation), the reported result size is then only
+          // a lower bound (see "resultsizeIsLowerBound" in the json).
+          size_t rowLimit = static_cast<size_t>(atol(pq._limit.c_str()));
+          if (!pq._offset.empty()) {
+            rowLimit += static_cast<size_t>(atol(pq._offset.c_str()));
+          }
+          qet.setRowLimit(rowLimit);
+        }
+        LOG(TRACE) << qet.asString() << std::endl;
+
+        // Compute the result before the header is sent, errors can then still
+        // be reported with an error response. If a size estimate was far off,
+        // the query is planned again with the sizes of the computed subtrees
+        // (which are cached).
+        try {
+          qet.getResult();
+          break;
+        } catch (const ReplanQueryException& e) {
+          LOG(INFO) << e.what() << std::endl;
+        }
+      }
+      auto& runtimeInfo = qet.getRootOperation()->getRuntimeInfo();
+      runtimeInfo.addDetail("memory_current_bytes",
+                            memoryTracker->currentBytes());
+      runtimeInfo.addDetail("memory_peak_bytes", memoryTracker->peakBytes());
+      const string action = ad_utility::getLowercase(params["action"]);
+      if (action == "csv_export") {
         contentType =
             "text/csv\r\n"
             "Content-Disposition: attachment;filename=export.csv";
-      } else if (ad_utility::getLowercase(params["action"]) == "tsv_export") {
-        // TSV export
-        response = composeResponseSepValues(pq, qet, '\t');
+      } else if (action == "tsv_export") {
         contentType =
             "text/tab-separated-values\r\n"
             "Content-Disposition: attachment;filename=export.tsv";
       } else {
-        // Normal case: JSON response
-        response = composeResponseJson(pq, qet, maxSend);
         contentType = "application/json";
       }
+      headerSent = true;
+      const bool chunked = httpRequest._httpVersion != "HTTP/1.0";
+      if (response->write(createStreamedHttpResponseHeader(
+              contentType, keepAlive, chunked))) {
+        ad_utility::HttpBodyStreamBuf bodyBuf(response, chunked);
+        std::ostream body(&bodyBuf);
+        if (action == "csv_export") {
+          composeResponseSepValues(pq, qet, ',', body);
+        } else if (action == "tsv_export") {
+          composeResponseSepValues(pq, qet, '\t', body);
+        } else {
+          composeResponseJson(pq, qet, body, maxSend);
+        }
+        if (!bodyBuf.finish()) {
+          LOG(INFO) << "The client has closed the connection before the "
+                       "result was sent completely."
+                    << std::endl;
+        }
+      }
       // Print the runtime info. This needs to be done after the query
       // was computed.
       LOG(INFO) << '\n' << qet.getRootOperation()->getRuntimeInfo().toString();
+      return;
     } catch (const ad_semsearch::Exception& e) {
-      response = composeResponseJson(query, e);
+      errorResponse = composeResponseJson(query, e);
     } catch (const std::exception& e) {
-      response = composeResponseJson(query, &e);
+      errorResponse = composeResponseJson(query, &e);
+    }
+    if (headerSent) {
+      // Part of the result may have been sent already.
+      LOG(ERROR) << "Error while sending the result: " << errorResponse
+                 << std::endl;
+      response->abort();
+      return;
     }
-    string httpResponse = createHttpResponse(response, contentType);
-    auto bytesSent = client->send(httpResponse);
-    LOG(DEBUG) << "Sent " << bytesSent << " bytes." << std::endl;
+    response->write(createHttpResponse(errorResponse, contentType, keepAlive));
   } else {
     LOG(INFO) << "Got invalid request " << request << '\n';
     LOG(INFO) << "Responding with 400 Bad Request.\n";
-    auto bytesSent = client->send(create400HttpResponse());
-    LOG(DEBUG) << "Sent " << bytesSent << " bytes." << std::endl;
+    response->write(create400HttpResponse(keepAlive));
   }
 }
 
@@ -309,13 +716,48 @@ string Server::createQueryFromHttpParams(const ParamValueMap& params) const {
   return it->second;
 }
 
+// _____________________________________________________________________________
+std::shared_ptr<ad_utility::CancellationHandle>
+Server::createCancellationHandle(const ParamValueMap& params) const {
+  auto it = params.find("timeout");
+  if (it == params.end() || it->second.empty()) {
+    if (_queryTimeoutSeconds == 0) {
+      return std::make_shared<ad_utility::CancellationHandle>();
+    }
+    return std::make_shared<ad_utility::CancellationHandle>(
+        std::chrono::seconds(_queryTimeoutSeconds));
+  }
+  double timeoutSeconds = 0;
+  try {
+    size_t end;
+    timeoutSeconds = std::stod(it->second, &end);
+    if (end != it->second.size()) {
+      timeoutSeconds = 0;
+    }
+  } catch (const std::exception& e) {
+    timeoutSeconds = 0;
+  }
+  if (!(timeoutSeconds > 0)) {
+    AD_THROW(ad_semsearch::Exception::BAD_REQUEST,
+             "The timeout must be a positive number of seconds, but is \"" +
+                 it->second + "\".");
+  }
+  // Larger timeouts would overflow the deadline, they are not needed anyway.
+  timeoutSeconds = std::min(timeoutSeconds, 1e9);
+  using Clock = ad_utility::CancellationHandle::Clock;
+  return std::make_shared<ad_utility::CancellationHandle>(
+      std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(timeoutSeconds)));
+}
+
 // _____________________________________________________________________________
 string Server::createHttpResponse(const string& content,
-                                  const string& contentType) const {
+                                  const string& contentType,
+                                  bool keepAlive) const {
   std::ostringstream os;
   os << "HTTP/1.1 200 OK\r\n"
      << "Content-Length: " << content.size() << "\r\n"
-     << "Connection: close\r\n"
+     << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n"
      << "Content-Type: " << contentType << "; charset="
      << "utf-8"
      << "\r\n"
@@ -327,46 +769,90 @@ string Server::createHttpResponse(const string& content,
 }
 
 // _____________________________________________________________________________
-string Server::create404HttpResponse() const {
+string Server::createStreamedHttpResponseHeader(const string& contentType,
+                                                bool keepAlive,
+                                                bool chunked) const {
+  std::ostringstream os;
+  os << "HTTP/1.1 200 OK\r\n";
+  if (chunked) {
+    os << "Transfer-Encoding: chunked\r\n";
+  }
+  os << "Connection: " << (keepAlive && chunked ? "keep-alive" : "close")
+     << "\r\n"
+     << "Content-Type: " << contentType << "; charset="
+     << "utf-8"
+     << "\r\n"
+     << "Access-Control-Allow-Origin: *"
+     << "\r\n"
+     << "\r\n";
+  return os.str();
+}
+
+// _____________________________________________________________________________
+string Server::create404HttpResponse(bool keepAlive) const {
   std::ostringstream os;
   os << "HTTP/1.1 404 Not Found\r\n"
      << "Content-Length: 0\r\n"
-     << "Connection: close\r\n"
+     << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n"
      << "\r\n";
   return os.str();
 }
 
 // _____________________________________________________________________________
-string Server::create400HttpResponse() const {
+string Server::create400HttpResponse(bool keepAlive) const {
   std::ostringstream os;
   os << "HTTP/1.1 400 Bad Request\r\n"
      << "Content-Length: 0\r\n"
-     << "Connection: close\r\n"
+     << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n"
+     << "\r\n";
+  return os.str();
+}
+
+// _____________________________________________________________________________
+string Server::create413HttpResponse(bool keepAlive) const {
+  std::ostringstream os;
+  os << "HTTP/1.1 413 Payload Too Large\r\n"
+     << "Content-Length: 0\r\n"
+     << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n"
+     << "\r\n";
+  return os.str();
+}
+
+// _____________________________________________________________________________
+string Server::create503HttpResponse(bool keepAlive) const {
+  std::ostringstream os;
+  os << "HTTP/1.1 503 Service Unavailable\r\n"
+     << "Content-Length: 0\r\n"
+     << "Retry-After: 1\r\n"
+     << "Access-Control-Allow-Origin: *\r\n"
+     << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n"
      << "\r\n";
   return os.str();
 }
 
 // _____________________________________________________________________________
-string Server::composeResponseJson(const ParsedQuery& query,
-                                   const QueryExecutionTree& qet,
-                                   size_t maxSend) const {
-  // TODO(schnelle) we really should use a json library
-  // such as https://github.com/nlohmann/json
+void Server::composeResponseJson(const ParsedQuery& query,
+                                 const QueryExecutionTree& qet,
+                                 std::ostream& out, size_t maxSend) const {
   shared_ptr<const ResultTable> rt = qet.getResult();
   _requestProcessingTimer.stop();
   off_t compResultUsecs = _requestProcessingTimer.usecs();
   size_t resultSize = rt->size();
 
-  nlohmann::json j;
-
-  j["query"] = query._originalString;
-  j["status"] = "OK";
-  j["resultsize"] = resultSize;
-  j["warnings"] = qet.collectWarnings();
-  j["selected"] = query._selectedVariables;
-
-  j["runtimeInformation"] = RuntimeInformation::ordered_json(
-      qet.getRootOperation()->getRuntimeInfo());
+  // The (potentially large) result is written directly to out, so the json
+  // object is written by hand, without indentation. Everything but "res" is
+  // small and dumped by nlohmann::json.
+  out << "{\"query\":" << nlohmann::json(query._originalString).dump()
+      << ",\"status\":\"OK\""
+      << ",\"resultsize\":" << resultSize
+      << ",\"resultsizeIsLowerBound\":"
+      << (qet.resultSizeIsLowerBound() ? "true" : "false")
+      << ",\"warnings\":" << nlohmann::json(qet.collectWarnings()).dump()
+      << ",\"selected\":" << nlohmann::json(query._selectedVariables).dump()
+      << ",\"runtimeInformation\":"
+      << RuntimeInformation::ordered_json(
+             qet.getRootOperation()->getRuntimeInfo())
+             .dump();
 
   {
     size_t limit = MAX_NOF_ROWS_IN_RESULT;
@@ -378,23 +864,23 @@ string Server::composeResponseJson(const ParsedQuery& query,
       offset = static_cast<size_t>(atol(query._offset.c_str()));
     }
     _requestProcessingTimer.cont();
-    j["res"] = qet.writeResultAsJson(query._selectedVariables,
-                                     std::min(limit, maxSend), offset);
+    out << ",\"res\":";
+    qet.writeResultAsJson(out, query._selectedVariables,
+                          std::min(limit, maxSend), offset);
     _requestProcessingTimer.stop();
   }
 
-  j["time"]["total"] =
+  nlohmann::json time;
+  time["total"] =
       std::to_string(_requestProcessingTimer.usecs() / 1000.0) + "ms";
-  j["time"]["computeResult"] = std::to_string(compResultUsecs / 1000.0) + "ms";
-
-  return j.dump(4);
+  time["computeResult"] = std::to_string(compResultUsecs / 1000.0) + "ms";
+  out << ",\"time\":" << time.dump() << '}';
 }
 
 // _____________________________________________________________________________
-string Server::composeResponseSepValues(const ParsedQuery& query,
-                                        const QueryExecutionTree& qet,
-                                        char sep) const {
-  std::ostringstream os;
+void Server::composeResponseSepValues(const ParsedQuery& query,
+                                      const QueryExecutionTree& qet, char sep,
+                                      std::ostream& out) const {
   size_t limit = std::numeric_limits<size_t>::max();
   size_t offset = 0;
   if (query._limit.size() > 0) {
@@ -403,9 +889,7 @@ string Server::composeResponseSepValues(const ParsedQuery& query,
   if (query._offset.size() > 0) {
     offset = static_cast<size_t>(atol(query._offset.c_str()));
   }
-  qet.writeResultToStream(os, query._selectedVariables, limit, offset, sep);
-
-  return os.str();
+  qet.writeResultToStream(out, query._selectedVariables, limit, offset, sep);
 }
 
 // _____________________________________________________________________________
@@ -456,16 +940,16 @@ string Server::composeResponseJson(const string& query,
 }
 
 // _____________________________________________________________________________
-void Server::serveFile(Socket* client, const string& requestedFile) const {
+string Server::serveFile(const string& requestedFile, bool keepAlive) const {
   string contentString;
   string contentType = "text/plain";
-  string statusString = "HTTP/1.0 200 OK";
+  string statusString = "HTTP/1.1 200 OK";
 
   // CASE: file.
   LOG(DEBUG) << "Looking for file: \"" << requestedFile << "\" ... \n";
   std::ifstream in(requestedFile.c_str());
   if (!in) {
-    statusString = "HTTP/1.0 404 NOT FOUND";
+    statusString = "HTTP/1.1 404 NOT FOUND";
     contentString = "404 NOT FOUND";
   } else {
     // File into string
@@ -488,12 +972,13 @@ void Server::serveFile(Socket* client, const string& requestedFile) const {
                << "Content-Length: " << contentLength << "\r\n"
                << "Content-Type: " << contentType << "\r\n"
                << "Access-Control-Allow-Origin: *\r\n"
-               << "Connection: close\r\n"
+               << "Connection: " << (keepAlive ? "keep-alive" : "close")
+               << "\r\n"
                << "\r\n";
 
   string data = headerStream.str();
   data += contentString;
-  client->send(data);
+  return data;
 }
 
 // _____________________________________________________________________________
@@ -513,7 +998,12 @@ string Server::composeStatsJson() const {
      << "\"textindex\": \"" << _index.getTextName() << "\",\n"
      << "\"nofrecords\": \"" << _index.getNofTextRecords() << "\",\n"
      << "\"nofwordpostings\": \"" << _index.getNofWordPostings() << "\",\n"
-     << "\"nofentitypostings\": \"" << _index.getNofEntityPostings() << "\"\n"
+     << "\"nofentitypostings\": \"" << _index.getNofEntityPostings()
+     << "\",\n";
+  // The memory of all tracked allocations (including the cached results).
+  const auto& memoryTracker = ad_utility::MemoryTracker::global();
+  os << "\"memory-allocated\": \"" << memoryTracker.currentBytes() << "\",\n"
+     << "\"memory-peak-allocated\": \"" << memoryTracker.peakBytes() << "\"\n"
      << "}\n";
   return os.str();
 }
@@ -526,5 +1016,34 @@ nlohmann::json Server::composeCacheStatsJson() const {
   result["cached-size"] = _cache.cachedSize();
   result["pinned-size"] = _cache.pinnedSize();
   result["num-pinned-index-scan-sizes"] = _pinnedSizes.rlock()->size();
+  // The sizes are in bytes.
+  result["max-size"] = _cache.getMaxSize();
+  result["max-size-single-entry"] = _cache.getMaxSizeSingleEntry();
+  size_t numHits = _cache.numHits();
+  size_t numMisses = _cache.numMisses();
+  result["num-hits"] = numHits;
+  result["num-misses"] = numMisses;
+  result["hit-rate"] =
+      numHits + numMisses > 0
+          ? static_cast<double>(numHits) / (numHits + numMisses)
+          : 0.0;
+  result["num-evictions"] = _cache.numEvictions();
+  // The memory of all tracked allocations (including the cached results).
+  const auto& memoryTracker = ad_utility::MemoryTracker::global();
+  result["memory-allocated"] = memoryTracker.currentBytes();
+  result["memory-peak-allocated"] = memoryTracker.peakBytes();
+  return result;
+}
+
+// _____________________________________________________________________________
+nlohmann::json Server::composePatternTrickStatsJson() const {
+  nlohmann::json result;
+  const PatternTrickTables& tables = _index.getPatternTrickTables();
+  result["has-all-entities-table"] = tables.getAllEntities() != nullptr;
+  result["num-type-tables"] = tables.getNofTypes();
+  result["num-precomputed-results"] =
+      CountAvailablePredicates::getNofPrecomputedResults();
+  result["num-computed-results"] =
+      CountAvailablePredicates::getNofComputedResults();
   return result;
 }
@@ -11,7 +11,12 @@
 #include "../index/Index.h"
 #include "../parser/ParseException.h"
 #include "../parser/SparqlParser.h"
+#include "../util/CancellationHandle.h"
+#include "../util/HashMap.h"
+#include "../util/HttpResponseStream.h"
 #include "../util/Socket.h"
+#include "../util/Synchronized.h"
+#include "../util/TaskQueue.h"
 #include "../util/Timer.h"
 #include "./QueryExecutionContext.h"
 #include "./QueryExecutionTree.h"
@@ -23,15 +28,44 @@ using ad_utility::Socket;
 
 //! The HTTP Sever used.
 class Server {
+  // The state of one client connection, defined in Server.cpp.
+  struct Connection;
+  // A worker thread has written data of a response to this connection (or
+  // completed the response).
+  struct ReadyResponse {
+    int _fd;
+    // the fd of a closed connection may be reused, so also store the id.
+    uint64_t _connectionId;
+  };
+  using ReadyQueue =
+      ad_utility::Synchronized<vector<ReadyResponse>, std::mutex>;
+
  public:
-  explicit Server(const int port, const int numThreads)
+  explicit Server(const int port, const int numThreads,
+                  size_t maxNofQueuedQueries = DEFAULT_MAX_NOF_QUEUED_QUERIES,
+                  size_t cacheMaxNumEntries = NOF_SUBTREES_TO_CACHE,
+                  size_t cacheMaxSizeGB = DEFAULT_CACHE_MAX_SIZE_GB,
+                  size_t cacheMaxSizeSingleEntryGB =
+                      DEFAULT_CACHE_MAX_SIZE_SINGLE_ENTRY_GB,
+                  size_t sortMemoryLimitGB =
+                      DEFAULT_SORT_MEMORY_LIMIT_PER_QUERY_GB,
+                  size_t memoryLimitGB = DEFAULT_MEMORY_LIMIT_PER_QUERY_GB,
+                  size_t queryTimeoutSeconds = DEFAULT_QUERY_TIMEOUT_SECONDS)
       : _numThreads(numThreads),
+        _maxNofQueuedQueries(maxNofQueuedQueries),
+        _sortMemoryLimit(sortMemoryLimitGB * (1ull << 30)),
+        _memoryLimit(memoryLimitGB * (1ull << 30)),
+        _queryTimeoutSeconds(queryTimeoutSeconds),
         _serverSocket(),
         _port(port),
-        _cache(NOF_SUBTREES_TO_CACHE),
+        _cache(cacheMaxNumEntries),
+        _observedSizes(NOF_OBSERVED_SIZES_TO_KEEP),
         _index(),
         _engine(),
-        _initialized(false) {}
+        _initialized(false) {
+    _cache.setMaxSize(cacheMaxSizeGB * (1ull << 30));
+    _cache.setMaxSizeSingleEntry(cacheMaxSizeSingleEntryGB * (1ull << 30));
+  }
 
   virtual ~Server();
 
@@ -39,47 +73,97 @@ class Server {
 
   // Initialize the server.
   void initialize(const string& ontologyBaseName, bool useText,
-                  bool usePatterns = true, bool usePatternTrick = true);
+                  bool usePatterns = true, bool usePatternTrick = true,
+                  bool onDiskVocabulary = false);
 
   //! Loop, wait for requests and trigger processing. This method never returns
   //! except when throwing an exceptiob
+  //! All connections are handled by a single event loop (epoll) that
+  //! supports HTTP/1.1 keep-alive and pipelining. Queries are computed by
+  //! _numThreads worker threads, at most _maxNofQueuedQueries queries wait for
+  //! a free worker, further queries are answered with 503.
   void run();
 
  private:
   const int _numThreads;
+  const size_t _maxNofQueuedQueries;
+  const size_t _sortMemoryLimit;
+  // The memory that the tracked allocations of a single query may use.
+  const size_t _memoryLimit;
+  // The timeout of queries without the HTTP parameter "timeout", 0 means no
+  // timeout.
+  const size_t _queryTimeoutSeconds;
   Socket _serverSocket;
   int _port;
   SubtreeCache _cache;
   PinnedSizes _pinnedSizes;
+  ObservedSizes _observedSizes;
   Index _index;
   Engine _engine;
 
   bool _initialized;
   bool _enablePatternTrick;
 
-  void runAcceptLoop();
+  // Accept all pending connections on the (non-blocking) server socket.
+  void acceptClients(int epollFd, ad_utility::HashMap<int, Connection>* conns);
+
+  // Read from a client, split the data into requests and answer them (cheap
+  // requests directly, queries via the workers).
+  void readFromClient(Connection* conn, ad_utility::TaskQueue* workers,
+                      ReadyQueue* ready, int wakeupFd);
+
+  // Move the available data of the responses of conn (in the order of the
+  // requests) to its output buffer and send as much as possible. Returns
+  // false iff the connection has to be closed.
+  bool sendToClient(Connection* conn, int epollFd);
+
+  // true iff the request has to be processed by one of the worker threads.
+  static bool needsWorker(const string& requestLine);
 
-  void process(Socket* client);
+  // The current resident set size of this process (0 if it can not be
+  // determined).
+  static size_t getResidentSetSizeInBytes();
 
-  void serveFile(Socket* client, const string& requestedFile) const;
+  // Process a single request and write the HTTP response to the stream.
+  // Query results are written while they are converted to strings, with
+  // chunked transfer encoding (HTTP/1.1) or as a body that ends with the
+  // connection (HTTP/1.0, then httpRequest._keepAlive must be false). Does not
+  // finish the stream.
+  void process(const ad_utility::HttpRequest& httpRequest,
+               ad_utility::HttpResponseStream* response);
+
+  string serveFile(const string& requestedFile, bool keepAlive) const;
 
   ParamValueMap parseHttpRequest(const string& request) const;
 
   string createQueryFromHttpParams(const ParamValueMap& params) const;
 
-  string createHttpResponse(const string& content,
-                            const string& contentType) const;
+  // The handle that cancels the query when its timeout (in seconds, from the
+  // parameter "timeout" or the default of the server) has passed.
+  std::shared_ptr<ad_utility::CancellationHandle> createCancellationHandle(
+      const ParamValueMap& params) const;
+
+  string createHttpResponse(const string& content, const string& contentType,
+                            bool keepAlive) const;
 
-  string create404HttpResponse() const;
-  string create400HttpResponse() const;
+  // The status line and headers of a response whose body follows with
+  // chunked transfer encoding, or without (then the connection is closed after
+  // the body).
+  string createStreamedHttpResponseHeader(const string& contentType,
+                                          bool keepAlive, bool chunked) const;
 
-  string composeResponseJson(const ParsedQuery& query,
-                             const QueryExecutionTree& qet,
-                             size_t sendMax = MAX_NOF_ROWS_IN_RESULT) const;
+  string create404HttpResponse(bool keepAlive) const;
+  string create400HttpResponse(bool keepAlive) const;
+  string create413HttpResponse(bool keepAlive) const;
+  string create503HttpResponse(bool keepAlive) const;
 
-  string composeResponseSepValues(const ParsedQuery& query,
-                                  const QueryExecutionTree& qet,
-                                  char sep) const;
+  void composeResponseJson(const ParsedQuery& query,
+                           const QueryExecutionTree& qet, std::ostream& out,
+                           size_t sendMax = MAX_NOF_ROWS_IN_RESULT) const;
+
+  void composeResponseSepValues(const ParsedQuery& query,
+                                const QueryExecutionTree& qet, char sep,
+                                std::ostream& out) const;
 
   string composeResponseJson(const string& query,
                              const ad_semsearch::Exception& e) const;
@@ -92,4 +176,8 @@ class Server {
   mutable ad_utility::Timer _requestProcessingTimer;
 
   json composeCacheStatsJson() const;
+
+  // The pattern trick tables of the index and how many pattern trick results
+  // were taken from them.
+  json composePatternTrickStatsJson() const;
 };
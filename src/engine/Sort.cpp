@@ -5,6 +5,7 @@
 #include "./Sort.h"
 #include <sstream>
 #include "CallFixedSize.h"
+#include "ExternalSort.h"
 #include "QueryExecutionTree.h"
 
 using std::string;
@@ -50,22 +51,28 @@ string Sort::getDescriptor() const {
 // _____________________________________________________________________________
 void Sort::computeResult(ResultTable* result) {
   LOG(DEBUG) << "Getting sub-result for Sort result computation..." << endl;
-  shared_ptr<const ResultTable> subRes = _subtree->getResult();
-
-  RuntimeInformation& runtimeInfo = getRuntimeInfo();
-  runtimeInfo.addChild(_subtree->getRootOperation()->getRuntimeInfo());
+  // The input is read lazily if possible, such that it is never in memory
+  // at the same time as the sorted result (see externalSort).
+  std::unique_ptr<LazyResult> subRes = _subtree->getLazyResult();
 
   LOG(DEBUG) << "Sort result computation..." << endl;
-  result->_data.setCols(subRes->_data.cols());
+  result->_data.setCols(subRes->width());
   result->_resultTypes.insert(result->_resultTypes.end(),
                               subRes->_resultTypes.begin(),
                               subRes->_resultTypes.end());
   result->_localVocab = subRes->_localVocab;
-  result->_data.insert(result->_data.end(), subRes->_data.begin(),
-                       subRes->_data.end());
-  int width = result->_data.cols();
-  CALL_FIXED_SIZE_1(width, Engine::sort, &result->_data, _sortCol);
+  int width = subRes->width();
+  size_t sortCol = _sortCol;
+  CALL_FIXED_SIZE_1(width, ad_utility::externalSort, std::move(subRes),
+                    &result->_data,
+                    [sortCol](const auto& a, const auto& b) {
+                      return a[sortCol] < b[sortCol];
+                    },
+                    getExecutionContext()->getSortMemoryLimit(),
+                    getIndex().getOnDiskBase());
   result->_sortedBy = resultSortedOn();
+  // The runtime information of the child is complete once it is read.
+  getRuntimeInfo().addChild(_subtree->getRootOperation()->getRuntimeInfo());
 
   LOG(DEBUG) << "Sort result computation done." << endl;
 }
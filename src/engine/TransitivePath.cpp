@@ -4,11 +4,264 @@
 
 #include "TransitivePath.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <limits>
+#include <utility>
 
+#include "../util/CancellationHandle.h"
 #include "../util/Exception.h"
+#include "../util/HashMap.h"
+#include "../util/MemoryTracker.h"
 #include "CallFixedSize.h"
 
+namespace {
+// The memory of the graph and of the paths is charged to the query (see
+// MemoryTracker.h).
+template <typename T>
+using TrackedVector = vector<T, ad_utility::TrackingAllocator<T>>;
+
+// The edges of a sub result as a graph in compressed sparse row format. The
+// nodes are numbered in the order of their Ids and the targets of node i are
+// _targets[_offsets[i]], ..., _targets[_offsets[i + 1] - 1].
+class CsrGraph {
+ public:
+  static constexpr size_t NO_NODE = std::numeric_limits<size_t>::max();
+
+  // The graph with the edges sub(i, fromCol) -> sub(i, toCol).
+  template <int SUB_WIDTH>
+  CsrGraph(const IdTableView<SUB_WIDTH>& sub, size_t fromCol, size_t toCol) {
+    TrackedVector<std::pair<Id, Id>> edges;
+    edges.reserve(sub.size());
+    _nodeIds.reserve(2 * sub.size());
+    for (size_t i = 0; i < sub.size(); ++i) {
+      ad_utility::checkCancellation(i);
+      edges.emplace_back(sub(i, fromCol), sub(i, toCol));
+      _nodeIds.push_back(sub(i, fromCol));
+      _nodeIds.push_back(sub(i, toCol));
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    std::sort(_nodeIds.begin(), _nodeIds.end());
+    _nodeIds.erase(std::unique(_nodeIds.begin(), _nodeIds.end()),
+                   _nodeIds.end());
+    _nodeIds.shrink_to_fit();
+
+    _offsets.resize(_nodeIds.size() + 1, 0);
+    _targets.reserve(edges.size());
+    size_t node = 0;
+    for (const auto& [from, to] : edges) {
+      while (_nodeIds[node] < from) {
+        _offsets[++node] = _targets.size();
+      }
+      _targets.push_back(nodeIndex(to));
+    }
+    while (node < _nodeIds.size()) {
+      _offsets[++node] = _targets.size();
+    }
+  }
+
+  size_t nofNodes() const { return _nodeIds.size(); }
+
+  Id id(size_t node) const { return _nodeIds[node]; }
+
+  // The number of the node with the given Id or NO_NODE.
+  size_t nodeIndex(Id id) const {
+    auto it = std::lower_bound(_nodeIds.begin(), _nodeIds.end(), id);
+    if (it == _nodeIds.end() || *it != id) {
+      return NO_NODE;
+    }
+    return it - _nodeIds.begin();
+  }
+
+  bool hasEdges(size_t node) const {
+    return _offsets[node] < _offsets[node + 1];
+  }
+
+  const size_t* targetsBegin(size_t node) const {
+    return _targets.data() + _offsets[node];
+  }
+
+  const size_t* targetsEnd(size_t node) const {
+    return _targets.data() + _offsets[node + 1];
+  }
+
+ private:
+  TrackedVector<Id> _nodeIds;
+  TrackedVector<size_t> _offsets;
+  TrackedVector<size_t> _targets;
+};
+
+// Searches the nodes that can be reached from a start node with at least
+// minDist and at most maxDist edges (breadth first). The marks of the nodes
+// are epochs, such that they don't have to be reset for each search.
+class PathSearch {
+ public:
+  PathSearch(const CsrGraph& graph, size_t minDist, size_t maxDist)
+      : _graph(graph),
+        _minDist(minDist),
+        _maxDist(maxDist),
+        _marks(graph.nofNodes(), 0) {}
+
+  // Appends the sorted Ids of the nodes reachable from start to *result.
+  void search(size_t start, TrackedVector<Id>* result) {
+    size_t resultBegin = result->size();
+    _frontier.assign(1, start);
+    uint32_t visitedEpoch = 0;
+    for (size_t dist = 1; dist <= _maxDist && !_frontier.empty(); ++dist) {
+      // Below the minimum distance a node can be reached again with more
+      // edges, so it is only marked for the current distance. From then on a
+      // node is marked as visited when it is reached the first time.
+      if (dist <= _minDist) {
+        visitedEpoch = nextEpoch();
+      }
+      _next.clear();
+      for (size_t node : _frontier) {
+        for (const size_t* target = _graph.targetsBegin(node);
+             target != _graph.targetsEnd(node); ++target) {
+          ad_utility::checkCancellation(++_nofSteps);
+          if (_marks[*target] == visitedEpoch) {
+            continue;
+          }
+          _marks[*target] = visitedEpoch;
+          _next.push_back(*target);
+          if (dist >= _minDist) {
+            result->push_back(_graph.id(*target));
+          }
+        }
+      }
+      std::swap(_frontier, _next);
+    }
+    std::sort(result->begin() + resultBegin, result->end());
+  }
+
+ private:
+  uint32_t nextEpoch() {
+    if (_epoch == std::numeric_limits<uint32_t>::max()) {
+      std::fill(_marks.begin(), _marks.end(), 0);
+      _epoch = 0;
+    }
+    return ++_epoch;
+  }
+
+  const CsrGraph& _graph;
+  size_t _minDist;
+  size_t _maxDist;
+  TrackedVector<uint32_t> _marks;
+  uint32_t _epoch = 0;
+  TrackedVector<size_t> _frontier;
+  TrackedVector<size_t> _next;
+  // The number of edges of all searches, to check for the cancellation of the
+  // query.
+  size_t _nofSteps = 0;
+};
+
+// The nodes reachable from each of the given start nodes. The threads take the
+// start nodes in blocks of TRANSITIVE_PATH_START_NODES_PER_BLOCK.
+class ReachableNodes {
+ public:
+  ReachableNodes(const CsrGraph& graph, const vector<size_t>& startNodes,
+                 size_t minDist, size_t maxDist) {
+    const size_t nofBlocks =
+        (startNodes.size() + TRANSITIVE_PATH_START_NODES_PER_BLOCK - 1) /
+        TRANSITIVE_PATH_START_NODES_PER_BLOCK;
+    _blocks.resize(nofBlocks);
+    const size_t nofThreads =
+        std::clamp<size_t>(nofBlocks, 1, NOF_TRANSITIVE_PATH_THREADS);
+    // The searches and blocks are created by this thread such that their
+    // memory is charged to the query.
+    vector<PathSearch> searches(nofThreads,
+                                PathSearch(graph, minDist, maxDist));
+    std::atomic<size_t> nextBlock{0};
+    auto searchBlocks = [&](size_t t) {
+      try {
+        for (size_t b = nextBlock++; b < nofBlocks; b = nextBlock++) {
+          size_t end = std::min((b + 1) * TRANSITIVE_PATH_START_NODES_PER_BLOCK,
+                                startNodes.size());
+          for (size_t i = b * TRANSITIVE_PATH_START_NODES_PER_BLOCK; i < end;
+               ++i) {
+            searches[t].search(startNodes[i], &_blocks[b]._targets);
+            _blocks[b]._ends.push_back(_blocks[b]._targets.size());
+          }
+        }
+      } catch (...) {
+        // Let the other threads stop after their current block.
+        nextBlock = nofBlocks;
+        throw;
+      }
+    };
+    if (nofThreads == 1) {
+      searchBlocks(0);
+      return;
+    }
+    vector<std::future<void>> futures;
+    for (size_t t = 0; t < nofThreads; ++t) {
+      futures.push_back(
+          std::async(std::launch::async,
+                     [&searchBlocks, t,
+                      handle = ad_utility::CancellationHandle::current()]() {
+                       ad_utility::CancellationHandle::Scope scope(handle);
+                       searchBlocks(t);
+                     }));
+    }
+    for (auto& future : futures) {
+      future.get();
+    }
+  }
+
+  // The sorted Ids of the nodes reachable from startNodes[i].
+  std::pair<const Id*, const Id*> get(size_t i) const {
+    const Block& block = _blocks[i / TRANSITIVE_PATH_START_NODES_PER_BLOCK];
+    size_t j = i % TRANSITIVE_PATH_START_NODES_PER_BLOCK;
+    const Id* targets = block._targets.data();
+    return {targets + (j == 0 ? 0 : block._ends[j - 1]),
+            targets + block._ends[j]};
+  }
+
+ private:
+  struct Block {
+    // The end of the targets of each start node in _targets.
+    TrackedVector<size_t> _ends;
+    TrackedVector<Id> _targets;
+  };
+  vector<Block> _blocks;
+};
+
+// The distinct values of column col of the table that are nodes of the graph
+// (sorted) and their nodes.
+template <int WIDTH>
+std::pair<vector<Id>, vector<size_t>> getStartNodes(
+    const CsrGraph& graph, const IdTableView<WIDTH>& table, size_t col) {
+  vector<Id> values;
+  values.reserve(table.size());
+  for (size_t i = 0; i < table.size(); i++) {
+    values.push_back(table(i, col));
+  }
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  vector<Id> startIds;
+  vector<size_t> startNodes;
+  for (Id id : values) {
+    size_t node = graph.nodeIndex(id);
+    if (node != CsrGraph::NO_NODE) {
+      startIds.push_back(id);
+      startNodes.push_back(node);
+    }
+  }
+  return {std::move(startIds), std::move(startNodes)};
+}
+
+// _____________________________________________________________________________
+void checkMinDist(size_t minDist) {
+  if (minDist == 0) {
+    AD_THROW(ad_semsearch::Exception::NOT_YET_IMPLEMENTED,
+             "The TransitivePath operation does not support a minimum "
+             "distance of 0 (use at least one instead).");
+  }
+}
+}  // namespace
+
 // _____________________________________________________________________________
 TransitivePath::TransitivePath(
     QueryExecutionContext* qec, std::shared_ptr<QueryExecutionTree> child,
@@ -91,12 +344,10 @@ size_t TransitivePath::getResultWidth() const { return _resultWidth; }
 
 // _____________________________________________________________________________
 vector<size_t> TransitivePath::resultSortedOn() const {
-  const std::vector<size_t>& subSortedOn =
-      _subtree->getRootOperation()->getResultSortedOn();
-  if (_leftSideTree == nullptr && _rightSideTree == nullptr && _leftIsVar &&
-      _rightIsVar && subSortedOn.size() > 0 && subSortedOn[0] == _leftSubCol) {
-    // This operation preserves the order of the _leftCol of the subtree.
-    return {0};
+  if (_leftSideTree == nullptr && _rightSideTree == nullptr) {
+    // The paths are computed for the sorted start nodes, and the targets of
+    // each start node are sorted (see computeTransitivePath).
+    return {0, 1};
   }
   if (_leftSideTree != nullptr) {
     const std::vector<size_t>& leftSortedOn =
@@ -205,389 +456,144 @@ void TransitivePath::computeTransitivePath(IdTable* dynRes,
                                            size_t rightSubCol, Id leftValue,
                                            Id rightValue, size_t minDist,
                                            size_t maxDist) {
-  using Map = ad_utility::HashMap<Id, std::shared_ptr<ad_utility::HashSet<Id>>>;
-  using MapIt = Map::iterator;
-
   if constexpr (!leftIsVar && !rightIsVar) {
     return;
   }
+  checkMinDist(minDist);
 
   const IdTableView<SUB_WIDTH> sub = dynSub.asStaticView<SUB_WIDTH>();
   IdTableStatic<2> res = dynRes->moveToStatic<2>();
 
-  // Used to map entries in the left column to entries they have connection with
-  Map edges;
-  // All nodes on the graph from which an edge leads to another node
-  std::vector<Id> nodes;
-
-  // initialize the map from the subresult
-  if constexpr (rightIsVar) {
-    (void)rightValue;
-    if (!leftIsVar) {
-      nodes.push_back(leftValue);
-    }
-    for (size_t i = 0; i < sub.size(); i++) {
-      size_t l = sub(i, leftSubCol);
-      size_t r = sub(i, rightSubCol);
-      MapIt it = edges.find(l);
-      if (it == edges.end()) {
-        if constexpr (leftIsVar) {
-          nodes.push_back(l);
-        }
-        std::shared_ptr<ad_utility::HashSet<Id>> s =
-            std::make_shared<ad_utility::HashSet<Id>>();
-        s->insert(r);
-        edges[l] = s;
-      } else {
-        // If r is not in the vector insert it
-        it->second->insert(r);
+  // If only the right side is fixed, the paths are searched from the right
+  // value along the inverted edges.
+  const CsrGraph graph = rightIsVar
+                             ? CsrGraph(sub, leftSubCol, rightSubCol)
+                             : CsrGraph(sub, rightSubCol, leftSubCol);
+  // The start nodes are sorted by their Ids and the nodes reachable from each
+  // start node are sorted as well, so the result is sorted by both columns.
+  vector<size_t> startNodes;
+  if constexpr (leftIsVar && rightIsVar) {
+    for (size_t node = 0; node < graph.nofNodes(); ++node) {
+      if (graph.hasEdges(node)) {
+        startNodes.push_back(node);
       }
     }
   } else {
-    (void)leftValue;
-    nodes.push_back(rightValue);
-    for (size_t i = 0; i < sub.size(); i++) {
-      // Use the inverted edges
-      size_t l = sub(i, leftSubCol);
-      size_t r = sub(i, rightSubCol);
-      MapIt it = edges.find(r);
-      if (it == edges.end()) {
-        std::shared_ptr<ad_utility::HashSet<Id>> s =
-            std::make_shared<ad_utility::HashSet<Id>>();
-        s->insert(l);
-        edges[r] = s;
-      } else {
-        // If r is not in the vector insert it
-        it->second->insert(l);
-      }
+    size_t start = graph.nodeIndex(rightIsVar ? leftValue : rightValue);
+    if (start != CsrGraph::NO_NODE) {
+      startNodes.push_back(start);
     }
   }
-
-  // For every node do a dfs on the graph
-
-  // Stores nodes we already have a path to. This avoids cycles.
-  ad_utility::HashSet<Id> marks;
-
-  // The stack used to store the dfs' progress
-  std::vector<ad_utility::HashSet<Id>::const_iterator> positions;
-
-  // Used to store all edges leading away from a node for every level.
-  // Reduces access to the hashmap, and is safe as the map will not
-  // be modified after this point.
-  std::vector<std::shared_ptr<const ad_utility::HashSet<Id>>> edgeCache;
-
-  for (size_t i = 0; i < nodes.size(); i++) {
-    MapIt rootEdges = edges.find(nodes[i]);
-    if (rootEdges != edges.end()) {
-      positions.push_back(rootEdges->second->begin());
-      edgeCache.push_back(rootEdges->second);
-    }
-    if (minDist == 0) {
-      AD_THROW(ad_semsearch::Exception::NOT_YET_IMPLEMENTED,
-               "The TransitivePath operation does not support a minimum "
-               "distance of 0 (use at least one instead).");
-    }
-
-    // While we have not found the entire transitive hull and have not reached
-    // the max step limit
-    while (!positions.empty()) {
-      size_t stackIndex = positions.size() - 1;
-      // Process the next child of the node at the top of the stack
-      ad_utility::HashSet<Id>::const_iterator& pos = positions[stackIndex];
-      const ad_utility::HashSet<Id>* nodeEdges = edgeCache.back().get();
-
-      if (pos == nodeEdges->end()) {
-        // We finished processing this node
-        positions.pop_back();
-        edgeCache.pop_back();
-        continue;
-      }
-
-      size_t child = *pos;
-      ++pos;
-      size_t childDepth = positions.size();
-      if (childDepth <= maxDist && marks.count(child) == 0) {
-        // process the child
-        if (childDepth >= minDist) {
-          marks.insert(child);
-          if constexpr (rightIsVar) {
-            res.push_back({nodes[i], child});
-          } else {
-            res.push_back({child, nodes[i]});
-          }
-        }
-        // Add the child to the stack
-        MapIt it = edges.find(child);
-        if (it != edges.end()) {
-          positions.push_back(it->second->begin());
-          edgeCache.push_back(it->second);
-        }
+  ReachableNodes reachable(graph, startNodes, minDist, maxDist);
+
+  for (size_t i = 0; i < startNodes.size(); ++i) {
+    Id start = graph.id(startNodes[i]);
+    auto [begin, end] = reachable.get(i);
+    for (const Id* target = begin; target != end; ++target) {
+      if constexpr (rightIsVar) {
+        res.push_back({start, *target});
+      } else {
+        res.push_back({*target, start});
       }
     }
-
-    if (i + 1 < nodes.size()) {
-      // reset everything for the next iteration
-      marks.clear();
-    }
   }
 
   *dynRes = res.moveToDynamic();
 }
 
+// _____________________________________________________________________________
 template <int SUB_WIDTH, int LEFT_WIDTH, int RES_WIDTH>
 void TransitivePath::computeTransitivePathLeftBound(
     IdTable* dynRes, const IdTable& dynSub, const IdTable& dynLeft,
     size_t leftSideCol, bool rightIsVar, size_t leftSubCol, size_t rightSubCol,
     Id rightValue, size_t minDist, size_t maxDist, size_t resWidth) {
-  using Map = ad_utility::HashMap<Id, std::shared_ptr<ad_utility::HashSet<Id>>>;
-  using MapIt = Map::iterator;
+  checkMinDist(minDist);
 
   const IdTableView<SUB_WIDTH> sub = dynSub.asStaticView<SUB_WIDTH>();
   const IdTableView<LEFT_WIDTH> left = dynLeft.asStaticView<LEFT_WIDTH>();
   IdTableStatic<RES_WIDTH> res = dynRes->moveToStatic<RES_WIDTH>();
 
-  // Used to map entries in the left column to entries they have connection with
-  Map edges;
-
-  // initialize the map from the subresult
-  for (size_t i = 0; i < sub.size(); i++) {
-    size_t l = sub(i, leftSubCol);
-    size_t r = sub(i, rightSubCol);
-    MapIt it = edges.find(l);
-    if (it == edges.end()) {
-      std::shared_ptr<ad_utility::HashSet<Id>> s =
-          std::make_shared<ad_utility::HashSet<Id>>();
-      s->insert(r);
-      edges[l] = s;
-    } else {
-      // If r is not in the vector insert it
-      it->second->insert(r);
-    }
-  }
-
-  // For every node do a dfs on the graph
+  const CsrGraph graph(sub, leftSubCol, rightSubCol);
+  // The paths are searched once for each distinct value of the left side.
+  auto [startIds, startNodes] = getStartNodes(graph, left, leftSideCol);
+  ReachableNodes reachable(graph, startNodes, minDist, maxDist);
 
-  // Stores nodes we already have a path to. This avoids cycles.
-  ad_utility::HashSet<Id> marks;
-
-  // The stack used to store the dfs' progress
-  std::vector<ad_utility::HashSet<Id>::const_iterator> positions;
-  // Used to store all edges leading away from a node for every level.
-  // Reduces access to the hashmap, and is safe as the map will not
-  // be modified after this point.
-  std::vector<std::shared_ptr<const ad_utility::HashSet<Id>>> edgeCache;
-
-  size_t last_elem = std::numeric_limits<size_t>::max();
-  size_t last_result_begin = 0;
-  size_t last_result_end = 0;
   for (size_t i = 0; i < left.size(); i++) {
-    if (left[i][leftSideCol] == last_elem) {
-      // We can repeat the last output
-      size_t num_new = last_result_end - last_result_begin;
-      size_t res_row = res.size();
-      res.resize(res.size() + num_new);
-      for (size_t j = 0; j < num_new; j++) {
-        for (size_t c = 0; c < resWidth; c++) {
-          res(res_row + j, c) = res(last_result_begin + j, c);
-        }
-      }
+    ad_utility::checkCancellation(i);
+    Id start = left(i, leftSideCol);
+    auto startIt = std::lower_bound(startIds.begin(), startIds.end(), start);
+    if (startIt == startIds.end() || *startIt != start) {
       continue;
     }
-    last_elem = left[i][leftSideCol];
-    last_result_begin = res.size();
-    MapIt rootEdges = edges.find(last_elem);
-    if (rootEdges != edges.end()) {
-      positions.push_back(rootEdges->second->begin());
-      edgeCache.push_back(rootEdges->second);
-    }
-    if (minDist == 0) {
-      AD_THROW(ad_semsearch::Exception::NOT_YET_IMPLEMENTED,
-               "The TransitivePath operation does not support a minimum "
-               "distance of 0 (use at least one instead).");
-    }
-
-    // While we have not found the entire transitive hull and have not reached
-    // the max step limit
-    while (!positions.empty()) {
-      size_t stackIndex = positions.size() - 1;
-      // Process the next child of the node at the top of the stack
-      ad_utility::HashSet<Id>::const_iterator& pos = positions[stackIndex];
-      const ad_utility::HashSet<Id>* nodeEdges = edgeCache.back().get();
-
-      if (pos == nodeEdges->end()) {
-        // We finished processing this node
-        positions.pop_back();
-        edgeCache.pop_back();
+    auto [begin, end] = reachable.get(startIt - startIds.begin());
+    for (const Id* target = begin; target != end; ++target) {
+      if (!rightIsVar && *target != rightValue) {
         continue;
       }
-
-      size_t child = *pos;
-      ++pos;
-      size_t childDepth = positions.size();
-      if (childDepth <= maxDist && marks.count(child) == 0) {
-        // process the child
-        if (childDepth >= minDist) {
-          marks.insert(child);
-          if (rightIsVar || child == rightValue) {
-            size_t row = res.size();
-            res.emplace_back();
-            res(row, 0) = last_elem;
-            res(row, 1) = child;
-            for (size_t k = 2; k < resWidth + 1; k++) {
-              if (k - 2 < leftSideCol) {
-                res(row, k) = left(i, k - 2);
-              } else if (k - 2 > leftSideCol) {
-                res(row, k - 1) = left(i, k - 2);
-              }
-            }
-          }
-        }
-        // Add the child to the stack
-        MapIt it = edges.find(child);
-        if (it != edges.end()) {
-          positions.push_back(it->second->begin());
-          edgeCache.push_back(it->second);
+      size_t row = res.size();
+      res.emplace_back();
+      res(row, 0) = start;
+      res(row, 1) = *target;
+      for (size_t k = 2; k < resWidth + 1; k++) {
+        if (k - 2 < leftSideCol) {
+          res(row, k) = left(i, k - 2);
+        } else if (k - 2 > leftSideCol) {
+          res(row, k - 1) = left(i, k - 2);
         }
       }
     }
-
-    if (i + 1 < left.size()) {
-      // reset everything for the next iteration
-      marks.clear();
-    }
-
-    last_result_end = res.size();
   }
 
   *dynRes = res.moveToDynamic();
 }
 
+// This instantiantion is needed by the unit tests
+template void TransitivePath::computeTransitivePathLeftBound<2, 2, 3>(
+    IdTable* res, const IdTable& sub, const IdTable& left, size_t leftSideCol,
+    bool rightIsVar, size_t leftSubCol, size_t rightSubCol, Id rightValue,
+    size_t minDist, size_t maxDist, size_t resWidth);
+
 // _____________________________________________________________________________
 template <int SUB_WIDTH, int LEFT_WIDTH, int RES_WIDTH>
 void TransitivePath::computeTransitivePathRightBound(
     IdTable* dynRes, const IdTable& dynSub, const IdTable& dynRight,
     size_t rightSideCol, bool leftIsVar, size_t leftSubCol, size_t rightSubCol,
     Id leftValue, size_t minDist, size_t maxDist, size_t resWidth) {
-  // Do the discovery from the right instead of the left.
-
-  using Map = ad_utility::HashMap<Id, std::shared_ptr<ad_utility::HashSet<Id>>>;
-  using MapIt = Map::iterator;
+  checkMinDist(minDist);
 
   const IdTableView<SUB_WIDTH> sub = dynSub.asStaticView<SUB_WIDTH>();
   const IdTableView<LEFT_WIDTH> right = dynRight.asStaticView<LEFT_WIDTH>();
   IdTableStatic<RES_WIDTH> res = dynRes->moveToStatic<RES_WIDTH>();
 
-  // Used to map entries in the left column to entries they have connection with
-  Map edges;
-
-  // initialize the map from the subresult
-  for (size_t i = 0; i < sub.size(); i++) {
-    size_t l = sub(i, leftSubCol);
-    size_t r = sub(i, rightSubCol);
-    MapIt it = edges.find(r);
-    if (it == edges.end()) {
-      std::shared_ptr<ad_utility::HashSet<Id>> s =
-          std::make_shared<ad_utility::HashSet<Id>>();
-      s->insert(l);
-      edges[r] = s;
-    } else {
-      it->second->insert(l);
-    }
-  }
-
-  // For every node do a dfs on the graph
-
-  // Stores nodes we already have a path to. This avoids cycles.
-  ad_utility::HashSet<Id> marks;
+  // Search the paths from the right side along the inverted edges.
+  const CsrGraph graph(sub, rightSubCol, leftSubCol);
+  auto [startIds, startNodes] = getStartNodes(graph, right, rightSideCol);
+  ReachableNodes reachable(graph, startNodes, minDist, maxDist);
 
-  // The stack used to store the dfs' progress
-  std::vector<ad_utility::HashSet<Id>::const_iterator> positions;
-
-  // Used to store all edges leading away from a node for every level.
-  // Reduces access to the hashmap, and is safe as the map will not
-  // be modified after this point.
-  std::vector<std::shared_ptr<const ad_utility::HashSet<Id>>> edgeCache;
-
-  size_t last_elem = std::numeric_limits<size_t>::max();
-  size_t last_result_begin = 0;
-  size_t last_result_end = 0;
   for (size_t i = 0; i < right.size(); i++) {
-    if (right[i][rightSideCol] == last_elem) {
-      // We can repeat the last output
-      size_t num_new = last_result_end - last_result_begin;
-      size_t res_row = res.size();
-      res.resize(res.size() + num_new);
-      for (size_t j = 0; j < num_new; j++) {
-        for (size_t c = 0; c < resWidth; c++) {
-          res(res_row + j, c) = res(last_result_begin + j, c);
-        }
-      }
+    ad_utility::checkCancellation(i);
+    Id start = right(i, rightSideCol);
+    auto startIt = std::lower_bound(startIds.begin(), startIds.end(), start);
+    if (startIt == startIds.end() || *startIt != start) {
       continue;
     }
-    last_elem = right(i, rightSideCol);
-    last_result_begin = res.size();
-    MapIt rootEdges = edges.find(last_elem);
-    if (rootEdges != edges.end()) {
-      positions.push_back(rootEdges->second->begin());
-      edgeCache.push_back(rootEdges->second);
-    }
-    if (minDist == 0) {
-      AD_THROW(ad_semsearch::Exception::NOT_YET_IMPLEMENTED,
-               "The TransitivePath operation does not support a minimum "
-               "distance of 0 (use at least one instead).");
-    }
-
-    // While we have not found the entire transitive hull and have not reached
-    // the max step limit
-    while (!positions.empty()) {
-      size_t stackIndex = positions.size() - 1;
-      // Process the next child of the node at the top of the stack
-      ad_utility::HashSet<Id>::const_iterator& pos = positions[stackIndex];
-      const ad_utility::HashSet<Id>* nodeEdges = edgeCache.back().get();
-
-      if (pos == nodeEdges->end()) {
-        // We finished processing this node
-        positions.pop_back();
-        edgeCache.pop_back();
+    auto [begin, end] = reachable.get(startIt - startIds.begin());
+    for (const Id* target = begin; target != end; ++target) {
+      if (!leftIsVar && *target != leftValue) {
         continue;
       }
-
-      size_t child = *pos;
-      ++pos;
-      size_t childDepth = positions.size();
-      if (childDepth <= maxDist && marks.count(child) == 0) {
-        // process the child
-        if (childDepth >= minDist) {
-          marks.insert(child);
-          if (leftIsVar || child == leftValue) {
-            size_t row = res.size();
-            res.emplace_back();
-            res(row, 0) = child;
-            res(row, 1) = last_elem;
-            for (size_t k = 2; k < resWidth + 1; k++) {
-              if (k - 2 < rightSideCol) {
-                res(row, k) = right(i, k - 2);
-              } else if (k - 2 > rightSideCol) {
-                res(row, k - 1) = right(i, k - 2);
-              }
-            }
-          }
-        }
-        // Add the child to the stack
-        MapIt it = edges.find(child);
-        if (it != edges.end()) {
-          positions.push_back(it->second->begin());
-          edgeCache.push_back(it->second);
+      size_t row = res.size();
+      res.emplace_back();
+      res(row, 0) = *target;
+      res(row, 1) = start;
+      for (size_t k = 2; k < resWidth + 1; k++) {
+        if (k - 2 < rightSideCol) {
+          res(row, k) = right(i, k - 2);
+        } else if (k - 2 > rightSideCol) {
+          res(row, k - 1) = right(i, k - 2);
         }
       }
     }
-
-    if (i + 1 < right.size()) {
-      // reset everything for the next iteration
-      marks.clear();
-    }
-
-    last_result_end = res.size();
   }
 
   *dynRes = res.moveToDynamic();
@@ -154,6 +154,50 @@ void Union::computeResult(ResultTable* result) {
   LOG(DEBUG) << "Union result computation done." << std::endl;
 }
 
+std::unique_ptr<LazyResult> Union::computeLazyResult() {
+  // First all the blocks of the left subtree, then the ones of the right
+  // subtree. The right subtree is only evaluated once the left one is
+  // exhausted.
+  std::shared_ptr<LazyResult> subResult = _subtrees[0]->getLazyResult();
+  vector<ResultTable::ResultType> resultTypes;
+  for (const std::array<size_t, 2>& o : _columnOrigins) {
+    if (o[0] != NO_COLUMN) {
+      resultTypes.push_back(subResult->getResultType(o[0]));
+    } else {
+      resultTypes.push_back(ResultTable::ResultType::KB);
+    }
+  }
+  int leftWidth = _subtrees[0]->getResultWidth();
+  int rightWidth = _subtrees[1]->getResultWidth();
+  int outWidth = getResultWidth();
+  bool isLeft = true;
+  auto generator = [this, subResult, isLeft, leftWidth, rightWidth,
+                    outWidth](IdTable* block) mutable {
+    IdTable input(isLeft ? leftWidth : rightWidth);
+    while (!subResult->nextBlock(&input)) {
+      if (!isLeft) {
+        return false;
+      }
+      isLeft = false;
+      subResult = _subtrees[1]->getLazyResult();
+      input = IdTable(rightWidth);
+    }
+    if (isLeft) {
+      IdTable empty(rightWidth);
+      CALL_FIXED_SIZE_3(leftWidth, rightWidth, outWidth, computeUnion, block,
+                        input, empty, _columnOrigins);
+    } else {
+      IdTable empty(leftWidth);
+      CALL_FIXED_SIZE_3(leftWidth, rightWidth, outWidth, computeUnion, block,
+                        empty, input, _columnOrigins);
+    }
+    return true;
+  };
+  return std::make_unique<LazyResult>(getResultWidth(), resultSortedOn(),
+                                      std::move(resultTypes), nullptr,
+                                      std::move(generator));
+}
+
 template <int LEFT_WIDTH, int RIGHT_WIDTH, int OUT_WIDTH>
 void Union::computeUnion(
     IdTable* dynRes, const IdTable& dynLeft, const IdTable& dynRight,
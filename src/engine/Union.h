@@ -54,6 +54,8 @@ class Union : public Operation {
  private:
   virtual void computeResult(ResultTable* result) override;
 
+  virtual std::unique_ptr<LazyResult> computeLazyResult() override;
+
   /**
    * @brief This stores the input column from each of the two subtrees or
    * NO_COLUMN if the subtree does not have a matching column for each result
@@ -5,13 +5,57 @@
 
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 static const size_t STXXL_MEMORY_TO_USE = 1024L * 1024L * 1024L * 2L;
 static const size_t STXXL_DISK_SIZE_INDEX_BUILDER = 1000 * 1000;
 static const size_t STXXL_DISK_SIZE_INDEX_TEST = 10;
 
 static const size_t NOF_SUBTREES_TO_CACHE = 1000;
+// The default maximal total size of the (non-pinned) results in the cache and
+// of a single result that may be cached.
+static const size_t DEFAULT_CACHE_MAX_SIZE_GB = 30;
+static const size_t DEFAULT_CACHE_MAX_SIZE_SINGLE_ENTRY_GB = 5;
 static const size_t MAX_NOF_ROWS_IN_RESULT = 100000;
+// Lazily computed results (see Operation::getLazyResult) are passed between
+// operations in blocks of about this many rows. Must be at least
+// NOF_PAIRS_PER_COMPRESSED_BLOCK.
+static const size_t LAZY_RESULT_BLOCK_SIZE = 1 << 16;
+// The default amount of memory that a single sort (ORDER BY or sorting for a
+// join) may use in addition to its input. Larger inputs are sorted externally.
+static const size_t DEFAULT_SORT_MEMORY_LIMIT_PER_QUERY_GB = 4;
+// The default amount of memory that the IdTables, local vocabularies and hash
+// tables of a single query may allocate (see MemoryTracker.h). A query that
+// exceeds it is aborted.
+static const size_t DEFAULT_MEMORY_LIMIT_PER_QUERY_GB = 16;
+// The default timeout of a query (it can be set per query with the HTTP
+// parameter "timeout"). The long loops of the operations check whether their
+// query has timed out every CANCELLATION_CHECK_INTERVAL rows, an operation
+// that waits for the result of another query checks every
+// CANCELLATION_WAIT_INTERVAL_MS milliseconds.
+static const size_t DEFAULT_QUERY_TIMEOUT_SECONDS = 600;
+static const size_t CANCELLATION_CHECK_INTERVAL = 1 << 14;
+static const size_t CANCELLATION_WAIT_INTERVAL_MS = 100;
+
+// Queries that are accepted by the server while all worker threads are busy
+// are queued. If the queue is full, the server responds with
+// 503 Service Unavailable.
+static const size_t DEFAULT_MAX_NOF_QUEUED_QUERIES = 64;
+// Keep-alive connections without any traffic are closed after this time.
+static const size_t HTTP_KEEP_ALIVE_TIMEOUT_SECONDS = 60;
+// Requests whose request line and headers are longer are rejected.
+static const size_t MAX_HTTP_REQUEST_SIZE = 1024 * 1024 * 10;
+// Query results are sent with chunked transfer encoding in chunks of this
+// size. The computing thread blocks while more than
+// HTTP_MAX_BUFFERED_RESPONSE_BYTES of a response have not been sent yet.
+static const size_t HTTP_CHUNK_SIZE = 1 << 16;
+static const size_t HTTP_MAX_BUFFERED_RESPONSE_BYTES = 1 << 22;
+// Connections whose client has not taken any of the pending response data
+// for this time are closed, which also unblocks the computing thread.
+static const size_t HTTP_SEND_TIMEOUT_SECONDS = 60;
+// When a result is exported, the strings of this many rows are looked up
+// together (in the order of their ids).
+static const size_t RESULT_EXPORT_BATCH_SIZE = 1 << 13;
 static const size_t MIN_WORD_PREFIX_SIZE = 4;
 static const char PREFIX_CHAR = '*';
 static const char EXTERNALIZED_LITERALS_PREFIX_CHAR{127};
@@ -27,11 +71,77 @@ static const size_t BUFFER_SIZE_RELATION_SIZE = 1000 * 1000 * 1000;
 static const size_t BUFFER_SIZE_DOCSFILE_LINE = 1024 * 1024 * 100;
 static const size_t DISTINCT_LHS_PER_BLOCK = 10 * 1000;
 static const size_t USE_BLOCKS_INDEX_SIZE_TRESHOLD = 20 * 1000;
+// The number of (col1, col2) pairs of a relation that are compressed together
+// in the permutation files. Each block can be decompressed independently.
+static const size_t NOF_PAIRS_PER_COMPRESSED_BLOCK = 1 << 13;
 
 static const size_t TEXT_PREDICATE_CARDINALITY_ESTIMATE = 1000 * 1000 * 1000;
 
 static const size_t GALLOP_THRESHOLD = 1000;
 
+// The default number of threads of a single merge join and the minimal number
+// of rows (of the larger input) per thread, see ParallelMergeJoin.h.
+static const size_t DEFAULT_NOF_JOIN_THREADS = 4;
+static const size_t DEFAULT_JOIN_MIN_PARTITION_SIZE = 100 * 1000;
+
+// The hash join partitions its inputs such that the hash table for each
+// partition has about this many rows (and fits into the cache).
+static const size_t HASH_JOIN_ROWS_PER_PARTITION = 1 << 15;
+
+// GROUP BY aggregates its groups in hash tables instead of sorting its input
+// if the input is not sorted yet and the estimated number of groups is at most
+// HASH_GROUP_BY_MAX_GROUPS. This is done with up to NOF_HASH_GROUP_BY_THREADS
+// threads, each of which gets at least the given number of rows, for at most
+// MAX_HASH_GROUP_BY_COLUMNS group by variables.
+static const size_t HASH_GROUP_BY_MAX_GROUPS = 1 << 18;
+static const size_t NOF_HASH_GROUP_BY_THREADS = 4;
+static const size_t HASH_GROUP_BY_MIN_ROWS_PER_THREAD = 100 * 1000;
+static const size_t MAX_HASH_GROUP_BY_COLUMNS = 4;
+
+// The transitive path searches the paths from its start nodes with up to
+// NOF_TRANSITIVE_PATH_THREADS threads. The threads take the start nodes in
+// blocks of this many nodes.
+static const size_t NOF_TRANSITIVE_PATH_THREADS = 4;
+static const size_t TRANSITIVE_PATH_START_NODES_PER_BLOCK = 1 << 10;
+
+// If one side of a join is a scan whose size estimate is at least this many
+// times larger than the other side, the other side is computed first and only
+// the rows of the scan with its join Ids are read (see Join::computeResult).
+static const size_t JOIN_KEY_FILTER_MIN_SIZE_RATIO = 10;
+
+// The server keeps the result sizes of this many subtrees of earlier queries
+// and uses them instead of the size estimates when planning later queries.
+static const size_t NOF_OBSERVED_SIZES_TO_KEEP = 10 * 1000;
+// If the size of a computed subtree differs from its estimate by at least
+// this factor (and one of them is at least REPLAN_MIN_SIZE), the query is
+// planned again with the actual size, at most MAX_NOF_REPLANS_PER_QUERY times.
+static const size_t REPLAN_MIN_ESTIMATE_ERROR = 10;
+static const size_t REPLAN_MIN_SIZE = 10 * 1000;
+static const size_t MAX_NOF_REPLANS_PER_QUERY = 2;
+
+// Regex filters match the distinct Ids of their column with up to this many
+// threads, but each thread gets at least the given number of Ids.
+static const size_t NOF_REGEX_FILTER_THREADS = 4;
+static const size_t REGEX_FILTER_MIN_IDS_PER_THREAD = 10 * 1000;
+
+// The pattern trick counts the predicates of its entities with up to this many
+// threads, but each thread gets at least the given number of entities.
+static const size_t NOF_PATTERN_TRICK_THREADS = 4;
+static const size_t PATTERN_TRICK_MIN_ENTITIES_PER_THREAD = 100 * 1000;
+
+// The pattern trick tables of the index contain the predicate counts for the
+// entities of the most frequent objects of these predicates (the types).
+static const std::vector<std::string> PATTERN_TRICK_TYPE_PREDICATES = {
+    "<http://www.w3.org/1999/02/22-rdf-syntax-ns#type>",
+    "<http://www.wikidata.org/prop/direct/P31>"};
+static const size_t DEFAULT_NOF_PATTERN_TRICK_TYPES = 100;
+
+// The relation statistics of the index contain an equi-depth histogram of the
+// objects of each predicate with this many buckets and its most frequent
+// objects (see RelationStatistics.h).
+static const size_t NOF_RELATION_HISTOGRAM_BUCKETS = 100;
+static const size_t NOF_RELATION_HEAVY_HITTERS = 10;
+
 static const char CONTAINS_ENTITY_PREDICATE[] =
     "<QLever-internal-function/contains-entity>";
 static const char CONTAINS_WORD_PREDICATE[] =
@@ -70,6 +180,13 @@ static const int DEFAULT_NOF_DATE_YEAR_DIGITS = 19;
 static const std::string MMAP_FILE_SUFFIX = ".meta-mmap";
 static const std::string CONFIGURATION_FILE = ".meta-data.json";
 static const std::string PREFIX_FILE = ".prefixes";
+static const std::string FRONT_CODED_VOCABULARY_SUFFIX = ".frontcoded";
+static const std::string PATTERN_TRICK_TABLES_SUFFIX = ".index.pattern-trick";
+static const std::string RELATION_STATISTICS_SUFFIX = ".index.statistics";
+
+// The number of words in one bucket of the front coded on-disk vocabulary.
+// Only the first word of each bucket is kept in RAM.
+static const size_t FRONT_CODED_VOCABULARY_BUCKET_SIZE = 16;
 
 static const std::string ERROR_IGNORE_CASE_UNSUPPORTED =
     "Key \"ignore-case\" is no longer supported. Please remove this key from "
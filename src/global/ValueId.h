@@ -0,0 +1,340 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "../util/Conversions.h"
+#include "../util/StringUtils.h"
+#include "./Constants.h"
+#include "./Id.h"
+
+/**
+ * @brief Numbers and dates are not stored in the vocabulary (as the index
+ * words created by ad_utility::convertValueLiteralToIndexWord) but inline in
+ * their Id.
+ *
+ * The highest TAG_BITS bits of an Id are its datatype. Ids of the datatype
+ * VOCAB (tag 0) are indices into the vocabulary, so all inline values are
+ * larger than all vocabulary Ids. The remaining PAYLOAD_BITS bits encode the
+ * value such that Ids of the same datatype are ordered like their values.
+ * Filters, aggregates and ORDER BY can thus work on the Ids directly.
+ *
+ * NUMBER: a double without its lowest 6 mantissa bits (about 13 significant
+ * decimal digits, integers are exact up to 2^47), followed by 2 bits for the
+ * xsd type (ad_utility::NumericType). Numbers with the same value and a
+ * different xsd type are adjacent. Numbers that can not be stored exactly this
+ * way stay in the vocabulary, see NumberOrder for how both are compared.
+ * DATE: year (34 bits, signed), month, day, hour, minute, second.
+ */
+class ValueId {
+ public:
+  enum class Datatype : uint8_t { VOCAB = 0, NUMBER = 1, DATE = 2 };
+  // The fields of a date as stored in the index words of dates. Month and
+  // day are 0 if the date only consists of a year.
+  struct Date {
+    int64_t _year;
+    uint8_t _month;
+    uint8_t _day;
+    uint8_t _hour;
+    uint8_t _minute;
+    uint8_t _second;
+  };
+
+  static constexpr int TAG_BITS = 4;
+  static constexpr int PAYLOAD_BITS = 64 - TAG_BITS;
+  static constexpr Id PAYLOAD_MASK = (Id(1) << PAYLOAD_BITS) - 1;
+
+  static Datatype datatype(Id id) {
+    auto tag = id >> PAYLOAD_BITS;
+    // All other tags are Ids of the vocabulary or sentinels like ID_NO_VALUE.
+    if (tag == static_cast<Id>(Datatype::NUMBER) ||
+        tag == static_cast<Id>(Datatype::DATE)) {
+      return static_cast<Datatype>(tag);
+    }
+    return Datatype::VOCAB;
+  }
+
+  static bool isValue(Id id) { return datatype(id) != Datatype::VOCAB; }
+
+  // All values of the datatype have Ids in [minId(type), maxId(type)].
+  static Id minId(Datatype type) {
+    return static_cast<Id>(type) << PAYLOAD_BITS;
+  }
+  static Id maxId(Datatype type) { return minId(type) | PAYLOAD_MASK; }
+
+  // The range [first, last] of the Ids that have the same value as id.
+  static std::pair<Id, Id> sameValueRange(Id id) {
+    if (datatype(id) == Datatype::NUMBER) {
+      return {id & ~NUMERIC_TYPE_MASK, id | NUMERIC_TYPE_MASK};
+    }
+    return {id, id};
+  }
+
+  // _____________________________________________________________________
+  static Id fromDouble(double value, ad_utility::NumericType type) {
+    uint64_t bits;
+    // Also maps -0.0 to 0.0.
+    value = value == 0 ? 0.0 : value;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // Round the absolute value to the nearest representable one.
+    uint64_t magnitude = bits & ~SIGN_BIT;
+    magnitude = (magnitude + (Id(1) << (DROPPED_BITS - 1))) &
+                ~((Id(1) << DROPPED_BITS) - 1);
+    bits = (bits & SIGN_BIT) | magnitude;
+    // Negative numbers are ordered by the complement of their bits.
+    uint64_t ordered = (bits & SIGN_BIT) ? ~bits : bits | SIGN_BIT;
+    return minId(Datatype::NUMBER) |
+           ((ordered >> DROPPED_BITS) << NUMERIC_TYPE_BITS) |
+           numericTypeCode(type);
+  }
+
+  static double toDouble(Id id) {
+    uint64_t ordered = ((id & PAYLOAD_MASK) >> NUMERIC_TYPE_BITS)
+                       << DROPPED_BITS;
+    uint64_t bits = (ordered & SIGN_BIT)
+                        ? ordered & ~SIGN_BIT
+                        : ~(ordered | ((Id(1) << DROPPED_BITS) - 1));
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  // The first Id of a number whose value is not smaller (larger) than value.
+  // maxId(NUMBER) + 1 if there is no such number.
+  static Id firstNumberNotBelow(double value) {
+    return firstNumber(value, false);
+  }
+  static Id firstNumberAbove(double value) { return firstNumber(value, true); }
+
+  static ad_utility::NumericType numericType(Id id) {
+    static constexpr ad_utility::NumericType types[] = {
+        ad_utility::NumericType::INTEGER, ad_utility::NumericType::FLOAT,
+        ad_utility::NumericType::DOUBLE, ad_utility::NumericType::DECIMAL};
+    return types[id & NUMERIC_TYPE_MASK];
+  }
+
+  // _____________________________________________________________________
+  static std::optional<Id> fromDate(const Date& date) {
+    if (date._year < -YEAR_OFFSET || date._year >= YEAR_OFFSET ||
+        date._month >= 16 || date._day >= 32 || date._hour >= 32 ||
+        date._minute >= 64 || date._second >= 64) {
+      return std::nullopt;
+    }
+    Id payload = static_cast<Id>(date._year + YEAR_OFFSET);
+    payload = (payload << 4) | date._month;
+    payload = (payload << 5) | date._day;
+    payload = (payload << 5) | date._hour;
+    payload = (payload << 6) | date._minute;
+    payload = (payload << 6) | date._second;
+    return minId(Datatype::DATE) | payload;
+  }
+
+  static Date toDate(Id id) {
+    Id payload = id & PAYLOAD_MASK;
+    Date date;
+    date._second = payload & 63;
+    date._minute = (payload >> 6) & 63;
+    date._hour = (payload >> 12) & 31;
+    date._day = (payload >> 17) & 31;
+    date._month = (payload >> 22) & 15;
+    date._year = static_cast<int64_t>(payload >> 26) - YEAR_OFFSET;
+    return date;
+  }
+
+  //! The Id of the value of an index word (":v:float:..." or ":v:date:...").
+  //! std::nullopt if it is no such word or its value can not be stored inline
+  //! (such words stay in the vocabulary).
+  static std::optional<Id> fromIndexWord(const std::string& indexWord) {
+    if (!ad_utility::startsWith(indexWord, VALUE_PREFIX)) {
+      return std::nullopt;
+    }
+    if (ad_utility::startsWith(indexWord, VALUE_FLOAT_PREFIX)) {
+      return numberFromIndexWord(indexWord);
+    }
+    if (ad_utility::startsWith(indexWord, VALUE_DATE_PREFIX)) {
+      return dateFromIndexWord(indexWord);
+    }
+    return std::nullopt;
+  }
+
+  //! The index word of an inline value, the inverse of fromIndexWord (up to
+  //! the precision of the numbers).
+  static std::string toIndexWord(Id id) {
+    if (datatype(id) == Datatype::DATE) {
+      return ad_utility::convertDateToIndexWord(formatDate(toDate(id)));
+    }
+    auto type = numericType(id);
+    double value = toDouble(id);
+    if (type == ad_utility::NumericType::INTEGER) {
+      return ad_utility::convertFloatStringToIndexWord(
+          std::to_string(std::llround(value)) + ".0", type);
+    }
+    return ad_utility::convertFloatStringToIndexWord(formatDecimal(value),
+                                                     type);
+  }
+
+ private:
+  static constexpr int NUMERIC_TYPE_BITS = 2;
+  static constexpr Id NUMERIC_TYPE_MASK = (Id(1) << NUMERIC_TYPE_BITS) - 1;
+  static constexpr int DROPPED_BITS = 64 - (PAYLOAD_BITS - NUMERIC_TYPE_BITS);
+  static constexpr uint64_t SIGN_BIT = uint64_t(1) << 63;
+  static constexpr int64_t YEAR_OFFSET = int64_t(1) << 33;
+
+  static Id numericTypeCode(ad_utility::NumericType type) {
+    switch (type) {
+      case ad_utility::NumericType::INTEGER:
+        return 0;
+      case ad_utility::NumericType::FLOAT:
+        return 1;
+      case ad_utility::NumericType::DOUBLE:
+        return 2;
+      default:
+        return 3;
+    }
+  }
+
+  // _____________________________________________________________________
+  static Id firstNumber(double value, bool strictlyAbove) {
+    if (std::isnan(value) || value == std::numeric_limits<double>::infinity()) {
+      return maxId(Datatype::NUMBER) + 1;
+    }
+    if (value == -std::numeric_limits<double>::infinity()) {
+      return minId(Datatype::NUMBER);
+    }
+    // The first Id of the stored value that is closest to value (the numeric
+    // type with code 0 comes first). If that value is too small, the next
+    // stored value is the first one that is larger.
+    Id id = fromDouble(value, ad_utility::NumericType::INTEGER);
+    double closest = toDouble(id);
+    if (closest > value || (closest == value && !strictlyAbove)) {
+      return id;
+    }
+    return (id | NUMERIC_TYPE_MASK) + 1;
+  }
+
+  // _____________________________________________________________________
+  static std::optional<Id> numberFromIndexWord(const std::string& indexWord) {
+    static const size_t prefixLength =
+        std::char_traits<char>::length(VALUE_FLOAT_PREFIX);
+    if (indexWord.size() < prefixLength + 2) {
+      return std::nullopt;
+    }
+    auto type = static_cast<ad_utility::NumericType>(indexWord.back());
+    if (type != ad_utility::NumericType::INTEGER &&
+        type != ad_utility::NumericType::FLOAT &&
+        type != ad_utility::NumericType::DOUBLE &&
+        type != ad_utility::NumericType::DECIMAL) {
+      return std::nullopt;
+    }
+    // Only decode well-formed words (convertFloatStringToIndexWord accepts
+    // anything that is typed as a number), see there for the format.
+    std::string number = indexWord.substr(
+        prefixLength, indexWord.size() - prefixLength - 1);
+    if (number != "N0") {
+      size_t posOfE = number.find('E');
+      auto isDigits = [&number](size_t begin, size_t end) {
+        return begin < end &&
+               std::all_of(number.begin() + begin, number.begin() + end,
+                           [](char c) { return c >= '0' && c <= '9'; });
+      };
+      if (number.size() < 5 || (number[0] != 'P' && number[0] != 'M') ||
+          std::string("PM+-").find(number[1]) == std::string::npos ||
+          posOfE == std::string::npos || !isDigits(2, posOfE) ||
+          !isDigits(posOfE + 1, number.size())) {
+        return std::nullopt;
+      }
+    }
+    std::string decimal = ad_utility::convertIndexWordToFloatString(indexWord);
+    char* end;
+    double value = std::strtod(decimal.c_str(), &end);
+    if (end != decimal.c_str() + decimal.size() || !std::isfinite(value)) {
+      return std::nullopt;
+    }
+    Id id = fromDouble(value, type);
+    // Only store numbers inline that we can convert back to the same word.
+    // Others (e.g. integers above 2^47 or decimals with more than 13
+    // significant digits) lose precision and stay in the vocabulary. Values
+    // close to the largest double are rounded to infinity.
+    if (!std::isfinite(toDouble(id)) || toIndexWord(id) != indexWord) {
+      return std::nullopt;
+    }
+    return id;
+  }
+
+  // _____________________________________________________________________
+  static std::optional<Id> dateFromIndexWord(const std::string& indexWord) {
+    // e.g. "-000000000000000500-01-02T03:04:05" for the 2nd of January 500 BC.
+    std::string date = ad_utility::convertIndexWordToDate(indexWord);
+    size_t endOfYear = date.find('-', 1);
+    if (endOfYear == std::string::npos || endOfYear > 20 ||
+        date.size() != endOfYear + 15) {
+      return std::nullopt;
+    }
+    auto field = [&date](size_t pos) -> int {
+      if (!std::isdigit(static_cast<unsigned char>(date[pos])) ||
+          !std::isdigit(static_cast<unsigned char>(date[pos + 1]))) {
+        return 64;
+      }
+      return (date[pos] - '0') * 10 + (date[pos + 1] - '0');
+    };
+    Date result;
+    result._year = std::strtoll(date.c_str(), nullptr, 10);
+    result._month = field(endOfYear + 1);
+    result._day = field(endOfYear + 4);
+    result._hour = field(endOfYear + 7);
+    result._minute = field(endOfYear + 10);
+    result._second = field(endOfYear + 13);
+    auto id = fromDate(result);
+    // Only store dates inline that we can convert back to the same word.
+    if (!id || toIndexWord(*id) != indexWord) {
+      return std::nullopt;
+    }
+    return id;
+  }
+
+  // The date in the format that ad_utility::normalizeDate expects.
+  static std::string formatDate(const Date& date) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%lld-%02d-%02dT%02d:%02d:%02d",
+                  static_cast<long long>(date._year), date._month, date._day,
+                  date._hour, date._minute, date._second);
+    return buffer;
+  }
+
+  // The value as a decimal without exponent ("0.00123", "-12.5", "1200.0")
+  // with at most 13 significant digits (all digits that are stored).
+  static std::string formatDecimal(double value) {
+    if (value == 0) {
+      return "0.0";
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.12e", std::abs(value));
+    // buffer is "d.dddddddddddde[+-]x"
+    std::string digits =
+        std::string(1, buffer[0]) + std::string(buffer + 2, 12);
+    int exponent = std::atoi(buffer + 15);
+    digits.erase(digits.find_last_not_of('0') + 1);
+    std::string result = value < 0 ? "-" : "";
+    if (exponent < 0) {
+      result += "0." + std::string(-exponent - 1, '0') + digits;
+    } else if (static_cast<size_t>(exponent) + 1 >= digits.size()) {
+      result += digits + std::string(exponent + 1 - digits.size(), '0') + ".0";
+    } else {
+      result += digits.substr(0, exponent + 1) + "." +
+                digits.substr(exponent + 1);
+    }
+    return result;
+  }
+};
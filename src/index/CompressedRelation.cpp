@@ -0,0 +1,394 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "./CompressedRelation.h"
+#include <algorithm>
+#include <cstring>
+#include "../util/Exception.h"
+#include "./IndexMetaData.h"
+
+namespace {
+// Layout of the header of each block:
+// uint32_t nofPairs, uint8_t codec col1, uint8_t codec col2,
+// uint32_t nofBytes col1, uint32_t nofBytes col2
+constexpr size_t BLOCK_HEADER_BYTES =
+    2 * sizeof(uint8_t) + 3 * sizeof(uint32_t);
+
+// ___________________________________________________________________________
+template <typename T>
+void append(vector<unsigned char>* out, T value) {
+  size_t pos = out->size();
+  out->resize(pos + sizeof(T));
+  std::memcpy(out->data() + pos, &value, sizeof(T));
+}
+
+// ___________________________________________________________________________
+template <typename T>
+T read(const unsigned char** in) {
+  T res;
+  std::memcpy(&res, *in, sizeof(T));
+  *in += sizeof(T);
+  return res;
+}
+
+// ___________________________________________________________________________
+void appendVarint(vector<unsigned char>* out, uint64_t value) {
+  while (value >= 128) {
+    out->push_back(static_cast<unsigned char>(value | 128));
+    value >>= 7;
+  }
+  out->push_back(static_cast<unsigned char>(value));
+}
+
+// ___________________________________________________________________________
+inline uint64_t readVarint(const unsigned char** in) {
+  uint64_t res = 0;
+  unsigned shift = 0;
+  const unsigned char* ptr = *in;
+  while (*ptr & 128) {
+    res |= uint64_t(*ptr & 127) << shift;
+    shift += 7;
+    ++ptr;
+  }
+  res |= uint64_t(*ptr) << shift;
+  *in = ptr + 1;
+  return res;
+}
+
+// The number of bits that are needed to represent all values in [0, maxValue]
+uint8_t numBits(uint64_t maxValue) {
+  uint8_t res = 0;
+  while (res < 64 && (maxValue >> res) != 0) {
+    ++res;
+  }
+  return res;
+}
+
+// Append the lowest numBits bits of each of the values to out.
+// Values are written in little endian bit order, the last byte is padded.
+template <typename F>
+void appendBitPacked(vector<unsigned char>* out, size_t nofValues,
+                     uint8_t bits, F getValue) {
+  unsigned __int128 acc = 0;
+  unsigned accBits = 0;
+  for (size_t i = 0; i < nofValues; ++i) {
+    acc |= static_cast<unsigned __int128>(getValue(i)) << accBits;
+    accBits += bits;
+    while (accBits >= 8) {
+      out->push_back(static_cast<unsigned char>(acc));
+      acc >>= 8;
+      accBits -= 8;
+    }
+  }
+  if (accBits > 0) {
+    out->push_back(static_cast<unsigned char>(acc));
+  }
+}
+
+// The inverse of appendBitPacked. Calls consume(i, value) for every value.
+template <typename F>
+const unsigned char* readBitPacked(const unsigned char* in, size_t nofValues,
+                                   uint8_t bits, F consume) {
+  const uint64_t mask = bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+  unsigned __int128 acc = 0;
+  unsigned accBits = 0;
+  for (size_t i = 0; i < nofValues; ++i) {
+    while (accBits < bits) {
+      acc |= static_cast<unsigned __int128>(*in++) << accBits;
+      accBits += 8;
+    }
+    consume(i, static_cast<uint64_t>(acc) & mask);
+    acc >>= bits;
+    accBits -= bits;
+  }
+  return in;
+}
+}  // namespace
+
+// ___________________________________________________________________________
+void CompressedRelation::encodeColumn(const vector<Id>& column,
+                                      ColumnCodec codec,
+                                      vector<unsigned char>* out) {
+  switch (codec) {
+    case ColumnCodec::DeltaVarint: {
+      Id last = 0;
+      for (Id id : column) {
+        AD_CHECK(id >= last);
+        appendVarint(out, id - last);
+        last = id;
+      }
+      return;
+    }
+    case ColumnCodec::FrameOfReference: {
+      auto [minIt, maxIt] = std::minmax_element(column.begin(), column.end());
+      Id min = *minIt;
+      uint8_t bits = numBits(*maxIt - min);
+      append(out, min);
+      append(out, bits);
+      appendBitPacked(out, column.size(), bits,
+                      [&](size_t i) { return column[i] - min; });
+      return;
+    }
+    case ColumnCodec::Dictionary: {
+      vector<Id> dict = column;
+      std::sort(dict.begin(), dict.end());
+      dict.erase(std::unique(dict.begin(), dict.end()), dict.end());
+      appendVarint(out, dict.size());
+      Id last = 0;
+      for (Id id : dict) {
+        appendVarint(out, id - last);
+        last = id;
+      }
+      uint8_t bits = numBits(dict.size() - 1);
+      append(out, bits);
+      appendBitPacked(out, column.size(), bits, [&](size_t i) {
+        return static_cast<uint64_t>(
+            std::lower_bound(dict.begin(), dict.end(), column[i]) -
+            dict.begin());
+      });
+      return;
+    }
+  }
+  AD_THROW(ad_semsearch::Exception::CHECK_FAILED, "Unknown column codec");
+}
+
+// ___________________________________________________________________________
+const unsigned char* CompressedRelation::decodeColumn(const unsigned char* in,
+                                                      ColumnCodec codec,
+                                                      size_t nofElements,
+                                                      Id* target,
+                                                      size_t stride) {
+  switch (codec) {
+    case ColumnCodec::DeltaVarint: {
+      Id last = 0;
+      for (size_t i = 0; i < nofElements; ++i) {
+        last += readVarint(&in);
+        target[i * stride] = last;
+      }
+      return in;
+    }
+    case ColumnCodec::FrameOfReference: {
+      Id min = read<Id>(&in);
+      uint8_t bits = read<uint8_t>(&in);
+      if (bits == 0) {
+        for (size_t i = 0; i < nofElements; ++i) {
+          target[i * stride] = min;
+        }
+        return in;
+      }
+      return readBitPacked(in, nofElements, bits, [&](size_t i, uint64_t v) {
+        target[i * stride] = min + v;
+      });
+    }
+    case ColumnCodec::Dictionary: {
+      size_t dictSize = readVarint(&in);
+      vector<Id> dict(dictSize);
+      Id last = 0;
+      for (size_t i = 0; i < dictSize; ++i) {
+        last += readVarint(&in);
+        dict[i] = last;
+      }
+      uint8_t bits = read<uint8_t>(&in);
+      if (bits == 0) {
+        for (size_t i = 0; i < nofElements; ++i) {
+          target[i * stride] = dict[0];
+        }
+        return in;
+      }
+      return readBitPacked(in, nofElements, bits, [&](size_t i, uint64_t v) {
+        target[i * stride] = dict[v];
+      });
+    }
+  }
+  AD_THROW(ad_semsearch::Exception::CHECK_FAILED, "Unknown column codec");
+}
+
+// ___________________________________________________________________________
+void CompressedRelation::compressBlock(const vector<Id>& col1,
+                                       const vector<Id>& col2,
+                                       vector<unsigned char>* out) {
+  AD_CHECK(col1.size() == col2.size());
+  AD_CHECK(!col1.empty());
+  // Try all the valid codecs for a column and keep the smallest result.
+  auto encodeBest = [](const vector<Id>& column,
+                       std::initializer_list<ColumnCodec> codecs,
+                       vector<unsigned char>* best) {
+    ColumnCodec bestCodec = *codecs.begin();
+    vector<unsigned char> current;
+    bool first = true;
+    for (auto codec : codecs) {
+      current.clear();
+      encodeColumn(column, codec, &current);
+      if (first || current.size() < best->size()) {
+        best->swap(current);
+        bestCodec = codec;
+        first = false;
+      }
+    }
+    return bestCodec;
+  };
+
+  vector<unsigned char> encoded1;
+  vector<unsigned char> encoded2;
+  ColumnCodec codec1 =
+      encodeBest(col1, {ColumnCodec::DeltaVarint, ColumnCodec::FrameOfReference},
+                 &encoded1);
+  ColumnCodec codec2 =
+      encodeBest(col2, {ColumnCodec::FrameOfReference, ColumnCodec::Dictionary},
+                 &encoded2);
+
+  out->reserve(out->size() + BLOCK_HEADER_BYTES + encoded1.size() +
+               encoded2.size());
+  append(out, static_cast<uint32_t>(col1.size()));
+  append(out, static_cast<uint8_t>(codec1));
+  append(out, static_cast<uint8_t>(codec2));
+  append(out, static_cast<uint32_t>(encoded1.size()));
+  append(out, static_cast<uint32_t>(encoded2.size()));
+  out->insert(out->end(), encoded1.begin(), encoded1.end());
+  out->insert(out->end(), encoded2.begin(), encoded2.end());
+}
+
+// ___________________________________________________________________________
+size_t CompressedRelation::decompressBlock(const unsigned char* in, Id* target,
+                                           size_t* nofBytesRead) {
+  const unsigned char* start = in;
+  auto nofPairs = read<uint32_t>(&in);
+  auto codec1 = static_cast<ColumnCodec>(read<uint8_t>(&in));
+  auto codec2 = static_cast<ColumnCodec>(read<uint8_t>(&in));
+  auto nofBytes1 = read<uint32_t>(&in);
+  auto nofBytes2 = read<uint32_t>(&in);
+  decodeColumn(in, codec1, nofPairs, target, 2);
+  decodeColumn(in + nofBytes1, codec2, nofPairs, target + 1, 2);
+  *nofBytesRead = (in - start) + nofBytes1 + nofBytes2;
+  return nofPairs;
+}
+
+// ___________________________________________________________________________
+vector<array<Id, 2>> CompressedRelation::decompressBlock(
+    const unsigned char* in) {
+  uint32_t nofPairs;
+  std::memcpy(&nofPairs, in, sizeof(nofPairs));
+  vector<array<Id, 2>> res(nofPairs);
+  size_t nofBytesRead;
+  decompressBlock(in, res.data()->data(), &nofBytesRead);
+  return res;
+}
+
+// ___________________________________________________________________________
+void CompressedRelation::readPairs(ad_utility::File& file, off_t startOffset,
+                                   size_t nofElements, Id* target) {
+  uint64_t nofBytes;
+  file.read(&nofBytes, sizeof(nofBytes), startOffset);
+  vector<unsigned char> buffer(nofBytes);
+  file.read(buffer.data(), nofBytes, startOffset + RELATION_HEADER_BYTES);
+  // Decompress block by block directly into the target.
+  const unsigned char* in = buffer.data();
+  size_t nofPairsDone = 0;
+  while (nofPairsDone < nofElements) {
+    size_t nofBytesRead;
+    nofPairsDone += decompressBlock(in, target + 2 * nofPairsDone,
+                                    &nofBytesRead);
+    in += nofBytesRead;
+  }
+  AD_CHECK(nofPairsDone == nofElements);
+  AD_CHECK(static_cast<size_t>(in - buffer.data()) == nofBytes);
+}
+
+// ___________________________________________________________________________
+void CompressedRelation::readPairs(ad_utility::File& file,
+                                   const FullRelationMetaData& rmd,
+                                   uint64_t metaDataVersion, Id* target) {
+  if (metaDataVersion >= V_COMPRESSED_RELATIONS) {
+    readPairs(file, rmd._startFullIndex, rmd.getNofElements(), target);
+  } else {
+    file.read(target, rmd.getNofElements() * 2 * sizeof(Id),
+              rmd._startFullIndex);
+  }
+}
+
+// ___________________________________________________________________________
+CompressedRelation::PairReader::PairReader(ad_utility::File& file,
+                                           const FullRelationMetaData& rmd,
+                                           uint64_t metaDataVersion)
+    : _file(&file),
+      _offset(rmd._startFullIndex),
+      _nofPairsLeft(rmd.getNofElements()),
+      _isCompressed(metaDataVersion >= V_COMPRESSED_RELATIONS) {
+  if (_isCompressed) {
+    _offset += RELATION_HEADER_BYTES;
+  }
+}
+
+// ___________________________________________________________________________
+size_t CompressedRelation::PairReader::readNextBlock(Id* target) {
+  if (_nofPairsLeft == 0) {
+    return 0;
+  }
+  if (!_isCompressed) {
+    size_t nofPairs = std::min(_nofPairsLeft, NOF_PAIRS_PER_COMPRESSED_BLOCK);
+    _file->read(target, nofPairs * 2 * sizeof(Id), _offset);
+    _offset += nofPairs * 2 * sizeof(Id);
+    _nofPairsLeft -= nofPairs;
+    return nofPairs;
+  }
+  // The header contains the size of the block.
+  _buffer.resize(BLOCK_HEADER_BYTES);
+  _file->read(_buffer.data(), BLOCK_HEADER_BYTES, _offset);
+  const unsigned char* in = _buffer.data();
+  auto nofPairs = read<uint32_t>(&in);
+  in += 2 * sizeof(uint8_t);
+  auto nofBytes1 = read<uint32_t>(&in);
+  auto nofBytes2 = read<uint32_t>(&in);
+  AD_CHECK(nofPairs <= NOF_PAIRS_PER_COMPRESSED_BLOCK);
+  AD_CHECK(nofPairs <= _nofPairsLeft);
+  size_t nofBytes = BLOCK_HEADER_BYTES + nofBytes1 + nofBytes2;
+  _buffer.resize(nofBytes);
+  _file->read(_buffer.data(), nofBytes, _offset);
+  size_t nofBytesRead;
+  decompressBlock(_buffer.data(), target, &nofBytesRead);
+  AD_CHECK(nofBytesRead == nofBytes);
+  _offset += nofBytes;
+  _nofPairsLeft -= nofPairs;
+  return nofPairs;
+}
+
+// ___________________________________________________________________________
+size_t CompressedRelation::PairReader::readNextBlockIf(
+    Id* target, const std::function<bool(Id, Id)>& isNeeded) {
+  if (!_isCompressed) {
+    // The pairs are not compressed, there is nothing to save.
+    size_t nofPairs = readNextBlock(target);
+    if (nofPairs > 0 && !isNeeded(target[0], target[2 * (nofPairs - 1)])) {
+      return 0;
+    }
+    return nofPairs;
+  }
+  if (_nofPairsLeft == 0) {
+    return 0;
+  }
+  _buffer.resize(BLOCK_HEADER_BYTES);
+  _file->read(_buffer.data(), BLOCK_HEADER_BYTES, _offset);
+  const unsigned char* in = _buffer.data();
+  auto nofPairs = read<uint32_t>(&in);
+  auto codec1 = static_cast<ColumnCodec>(read<uint8_t>(&in));
+  auto codec2 = static_cast<ColumnCodec>(read<uint8_t>(&in));
+  auto nofBytes1 = read<uint32_t>(&in);
+  auto nofBytes2 = read<uint32_t>(&in);
+  AD_CHECK(nofPairs <= NOF_PAIRS_PER_COMPRESSED_BLOCK);
+  AD_CHECK(nofPairs <= _nofPairsLeft);
+  off_t startCol1 = _offset + BLOCK_HEADER_BYTES;
+  _offset = startCol1 + nofBytes1 + nofBytes2;
+  _nofPairsLeft -= nofPairs;
+
+  // The first column is sorted, so its first and last entry are its range.
+  _buffer.resize(nofBytes1);
+  _file->read(_buffer.data(), nofBytes1, startCol1);
+  decodeColumn(_buffer.data(), codec1, nofPairs, target, 2);
+  if (nofPairs == 0 || !isNeeded(target[0], target[2 * (nofPairs - 1)])) {
+    return 0;
+  }
+  _buffer.resize(nofBytes2);
+  _file->read(_buffer.data(), nofBytes2, startCol1 + nofBytes1);
+  decodeColumn(_buffer.data(), codec2, nofPairs, target + 1, 2);
+  return nofPairs;
+}
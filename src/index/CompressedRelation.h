@@ -0,0 +1,200 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "../global/Constants.h"
+#include "../global/Id.h"
+#include "../util/File.h"
+#include "./MetaDataTypes.h"
+
+using std::array;
+using std::vector;
+
+// The codecs that can be used for one column of a compressed block.
+// The numeric values are part of the on-disk format, never change them.
+enum class ColumnCodec : uint8_t {
+  // First value as varint, then the (non-negative) differences to the
+  // previous value as varints. Only valid for sorted columns.
+  DeltaVarint = 0,
+  // The minimum of the block as a plain uint64_t, followed by all values
+  // minus this minimum, bit-packed with the minimal number of bits.
+  FrameOfReference = 1,
+  // The sorted distinct values of the block (delta + varint encoded) followed
+  // by the bit-packed index of each value in this dictionary.
+  Dictionary = 2
+};
+
+// On-disk format of the pair index of a single relation of a permutation
+// (available since the metadata version V_COMPRESSED_RELATIONS).
+//
+// At the start of the relation (FullRelationMetaData::_startFullIndex) there
+// is a uint64_t with the number of bytes of all the blocks that follow. Each
+// block contains at most NOF_PAIRS_PER_COMPRESSED_BLOCK (col1, col2) pairs of
+// the relation. The first column (which is sorted) is encoded with
+// DeltaVarint or FrameOfReference, the second column with FrameOfReference or
+// Dictionary, depending on which encoding is smaller for this block.
+class CompressedRelation {
+ public:
+  // The number of bytes of the header at the start of each relation.
+  static constexpr size_t RELATION_HEADER_BYTES = sizeof(uint64_t);
+
+  // Compress the pairs [data[0], data[nofElements]) and write them to the
+  // current position of out which has to be equal to startOffset.
+  // If blocks is not nullptr, a BlockMetaData with the first col1 entry and
+  // the start offset is appended to it for each compressed block.
+  // Returns the offset directly after the written relation.
+  template <class Container>
+  static off_t writePairs(ad_utility::File& out, off_t startOffset,
+                          const Container& data,
+                          vector<BlockMetaData>* blocks) {
+    vector<unsigned char> blockBuffer;
+    vector<Id> col1;
+    vector<Id> col2;
+    uint64_t nofBytes = 0;
+    if (data.size() <= NOF_PAIRS_PER_COMPRESSED_BLOCK) {
+      // The common case of a small relation (e.g. one subject in SPO).
+      // Write header and block at once instead of seeking back afterwards.
+      for (size_t j = 0; j < data.size(); ++j) {
+        col1.push_back(data[j][0]);
+        col2.push_back(data[j][1]);
+      }
+      compressBlock(col1, col2, &blockBuffer);
+      if (blocks) {
+        blocks->emplace_back(col1[0], startOffset + RELATION_HEADER_BYTES);
+      }
+      nofBytes = blockBuffer.size();
+      out.write(&nofBytes, sizeof(nofBytes));
+      out.write(blockBuffer.data(), blockBuffer.size());
+      return startOffset + RELATION_HEADER_BYTES + nofBytes;
+    }
+    // write a placeholder for the header, we only know the size at the end.
+    out.write(&nofBytes, sizeof(nofBytes));
+    for (size_t i = 0; i < data.size(); i += NOF_PAIRS_PER_COMPRESSED_BLOCK) {
+      size_t end = std::min(data.size(), i + NOF_PAIRS_PER_COMPRESSED_BLOCK);
+      col1.clear();
+      col2.clear();
+      for (size_t j = i; j < end; ++j) {
+        col1.push_back(data[j][0]);
+        col2.push_back(data[j][1]);
+      }
+      blockBuffer.clear();
+      compressBlock(col1, col2, &blockBuffer);
+      if (blocks) {
+        blocks->emplace_back(col1[0], startOffset + RELATION_HEADER_BYTES +
+                                          static_cast<off_t>(nofBytes));
+      }
+      out.write(blockBuffer.data(), blockBuffer.size());
+      nofBytes += blockBuffer.size();
+    }
+    off_t offsetAfter = startOffset + RELATION_HEADER_BYTES + nofBytes;
+    // now we can fill in the header.
+    out.seek(startOffset, SEEK_SET);
+    out.write(&nofBytes, sizeof(nofBytes));
+    out.seek(offsetAfter, SEEK_SET);
+    return offsetAfter;
+  }
+
+  // Read and decompress the complete pair index of the relation that starts at
+  // startOffset in file. The nofElements pairs are written row by row to
+  // target which must have space for 2 * nofElements Ids (this way we can
+  // directly decompress into the storage of an IdTable with two columns).
+  static void readPairs(ad_utility::File& file, off_t startOffset,
+                        size_t nofElements, Id* target);
+
+  // Same as readPairs, but decides based on the metadata version of the
+  // permutation whether the relation is stored compressed or as plain pairs.
+  static void readPairs(ad_utility::File& file, const FullRelationMetaData& rmd,
+                        uint64_t metaDataVersion, Id* target);
+
+  // Reads the pair index of a single relation block by block. This way a scan
+  // can be computed lazily and only reads the blocks that are requested.
+  class PairReader {
+   public:
+    PairReader(ad_utility::File& file, const FullRelationMetaData& rmd,
+               uint64_t metaDataVersion);
+
+    // Read the next block of pairs and write it row by row to target which
+    // must have space for NOF_PAIRS_PER_COMPRESSED_BLOCK pairs.
+    // Returns the number of pairs, 0 iff all pairs have been read.
+    size_t readNextBlock(Id* target);
+
+    // Like readNextBlock, but at first only reads and decodes the first
+    // column of the next block. If isNeeded(first, last) is false for its
+    // first and last entry, the rest of the block is neither read nor
+    // decoded and 0 is returned.
+    size_t readNextBlockIf(Id* target,
+                           const std::function<bool(Id, Id)>& isNeeded);
+
+    // True iff all blocks have been read or skipped.
+    bool done() const { return _nofPairsLeft == 0; }
+
+   private:
+    ad_utility::File* _file;
+    off_t _offset;
+    size_t _nofPairsLeft;
+    bool _isCompressed;
+    vector<unsigned char> _buffer;
+  };
+
+  // Read the pairs of a relation whose first entry is one of the keys (sorted
+  // and distinct) and append them to result (via push_back({col1, col2}),
+  // e.g. an IdTable with two columns). The blocks of the relation whose first
+  // column has no key in its range are skipped, see readNextBlockIf.
+  // Returns the number of skipped blocks.
+  template <class Result>
+  static size_t readPairsWithKeys(PairReader* reader, const vector<Id>& keys,
+                                  Result* result) {
+    size_t nofSkippedBlocks = 0;
+    vector<array<Id, 2>> block(NOF_PAIRS_PER_COMPRESSED_BLOCK);
+    // Both the blocks and the keys are sorted, so the keys before the
+    // current block are never needed again.
+    auto key = keys.begin();
+    auto isNeeded = [&key, &keys](Id first, Id last) {
+      key = std::lower_bound(key, keys.end(), first);
+      return key != keys.end() && *key <= last;
+    };
+    while (!reader->done() && key != keys.end()) {
+      size_t nofPairs = reader->readNextBlockIf(block.data()->data(), isNeeded);
+      if (nofPairs == 0) {
+        ++nofSkippedBlocks;
+        continue;
+      }
+      for (size_t i = 0; i < nofPairs && key != keys.end(); ++i) {
+        while (key != keys.end() && *key < block[i][0]) {
+          ++key;
+        }
+        if (key != keys.end() && *key == block[i][0]) {
+          result->push_back({block[i][0], block[i][1]});
+        }
+      }
+    }
+    return nofSkippedBlocks;
+  }
+
+  // Decompress the block that starts at the beginning of in.
+  // Writes the pairs row by row to target. Returns the number of decoded pairs
+  // and sets *nofBytesRead to the size of the block.
+  static size_t decompressBlock(const unsigned char* in, Id* target,
+                                size_t* nofBytesRead);
+
+  // Decompress a single block that was located via a BlockMetaData.
+  static vector<array<Id, 2>> decompressBlock(const unsigned char* in);
+
+  // Compress the columns of a single block and append the result to out.
+  // col1 has to be sorted, both columns have to be of the same size.
+  static void compressBlock(const vector<Id>& col1, const vector<Id>& col2,
+                            vector<unsigned char>* out);
+
+  // Helpers for the individual codecs, public for testing.
+  static void encodeColumn(const vector<Id>& column, ColumnCodec codec,
+                           vector<unsigned char>* out);
+  static const unsigned char* decodeColumn(const unsigned char* in,
+                                           ColumnCodec codec,
+                                           size_t nofElements, Id* target,
+                                           size_t stride);
+};
@@ -34,6 +34,13 @@ static const size_t PARSER_MIN_TRIPLES_AT_ONCE = 100000;
 // be fed to the parser at once (100 << 20  is exactly 100 MiB
 static const size_t FILE_BUFFER_SIZE = 100 << 20;
 
+// The parallel Turtle parser splits its input into batches of about this
+// many bytes, which are parsed concurrently (10 << 20 is 10 MiB).
+static const size_t PARALLEL_PARSER_BLOCK_SIZE = 10 << 20;
+
+// The number of batches the parallel Turtle parser parses at the same time.
+static const size_t NUM_PARALLEL_PARSER_THREADS = 8;
+
 // When the BZIP2 parser encouters a parsing exception it will increase its
 // buffer and try again (we have no other way currently to determine if the
 // exception was "real" or only because we cut a statement in the middle. Once
@@ -28,6 +28,8 @@ using std::string;
 // Available options.
 struct option options[] = {{"help", no_argument, NULL, 'h'},
                            {"index-basename", required_argument, NULL, 'i'},
+                           {"pattern-trick-types", required_argument, NULL,
+                            't'},
                            {NULL, 0, NULL, 0}};
 
 string getStxxlConfigFileName(const string& location) {
@@ -68,6 +70,11 @@ void printUsage(char* execName) {
   cout << "Options" << endl;
   cout << "  " << std::setw(20) << "i, index-basename" << std::setw(1) << "    "
        << "(designated) name and path of the index to build." << endl;
+  cout << "  " << std::setw(20) << "t, pattern-trick-types" << std::setw(1)
+       << "    "
+       << "Also precompute the predicate counts of the pattern trick for all "
+          "entities and the given number of most frequent types (default: "
+       << DEFAULT_NOF_PATTERN_TRICK_TYPES << ")." << endl;
   cout.copyfmt(coutState);
 }
 
@@ -81,10 +88,11 @@ int main(int argc, char** argv) {
   ad_utility::Log::imbue(locWithNumberGrouping);
 
   string baseName;
+  size_t nofPatternTrickTypes = DEFAULT_NOF_PATTERN_TRICK_TYPES;
   optind = 1;
   // Process command line arguments.
   while (true) {
-    int c = getopt_long(argc, argv, "i:", options, NULL);
+    int c = getopt_long(argc, argv, "i:t:", options, NULL);
     if (c == -1) {
       break;
     }
@@ -92,6 +100,9 @@ int main(int argc, char** argv) {
       case 'i':
         baseName = optarg;
         break;
+      case 't':
+        nofPatternTrickTypes = static_cast<size_t>(atol(optarg));
+        break;
       default:
         cout << endl
              << "! ERROR in processing options (getopt returned '" << c
@@ -118,6 +129,8 @@ int main(int argc, char** argv) {
     index.setUsePatterns(false);
     index.createFromOnDiskIndex(baseName);
     index.addPatternsToExistingIndex();
+    index.setUsePatterns(true);
+    index.createPatternTrickTables(nofPatternTrickTypes);
   } catch (const std::exception& e) {
     LOG(ERROR) << e.what() << std::endl;
   }
@@ -0,0 +1,263 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <future>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "../global/Id.h"
+#include "../util/File.h"
+#include "../util/Log.h"
+
+using std::array;
+using std::string;
+using std::vector;
+
+/**
+ * @brief Sort triples externally for several sort orders at once.
+ *
+ * createRuns() reads the triples once and splits them into runs that fit into
+ * the memory limit. Each run is sorted with every comparator (in parallel with
+ * numThreads threads) and written to one temporary file per comparator, while
+ * the next run is read. merge<I>() then merges the runs of the I-th comparator
+ * and writes the sorted triples without duplicates. The next buffer of every
+ * run is read asynchronously while the current ones are merged.
+ *
+ * @tparam Comparators (triple, triple) -> bool, e.g. SortByPSO
+ */
+template <typename... Comparators>
+class ExternalTripleSorter {
+ public:
+  using Triple = array<Id, 3>;
+  static constexpr size_t NUM_ORDERS = sizeof...(Comparators);
+
+  // The runs of the I-th comparator are stored in <tmpFilePrefix>.I and are
+  // deleted by the destructor.
+  ExternalTripleSorter(string tmpFilePrefix, size_t memoryLimitInBytes,
+                       size_t numThreads, Comparators... comparators)
+      : _tmpFilePrefix(std::move(tmpFilePrefix)),
+        // the current run, the run that is sorted for the next comparator and
+        // the run that is written to disk
+        _rowsPerRun(
+            std::max<size_t>(1, memoryLimitInBytes / (3 * sizeof(Triple)))),
+        _numThreads(std::max<size_t>(1, numThreads)),
+        _comparators(comparators...) {}
+
+  ~ExternalTripleSorter() {
+    for (size_t i = 0; i < NUM_ORDERS; ++i) {
+      remove(fileName(i).c_str());
+    }
+  }
+
+  ExternalTripleSorter(const ExternalTripleSorter&) = delete;
+  ExternalTripleSorter& operator=(const ExternalTripleSorter&) = delete;
+
+  /**
+   * @brief Create the sorted runs for all comparators.
+   * @param reader Reads the input triples, like stxxl::vector::bufreader_type
+   *               (empty(), operator* and operator++).
+   */
+  template <typename Reader>
+  void createRuns(Reader* reader) {
+    _runEnds.clear();
+    std::array<ad_utility::File, NUM_ORDERS> files;
+    for (size_t i = 0; i < NUM_ORDERS; ++i) {
+      files[i].open(fileName(i).c_str(), "w");
+    }
+    vector<Triple> run;
+    run.reserve(_rowsPerRun);
+    while (true) {
+      run.clear();
+      while (!reader->empty() && run.size() < _rowsPerRun) {
+        run.push_back(**reader);
+        ++(*reader);
+      }
+      if (run.empty()) {
+        break;
+      }
+      sortAndWriteRun(run, &files, std::index_sequence_for<Comparators...>{});
+      size_t numRows = run.size();
+      _runEnds.push_back(_runEnds.empty() ? numRows
+                                          : _runEnds.back() + numRows);
+    }
+    if (_writeFuture.valid()) {
+      _writeFuture.get();
+    }
+    LOG(INFO) << "Created " << _runEnds.size() << " sorted runs for "
+              << NUM_ORDERS << " sort orders" << std::endl;
+  }
+
+  /**
+   * @brief Merge the runs of the I-th comparator and write the triples
+   * without duplicates to writer (writer << triple). Only valid after
+   * createRuns(). Returns the number of written triples.
+   */
+  template <size_t I, typename Writer>
+  size_t merge(Writer* writer) const {
+    const auto& comp = std::get<I>(_comparators);
+    const size_t numRuns = _runEnds.size();
+    if (numRuns == 0) {
+      return 0;
+    }
+    ad_utility::File in(fileName(I), "r");
+    // Every run has a current and a next buffer.
+    const size_t rowsPerBuffer =
+        std::max<size_t>(1, _rowsPerRun * 3 / (2 * numRuns));
+    auto read = [&in](size_t from, size_t numRows) {
+      vector<Triple> buffer(numRows);
+      in.read(buffer.data(), numRows * sizeof(Triple),
+              static_cast<off_t>(from * sizeof(Triple)));
+      return buffer;
+    };
+    struct Run {
+      vector<Triple> _buffer;
+      size_t _pos = 0;
+      size_t _next;
+      size_t _end;
+      std::future<vector<Triple>> _nextBuffer;
+    };
+    auto prefetch = [&read, rowsPerBuffer](Run* run) {
+      if (run->_next < run->_end) {
+        size_t numRows = std::min(rowsPerBuffer, run->_end - run->_next);
+        run->_nextBuffer =
+            std::async(std::launch::async, read, run->_next, numRows);
+        run->_next += numRows;
+      }
+    };
+    // Move to the next buffer of a run, leaves it empty at the end of the run.
+    auto nextBuffer = [&prefetch](Run* run) {
+      run->_pos = 0;
+      if (run->_nextBuffer.valid()) {
+        run->_buffer = run->_nextBuffer.get();
+        prefetch(run);
+      } else {
+        run->_buffer.clear();
+      }
+    };
+
+    vector<Run> runs(numRuns);
+    for (size_t i = 0; i < numRuns; ++i) {
+      runs[i]._next = i == 0 ? 0 : _runEnds[i - 1];
+      runs[i]._end = _runEnds[i];
+      prefetch(&runs[i]);
+      nextBuffer(&runs[i]);
+    }
+    // The run with the smallest current triple is at the top.
+    auto greater = [&runs, &comp](size_t a, size_t b) {
+      return comp(runs[b]._buffer[runs[b]._pos], runs[a]._buffer[runs[a]._pos]);
+    };
+    std::priority_queue<size_t, vector<size_t>, decltype(greater)> queue(
+        greater);
+    for (size_t i = 0; i < numRuns; ++i) {
+      queue.push(i);
+    }
+
+    size_t numWritten = 0;
+    Triple last;
+    while (!queue.empty()) {
+      size_t i = queue.top();
+      queue.pop();
+      Run& run = runs[i];
+      const Triple& triple = run._buffer[run._pos];
+      // RDF does not allow duplicate triples.
+      if (numWritten == 0 || triple != last) {
+        *writer << triple;
+        last = triple;
+        ++numWritten;
+      }
+      ++run._pos;
+      if (run._pos == run._buffer.size()) {
+        nextBuffer(&run);
+      }
+      if (run._pos < run._buffer.size()) {
+        queue.push(i);
+      }
+    }
+    return numWritten;
+  }
+
+  /**
+   * @brief Sort v according to comp with numThreads threads: the parts are
+   * sorted concurrently and then merged pairwise.
+   */
+  template <typename Comparator>
+  static void parallelSort(vector<Triple>* v, Comparator comp,
+                           size_t numThreads) {
+    // below this size the threads do not pay off.
+    static constexpr size_t MIN_ROWS_PER_THREAD = 1 << 16;
+    size_t numParts = std::max<size_t>(
+        1, std::min(numThreads, v->size() / MIN_ROWS_PER_THREAD));
+    vector<size_t> bounds;
+    for (size_t i = 0; i <= numParts; ++i) {
+      bounds.push_back(v->size() * i / numParts);
+    }
+    auto begin = v->begin();
+    vector<std::future<void>> futures;
+    for (size_t i = 0; i < numParts; ++i) {
+      futures.push_back(std::async(std::launch::async, [=]() {
+        std::sort(begin + bounds[i], begin + bounds[i + 1], comp);
+      }));
+    }
+    for (auto& f : futures) {
+      f.get();
+    }
+    for (size_t width = 1; width < numParts; width *= 2) {
+      futures.clear();
+      for (size_t i = 0; i + width < numParts; i += 2 * width) {
+        size_t end = std::min(i + 2 * width, numParts);
+        futures.push_back(std::async(std::launch::async, [=]() {
+          std::inplace_merge(begin + bounds[i], begin + bounds[i + width],
+                             begin + bounds[end], comp);
+        }));
+      }
+      for (auto& f : futures) {
+        f.get();
+      }
+    }
+  }
+
+ private:
+  string fileName(size_t i) const {
+    return _tmpFilePrefix + "." + std::to_string(i);
+  }
+
+  template <size_t... Is>
+  void sortAndWriteRun(const vector<Triple>& run,
+                       std::array<ad_utility::File, NUM_ORDERS>* files,
+                       std::index_sequence<Is...>) {
+    (sortAndWriteRun<Is>(run, &(*files)[Is]), ...);
+  }
+
+  // Sort a copy of the run for the I-th comparator and write it to file
+  // asynchronously, such that the next comparator (or run) can already start.
+  template <size_t I>
+  void sortAndWriteRun(const vector<Triple>& run, ad_utility::File* file) {
+    _sortBuffer = run;
+    parallelSort(&_sortBuffer, std::get<I>(_comparators), _numThreads);
+    if (_writeFuture.valid()) {
+      _writeFuture.get();
+    }
+    std::swap(_sortBuffer, _writeBuffer);
+    _writeFuture = std::async(std::launch::async, [this, file]() {
+      file->write(_writeBuffer.data(), _writeBuffer.size() * sizeof(Triple));
+    });
+  }
+
+  string _tmpFilePrefix;
+  size_t _rowsPerRun;
+  size_t _numThreads;
+  std::tuple<Comparators...> _comparators;
+  // _runEnds[i] is the index of the first triple after the i-th run (the
+  // runs have the same sizes for all comparators).
+  vector<size_t> _runEnds;
+  vector<Triple> _sortBuffer;
+  vector<Triple> _writeBuffer;
+  std::future<void> _writeFuture;
+};
@@ -7,6 +7,7 @@
 #include <map>
 #include <set>
 #include <utility>
+#include "../util/CancellationHandle.h"
 #include "../util/HashMap.h"
 #include "../util/HashSet.h"
 
@@ -519,6 +520,9 @@ void FTSAlgorithms::multVarsAggScoresAndTakeTopKContexts(
     using AggMap = ad_utility::HashMap<vector<Id>, ScoreAndStC, IdVectorHash>;
     AggMap map;
     vector<Id> entitiesInContext;
+    // The number of keys of all cross products, to check for the cancellation
+    // of the query.
+    size_t nofKeys = 0;
     Id currentCid = cids[0];
     Score cscore = scores[0];
 
@@ -531,6 +535,7 @@ void FTSAlgorithms::multVarsAggScoresAndTakeTopKContexts(
         size_t nofPossibilities =
             static_cast<size_t>(pow(entitiesInContext.size(), nofVars));
         for (size_t j = 0; j < nofPossibilities; ++j) {
+          ad_utility::checkCancellation(++nofKeys);
           vector<Id> key;
           key.reserve(nofVars);
           size_t n = j;
@@ -566,6 +571,7 @@ void FTSAlgorithms::multVarsAggScoresAndTakeTopKContexts(
     size_t nofPossibilities =
         static_cast<size_t>(pow(entitiesInContext.size(), nofVars));
     for (size_t j = 0; j < nofPossibilities; ++j) {
+      ad_utility::checkCancellation(++nofKeys);
       vector<Id> key;
       key.reserve(nofVars);
       size_t n = j;
@@ -645,6 +651,7 @@ void FTSAlgorithms::multVarsAggScoresAndTakeTopContext(
   vector<Id> deletedKey = {{std::numeric_limits<Id>::max() - 1}};
   AggMap map;
   vector<Id> entitiesInContext;
+  size_t nofKeys = 0;
   Id currentCid = cids[0];
   Score cscore = scores[0];
 
@@ -657,6 +664,7 @@ void FTSAlgorithms::multVarsAggScoresAndTakeTopContext(
       size_t nofPossibilities =
           static_cast<size_t>(pow(entitiesInContext.size(), nofVars));
       for (size_t j = 0; j < nofPossibilities; ++j) {
+        ad_utility::checkCancellation(++nofKeys);
         vector<Id> key;
         key.reserve(nofVars);
         size_t n = j;
@@ -685,6 +693,7 @@ void FTSAlgorithms::multVarsAggScoresAndTakeTopContext(
   size_t nofPossibilities =
       static_cast<size_t>(pow(entitiesInContext.size(), nofVars));
   for (size_t j = 0; j < nofPossibilities; ++j) {
+    ad_utility::checkCancellation(++nofKeys);
     vector<Id> key;
     key.reserve(nofVars);
     size_t n = j;
@@ -766,6 +775,7 @@ void FTSAlgorithms::appendCrossProduct(
   for (size_t i = from; i < toExclusive; ++i) {
     for (size_t j = 0; j < contextSubRes1.size(); ++j) {
       for (size_t k = 0; k < contextSubRes2.size(); ++k) {
+        ad_utility::checkCancellation(res.size());
         res.emplace_back(array<Id, 5>{{eids[i], scores[i], cids[i],
                                        contextSubRes1[j], contextSubRes2[k]}});
       }
@@ -811,6 +821,7 @@ void FTSAlgorithms::appendCrossProduct(
     }
 
     for (size_t n = 0; n < nofResultRows; ++n) {
+      ad_utility::checkCancellation(res.size());
       vector<Id> resRow = {eids[i], scores[i], cids[i]};
       for (size_t j = 0; j < subResMatches.size(); ++j) {
         size_t index = n;
@@ -1027,6 +1038,7 @@ void FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts(
   using AggMap = ad_utility::HashMap<vector<Id>, ScoreAndStC, IdVectorHash>;
   AggMap map;
   vector<Id> entitiesInContext;
+  size_t nofKeys = 0;
   vector<Id> filteredEntitiesInContext;
   Id currentCid = cids[0];
   Score cscore = scores[0];
@@ -1045,6 +1057,7 @@ void FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts(
             filteredEntitiesInContext.size() *
             static_cast<size_t>(pow(entitiesInContext.size(), nofVars - 1));
         for (size_t j = 0; j < nofPossibilities; ++j) {
+          ad_utility::checkCancellation(++nofKeys);
           vector<Id> key;
           key.reserve(nofVars);
           size_t n = j;
@@ -1090,6 +1103,7 @@ void FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts(
         filteredEntitiesInContext.size() *
         static_cast<size_t>(pow(entitiesInContext.size(), nofVars - 1));
     for (size_t j = 0; j < nofPossibilities; ++j) {
+      ad_utility::checkCancellation(++nofKeys);
       vector<Id> key;
       key.reserve(nofVars);
       size_t n = j;
@@ -1199,6 +1213,7 @@ void FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts(
   using AggMap = ad_utility::HashMap<vector<Id>, ScoreAndStC, IdVectorHash>;
   AggMap map;
   vector<Id> entitiesInContext;
+  size_t nofKeys = 0;
   vector<Id> filteredEntitiesInContext;
   Id currentCid = cids[0];
   Score cscore = scores[0];
@@ -1217,6 +1232,7 @@ void FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts(
             filteredEntitiesInContext.size() *
             static_cast<size_t>(pow(entitiesInContext.size(), nofVars - 1));
         for (size_t j = 0; j < nofPossibilities; ++j) {
+          ad_utility::checkCancellation(++nofKeys);
           vector<Id> key;
           key.reserve(nofVars);
           size_t n = j;
@@ -1262,6 +1278,7 @@ void FTSAlgorithms::multVarsFilterAggScoresAndTakeTopKContexts(
         filteredEntitiesInContext.size() *
         static_cast<size_t>(pow(entitiesInContext.size(), nofVars - 1));
     for (size_t j = 0; j < nofPossibilities; ++j) {
+      ad_utility::checkCancellation(++nofKeys);
       vector<Id> key;
       key.reserve(nofVars);
       size_t n = j;
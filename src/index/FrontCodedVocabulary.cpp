@@ -0,0 +1,178 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "./FrontCodedVocabulary.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "../util/Exception.h"
+#include "../util/Log.h"
+
+namespace {
+// number of uint64_t at the end of the file.
+constexpr size_t NOF_TRAILER_ENTRIES = 5;
+
+// ___________________________________________________________________________
+void appendVarint(string* out, uint64_t value) {
+  while (value >= 128) {
+    out->push_back(static_cast<char>(value | 128));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+// ___________________________________________________________________________
+uint64_t readVarint(const char** in) {
+  uint64_t res = 0;
+  unsigned shift = 0;
+  auto ptr = reinterpret_cast<const unsigned char*>(*in);
+  while (*ptr & 128) {
+    res |= uint64_t(*ptr & 127) << shift;
+    shift += 7;
+    ++ptr;
+  }
+  res |= uint64_t(*ptr) << shift;
+  *in = reinterpret_cast<const char*>(ptr + 1);
+  return res;
+}
+
+// Append the bytes to the end of vec.
+void append(ad_utility::MmapVector<char>* vec, const void* bytes,
+            size_t nofBytes) {
+  size_t oldSize = vec->size();
+  vec->resize(oldSize + nofBytes);
+  std::memcpy(vec->data() + oldSize, bytes, nofBytes);
+}
+
+// ___________________________________________________________________________
+uint64_t readUint64(const char* ptr) {
+  uint64_t res;
+  std::memcpy(&res, ptr, sizeof(res));
+  return res;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+void FrontCodedVocabulary::buildFromTextFile(const string& textFileName,
+                                             const string& outFileName,
+                                             size_t bucketSize) {
+  LOG(INFO) << "Building front coded vocabulary " << outFileName << " from "
+            << textFileName << " ..." << std::endl;
+  AD_CHECK_GT(bucketSize, 0);
+  std::ifstream in(textFileName);
+  AD_CHECK(in.is_open());
+  ad_utility::MmapVector<char> out(outFileName, ad_utility::CreateTag());
+
+  vector<uint64_t> bucketOffsets;
+  string samples;
+  vector<uint64_t> sampleOffsets;
+  string bucket;
+  string previous;
+  string word;
+  uint64_t nofWords = 0;
+  while (std::getline(in, word)) {
+    if (nofWords % bucketSize == 0) {
+      append(&out, bucket.data(), bucket.size());
+      bucket.clear();
+      bucketOffsets.push_back(out.size());
+      sampleOffsets.push_back(samples.size());
+      samples += word;
+    } else {
+      auto mismatch = std::mismatch(previous.begin(), previous.end(),
+                                    word.begin(), word.end());
+      size_t common = mismatch.first - previous.begin();
+      appendVarint(&bucket, common);
+      appendVarint(&bucket, word.size() - common);
+      bucket.append(word, common, string::npos);
+    }
+    previous = std::move(word);
+    ++nofWords;
+  }
+  append(&out, bucket.data(), bucket.size());
+  uint64_t startOfSamples = out.size();
+  bucketOffsets.push_back(startOfSamples);
+  sampleOffsets.push_back(samples.size());
+  append(&out, samples.data(), samples.size());
+  uint64_t startOfBucketOffsets = out.size();
+  append(&out, bucketOffsets.data(), bucketOffsets.size() * sizeof(uint64_t));
+  append(&out, sampleOffsets.data(), sampleOffsets.size() * sizeof(uint64_t));
+  uint64_t nofBuckets = bucketOffsets.size() - 1;
+  std::array<uint64_t, NOF_TRAILER_ENTRIES> trailer{
+      nofWords, bucketSize, nofBuckets, startOfSamples, startOfBucketOffsets};
+  append(&out, trailer.data(), sizeof(trailer));
+  out.close();
+  LOG(INFO) << "Done, the vocabulary contains " << nofWords << " words in "
+            << nofBuckets << " buckets" << std::endl;
+}
+
+// _____________________________________________________________________________
+void FrontCodedVocabulary::initFromFile(const string& fileName) {
+  _data.open(fileName, ad_utility::AccessPattern::Random);
+  AD_CHECK_GE(_data.size(), NOF_TRAILER_ENTRIES * sizeof(uint64_t));
+  const char* trailer =
+      _data.begin() + _data.size() - NOF_TRAILER_ENTRIES * sizeof(uint64_t);
+  _nofWords = readUint64(trailer);
+  _bucketSize = readUint64(trailer + sizeof(uint64_t));
+  size_t nofBuckets = readUint64(trailer + 2 * sizeof(uint64_t));
+  size_t startOfSamples = readUint64(trailer + 3 * sizeof(uint64_t));
+  size_t startOfBucketOffsets = readUint64(trailer + 4 * sizeof(uint64_t));
+
+  // Only the samples and the offsets are copied to RAM, these are stored
+  // contiguously, so the rest of the file is never touched here.
+  _bucketOffsets.resize(nofBuckets + 1);
+  std::memcpy(_bucketOffsets.data(), _data.begin() + startOfBucketOffsets,
+              _bucketOffsets.size() * sizeof(uint64_t));
+  const char* sampleOffsets = _data.begin() + startOfBucketOffsets +
+                              _bucketOffsets.size() * sizeof(uint64_t);
+  _samples.clear();
+  _samples.reserve(nofBuckets);
+  for (size_t i = 0; i < nofBuckets; ++i) {
+    uint64_t from = readUint64(sampleOffsets + i * sizeof(uint64_t));
+    uint64_t to = readUint64(sampleOffsets + (i + 1) * sizeof(uint64_t));
+    _samples.emplace_back(_data.begin() + startOfSamples + from, to - from);
+  }
+  LOG(INFO) << "Initialized front coded vocabulary. It contains " << _nofWords
+            << " words, the in-memory index has " << bytesInRam() << " bytes."
+            << std::endl;
+}
+
+// _____________________________________________________________________________
+size_t FrontCodedVocabulary::bytesInRam() const {
+  size_t res = _bucketOffsets.size() * sizeof(uint64_t);
+  for (const auto& sample : _samples) {
+    res += sizeof(sample) + sample.capacity();
+  }
+  return res;
+}
+
+// _____________________________________________________________________________
+vector<string> FrontCodedVocabulary::decodeBucket(size_t bucket) const {
+  AD_CHECK_LT(bucket, _samples.size());
+  vector<string> res;
+  res.reserve(_bucketSize);
+  res.push_back(_samples[bucket]);
+  const char* in = _data.begin() + _bucketOffsets[bucket];
+  const char* end = _data.begin() + _bucketOffsets[bucket + 1];
+  while (in < end) {
+    size_t common = readVarint(&in);
+    size_t suffixLength = readVarint(&in);
+    string word;
+    word.reserve(common + suffixLength);
+    word.append(res.back(), 0, common);
+    word.append(in, suffixLength);
+    in += suffixLength;
+    res.push_back(std::move(word));
+  }
+  return res;
+}
+
+// _____________________________________________________________________________
+string FrontCodedVocabulary::operator[](Id id) const {
+  AD_CHECK_LT(id, _nofWords);
+  size_t bucket = id / _bucketSize;
+  size_t idxInBucket = id % _bucketSize;
+  if (idxInBucket == 0) {
+    return _samples[bucket];
+  }
+  return std::move(decodeBucket(bucket)[idxInBucket]);
+}
@@ -0,0 +1,93 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../global/Constants.h"
+#include "../global/Id.h"
+#include "../util/MmapVector.h"
+
+using std::string;
+using std::vector;
+
+//! Memory-mapped vocabulary with a small in-RAM index. The (already prefix
+//! compressed) words of a sorted vocabulary are split into buckets of
+//! bucketSize consecutive words. The first word of each bucket (the "sample")
+//! is kept in RAM, the other words of a bucket are front coded: each word is
+//! stored as the number of leading bytes it shares with the previous word of
+//! the bucket, followed by the remaining bytes.
+//! Accessing a word or searching for a word decodes at most one bucket.
+//!
+//! Layout of the file (an MmapVector<char>):
+//! <bucket_0>..<bucket_n-1><sample_0>..<sample_n-1>
+//! <bucketOffsets (n + 1) x uint64_t><sampleOffsets (n + 1) x uint64_t>
+//! <nofWords><bucketSize><nofBuckets><startOfSamples><startOfBucketOffsets>
+//! where all numbers in the last line are uint64_t. Inside the buckets the
+//! lengths are stored as varints.
+class FrontCodedVocabulary {
+ public:
+  //! Build from a text file with one word per line (e.g. the .vocabulary file
+  //! of an index). The words must already be sorted. Only the samples and
+  //! offsets are kept in RAM during the build.
+  static void buildFromTextFile(
+      const string& textFileName, const string& outFileName,
+      size_t bucketSize = FRONT_CODED_VOCABULARY_BUCKET_SIZE);
+
+  //! Map the file and read the samples and offsets to RAM.
+  void initFromFile(const string& fileName);
+
+  //! Get the word with the given id. Decodes one bucket.
+  string operator[](Id id) const;
+
+  //! Get the number of words in the vocabulary.
+  size_t size() const { return _nofWords; }
+
+  //! The number of bytes of the in-RAM index (samples and offsets).
+  size_t bytesInRam() const;
+
+  //! Returns the first Id for which pred(word) is false. pred must be true
+  //! for all words before and false for all words after this Id (like the
+  //! predicate of std::partition_point). This way both lower_bound and
+  //! upper_bound can be implemented with an arbitrary comparator.
+  //! Does a binary search on the samples and then decodes one bucket.
+  template <class Pred>
+  Id partitionPoint(Pred pred) const {
+    // first bucket whose sample is not part of the prefix.
+    size_t lower = 0;
+    size_t upper = _samples.size();
+    while (lower < upper) {
+      size_t mid = (lower + upper) / 2;
+      if (pred(_samples[mid])) {
+        lower = mid + 1;
+      } else {
+        upper = mid;
+      }
+    }
+    if (lower == 0) {
+      return 0;
+    }
+    // The result is inside bucket lower - 1, or it is the first word of the
+    // bucket lower.
+    size_t bucket = lower - 1;
+    auto words = decodeBucket(bucket);
+    for (size_t i = 1; i < words.size(); ++i) {
+      if (!pred(words[i])) {
+        return bucket * _bucketSize + i;
+      }
+    }
+    return bucket * _bucketSize + words.size();
+  }
+
+ private:
+  // Decode all the words of a bucket including its sample.
+  vector<string> decodeBucket(size_t bucket) const;
+
+  ad_utility::MmapVectorView<char> _data;
+  vector<string> _samples;
+  vector<uint64_t> _bucketOffsets;
+  size_t _nofWords = 0;
+  size_t _bucketSize = FRONT_CODED_VOCABULARY_BUCKET_SIZE;
+};
@@ -8,9 +8,29 @@
 #include "../engine/CallFixedSize.h"
 #include "../parser/ContextFileParser.h"
 #include "../util/Simple8bCode.h"
+#include "../util/StreamVByteCode.h"
 #include "./FTSAlgorithms.h"
 #include "./Index.h"
 
+namespace {
+// Decode a list that was written by Index::writeList with the given codec.
+// The nofBytes of encoded only contain the list itself (not the codebook).
+// Requires decoded to be preallocated with nofElements + 239 elements.
+template <typename Numeric>
+void decodeList(TextListCodec codec, const uint64_t* encoded, size_t nofBytes,
+                size_t nofElements, Numeric* decoded) {
+  if (codec == TextListCodec::StreamVByte) {
+    LOG(DEBUG) << "Decoding StreamVByte code...\n";
+    ad_utility::StreamVByteCode::decode(
+        reinterpret_cast<const unsigned char*>(encoded), nofBytes, nofElements,
+        decoded);
+  } else {
+    LOG(DEBUG) << "Decoding Simple8b code...\n";
+    ad_utility::Simple8bCode::decode(encoded, nofElements, decoded);
+  }
+}
+}  // namespace
+
 // _____________________________________________________________________________
 void Index::addTextFromContextFile(const string& contextFile) {
   string indexFilename = _onDiskBase + ".text.index";
@@ -352,12 +372,19 @@ ContextListMetaData Index::writePostings(ad_utility::File& out,
 
   AD_CHECK(meta._nofElements == n);
 
+  // The word and score lists only contain small codes, the gaps of the
+  // context list decide if the codec can be used.
+  if (_textListCodec == TextListCodec::StreamVByte &&
+      ad_utility::StreamVByteCode::canEncode(contextList, n)) {
+    meta._codec = TextListCodec::StreamVByte;
+  }
+
   // Do the actual writing:
   size_t bytes = 0;
 
   // Write context list:
   meta._startContextlist = _currentoff_t;
-  bytes = writeList(contextList, meta._nofElements, out);
+  bytes = writeList(contextList, meta._nofElements, meta._codec, out);
   _currentoff_t += bytes;
 
   // Write word list:
@@ -367,14 +394,14 @@ ContextListMetaData Index::writePostings(ad_utility::File& out,
   meta._startWordlist = _currentoff_t;
   if (!skipWordlistIfAllTheSame || wordCodebook.size() > 1) {
     _currentoff_t += writeCodebook(wordCodebook, out);
-    bytes = writeList(wordList, meta._nofElements, out);
+    bytes = writeList(wordList, meta._nofElements, meta._codec, out);
     _currentoff_t += bytes;
   }
 
   // Write scores
   meta._startScorelist = _currentoff_t;
   _currentoff_t += writeCodebook(scoreCodebook, out);
-  bytes = writeList(scoreList, meta._nofElements, out);
+  bytes = writeList(scoreList, meta._nofElements, meta._codec, out);
   _currentoff_t += bytes;
 
   meta._lastByte = _currentoff_t - 1;
@@ -443,11 +470,23 @@ bool Index::isEntityBlockId(Id blockId) const {
 
 // _____________________________________________________________________________
 template <typename Numeric>
-size_t Index::writeList(Numeric* data, size_t nofElements,
+size_t Index::writeList(Numeric* data, size_t nofElements, TextListCodec codec,
                         ad_utility::File& file) const {
   if (nofElements > 0) {
-    uint64_t* encoded = new uint64_t[nofElements];
-    size_t size = ad_utility::Simple8bCode::encode(data, nofElements, encoded);
+    size_t size;
+    uint64_t* encoded;
+    if (codec == TextListCodec::StreamVByte) {
+      // Pad to full 64 bit words like Simple8b, the readers rely on it.
+      size_t maxWords =
+          (ad_utility::StreamVByteCode::maxEncodedBytes(nofElements) + 7) / 8;
+      encoded = new uint64_t[maxWords]();
+      size = ad_utility::StreamVByteCode::encode(
+          data, nofElements, reinterpret_cast<unsigned char*>(encoded));
+      size = (size + 7) / 8 * 8;
+    } else {
+      encoded = new uint64_t[nofElements];
+      size = ad_utility::Simple8bCode::encode(data, nofElements, encoded);
+    }
     size_t ret = file.write(encoded, size);
     AD_CHECK_EQ(size, ret);
     delete[] encoded;
@@ -609,26 +648,26 @@ void Index::getWordPostingsForTerm(const string& term, vector<Id>& cids,
     readGapComprList(tbmd._cl._nofElements, tbmd._cl._startContextlist,
                      static_cast<size_t>(tbmd._cl._startWordlist -
                                          tbmd._cl._startContextlist),
-                     blockCids);
+                     tbmd._cl._codec, blockCids);
     readFreqComprList(
         tbmd._cl._nofElements, tbmd._cl._startWordlist,
         static_cast<size_t>(tbmd._cl._startScorelist - tbmd._cl._startWordlist),
-        blockWids);
+        tbmd._cl._codec, blockWids);
     readFreqComprList(
         tbmd._cl._nofElements, tbmd._cl._startScorelist,
         static_cast<size_t>(tbmd._cl._lastByte + 1 - tbmd._cl._startScorelist),
-        blockScores);
+        tbmd._cl._codec, blockScores);
     FTSAlgorithms::filterByRange(idRange, blockCids, blockWids, blockScores,
                                  cids, scores);
   } else {
     readGapComprList(tbmd._cl._nofElements, tbmd._cl._startContextlist,
                      static_cast<size_t>(tbmd._cl._startWordlist -
                                          tbmd._cl._startContextlist),
-                     cids);
+                     tbmd._cl._codec, cids);
     readFreqComprList(
         tbmd._cl._nofElements, tbmd._cl._startScorelist,
         static_cast<size_t>(tbmd._cl._lastByte + 1 - tbmd._cl._startScorelist),
-        scores);
+        tbmd._cl._codec, scores);
   }
   LOG(DEBUG) << "Word postings for term: " << term << ": cids: " << cids.size()
              << " scores " << scores.size() << '\n';
@@ -828,17 +867,17 @@ void Index::getEntityPostingsForTerm(const string& term, vector<Id>& cids,
                      tbmd._entityCl._startContextlist,
                      static_cast<size_t>(tbmd._entityCl._startWordlist -
                                          tbmd._entityCl._startContextlist),
-                     cids);
+                     tbmd._entityCl._codec, cids);
     readFreqComprList(tbmd._entityCl._nofElements,
                       tbmd._entityCl._startWordlist,
                       static_cast<size_t>(tbmd._entityCl._startScorelist -
                                           tbmd._entityCl._startWordlist),
-                      eids);
+                      tbmd._entityCl._codec, eids);
     readFreqComprList(tbmd._entityCl._nofElements,
                       tbmd._entityCl._startScorelist,
                       static_cast<size_t>(tbmd._entityCl._lastByte + 1 -
                                           tbmd._entityCl._startScorelist),
-                      scores);
+                      tbmd._entityCl._codec, scores);
   } else {
     // CASE: more than one word in the block.
     // Need to obtain matching postings for regular words and intersect for
@@ -855,17 +894,17 @@ void Index::getEntityPostingsForTerm(const string& term, vector<Id>& cids,
                      tbmd._entityCl._startContextlist,
                      static_cast<size_t>(tbmd._entityCl._startWordlist -
                                          tbmd._entityCl._startContextlist),
-                     eBlockCids);
+                     tbmd._entityCl._codec, eBlockCids);
     readFreqComprList(tbmd._entityCl._nofElements,
                       tbmd._entityCl._startWordlist,
                       static_cast<size_t>(tbmd._entityCl._startScorelist -
                                           tbmd._entityCl._startWordlist),
-                      eBlockWids);
+                      tbmd._entityCl._codec, eBlockWids);
     readFreqComprList(tbmd._entityCl._nofElements,
                       tbmd._entityCl._startScorelist,
                       static_cast<size_t>(tbmd._entityCl._lastByte + 1 -
                                           tbmd._entityCl._startScorelist),
-                      eBlockScores);
+                      tbmd._entityCl._codec, eBlockScores);
     FTSAlgorithms::intersect(matchingContexts, eBlockCids, eBlockWids,
                              eBlockScores, cids, eids, scores);
   }
@@ -874,15 +913,14 @@ void Index::getEntityPostingsForTerm(const string& term, vector<Id>& cids,
 // _____________________________________________________________________________
 template <typename T>
 void Index::readGapComprList(size_t nofElements, off_t from, size_t nofBytes,
-                             vector<T>& result) const {
+                             TextListCodec codec, vector<T>& result) const {
   LOG(DEBUG) << "Reading gap-encoded list from disk...\n";
   LOG(TRACE) << "NofElements: " << nofElements << ", from: " << from
              << ", nofBytes: " << nofBytes << '\n';
   result.resize(nofElements + 250);
   uint64_t* encoded = new uint64_t[nofBytes / 8];
   _textIndexFile.read(encoded, nofBytes, from);
-  LOG(DEBUG) << "Decoding Simple8b code...\n";
-  ad_utility::Simple8bCode::decode(encoded, nofElements, result.data());
+  decodeList(codec, encoded, nofBytes, nofElements, result.data());
   LOG(DEBUG) << "Reverting gaps to actual IDs...\n";
   T id = 0;
   for (size_t i = 0; i < result.size(); ++i) {
@@ -898,7 +936,7 @@ void Index::readGapComprList(size_t nofElements, off_t from, size_t nofBytes,
 // _____________________________________________________________________________
 template <typename T>
 void Index::readFreqComprList(size_t nofElements, off_t from, size_t nofBytes,
-                              vector<T>& result) const {
+                              TextListCodec codec, vector<T>& result) const {
   AD_CHECK_GT(nofBytes, 0);
   LOG(DEBUG) << "Reading frequency-encoded list from disk...\n";
   LOG(TRACE) << "NofElements: " << nofElements << ", from: " << from
@@ -915,12 +953,11 @@ void Index::readFreqComprList(size_t nofElements, off_t from, size_t nofBytes,
   ret = _textIndexFile.read(codebook, nofCodebookBytes, current);
   current += ret;
   AD_CHECK_EQ(ret, size_t(nofCodebookBytes));
-  ret = _textIndexFile.read(
-      encoded, static_cast<size_t>(nofBytes - (current - from)), current);
+  size_t nofEncodedBytes = static_cast<size_t>(nofBytes - (current - from));
+  ret = _textIndexFile.read(encoded, nofEncodedBytes, current);
   current += ret;
   AD_CHECK_EQ(size_t(current - from), nofBytes);
-  LOG(DEBUG) << "Decoding Simple8b code...\n";
-  ad_utility::Simple8bCode::decode(encoded, nofElements, result.data());
+  decodeList(codec, encoded, nofEncodedBytes, nofElements, result.data());
   LOG(DEBUG) << "Reverting frequency encoded items to actual IDs...\n";
   result.resize(nofElements);
   for (size_t i = 0; i < result.size(); ++i) {
@@ -1001,8 +1038,7 @@ void Index::dumpAsciiLists(const TextBlockMetaData& tbmd) const {
     ids.resize(nofElements + 250);
     uint64_t* encodedD = new uint64_t[nofBytes / 8];
     _textIndexFile.read(encodedD, nofBytes, from);
-    LOG(DEBUG) << "Decoding Simple8b code...\n";
-    ad_utility::Simple8bCode::decode(encodedD, nofElements, ids.data());
+    decodeList(tbmd._cl._codec, encodedD, nofBytes, nofElements, ids.data());
     ids.resize(nofElements);
     delete[] encodedD;
     writeAsciiListFile(docIdsFn, ids);
@@ -1030,8 +1066,7 @@ void Index::dumpAsciiLists(const TextBlockMetaData& tbmd) const {
           encodedW, static_cast<size_t>(nofBytes - (current - from)), current);
       current += ret;
       AD_CHECK_EQ(size_t(current - from), nofBytes);
-      LOG(DEBUG) << "Decoding Simple8b code...\n";
-      ad_utility::Simple8bCode::decode(encodedW, nofElements, ids.data());
+      decodeList(tbmd._cl._codec, encodedW, ret, nofElements, ids.data());
       ids.resize(nofElements);
       ;
       delete[] encodedW;
@@ -1058,8 +1093,7 @@ void Index::dumpAsciiLists(const TextBlockMetaData& tbmd) const {
         encodedS, static_cast<size_t>(nofBytes - (current - from)), current);
     current += ret;
     AD_CHECK_EQ(size_t(current - from), nofBytes);
-    LOG(DEBUG) << "Decoding Simple8b code...\n";
-    ad_utility::Simple8bCode::decode(encodedS, nofElements, ids.data());
+    decodeList(tbmd._cl._codec, encodedS, ret, nofElements, ids.data());
     ids.resize(nofElements);
     delete[] encodedS;
     delete[] codebookS;
@@ -1081,8 +1115,8 @@ void Index::dumpAsciiLists(const TextBlockMetaData& tbmd) const {
     ids.resize(nofElements + 250);
     uint64_t* encodedD = new uint64_t[nofBytes / 8];
     _textIndexFile.read(encodedD, nofBytes, from);
-    LOG(DEBUG) << "Decoding Simple8b code...\n";
-    ad_utility::Simple8bCode::decode(encodedD, nofElements, ids.data());
+    decodeList(tbmd._entityCl._codec, encodedD, nofBytes, nofElements,
+               ids.data());
     ids.resize(nofElements);
     delete[] encodedD;
     writeAsciiListFile(eDocIdsFn, ids);
@@ -1110,8 +1144,8 @@ void Index::dumpAsciiLists(const TextBlockMetaData& tbmd) const {
           encodedW, static_cast<size_t>(nofBytes - (current - from)), current);
       current += ret;
       AD_CHECK_EQ(size_t(current - from), nofBytes);
-      LOG(DEBUG) << "Decoding Simple8b code...\n";
-      ad_utility::Simple8bCode::decode(encodedW, nofElements, ids.data());
+      decodeList(tbmd._entityCl._codec, encodedW, ret, nofElements,
+                 ids.data());
       ids.resize(nofElements);
       ;
       delete[] encodedW;
@@ -1139,8 +1173,7 @@ void Index::dumpAsciiLists(const TextBlockMetaData& tbmd) const {
         encodedS, static_cast<size_t>(nofBytes - (current - from)), current);
     current += ret;
     AD_CHECK_EQ(size_t(current - from), nofBytes);
-    LOG(DEBUG) << "Decoding Simple8b code...\n";
-    ad_utility::Simple8bCode::decode(encodedS, nofElements, ids.data());
+    decodeList(tbmd._entityCl._codec, encodedS, ret, nofElements, ids.data());
     ids.resize(nofElements);
     ;
     delete[] encodedS;
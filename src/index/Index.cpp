@@ -6,9 +6,12 @@
 #include <cmath>
 #include <cstdio>
 #include <future>
+#include <iomanip>
 #include <optional>
+#include <sstream>
 #include <stxxl/algorithm>
 #include <stxxl/map>
+#include <thread>
 #include <unordered_map>
 
 #include "../parser/NTriplesParser.h"
@@ -17,8 +20,11 @@
 #include "../util/BatchedPipeline.h"
 #include "../util/Conversions.h"
 #include "../util/HashMap.h"
+#include "../util/Timer.h"
 #include "../util/TupleHelpers.h"
+#include "./ExternalTripleSorter.h"
 #include "./Index.h"
+#include "./PatternTrickCounts.h"
 #include "./PrefixHeuristic.h"
 #include "./VocabularyGenerator.h"
 #include "MetaDataIterator.h"
@@ -64,12 +70,24 @@ template <class Parser>
 void Index::createFromFile(const string& filename) {
   string indexFilename = _onDiskBase + ".index";
   _configurationJson["external-literals"] = _onDiskLiterals;
+  // Numbers and dates are stored in their Ids, see ValueId.h.
+  _configurationJson["inline-values"] = true;
 
   initializeVocabularySettingsBuild<Parser>();
 
   VocabularyData vocabData;
   if constexpr (std::is_same_v<std::decay_t<Parser>, TurtleParserDummy>) {
-    if (_onlyAsciiTurtlePrefixes) {
+    if (_useParallelParser) {
+      LOG(INFO) << "Parsing the Turtle input in parallel with "
+                << _numParserThreads << " threads\n";
+      if (_onlyAsciiTurtlePrefixes) {
+        vocabData = createIdTriplesAndVocab<TurtleParallelParser<TokenizerCtre>>(
+            filename);
+      } else {
+        vocabData =
+            createIdTriplesAndVocab<TurtleParallelParser<Tokenizer>>(filename);
+      }
+    } else if (_onlyAsciiTurtlePrefixes) {
       LOG(INFO) << "Using the CTRE library for Tokenization\n";
       vocabData =
           createIdTriplesAndVocab<TurtleStreamParser<TokenizerCtre>>(filename);
@@ -83,13 +101,38 @@ void Index::createFromFile(const string& filename) {
     vocabData = createIdTriplesAndVocab<Parser>(filename);
   }
 
-  // also perform unique for first permutation
-  createPermutationPair<IndexMetaDataHmapDispatcher>(&vocabData, _PSO, _POS,
-                                                     true);
-  // also create Patterns after the Spo permutation if specified
-  createPermutationPair<IndexMetaDataMmapDispatcher>(&vocabData, _SPO, _SOP,
-                                                     false, _usePatterns);
-  createPermutationPair<IndexMetaDataMmapDispatcher>(&vocabData, _OSP, _OPS);
+  {
+    // Create the sorted runs for the PSO, SPO and OSP orders in one pass over
+    // the triples. Before each pair of permutations is created, the runs of
+    // its order are merged back into the triple vector (without duplicates,
+    // which are not supported by RDF).
+    ExternalTripleSorter sorter(_onDiskBase + ".permutation-sort-tmp",
+                                _sortMemoryInBytes,
+                                std::max(1u, std::thread::hardware_concurrency()),
+                                _PSO._comp, _SPO._comp, _OSP._comp);
+    LOG(INFO) << "Sorting the triples for all permutations, using "
+              << (_sortMemoryInBytes >> 20) << " MB of memory" << std::endl;
+    {
+      TripleVec::bufreader_type reader(*vocabData.idTriples);
+      sorter.createRuns(&reader);
+    }
+    auto mergeInto = [&sorter, &vocabData](auto order) {
+      vocabData.idTriples->clear();
+      TripleVec::bufwriter_type writer(*vocabData.idTriples);
+      size_t numTriples = sorter.template merge<decltype(order)::value>(&writer);
+      writer.finish();
+      LOG(INFO) << "Sort done, " << numTriples << " distinct triples"
+                << std::endl;
+    };
+    mergeInto(std::integral_constant<size_t, 0>{});
+    createPermutationPair<IndexMetaDataHmapDispatcher>(&vocabData, _PSO, _POS);
+    mergeInto(std::integral_constant<size_t, 1>{});
+    // also create Patterns after the Spo permutation if specified
+    createPermutationPair<IndexMetaDataMmapDispatcher>(&vocabData, _SPO, _SOP,
+                                                       _usePatterns);
+    mergeInto(std::integral_constant<size_t, 2>{});
+    createPermutationPair<IndexMetaDataMmapDispatcher>(&vocabData, _OSP, _OPS);
+  }
 
   // if we have no compression, this will also copy the whole vocabulary.
   // but since we expect compression to be the default case, this  should not
@@ -121,6 +164,8 @@ void Index::createFromFile(const string& filename) {
               << ". Terminating...\n";
     AD_CHECK(false);
   }
+  FrontCodedVocabulary::buildFromTextFile(
+      vocabFile, vocabFile + FRONT_CODED_VOCABULARY_SUFFIX);
   writeConfiguration();
 }
 
@@ -137,7 +182,13 @@ template void Index::createFromFile<TurtleParserDummy>(const string& filename);
 template <class Parser>
 VocabularyData Index::passFileForVocabulary(const string& filename,
                                             size_t linesPerPartial) {
-  auto parser = std::make_shared<Parser>(filename);
+  std::shared_ptr<Parser> parser;
+  if constexpr (std::is_same_v<Parser, TurtleParallelParser<Tokenizer>> ||
+                std::is_same_v<Parser, TurtleParallelParser<TokenizerCtre>>) {
+    parser = std::make_shared<Parser>(filename, _numParserThreads);
+  } else {
+    parser = std::make_shared<Parser>(filename);
+  }
   std::unique_ptr<TripleVec> idTriples(new TripleVec());
   TripleVec::bufwriter_type writer(*idTriples);
   bool parserExhausted = false;
@@ -323,34 +374,107 @@ void Index::convertPartialToGlobalIds(
   LOG(INFO) << "Pass done.\n";
 }
 
-pair<FullRelationMetaData, BlockBasedRelationMetaData> Index::writeSwitchedRel(
-    ad_utility::File* out, off_t lastOffset, Id currentRel,
-    ad_utility::BufferedVector<array<Id, 2>>* bufPtr) {
-  // sort according to the "switched" relation.
-  auto& buffer = *bufPtr;
+namespace {
+// The (col1, col2) pairs of one relation inside a RelationBatch.
+struct PairRange {
+  const array<Id, 2>* _begin;
+  size_t _size;
+  size_t size() const { return _size; }
+  const array<Id, 2>& operator[](size_t i) const { return _begin[i]; }
+};
+
+// Consecutive relations of a permutation pair that are handed to the writers
+// of both permutations at once.
+struct RelationBatch {
+  struct Relation {
+    Id _relId;
+    size_t _begin;
+    size_t _size;
+  };
 
-  for (auto& el : buffer) {
-    std::swap(el[0], el[1]);
+  explicit RelationBatch(const string& tmpFilePrefix)
+      : _pairs(THRESHOLD_RELATION_CREATION, tmpFilePrefix + ".pairs"),
+        _switched(THRESHOLD_RELATION_CREATION, tmpFilePrefix + ".switched") {}
+
+  void clear() {
+    _pairs.clear();
+    _switched.clear();
+    _relations.clear();
+  }
+
+  // (col1, col2) of all relations, sorted like the input.
+  ad_utility::BufferedVector<array<Id, 2>> _pairs;
+  // (col2, col1) of all relations, only sorted within each relation after
+  // sortSwitched().
+  ad_utility::BufferedVector<array<Id, 2>> _switched;
+  vector<Relation> _relations;
+};
+
+// Sort the switched pairs of each relation of the batch. The relations are
+// split into numThreads groups of roughly the same number of pairs that are
+// sorted concurrently.
+void sortSwitched(RelationBatch* batch, size_t numThreads) {
+  auto sortRelations = [batch](size_t from, size_t to) {
+    for (size_t i = from; i < to; ++i) {
+      auto begin = batch->_switched.begin() + batch->_relations[i]._begin;
+      std::sort(begin, begin + batch->_relations[i]._size);
+    }
+  };
+  const size_t pairsPerThread = batch->_switched.size() / numThreads + 1;
+  vector<std::future<void>> futures;
+  size_t from = 0;
+  size_t numPairs = 0;
+  for (size_t i = 0; i < batch->_relations.size(); ++i) {
+    numPairs += batch->_relations[i]._size;
+    if (numPairs >= pairsPerThread || i + 1 == batch->_relations.size()) {
+      futures.push_back(std::async(std::launch::async, sortRelations, from,
+                                   i + 1));
+      from = i + 1;
+      numPairs = 0;
+    }
   }
-  std::sort(buffer.begin(), buffer.end(), [](const auto& a, const auto& b) {
-    return a[0] == b[0] ? a[1] < b[1] : a[0] < b[0];
-  });
-
-  Id lastLhs = std::numeric_limits<Id>::max();
+  for (auto& f : futures) {
+    f.get();
+  }
+}
 
-  bool functional = true;
-  size_t distinctC1 = 0;
-  for (const auto& el : buffer) {
-    if (el[0] == lastLhs) {
-      functional = false;
-    } else {
-      distinctC1++;
+// Write the relations of a batch (from pairs, which have to be sorted within
+// each relation) to out and add them to metaData. The time spent is added to
+// timer.
+template <class MetaData>
+void writeBatch(const ad_utility::BufferedVector<array<Id, 2>>& pairs,
+                const vector<RelationBatch::Relation>& relations,
+                ad_utility::File* out, MetaData* metaData,
+                ad_utility::Timer* timer) {
+  timer->cont();
+  for (const auto& rel : relations) {
+    PairRange range{pairs.data() + rel._begin, rel._size};
+    bool functional = true;
+    size_t distinctC1 = 1;
+    for (size_t i = 1; i < range.size(); ++i) {
+      if (range[i][0] == range[i - 1][0]) {
+        functional = false;
+      } else {
+        distinctC1++;
+      }
     }
-    lastLhs = el[0];
+    auto md = Index::writeRel(*out, metaData->getOffsetAfter(), rel._relId,
+                              range, distinctC1, functional);
+    metaData->add(md.first, md.second);
   }
+  timer->stop();
+}
 
-  return writeRel(*out, lastOffset, currentRel, buffer, distinctC1, functional);
+// The throughput of writing a permutation for the log.
+string throughput(off_t bytes, const ad_utility::Timer& timer) {
+  double megaBytes = bytes / double(1 << 20);
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(1) << megaBytes << " MB in "
+     << timer.secs() << " s ("
+     << megaBytes / std::max(timer.secs(), 0.001f) << " MB/s)";
+  return os.str();
 }
+}  // namespace
 
 // _____________________________________________________________________________
 template <class MetaDataDispatcher>
@@ -378,54 +502,67 @@ Index::createPermutationPairImpl(const string& fileName1,
 
   LOG(INFO) << "Creating a pair of on-disk index permutation of " << vec.size()
             << " elements / facts." << std::endl;
-  // Iterate over the vector and identify relation boundaries
-  size_t from = 0;
-  Id currentRel = vec[0][c0];
-  off_t lastOffset1 = 0;
-  off_t lastOffset2 = 0;
-  ad_utility::BufferedVector<array<Id, 2>> buffer(
-      THRESHOLD_RELATION_CREATION, fileName1 + ".tmp.MmapBuffer");
-  bool functional = true;
-  size_t distinctC1 = 1;
-  size_t sizeOfRelation = 0;
-  Id lastLhs = std::numeric_limits<Id>::max();
+  // The relations are collected in batches of about
+  // THRESHOLD_RELATION_CREATION pairs. While one batch is filled, the previous
+  // one is written to both permutations concurrently (the second permutation
+  // first has to sort the switched pairs of each relation).
+  const size_t numThreads =
+      std::max<size_t>(1, std::thread::hardware_concurrency());
+  std::array<RelationBatch, 2> batches{
+      {RelationBatch(fileName1 + ".tmp.batch0"),
+       RelationBatch(fileName1 + ".tmp.batch1")}};
+  ad_utility::Timer timer1;
+  ad_utility::Timer timer2;
+  std::future<void> writer1;
+  std::future<void> writer2;
+  auto waitForWriters = [&writer1, &writer2]() {
+    if (writer1.valid()) {
+      writer1.get();
+    }
+    if (writer2.valid()) {
+      writer2.get();
+    }
+  };
+  auto submit = [&](RelationBatch* batch) {
+    waitForWriters();
+    writer1 = std::async(std::launch::async, [&, batch]() {
+      writeBatch(batch->_pairs, batch->_relations, &out1, &metaData1, &timer1);
+    });
+    writer2 = std::async(std::launch::async, [&, batch]() {
+      timer2.cont();
+      sortSwitched(batch, numThreads);
+      timer2.stop();
+      writeBatch(batch->_switched, batch->_relations, &out2, &metaData2,
+                 &timer2);
+    });
+  };
+
+  RelationBatch* batch = &batches[0];
   for (TripleVec::bufreader_type reader(vec); !reader.empty(); ++reader) {
-    if ((*reader)[c0] != currentRel) {
-      auto md = writeRel(out1, lastOffset1, currentRel, buffer, distinctC1,
-                         functional);
-      metaData1.add(md.first, md.second);
-      auto md2 = writeSwitchedRel(&out2, lastOffset2, currentRel, &buffer);
-      metaData2.add(md2.first, md2.second);
-      buffer.clear();
-      distinctC1 = 1;
-      lastOffset1 = metaData1.getOffsetAfter();
-      lastOffset2 = metaData2.getOffsetAfter();
-      currentRel = (*reader)[c0];
-      functional = true;
-    } else {
-      sizeOfRelation++;
-      if ((*reader)[c1] == lastLhs) {
-        functional = false;
-      } else {
-        distinctC1++;
+    const auto& triple = *reader;
+    if (batch->_relations.empty() ||
+        triple[c0] != batch->_relations.back()._relId) {
+      if (batch->_pairs.size() >= THRESHOLD_RELATION_CREATION) {
+        submit(batch);
+        batch = batch == &batches[0] ? &batches[1] : &batches[0];
+        // The writers of this batch were already waited for by submit.
+        batch->clear();
       }
+      batch->_relations.push_back({triple[c0], batch->_pairs.size(), 0});
     }
-    buffer.push_back(array<Id, 2>{{(*reader)[c1], (*reader)[c2]}});
-    lastLhs = (*reader)[c1];
-  }
-  if (from < vec.size()) {
-    auto md =
-        writeRel(out1, lastOffset1, currentRel, buffer, distinctC1, functional);
-    metaData1.add(md.first, md.second);
-
-    auto md2 = writeSwitchedRel(&out2, lastOffset2, currentRel, &buffer);
-    metaData2.add(md2.first, md2.second);
+    batch->_relations.back()._size++;
+    batch->_pairs.push_back(array<Id, 2>{{triple[c1], triple[c2]}});
+    batch->_switched.push_back(array<Id, 2>{{triple[c2], triple[c1]}});
   }
+  submit(batch);
+  waitForWriters();
 
+  // The statistics were updated by IndexMetaData::add on the fly.
   LOG(INFO) << "Done creating index permutation." << std::endl;
-  LOG(INFO) << "Calculating statistics for these permutation.\n";
-  metaData1.calculateExpensiveStatistics();
-  metaData2.calculateExpensiveStatistics();
+  LOG(INFO) << "Wrote " << fileName1 << ": "
+            << throughput(metaData1.getOffsetAfter(), timer1) << std::endl;
+  LOG(INFO) << "Wrote " << fileName2 << ": "
+            << throughput(metaData2.getOffsetAfter(), timer2) << std::endl;
   LOG(INFO) << "Writing statistics for this permutation:\n"
             << metaData1.statistics() << std::endl;
   LOG(INFO) << "Writing statistics for this permutation:\n"
@@ -446,24 +583,7 @@ Index::createPermutations(
     const PermutationImpl<Comparator1, typename MetaDataDispatcher::ReadType>&
         p1,
     const PermutationImpl<Comparator2, typename MetaDataDispatcher::ReadType>&
-        p2,
-    bool performUnique) {
-  LOG(INFO) << "Sorting for " << p1._readableName << " permutation..."
-            << std::endl;
-  stxxl::sort(begin(*vec), end(*vec), p1._comp, STXXL_MEMORY_TO_USE);
-  LOG(INFO) << "Sort done." << std::endl;
-
-  if (performUnique) {
-    // this only has to be done for the first permutation (PSO)
-    LOG(INFO) << "Removing duplicate triples as these are not supported in RDF"
-              << std::endl;
-    LOG(INFO) << "Size before: " << vec->size() << std::endl;
-    auto last = std::unique(begin(*vec), end(*vec));
-    vec->resize(size_t(last - vec->begin()));
-    LOG(INFO) << "Done: unique." << std::endl;
-    LOG(INFO) << "Size after: " << vec->size() << std::endl;
-  }
-
+        p2) {
   return createPermutationPairImpl<MetaDataDispatcher>(
       _onDiskBase + ".index" + p1._fileSuffix,
       _onDiskBase + ".index" + p2._fileSuffix, *vec, p1._keyOrder[0],
@@ -478,9 +598,9 @@ void Index::createPermutationPair(
         p1,
     const PermutationImpl<Comparator2, typename MetaDataDispatcher::ReadType>&
         p2,
-    bool performUnique, bool createPatternsAfterFirst) {
+    bool createPatternsAfterFirst) {
   auto metaData = createPermutations<MetaDataDispatcher>(
-      &(*vocabData->idTriples), p1, p2, performUnique);
+      &(*vocabData->idTriples), p1, p2);
   if (createPatternsAfterFirst) {
     // the second permutation does not alter the original triple vector,
     // so this does still work.
@@ -522,6 +642,8 @@ void Index::exchangeMultiplicities(MetaData* m1, MetaData* m2) {
 
 // _____________________________________________________________________________
 void Index::addPatternsToExistingIndex() {
+  // the pattern trick tables of the old patterns are no longer valid.
+  std::remove((_onDiskBase + PATTERN_TRICK_TABLES_SUFFIX).c_str());
   auto [langPredLowerBound, langPredUpperBound] = _vocab.prefix_range("@");
   createPatternsImpl<MetaDataIterator<IndexMetaDataMmapView>,
                      IndexMetaDataMmapView, ad_utility::File>(
@@ -532,6 +654,111 @@ void Index::addPatternsToExistingIndex() {
       _SPO._file);
 }
 
+// _____________________________________________________________________________
+void Index::createPatternTrickTables(size_t nofTypes) {
+  throwExceptionIfNoPatterns();
+  LOG(INFO) << "Creating the pattern trick tables ..." << std::endl;
+  PatternTrickTables tables;
+  auto count = [this](auto subjectAt, size_t nofRows) {
+    return predicateCountTable(
+        countPredicates(subjectAt, nofRows, _hasPattern, _hasPredicate,
+                        _patterns.size(), NOF_PATTERN_TRICK_THREADS,
+                        PATTERN_TRICK_MIN_ENTITIES_PER_THREAD),
+        _patterns);
+  };
+  tables.setAllEntities(
+      count([](size_t i) -> std::optional<Id> { return i; },
+            std::max(_hasPattern.size(), _hasPredicate.size())));
+
+  for (const string& typePredicate : PATTERN_TRICK_TYPE_PREDICATES) {
+    Id predicateId;
+    if (!_vocab.getId(typePredicate, &predicateId)) {
+      continue;
+    }
+    // The pairs (type, entity), sorted by the type.
+    IdTable typeEntities(2);
+    scan(predicateId, &typeEntities, _POS);
+    // The ranges of the rows of each type.
+    vector<std::pair<size_t, size_t>> typeRanges;
+    for (size_t i = 0; i < typeEntities.size(); ++i) {
+      if (i == 0 || typeEntities(i, 0) != typeEntities(i - 1, 0)) {
+        typeRanges.emplace_back(i, i);
+      }
+      typeRanges.back().second = i + 1;
+    }
+    auto largerRange = [](const auto& a, const auto& b) {
+      return a.second - a.first > b.second - b.first;
+    };
+    size_t nofTables = std::min(nofTypes, typeRanges.size());
+    std::partial_sort(typeRanges.begin(), typeRanges.begin() + nofTables,
+                      typeRanges.end(), largerRange);
+    for (size_t i = 0; i < nofTables; ++i) {
+      auto [begin, end] = typeRanges[i];
+      tables.addType(
+          predicateId, typeEntities(begin, 0),
+          count(
+              [&typeEntities, begin = begin](size_t j) -> std::optional<Id> {
+                return typeEntities(begin + j, 1);
+              },
+              end - begin));
+    }
+  }
+  tables.writeToFile(_onDiskBase + PATTERN_TRICK_TABLES_SUFFIX);
+  LOG(INFO) << "Done creating the pattern trick tables for all entities and "
+            << tables.getNofTypes() << " types." << std::endl;
+  _patternTrickTables = std::move(tables);
+}
+
+// _____________________________________________________________________________
+void Index::createRelationStatistics() {
+  LOG(INFO) << "Creating the relation statistics ..." << std::endl;
+  vector<Id> predicates;
+  const auto& posData = _POS.metaData().data();
+  for (auto it = posData.cbegin(); it != posData.cend(); ++it) {
+    predicates.push_back(it->first);
+  }
+  std::sort(predicates.begin(), predicates.end());
+
+  RelationStatistics statistics;
+  WidthTwoList block(NOF_PAIRS_PER_COMPRESSED_BLOCK);
+  for (Id predicate : predicates) {
+    // The first column of the PSO relation are the sorted subjects.
+    size_t nofDistinctSubjects = 0;
+    if (_PSO.metaData().relationExists(predicate)) {
+      CompressedRelation::PairReader reader(
+          _PSO._file, _PSO.metaData().getRmd(predicate)._rmdPairs,
+          _PSO.metaData().getVersion());
+      Id lastSubject = 0;
+      while (size_t nofPairs = reader.readNextBlock(block.data()->data())) {
+        for (size_t i = 0; i < nofPairs; ++i) {
+          if (nofDistinctSubjects == 0 || block[i][0] != lastSubject) {
+            ++nofDistinctSubjects;
+            lastSubject = block[i][0];
+          }
+        }
+      }
+    }
+    // The first column of the POS relation are the sorted objects.
+    const FullRelationMetaData& rmd =
+        _POS.metaData().getRmd(predicate)._rmdPairs;
+    PredicateStatisticsBuilder builder(rmd.getNofElements(),
+                                       NOF_RELATION_HISTOGRAM_BUCKETS,
+                                       NOF_RELATION_HEAVY_HITTERS);
+    CompressedRelation::PairReader reader(_POS._file, rmd,
+                                          _POS.metaData().getVersion());
+    while (size_t nofPairs = reader.readNextBlock(block.data()->data())) {
+      for (size_t i = 0; i < nofPairs; ++i) {
+        builder.addObject(block[i][0]);
+      }
+    }
+    statistics.add(predicate, builder.finish(nofDistinctSubjects));
+  }
+  statistics.writeToFile(_onDiskBase + RELATION_STATISTICS_SUFFIX);
+  LOG(INFO) << "Done creating the relation statistics for "
+            << statistics.size() << " predicates." << std::endl;
+  _relationStatistics = std::move(statistics);
+}
+
 // _____________________________________________________________________________
 void Index::createPatterns(bool vecAlreadySorted, VocabularyData* vocabData) {
   if (vecAlreadySorted) {
@@ -542,6 +769,8 @@ void Index::createPatterns(bool vecAlreadySorted, VocabularyData* vocabData) {
                 SortBySPO(), STXXL_MEMORY_TO_USE);
     LOG(INFO) << "Sort done." << std::endl;
   }
+  // the pattern trick tables of the old patterns are no longer valid.
+  std::remove((_onDiskBase + PATTERN_TRICK_TABLES_SUFFIX).c_str());
   createPatternsImpl<TripleVec::bufreader_type>(
       _onDiskBase + ".index.patterns", _hasPredicate, _hasPattern, _patterns,
       _fullHasPredicateMultiplicityEntities,
@@ -881,10 +1110,10 @@ void Index::createPatternsImpl(const string& fileName,
 }
 
 // _____________________________________________________________________________
+template <class Container>
 pair<FullRelationMetaData, BlockBasedRelationMetaData> Index::writeRel(
-    ad_utility::File& out, off_t currentOffset, Id relId,
-    const ad_utility::BufferedVector<array<Id, 2>>& data, size_t distinctC1,
-    bool functional) {
+    ad_utility::File& out, off_t currentOffset, Id relId, const Container& data,
+    size_t distinctC1, bool functional) {
   LOG(TRACE) << "Writing a relation ...\n";
   AD_CHECK_GT(data.size(), 0);
   LOG(TRACE) << "Calculating multiplicities ...\n";
@@ -896,52 +1125,49 @@ pair<FullRelationMetaData, BlockBasedRelationMetaData> Index::writeRel(
       relId, currentOffset, data.size(), multC1, multC2, functional,
       !functional && data.size() > USE_BLOCKS_INDEX_SIZE_TRESHOLD);
 
-  // Write the full pair index.
-  out.write(data.data(), data.size() * 2 * sizeof(Id));
   pair<FullRelationMetaData, BlockBasedRelationMetaData> ret;
   ret.first = rmd;
 
+  // Write the full pair index in compressed blocks. For functional relations
+  // these blocks directly serve as the blocks of the relation's meta data.
+  off_t afterPairs = CompressedRelation::writePairs(
+      out, currentOffset, data,
+      functional && rmd.hasBlocks() ? &ret.second._blocks : nullptr);
+
   if (functional) {
-    writeFunctionalRelation(data, ret);
+    writeFunctionalRelation(afterPairs, ret);
   } else {
-    writeNonFunctionalRelation(out, data, ret);
+    writeNonFunctionalRelation(out, afterPairs, data, ret);
   };
+  if (!rmd.hasBlocks()) {
+    // The meta data needs the end of a compressed relation, see
+    // IndexMetaData::add.
+    ret.second._offsetAfter = afterPairs;
+  }
   LOG(TRACE) << "Done writing relation.\n";
   return ret;
 }
 
 // _____________________________________________________________________________
 void Index::writeFunctionalRelation(
-    const BufferedVector<array<Id, 2>>& data,
+    off_t afterPairs,
     pair<FullRelationMetaData, BlockBasedRelationMetaData>& rmd) {
   // Only has to do something if there are blocks.
   if (rmd.first.hasBlocks()) {
     LOG(TRACE) << "Writing part for functional relation ...\n";
-    // Do not write extra LHS and RHS lists.
-    rmd.second._startRhs =
-        rmd.first._startFullIndex + rmd.first.getNofBytesForFulltextIndex();
+    // Do not write extra LHS and RHS lists. The blocks are the compressed
+    // blocks of the pair index and were already set by writeRel.
+    rmd.second._startRhs = afterPairs;
     // Since the relation is functional, there are no lhs lists and thus this
     // is trivial.
     rmd.second._offsetAfter = rmd.second._startRhs;
-    // Create the block data for the meta data.
-    // Blocks are offsets into the full pair index for functional relations.
-    size_t nofDistinctLhs = 0;
-    Id lastLhs = std::numeric_limits<Id>::max();
-    for (size_t i = 0; i < data.size(); ++i) {
-      if (data[i][0] != lastLhs) {
-        if (nofDistinctLhs % DISTINCT_LHS_PER_BLOCK == 0) {
-          rmd.second._blocks.emplace_back(BlockMetaData(
-              data[i][0], rmd.first._startFullIndex + i * 2 * sizeof(Id)));
-        }
-        ++nofDistinctLhs;
-      }
-    }
   }
 }
 
 // _____________________________________________________________________________
+template <class Container>
 void Index::writeNonFunctionalRelation(
-    ad_utility::File& out, const BufferedVector<array<Id, 2>>& data,
+    ad_utility::File& out, off_t startOfLhs, const Container& data,
     pair<FullRelationMetaData, BlockBasedRelationMetaData>& rmd) {
   // Only has to do something if there are blocks.
   if (rmd.first.hasBlocks()) {
@@ -964,8 +1190,7 @@ void Index::writeNonFunctionalRelation(
     }
 
     // Go over the Lhs data once more and adjust the offsets.
-    off_t startRhs = rmd.first.getStartOfLhs() +
-                     nofDistinctLhs * (sizeof(Id) + sizeof(off_t));
+    off_t startRhs = startOfLhs + nofDistinctLhs * (sizeof(Id) + sizeof(off_t));
 
     for (size_t i = 0; i < nofDistinctLhs; ++i) {
       bufLhs[i].second += startRhs;
@@ -985,8 +1210,7 @@ void Index::writeNonFunctionalRelation(
     for (size_t i = 0; i < nofDistinctLhs; ++i) {
       if (i % DISTINCT_LHS_PER_BLOCK == 0) {
         rmd.second._blocks.emplace_back(BlockMetaData(
-            bufLhs[i].first,
-            rmd.first.getStartOfLhs() + i * (sizeof(Id) + sizeof(off_t))));
+            bufLhs[i].first, startOfLhs + i * (sizeof(Id) + sizeof(off_t))));
       }
     }
     delete[] bufLhs;
@@ -998,17 +1222,37 @@ void Index::writeNonFunctionalRelation(
 void Index::createFromOnDiskIndex(const string& onDiskBase) {
   setOnDiskBase(onDiskBase);
   readConfiguration();
-  _vocab.readFromFile(_onDiskBase + ".vocabulary",
-                      _onDiskLiterals ? _onDiskBase + ".literals-index" : "");
+  string vocabFile = _onDiskBase + ".vocabulary";
+  string extLitsFile = _onDiskLiterals ? _onDiskBase + ".literals-index" : "";
+  if (_onDiskVocabulary) {
+    string frontCodedFile = vocabFile + FRONT_CODED_VOCABULARY_SUFFIX;
+    if (!ad_utility::File::exists(frontCodedFile)) {
+      // indices built with an older version only have the text vocabulary.
+      LOG(INFO) << "No front coded vocabulary found, creating it ...\n";
+      FrontCodedVocabulary::buildFromTextFile(vocabFile, frontCodedFile);
+    }
+    _vocab.readFromFrontCodedFile(frontCodedFile, extLitsFile);
+  } else {
+    _vocab.readFromFile(vocabFile, extLitsFile);
+  }
 
   _totalVocabularySize = _vocab.size() + _vocab.getExternalVocab().size();
   LOG(INFO) << "total vocab size is " << _totalVocabularySize << std::endl;
+  _numberOrder = NumberOrder::fromVocabulary(_vocab);
+  LOG(INFO) << "Numbers that are stored in the vocabulary: "
+            << _numberOrder.size() << std::endl;
   _PSO.loadFromDisk(_onDiskBase);
   _POS.loadFromDisk(_onDiskBase);
   _OPS.loadFromDisk(_onDiskBase);
   _OSP.loadFromDisk(_onDiskBase);
   _SPO.loadFromDisk(_onDiskBase);
   _SOP.loadFromDisk(_onDiskBase);
+  string statisticsFile = _onDiskBase + RELATION_STATISTICS_SUFFIX;
+  if (ad_utility::File::exists(statisticsFile)) {
+    _relationStatistics.readFromFile(statisticsFile);
+    LOG(INFO) << "Read the relation statistics for "
+              << _relationStatistics.size() << " predicates." << std::endl;
+  }
 
   if (_usePatterns) {
     // Read the pattern info from the patterns file
@@ -1097,6 +1341,12 @@ void Index::createFromOnDiskIndex(const string& onDiskBase) {
       }
       _hasPredicate.build(hasPredicateTmp);
     }
+    string tablesFile = _onDiskBase + PATTERN_TRICK_TABLES_SUFFIX;
+    if (ad_utility::File::exists(tablesFile)) {
+      _patternTrickTables.readFromFile(tablesFile);
+      LOG(INFO) << "Read the pattern trick tables for "
+                << _patternTrickTables.getNofTypes() << " types." << std::endl;
+    }
   }
 }
 
@@ -1156,9 +1406,11 @@ void Index::scanFunctionalRelation(const pair<off_t, size_t>& blockOff,
     return;
   }
   LOG(TRACE) << "Scanning functional relation ...\n";
-  WidthTwoList block;
-  block.resize(blockOff.second / (2 * sizeof(Id)));
-  indexFile.read(block.data(), blockOff.second, blockOff.first);
+  // The blocks of functional relations are compressed blocks of the pair
+  // index.
+  vector<unsigned char> compressedBlock(blockOff.second);
+  indexFile.read(compressedBlock.data(), blockOff.second, blockOff.first);
+  WidthTwoList block = CompressedRelation::decompressBlock(compressedBlock.data());
   auto it = std::lower_bound(
       block.begin(), block.end(), lhsId,
       [](const array<Id, 2>& elem, Id key) { return elem[0] < key; });
@@ -1292,6 +1544,13 @@ template void Index::writeAsciiListFile<vector<Id>>(
 template void Index::writeAsciiListFile<vector<Score>>(
     const string& filename, const vector<Score>& ids) const;
 
+// used by the MetaDataConverter
+template pair<FullRelationMetaData, BlockBasedRelationMetaData>
+Index::writeRel<BufferedVector<array<Id, 2>>>(
+    ad_utility::File& out, off_t currentOffset, Id relId,
+    const BufferedVector<array<Id, 2>>& data, size_t distinctC1,
+    bool functional);
+
 // _____________________________________________________________________________
 bool Index::isLiteral(const string& object) {
   return decltype(_vocab)::isLiteral(object);
@@ -1317,6 +1576,11 @@ void Index::setOnDiskLiterals(bool onDiskLiterals) {
   _onDiskLiterals = onDiskLiterals;
 }
 
+// ____________________________________________________________________________
+void Index::setOnDiskVocabulary(bool onDiskVocabulary) {
+  _onDiskVocabulary = onDiskVocabulary;
+}
+
 // ____________________________________________________________________________
 void Index::setOnDiskBase(const std::string& onDiskBase) {
   _onDiskBase = onDiskBase;
@@ -1340,6 +1604,14 @@ void Index::setPrefixCompression(bool compressed) {
   _vocabPrefixCompressed = compressed;
 }
 
+// ____________________________________________________________________________
+void Index::setSortMemory(size_t sortMemoryInBytes) {
+  _sortMemoryInBytes = sortMemoryInBytes;
+}
+
+// ____________________________________________________________________________
+void Index::setTextListCodec(TextListCodec codec) { _textListCodec = codec; }
+
 // ____________________________________________________________________________
 void Index::writeConfiguration() const {
   std::ofstream f(_onDiskBase + CONFIGURATION_FILE);
@@ -1401,6 +1673,14 @@ void Index::readConfiguration() {
     _vocab.initializeInternalizedLangs(
         _configurationJson["languages-internal"]);
   }
+
+  if (!_configurationJson.count("inline-values")) {
+    LOG(ERROR) << "Key \"inline-values\" is missing in the metadata. This "
+                  "index stores numbers and dates in its vocabulary, which is "
+                  "no longer supported by QLever. Please rebuild your index\n";
+    throw std::runtime_error(
+        "Missing required key \"inline-values\" in index build's metadata");
+  }
 }
 
 // ___________________________________________________________________________
@@ -1514,6 +1794,19 @@ void Index::initializeVocabularySettingsBuild() {
     }
   }
 
+  if (j.count("parallel-parsing")) {
+    if constexpr (std::is_same_v<std::decay_t<Parser>, TurtleParserDummy>) {
+      _useParallelParser = j["parallel-parsing"];
+      if (j.count("num-parser-threads")) {
+        _numParserThreads = j["num-parser-threads"];
+      }
+    } else {
+      LOG(WARN) << "You specified parallel-parsing but a parser that is not "
+                   "the Turtle stream parser. This means that this setting "
+                   "is ignored\n";
+    }
+  }
+
   if (j.count("num-triples-per-partial-vocab")) {
     _numTriplesPerPartialVocab = j["num-triples-per-partial-vocab"];
     LOG(INFO) << "Overriding setting num-triples-per-partial-vocab to "
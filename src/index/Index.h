@@ -21,10 +21,14 @@
 #include "../util/File.h"
 #include "../util/HashMap.h"
 #include "../util/MmapVector.h"
+#include "./CompressedRelation.h"
 #include "./ConstantsIndexCreation.h"
 #include "./DocsDB.h"
 #include "./IndexBuilderTypes.h"
 #include "./IndexMetaData.h"
+#include "./NumberOrder.h"
+#include "./PatternTrickTables.h"
+#include "./RelationStatistics.h"
 #include "./Permutations.h"
 #include "./StxxlSortFunctors.h"
 #include "./TextMetaData.h"
@@ -136,6 +140,17 @@ class Index {
 
   void addPatternsToExistingIndex();
 
+  // Precompute the results of the pattern trick for all entities and for the
+  // entities of the nofTypes most frequent objects of each of the
+  // PATTERN_TRICK_TYPE_PREDICATES and write them to the pattern trick tables
+  // file. Requires a loaded index with patterns.
+  void createPatternTrickTables(size_t nofTypes);
+
+  // Compute the PredicateStatistics of all predicates from the POS and PSO
+  // permutations and write them to the relation statistics file. Requires a
+  // loaded index.
+  void createRelationStatistics();
+
   // Creates an index object from an on disk index
   // that has previously been constructed.
   // Read necessary meta data into memory and opens file handles.
@@ -184,6 +199,16 @@ class Index {
   const vector<PatternID>& getHasPattern() const;
   const CompactStringVector<Id, Id>& getHasPredicate() const;
   const CompactStringVector<size_t, Id>& getPatterns() const;
+  // Empty if the index has no pattern trick tables.
+  const PatternTrickTables& getPatternTrickTables() const {
+    return _patternTrickTables;
+  }
+  // Empty if the index has no relation statistics.
+  const RelationStatistics& getRelationStatistics() const {
+    return _relationStatistics;
+  }
+  // The order of the numbers in the vocabulary relative to the inline ones.
+  const NumberOrder& getNumberOrder() const { return _numberOrder; }
   /**
    * @return The multiplicity of the Entites column (0) of the full has-relation
    *         relation after unrolling the patterns.
@@ -283,6 +308,10 @@ class Index {
 
   void setOnDiskLiterals(bool onDiskLiterals);
 
+  // If true, createFromOnDiskIndex uses a memory-mapped FrontCodedVocabulary
+  // instead of reading the complete vocabulary to RAM.
+  void setOnDiskVocabulary(bool onDiskVocabulary);
+
   void setKeepTempFiles(bool keepTempFiles);
 
   void setOnDiskBase(const std::string& onDiskBase);
@@ -291,10 +320,20 @@ class Index {
 
   void setPrefixCompression(bool compressed);
 
+  // The memory (in bytes) that the sort of the triples for the permutations
+  // may use during the index build, see ExternalTripleSorter.
+  void setSortMemory(size_t sortMemoryInBytes);
+
+  // The codec for the lists of the text index that is built next. Lists whose
+  // values do not fit into 32 bits are always compressed with Simple8b.
+  void setTextListCodec(TextListCodec codec);
+
   const string& getTextName() const { return _textMeta.getName(); }
 
   const string& getKbName() const { return _PSO.metaData().getName(); }
 
+  const string& getOnDiskBase() const { return _onDiskBase; }
+
   size_t getNofTriples() const { return _PSO.metaData().getNofTriples(); }
 
   size_t getNofTextRecords() const { return _textMeta.getNofTextRecords(); }
@@ -335,7 +374,18 @@ class Index {
                                   const PermutationImpl& p) const {
     Id keyId;
     vector<float> res;
-    if (_vocab.getId(key, &keyId) && p._meta.relationExists(keyId)) {
+    const PredicateStatistics* stats = nullptr;
+    if (p._keyOrder[0] == 1 && _vocab.getId(key, &keyId)) {
+      stats = _relationStatistics.get(keyId);
+    }
+    if (stats && stats->_nofTriples > 0) {
+      // The exact numbers of distinct subjects and objects.
+      float nofTriples = stats->_nofTriples;
+      float m[3] = {nofTriples / stats->_nofDistinctSubjects, 1,
+                    nofTriples / stats->_nofDistinctObjects};
+      res.push_back(m[p._keyOrder[1]]);
+      res.push_back(m[p._keyOrder[2]]);
+    } else if (_vocab.getId(key, &keyId) && p._meta.relationExists(keyId)) {
       auto rmd = p._meta.getRmd(keyId);
       auto logM1 = rmd.getCol1LogMultiplicity();
       res.push_back(static_cast<float>(pow(2, logM1)));
@@ -375,8 +425,8 @@ class Index {
       const FullRelationMetaData& rmd = p._meta.getRmd(key)._rmdPairs;
       result->reserve(rmd.getNofElements() + 2);
       result->resize(rmd.getNofElements());
-      p._file.read(result->data(), rmd.getNofElements() * 2 * sizeof(Id),
-                   rmd._startFullIndex);
+      CompressedRelation::readPairs(p._file, rmd, p._meta.getVersion(),
+                                    result->data());
     }
   }
 
@@ -402,6 +452,45 @@ class Index {
     LOG(DEBUG) << "Scan done, got " << result->size() << " elements.\n";
   }
 
+  /**
+   * @brief Lazy version of scan(key, result, p): Returns a reader for the
+   * pairs YZ of the key, which reads them block by block on demand.
+   * Returns std::nullopt if there is no relation for the key.
+   */
+  template <class Permutation>
+  std::optional<CompressedRelation::PairReader> lazyScan(
+      const string& key, const Permutation& p) const {
+    Id relId;
+    if (_vocab.getId(key, &relId) && p._meta.relationExists(relId)) {
+      LOG(DEBUG) << "Performing lazy " << p._readableName
+                 << " scan for full list for: " << key << "\n";
+      return CompressedRelation::PairReader(
+          p._file, p._meta.getRmd(relId)._rmdPairs, p._meta.getVersion());
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Like scan(key, result, p), but only retrieves the pairs YZ whose Y
+   * is one of keys (sorted and distinct). The blocks of the relation without
+   * such a Y are skipped after decoding their Y column.
+   * Returns the number of skipped blocks.
+   */
+  template <class Permutation>
+  size_t scanWithKeyFilter(const string& key, const vector<Id>& keys,
+                           IdTable* result, const Permutation& p) const {
+    auto reader = lazyScan(key, p);
+    if (!reader) {
+      return 0;
+    }
+    size_t nofSkippedBlocks =
+        CompressedRelation::readPairsWithKeys(&reader.value(), keys, result);
+    LOG(DEBUG) << "Scan with " << keys.size() << " keys done, got "
+               << result->size() << " elements and skipped "
+               << nofSkippedBlocks << " blocks.\n";
+    return nofSkippedBlocks;
+  }
+
   /**
    * @brief Perform a scan for two keys i.e. retrieve all Z from the XYZ
    * permutation for specific key values of X and Y.
@@ -445,9 +534,9 @@ class Index {
           // restrict.
           IdTable fullRelation(2);
           fullRelation.resize(rmd.getNofElements());
-          p._file.read(fullRelation.data(),
-                       rmd.getNofElements() * 2 * sizeof(Id),
-                       rmd._rmdPairs._startFullIndex);
+          CompressedRelation::readPairs(p._file, rmd._rmdPairs,
+                                        p._meta.getVersion(),
+                                        fullRelation.data());
           getRhsForSingleLhs(fullRelation, subjId, result);
         }
       } else {
@@ -459,11 +548,39 @@ class Index {
     LOG(DEBUG) << "Scan done, got " << result->size() << " elements.\n";
   }
 
+  // Add relation to permutation file. Calculate corresponding metaData
+  // (Mutliplicity of second column will be invalid and has to be set by a
+  // separate call to exchangeMultiplicities)
+  // Args:
+  //   out - permutation file to which we write the relation. Must be open.
+  //   currentOffset - the offset of this relation within the permutation file
+  //   relId - the Id of the 0-th column of this relation (e.g. the 'P' in PSO)
+  //   data - the 1st and 2nd column of this relation (e.g. the "SO" for a fixed
+  //          'P' in PSO. Must be sorted by 1. and then 2. column. Any
+  //          container of array<Id, 2> with size() and operator[].
+  //   distinctC1 - the number of distinct elemens in 1. column of data ("S" in
+  //                PSO)
+  //   functional - is this relation functional (only one triple per value for
+  //                1. column)
+  // Returns:
+  //   The Meta Data (Permutation offsets) for this relation,
+  //   Careful: only multiplicity for first column is valid in return value
+  // Also used by the MetaDataConverter to compress the relations of indices
+  // that were built with an older version.
+  template <class Container>
+  static pair<FullRelationMetaData, BlockBasedRelationMetaData> writeRel(
+      ad_utility::File& out, off_t currentOffset, Id relId,
+      const Container& data, size_t distinctC1, bool functional);
+
  private:
   string _onDiskBase;
   string _settingsFileName;
   bool _onlyAsciiTurtlePrefixes = false;
+  // parse Turtle input with the TurtleParallelParser
+  bool _useParallelParser = false;
+  size_t _numParserThreads = NUM_PARALLEL_PARSER_THREADS;
   bool _onDiskLiterals = false;
+  bool _onDiskVocabulary = false;
   bool _keepTempFiles = false;
   json _configurationJson;
   Vocabulary<CompressedString, TripleComponentComparator> _vocab;
@@ -485,6 +602,8 @@ class Index {
   double _fullHasPredicateMultiplicityPredicates;
   size_t _fullHasPredicateSize;
 
+  size_t _sortMemoryInBytes = STXXL_MEMORY_TO_USE;
+  TextListCodec _textListCodec = TextListCodec::Simple8b;
   size_t _parserBatchSize = PARSER_BATCH_SIZE;
   size_t _numTriplesPerPartialVocab = NUM_TRIPLES_PER_PARTIAL_VOCAB;
   /**
@@ -499,6 +618,9 @@ class Index {
    * @brief Maps entity ids to sets of predicate ids
    */
   CompactStringVector<Id, Id> _hasPredicate;
+  PatternTrickTables _patternTrickTables;
+  RelationStatistics _relationStatistics;
+  NumberOrder _numberOrder;
 
   // Create Vocabulary and directly write it to disk. Create TripleVec with all
   // the triples converted to id space. This Vec can be used for creating
@@ -548,17 +670,12 @@ class Index {
                             const Index::TripleVec& vec, size_t c0, size_t c1,
                             size_t c2);
 
-  pair<FullRelationMetaData, BlockBasedRelationMetaData> writeSwitchedRel(
-      ad_utility::File* out, off_t lastOffset, Id currentRel,
-      ad_utility::BufferedVector<array<Id, 2>>* buffer);
-
   // _______________________________________________________________________
   // Create a pair of permutations. Only works for valid pairs (PSO-POS,
   // OSP-OPS, SPO-SOP).  First creates the permutation and then exchanges the
   // multiplicities and also writes the MetaData to disk. So we end up with
   // fully functional permutations.
-  // performUnique must be set for the first pair created using vec to enforce
-  // RDF standard (no duplicate triples).
+  // vec->idTriples must already be sorted by p1 (see ExternalTripleSorter).
   // createPatternsAfterFirst is only valid when  the pair is SPO-SOP because
   // the SPO permutation is also needed for patterns (see usage in
   // Index::createFromFile function)
@@ -569,7 +686,7 @@ class Index {
           p1,
       const PermutationImpl<Comparator2, typename MetaDataDispatcher::ReadType>&
           p2,
-      bool performUnique = false, bool createPatternsAfterFirst = false);
+      bool createPatternsAfterFirst = false);
 
   // The pairs of permutations are PSO-POS, OSP-OPS and SPO-SOP
   // the multiplicity of column 1 in partner 1 of the pair is equal to the
@@ -581,9 +698,7 @@ class Index {
 
   // wrapper for createPermutation that saves a lot of code duplications
   // Writes the permutation that is specified by argument permutation
-  // performs std::unique on arg vec iff arg performUnique is true (normally
-  // done for first permutation that is created using vec).
-  // Will sort vec.
+  // vec must already be sorted by p1 and must not contain duplicates.
   // returns the MetaData (MmapBased or HmapBased) for this relation.
   // Careful: only multiplicities for first column is valid after call, need to
   // call exchangeMultiplicities as done by createPermutationPair
@@ -596,8 +711,7 @@ class Index {
       const PermutationImpl<Comparator1, typename MetaDataDispatcher::ReadType>&
           p1,
       const PermutationImpl<Comparator2, typename MetaDataDispatcher::ReadType>&
-          p2,
-      bool performUnique);
+          p2);
 
   /**
    * @brief Creates the data required for the "pattern-trick" used for fast
@@ -632,33 +746,17 @@ class Index {
                                     const vector<Posting>& postings,
                                     bool skipWordlistIfAllTheSame);
 
-  // Add relation to permutation file. Calculate corresponding metaData
-  // (Mutliplicity of second column will be invalid and has to be set by a
-  // separate call to exchangeMultiplicities)
-  // Args:
-  //   out - permutation file to which we write the relation. Must be open.
-  //   currentOffset - the offset of this relation within the permutation file
-  //   relId - the Id of the 0-th column of this relation (e.g. the 'P' in PSO)
-  //   data - the 1st and 2nd column of this relation (e.g. the "SO" for a fixed
-  //          'P' in PSO. Must be sorted by 1. and then 2. column.
-  //   distinctC1 - the number of distinct elemens in 1. column of data ("S" in
-  //                PSO)
-  //   functional - is this relation functional (only one triple per value for
-  //                1. column)
-  // Returns:
-  //   The Meta Data (Permutation offsets) for this relation,
-  //   Careful: only multiplicity for first column is valid in return value
-  static pair<FullRelationMetaData, BlockBasedRelationMetaData> writeRel(
-      ad_utility::File& out, off_t currentOffset, Id relId,
-      const BufferedVector<array<Id, 2>>& data, size_t distinctC1,
-      bool functional);
-
+  // afterPairs is the offset directly after the compressed pair index of the
+  // relation.
   static void writeFunctionalRelation(
-      const BufferedVector<array<Id, 2>>& data,
+      off_t afterPairs,
       pair<FullRelationMetaData, BlockBasedRelationMetaData>& rmd);
 
+  // The lhs and rhs lists are written to out starting at startOfLhs, which is
+  // the offset directly after the compressed pair index.
+  template <class Container>
   static void writeNonFunctionalRelation(
-      ad_utility::File& out, const BufferedVector<array<Id, 2>>& data,
+      ad_utility::File& out, off_t startOfLhs, const Container& data,
       pair<FullRelationMetaData, BlockBasedRelationMetaData>& rmd);
 
   void openTextFileHandle();
@@ -678,11 +776,11 @@ class Index {
 
   template <typename T>
   void readGapComprList(size_t nofElements, off_t from, size_t nofBytes,
-                        vector<T>& result) const;
+                        TextListCodec codec, vector<T>& result) const;
 
   template <typename T>
   void readFreqComprList(size_t nofElements, off_t from, size_t nofBytes,
-                         vector<T>& result) const;
+                         TextListCodec codec, vector<T>& result) const;
 
   size_t getIndexOfBestSuitedElTerm(const vector<string>& terms) const;
 
@@ -695,10 +793,10 @@ class Index {
   bool isEntityBlockId(Id blockId) const;
 
   //! Writes a list of elements (have to be able to be cast to unit64_t)
-  //! to file.
-  //! Returns the number of bytes written.
+  //! to file, compressed with the given codec.
+  //! Returns the number of bytes written (always a multiple of 8).
   template <class Numeric>
-  size_t writeList(Numeric* data, size_t nofElements,
+  size_t writeList(Numeric* data, size_t nofElements, TextListCodec codec,
                    ad_utility::File& file) const;
 
   typedef ad_utility::HashMap<Id, Id> IdCodeMap;
@@ -8,6 +8,7 @@
 #include <exception>
 #include <iomanip>
 #include <iostream>
+#include <optional>
 #include <sstream>
 #include <string>
 
@@ -44,6 +45,9 @@ struct option options[] = {
     {"keep-temporary-files", no_argument, NULL, 'k'},
     {"settings-file", required_argument, NULL, 's'},
     {"no-compressed-vocabulary", no_argument, NULL, 'N'},
+    {"sort-memory", required_argument, NULL, 'm'},
+    {"text-list-codec", required_argument, NULL, 'c'},
+    {"pattern-trick-types", required_argument, NULL, 't'},
     {NULL, 0, NULL, 0}};
 
 string getStxxlConfigFileName(const string& location) {
@@ -128,6 +132,21 @@ void printUsage(char* execName) {
       << "    "
       << "Keep Temporary Files from IndexCreation (normally only for debugging)"
       << endl;
+  cerr << "  " << std::setw(20) << "m, sort-memory" << std::setw(1) << "    "
+       << "Memory (in GB) for sorting the triples of the permutations "
+          "(default: "
+       << (STXXL_MEMORY_TO_USE >> 30) << ")." << endl;
+  cerr << "  " << std::setw(20) << "c, text-list-codec" << std::setw(1)
+       << "    "
+       << "Compression of the text index lists: simple8b (default) or "
+          "streamvbyte (faster to decode, sometimes larger)."
+       << endl;
+  cerr << "  " << std::setw(20) << "t, pattern-trick-types" << std::setw(1)
+       << "    "
+       << "Precompute the predicate counts of the pattern trick for all "
+          "entities and for the entities of the given number of most "
+          "frequent types (objects of rdf:type and wdt:P31)."
+       << endl;
   cerr << "  " << std::setw(20) << "s, settings-file" << std::setw(1) << "    "
        << "Specify a input settings file where prefixes that are to be "
           "externalized etc can be specified"
@@ -162,10 +181,14 @@ int main(int argc, char** argv) {
   bool usePatterns = true;
   bool onlyAddTextIndex = false;
   bool keepTemporaryFiles = false;
+  size_t sortMemoryInBytes = STXXL_MEMORY_TO_USE;
+  TextListCodec textListCodec = TextListCodec::Simple8b;
+  std::optional<size_t> nofPatternTrickTypes;
   optind = 1;
   // Process command line arguments.
   while (true) {
-    int c = getopt_long(argc, argv, "F:f:i:w:d:lT:K:hAks:N", options, nullptr);
+    int c = getopt_long(argc, argv, "F:f:i:w:d:lT:K:hAks:Nm:c:t:", options,
+                        nullptr);
     if (c == -1) {
       break;
     }
@@ -213,6 +236,23 @@ int main(int argc, char** argv) {
       case 'N':
         useCompression = false;
         break;
+      case 'm':
+        sortMemoryInBytes = static_cast<size_t>(std::stod(optarg) * (1 << 30));
+        break;
+      case 't':
+        nofPatternTrickTypes = static_cast<size_t>(atol(optarg));
+        break;
+      case 'c':
+        if (string(optarg) == "simple8b") {
+          textListCodec = TextListCodec::Simple8b;
+        } else if (string(optarg) == "streamvbyte") {
+          textListCodec = TextListCodec::StreamVByte;
+        } else {
+          cerr << "Unknown text list codec " << optarg << endl;
+          printUsage(argv[0]);
+          exit(1);
+        }
+        break;
       default:
         cerr << endl
              << "! ERROR in processing options (getopt returned '" << c
@@ -262,6 +302,8 @@ int main(int argc, char** argv) {
     index.setKeepTempFiles(keepTemporaryFiles);
     index.setSettingsFile(settingsFile);
     index.setPrefixCompression(useCompression);
+    index.setSortMemory(sortMemoryInBytes);
+    index.setTextListCodec(textListCodec);
     if (!onlyAddTextIndex) {
       // if onlyAddTextIndex is true, we do not want to construct an index,
       // but assume that it  already exists (especially we need a valid
@@ -339,6 +381,21 @@ int main(int argc, char** argv) {
     if (docsfile.size() > 0) {
       index.buildDocsDB(docsfile);
     }
+
+    bool createPatternTrickTables = usePatterns && nofPatternTrickTypes;
+    if (!onlyAddTextIndex || createPatternTrickTables) {
+      // The relation statistics and the pattern trick tables are computed
+      // from the permutations and patterns on disk.
+      Index builtIndex;
+      builtIndex.setUsePatterns(createPatternTrickTables);
+      builtIndex.createFromOnDiskIndex(baseName);
+      if (!onlyAddTextIndex) {
+        builtIndex.createRelationStatistics();
+      }
+      if (createPatternTrickTables) {
+        builtIndex.createPatternTrickTables(nofPatternTrickTypes.value());
+      }
+    }
     std::remove(stxxlFileName.c_str());
   } catch (std::exception& e) {
     LOG(ERROR) << e.what() << std::endl;
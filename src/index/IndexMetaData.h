@@ -64,9 +64,15 @@ const uint64_t MAGIC_NUMBER_SPARSE_META_DATA_VERSION =
 // constants for meta data versions in case the format is changed again
 constexpr uint64_t V_NO_VERSION = 0;  // this is  a dummy
 constexpr uint64_t V_BLOCK_LIST_AND_STATISTICS = 1;
+// the pair index of each relation is stored in compressed blocks, see
+// CompressedRelation.h
+constexpr uint64_t V_COMPRESSED_RELATIONS = 2;
+// the relations of numbers and dates (whose Ids are beyond the vocabulary, see
+// ValueId.h) are stored explicitly before the block data
+constexpr uint64_t V_INLINE_VALUES = 3;
 
 // this always tags the current version
-constexpr uint64_t V_CURRENT = V_BLOCK_LIST_AND_STATISTICS;
+constexpr uint64_t V_CURRENT = V_INLINE_VALUES;
 
 // Check index_layout.md for explanations (expected comments).
 // Removed comments here so that not two places had to be kept up-to-date.
@@ -91,6 +97,8 @@ class IndexMetaData {
     _data.setup(std::forward<dataArgs>(args)...);
   }
 
+  // For metadata with compressed relations, bRmd._offsetAfter always has to
+  // contain the offset after the relation, even if it has no blocks.
   // persistentRMD == true means we do not need to add rmd to _data
   // but assume that it is already contained in _data (for persistent
   // metaData implementations. Must be a compile time parameter because we have
@@ -159,6 +167,11 @@ class IndexMetaData {
 
   size_t getVersion() const { return _version; }
 
+  // true iff the pair index of the relations is stored in compressed blocks
+  bool hasCompressedRelations() const {
+    return _version >= V_COMPRESSED_RELATIONS;
+  }
+
   MapType& data() { return _data; }
   const MapType& data() const { return _data; }
 
@@ -19,15 +19,27 @@ void IndexMetaData<MapType>::add(const FullRelationMetaData& rmd,
     _data.set(rmd._relId, rmd);
   }
 
+  // the size of a compressed relation can not be derived from the rmd alone.
   off_t afterExpected =
-      rmd.hasBlocks() ? bRmd._offsetAfter
-                      : static_cast<off_t>(rmd._startFullIndex + rmd.getNofBytesForFulltextIndex());
+      rmd.hasBlocks() || hasCompressedRelations()
+          ? bRmd._offsetAfter
+          : static_cast<off_t>(rmd._startFullIndex + rmd.getNofBytesForFulltextIndex());
   if (rmd.hasBlocks()) {
     _blockData[rmd._relId] = bRmd;
   }
   if (afterExpected > _offsetAfter) {
     _offsetAfter = afterExpected;
   }
+  if constexpr (!persistentRMD) {
+    // Keep the statistics up to date while a permutation is written, so the
+    // index build needs no extra pass (see calculateExpensiveStatistics).
+    // When reading, they are overwritten or recalculated afterwards.
+    _totalElements += rmd.getNofElements();
+    _totalBlocks += getNofBlocksForRelation(rmd._relId);
+    _totalBytes = hasCompressedRelations()
+                      ? static_cast<size_t>(_offsetAfter)
+                      : _totalBytes + getTotalBytesForRelation(rmd);
+  }
 }
 
 // _____________________________________________________________________________
@@ -92,6 +104,15 @@ void IndexMetaData<MapType>::createFromByteBuffer(unsigned char* buf) {
     } else {
       // version >= V_BLOCK_LIST_AND_STATISTICS, no need to touch Relations that
       // don't have blocks
+      if (version >= V_INLINE_VALUES) {
+        size_t numSparse = readFromBuf<size_t>(&buf);
+        for (size_t i = 0; i < numSparse; ++i) {
+          FullRelationMetaData rmd;
+          rmd.createFromByteBuffer(buf);
+          buf += rmd.bytesRequired();
+          _data.restoreSparse(rmd);
+        }
+      }
       size_t numBlockData = readFromBuf<size_t>(&buf);
       for (size_t i = 0; i < numBlockData; ++i) {
         Id id = readFromBuf<Id>(&buf);
@@ -158,6 +179,13 @@ ad_utility::File& operator<<(ad_utility::File& f, const IndexMetaData<MapType>&
       }
     }
   } else {
+    // the entries that are not part of the persistent array, see
+    // MetaDataWrapperDense::sparse()
+    size_t numSparse = imd._data.sparse().size();
+    f.write(&numSparse, sizeof(numSparse));
+    for (const auto& el : imd._data.sparse()) {
+      f << el.second;
+    }
     size_t numBlockData = imd._blockData.size();
     f.write(&numBlockData, sizeof(numBlockData));
     for (const auto& [id, blockData] : imd._blockData) {
@@ -278,6 +306,18 @@ void IndexMetaData<MapType>::calculateExpensiveStatistics() {
     _totalBytes += getTotalBytesForRelation(el.second);
     _totalBlocks += getNofBlocksForRelation(el.first);
   }
+  if constexpr (_isMmapBased) {
+    for (const auto& [id, rmd] : _data.sparse()) {
+      _totalElements += rmd.getNofElements();
+      _totalBytes += getTotalBytesForRelation(rmd);
+      _totalBlocks += getNofBlocksForRelation(id);
+    }
+  }
+  if (hasCompressedRelations()) {
+    // The size of compressed relations without blocks is not stored, but all
+    // relations are stored contiguously.
+    _totalBytes = _offsetAfter;
+  }
 }
 
 // ___________________________________________________________________
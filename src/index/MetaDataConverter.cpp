@@ -7,7 +7,9 @@
 #include <nlohmann/json.hpp>
 #include <string>
 #include "../global/Constants.h"
+#include "../util/BufferedVector.h"
 #include "./CompressedString.h"
+#include "./Index.h"
 #include "./IndexMetaData.h"
 #include "./PrefixHeuristic.h"
 #include "./Vocabulary.h"
@@ -52,6 +54,7 @@ IndexMetaDataMmap convertHmapMetaDataToMmap(const IndexMetaDataHmap& hmap,
   IndexMetaDataMmap res;
   res._offsetAfter = hmap._offsetAfter;
   res._totalElements = hmap._totalElements;
+  res._version = hmap._version;
   res._name = hmap._name;
   res._filename = hmap._filename;
   res._data = convertHmapHandlerToMmap(hmap._data, filename);
@@ -80,6 +83,7 @@ IndexMetaDataHmap convertMmapMetaDataToHmap(const IndexMetaDataMmap& mmap,
   IndexMetaDataHmap res;
   res._offsetAfter = mmap._offsetAfter;
   res._totalElements = mmap._totalElements;
+  res._version = mmap._version;
   res._name = mmap._name;
   res._filename = mmap._filename;
   res._data = convertMmapHandlerToHmap(mmap._data);
@@ -114,6 +118,7 @@ void convertPermutationToMmap(const string& permutIn, const string& permutOut,
   } catch (const WrongFormatException& e) {
     std::cerr << "this is not a sparse permutation, Trying to read as Mmap";
     IndexMetaDataMmap m;
+    m.setup(mmap, ad_utility::ReuseTag());
     m.readFromFile(permutIn);
     if (m.getVersion() < V_CURRENT) {
       writeNewPermutation(permutIn, permutOut, m);
@@ -137,11 +142,76 @@ void convertPermutationToHmap(const string& permutIn, const string& permutOut,
   }
 }
 
+// ________________________________________________________________________
+template <class MetaData>
+void writeCompressedPermutation(const string& oldPermutation,
+                                const string& newPermutation,
+                                const MetaData& metaData) {
+  ad_utility::File oldFile(oldPermutation, "r");
+  ad_utility::File newFile(newPermutation, "w");
+
+  // Rewrite the relations in the order in which they appear in the old file.
+  vector<FullRelationMetaData> relations;
+  Id maxId = 0;
+  for (auto it = metaData.data().cbegin(); it != metaData.data().cend(); ++it) {
+    relations.push_back(it->second);
+    maxId = std::max(maxId, it->first);
+  }
+  std::sort(relations.begin(), relations.end(),
+            [](const auto& a, const auto& b) {
+              return a._startFullIndex < b._startFullIndex;
+            });
+
+  MetaData newMetaData;
+  if constexpr (MetaData::_isMmapBased) {
+    string mmapFile = oldPermutation + MMAP_FILE_SUFFIX;
+    newMetaData.setup(maxId + 1, FullRelationMetaData::empty,
+                      mmapFile + ".converted");
+    notifyCreated(mmapFile, true);
+  }
+  newMetaData.setName(metaData.getName());
+
+  ad_utility::BufferedVector<array<Id, 2>> buffer(
+      THRESHOLD_RELATION_CREATION, newPermutation + ".tmp.MmapBuffer");
+  vector<array<Id, 2>> pairs;
+  off_t currentOffset = 0;
+  for (const auto& rmd : relations) {
+    pairs.resize(rmd.getNofElements());
+    oldFile.read(pairs.data(), pairs.size() * sizeof(pairs[0]),
+                 rmd._startFullIndex);
+    buffer.clear();
+    size_t distinctC1 = 0;
+    for (size_t i = 0; i < pairs.size(); ++i) {
+      if (i == 0 || pairs[i][0] != pairs[i - 1][0]) {
+        distinctC1++;
+      }
+      buffer.push_back(pairs[i]);
+    }
+    auto md = Index::writeRel(newFile, currentOffset, rmd._relId, buffer,
+                              distinctC1, rmd.isFunctional());
+    // keep the multiplicities of the old index, the second one can not be
+    // computed from this permutation alone.
+    md.first.setCol1LogMultiplicity(rmd.getCol1LogMultiplicity());
+    md.first.setCol2LogMultiplicity(rmd.getCol2LogMultiplicity());
+    newMetaData.add(md.first, md.second);
+    currentOffset = newMetaData.getOffsetAfter();
+  }
+  newMetaData.calculateExpensiveStatistics();
+  newMetaData.appendToFile(&newFile);
+  notifyCreated(oldPermutation, true);
+}
+
 // ________________________________________________________________________
 template <class MetaData>
 void writeNewPermutation(const string& oldPermutation,
                          const string& newPermutation,
                          const MetaData& metaData) {
+  if (!metaData.hasCompressedRelations()) {
+    // The pair index of the relations has to be converted to the compressed
+    // format, we can not simply copy it.
+    writeCompressedPermutation(oldPermutation, newPermutation, metaData);
+    return;
+  }
   ad_utility::File oldFile(oldPermutation, "r");
   ad_utility::File newFile(newPermutation, "w");
 
@@ -42,11 +42,22 @@ void convertPermutationToHmap(const string& permutIn, const string& permutOut,
 void addMagicNumberToHmapMetaDataPermutation(const string& permutIn,
                                              const string& permutOut);
 // Copy the permutation data from oldPermutation to newPermutation and add the
-// meta data
+// meta data. If the relations of oldPermutation are not yet stored in
+// compressed blocks (meta data version < V_COMPRESSED_RELATIONS) they are
+// compressed via writeCompressedPermutation.
 template <class MetaData>
 void writeNewPermutation(const string& oldPermutation,
                          const string& newPermutation, const MetaData& meta);
 
+// Compress all relations of oldPermutation and write them together with
+// updated meta data to newPermutation. For mmap based meta data the new
+// persistent meta data is written to
+// oldPermutation + MMAP_FILE_SUFFIX + ".converted".
+template <class MetaData>
+void writeCompressedPermutation(const string& oldPermutation,
+                                const string& newPermutation,
+                                const MetaData& meta);
+
 // __________________________________________________________________________
 inline void notifyCreated(const string& filename, bool hasConvertedSuffix) {
   if (hasConvertedSuffix) {
@@ -100,12 +100,15 @@ class MetaDataWrapperDense {
 
   // ________________________________________________________
   MetaDataWrapperDense(MetaDataWrapperDense<M>&& other)
-      : _size(other._size), _vec(std::move(other._vec)) {}
+      : _size(other._size),
+        _vec(std::move(other._vec)),
+        _sparse(std::move(other._sparse)) {}
 
   // ______________________________________________________________
   MetaDataWrapperDense& operator=(MetaDataWrapperDense<M>&& other) {
     _size = other._size;
     _vec = std::move(other._vec);
+    _sparse = std::move(other._sparse);
     return *this;
   }
 
@@ -118,6 +121,7 @@ class MetaDataWrapperDense {
     // in IndexMetaData::createFromByteBuffer
     _size = 0;
     _vec = M(args...);
+    _sparse.clear();
   }
 
   // ___________________________________________________________
@@ -149,7 +153,13 @@ class MetaDataWrapperDense {
   // ____________________________________________________________
   void set(Id id, const FullRelationMetaData& value) {
     if (id >= _vec.size()) {
-      AD_CHECK(id < _vec.size());
+      // check that we never insert the empty key
+      assert(value != emptyMetaData);
+      if (_sparse.count(id) == 0) {
+        _size++;
+      }
+      _sparse[id] = value;
+      return;
     }
     bool previouslyEmpty = _vec[id] == emptyMetaData;
 
@@ -163,6 +173,11 @@ class MetaDataWrapperDense {
 
   // __________________________________________________________
   const FullRelationMetaData& getAsserted(Id id) const {
+    if (id >= _vec.size()) {
+      auto it = _sparse.find(id);
+      AD_CHECK(it != _sparse.end());
+      return it->second;
+    }
     const auto& res = _vec[id];
     AD_CHECK(res != emptyMetaData);
     return res;
@@ -170,6 +185,11 @@ class MetaDataWrapperDense {
 
   // _________________________________________________________
   FullRelationMetaData& operator[](Id id) {
+    if (id >= _vec.size()) {
+      auto it = _sparse.find(id);
+      AD_CHECK(it != _sparse.end());
+      return it->second;
+    }
     auto& res = _vec[id];
     AD_CHECK(res != emptyMetaData);
     return res;
@@ -178,9 +198,27 @@ class MetaDataWrapperDense {
   // ________________________________________________________
   size_t count(Id id) const {
     // can either be 1 or 0 for map-like types
+    if (id >= _vec.size()) {
+      return _sparse.count(id);
+    }
     return _vec[id] != emptyMetaData;
   }
 
+  // The entries whose Ids are beyond the key space of the array (the numbers
+  // and dates that are stored in their Id, see ValueId.h). They are not part
+  // of the persistent array and not visited by begin() and end(), but have to
+  // be stored and restored (restoreSparse()) together with the block data.
+  const ad_utility::HashMap<Id, FullRelationMetaData>& sparse() const {
+    return _sparse;
+  }
+
+  // Add an entry of sparse() when reading the meta data. Does not change
+  // size(), which includes these entries and is set by setSize().
+  void restoreSparse(const FullRelationMetaData& value) {
+    AD_CHECK(value._relId >= _vec.size());
+    _sparse[value._relId] = value;
+  }
+
   // ___________________________________________________________
   std::string getFilename() const { return _vec.getFilename(); }
 
@@ -189,6 +227,7 @@ class MetaDataWrapperDense {
   const FullRelationMetaData emptyMetaData = FullRelationMetaData::empty;
   size_t _size = 0;
   M _vec;
+  ad_utility::HashMap<Id, FullRelationMetaData> _sparse;
 };
 
 // _____________________________________________________________________
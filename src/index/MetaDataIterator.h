@@ -2,6 +2,7 @@
 
 #include "../global/Id.h"
 #include "../util/File.h"
+#include "./CompressedRelation.h"
 
 /**
  * This allows iterating over one of the permutations of the index once.
@@ -43,8 +44,8 @@ class MetaDataIterator {
   void scanCurrentPos() {
     const FullRelationMetaData& rmd = _iterator->second.get();
     _buffer.resize(rmd.getNofElements());
-    _file.read(_buffer.data(), rmd.getNofElements() * 2 * sizeof(Id),
-               rmd._startFullIndex);
+    CompressedRelation::readPairs(_file, rmd, meta_.getVersion(),
+                                  _buffer.data()->data());
   }
 
   const MetaDataType& meta_;
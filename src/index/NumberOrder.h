@@ -0,0 +1,127 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../global/Constants.h"
+#include "../global/Id.h"
+#include "../global/ValueId.h"
+#include "../util/Conversions.h"
+
+/**
+ * @brief The order of all numbers of the index by their value.
+ *
+ * Most numbers are stored inline in their Id (see ValueId), but the ones that
+ * can not be stored exactly stay in the vocabulary. The vocabulary numbers are
+ * a contiguous range of Ids that is sorted by value (as their index words),
+ * all of them are smaller than the inline numbers. To compare a number of one
+ * kind with a number of the other kind, each vocabulary number is placed
+ * before the first inline number with a larger value. Numbers are compared by
+ * their value as a double.
+ */
+class NumberOrder {
+ public:
+  enum class Relation { LT, LE, EQ, GE, GT };
+
+  NumberOrder() = default;
+
+  // values are the values of the vocabulary numbers with the Ids begin,
+  // begin + 1, ..., in ascending order.
+  NumberOrder(Id begin, std::vector<double> values)
+      : _begin(begin), _values(std::move(values)) {
+    _positions.reserve(_values.size());
+    for (double value : _values) {
+      _positions.push_back(ValueId::firstNumberAbove(value));
+    }
+  }
+
+  template <typename Vocab>
+  static NumberOrder fromVocabulary(const Vocab& vocab) {
+    auto [begin, end] = vocab.prefix_range(VALUE_FLOAT_PREFIX);
+    std::vector<double> values;
+    values.reserve(end - begin);
+    for (Id id = begin; id < end; ++id) {
+      values.push_back(std::strtod(
+          ad_utility::convertIndexWordToFloatString(vocab.at(id)).c_str(),
+          nullptr));
+    }
+    return NumberOrder(begin, std::move(values));
+  }
+
+  // True iff all numbers of the index are inline, then the order of the Ids
+  // is the order of the values.
+  bool empty() const { return _values.empty(); }
+  size_t size() const { return _values.size(); }
+
+  bool isVocabNumber(Id id) const {
+    return id >= _begin && id - _begin < _values.size();
+  }
+
+  // Strict weak order of all Ids: numbers by value (inline numbers before
+  // vocabulary numbers with the same value), all other Ids by Id.
+  bool less(Id a, Id b) const {
+    bool aIsVocab = isVocabNumber(a);
+    bool bIsVocab = isVocabNumber(b);
+    if (aIsVocab == bIsVocab) {
+      return a < b;
+    }
+    if (aIsVocab) {
+      return _positions[a - _begin] <= b;
+    }
+    return a < _positions[b - _begin];
+  }
+
+  // The range [first, last) of the vocabulary numbers whose value stands in
+  // relation to value.
+  std::pair<Id, Id> vocabRange(Relation relation, double value) const {
+    size_t lower =
+        std::lower_bound(_values.begin(), _values.end(), value) -
+        _values.begin();
+    size_t upper =
+        std::upper_bound(_values.begin(), _values.end(), value) -
+        _values.begin();
+    switch (relation) {
+      case Relation::LT:
+        return {_begin, _begin + lower};
+      case Relation::LE:
+        return {_begin, _begin + upper};
+      case Relation::EQ:
+        return {_begin + lower, _begin + upper};
+      case Relation::GE:
+        return {_begin + lower, _begin + _values.size()};
+      default:
+        return {_begin + upper, _begin + _values.size()};
+    }
+  }
+
+  // The range [first, last) of the inline numbers whose value stands in
+  // relation to value.
+  static std::pair<Id, Id> inlineRange(Relation relation, double value) {
+    Id min = ValueId::minId(ValueId::Datatype::NUMBER);
+    Id end = ValueId::maxId(ValueId::Datatype::NUMBER) + 1;
+    switch (relation) {
+      case Relation::LT:
+        return {min, ValueId::firstNumberNotBelow(value)};
+      case Relation::LE:
+        return {min, ValueId::firstNumberAbove(value)};
+      case Relation::EQ:
+        return {ValueId::firstNumberNotBelow(value),
+                ValueId::firstNumberAbove(value)};
+      case Relation::GE:
+        return {ValueId::firstNumberNotBelow(value), end};
+      default:
+        return {ValueId::firstNumberAbove(value), end};
+    }
+  }
+
+ private:
+  Id _begin = 0;
+  std::vector<double> _values;
+  // The first inline number with a larger value than the vocabulary number.
+  std::vector<Id> _positions;
+};
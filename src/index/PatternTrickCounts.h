@@ -0,0 +1,175 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <optional>
+#include <string>
+#include <vector>
+#include "../global/Id.h"
+#include "../global/Pattern.h"
+#include "../util/HashMap.h"
+#include "../util/Log.h"
+
+using std::array;
+using std::vector;
+
+// Counts how often each pattern occurs. For many entities the counts are
+// stored in a vector indexed by the PatternID, which is much faster to update
+// and to merge than a hash map, otherwise in a hash map.
+class PatternCounts {
+ public:
+  PatternCounts(size_t nofPatterns, bool dense)
+      : _dense(dense), _denseCounts(dense ? nofPatterns : 0) {}
+
+  void add(PatternID pattern) {
+    if (_dense) {
+      _denseCounts[pattern]++;
+    } else {
+      _sparseCounts[pattern]++;
+    }
+  }
+
+  void merge(const PatternCounts& other) {
+    if (_dense) {
+      for (size_t i = 0; i < _denseCounts.size(); ++i) {
+        _denseCounts[i] += other._denseCounts[i];
+      }
+    } else {
+      for (const auto& [pattern, count] : other._sparseCounts) {
+        _sparseCounts[pattern] += count;
+      }
+    }
+  }
+
+  // Calls f(pattern, count) for each pattern that occurred.
+  template <typename F>
+  void forEach(F f) const {
+    if (_dense) {
+      for (size_t i = 0; i < _denseCounts.size(); ++i) {
+        if (_denseCounts[i] > 0) {
+          f(i, _denseCounts[i]);
+        }
+      }
+    } else {
+      for (const auto& [pattern, count] : _sparseCounts) {
+        f(pattern, count);
+      }
+    }
+  }
+
+  size_t size() const {
+    if (!_dense) {
+      return _sparseCounts.size();
+    }
+    return std::count_if(_denseCounts.begin(), _denseCounts.end(),
+                         [](size_t count) { return count > 0; });
+  }
+
+ private:
+  bool _dense;
+  vector<size_t> _denseCounts;
+  ad_utility::HashMap<size_t, size_t> _sparseCounts;
+};
+
+// The counts of a part of the entities.
+struct PredicateCounts {
+  PredicateCounts(size_t nofPatterns, bool densePatterns)
+      : _patternCounts(nofPatterns, densePatterns) {}
+  PatternCounts _patternCounts;
+  // The predicates of the entities without a pattern.
+  ad_utility::HashMap<Id, size_t> _predicateCounts;
+  size_t _numEntitiesWithPatterns = 0;
+  // the number of predicates counted without patterns
+  size_t _numListPredicates = 0;
+};
+
+// Count the patterns and predicates of the entities subjectAt(i) for i in
+// [0, nofRows). subjectAt returns std::nullopt for rows that should be
+// skipped. The rows are split into at most nofThreads parts with at least
+// minRowsPerThread rows that are counted concurrently, the counts are then
+// merged.
+template <typename SubjectAt>
+PredicateCounts countPredicates(SubjectAt subjectAt, size_t nofRows,
+                                const vector<PatternID>& hasPattern,
+                                const CompactStringVector<Id, Id>& hasPredicate,
+                                size_t nofPatterns, size_t nofThreads,
+                                size_t minRowsPerThread) {
+  const size_t nofParts = std::clamp<size_t>(
+      nofRows / std::max<size_t>(1, minRowsPerThread), 1, nofThreads);
+  const bool densePatterns = nofRows >= nofPatterns;
+  auto countPart = [&](size_t begin, size_t end) {
+    PredicateCounts counts(nofPatterns, densePatterns);
+    for (size_t i = begin; i < end; i++) {
+      std::optional<Id> subject = subjectAt(i);
+      if (!subject) {
+        continue;
+      }
+      if (*subject < hasPattern.size() && hasPattern[*subject] != NO_PATTERN) {
+        // The subject matches a pattern
+        counts._patternCounts.add(hasPattern[*subject]);
+        counts._numEntitiesWithPatterns++;
+      } else if (*subject < hasPredicate.size()) {
+        // The subject does not match a pattern
+        auto [predicateData, numPredicates] = hasPredicate[*subject];
+        counts._numListPredicates += numPredicates;
+        if (numPredicates > 0) {
+          for (size_t j = 0; j < numPredicates; j++) {
+            counts._predicateCounts[predicateData[j]]++;
+          }
+        } else {
+          LOG(TRACE) << "No pattern or has-relation entry found for entity "
+                     << std::to_string(*subject) << std::endl;
+        }
+      } else {
+        LOG(TRACE) << "Subject " << *subject
+                   << " does not appear to be an entity "
+                      "(its id is to high)."
+                   << std::endl;
+      }
+    }
+    return counts;
+  };
+
+  vector<std::future<PredicateCounts>> futures;
+  for (size_t t = 1; t < nofParts; ++t) {
+    futures.push_back(std::async(std::launch::async, countPart,
+                                 nofRows * t / nofParts,
+                                 nofRows * (t + 1) / nofParts));
+  }
+  PredicateCounts counts = countPart(0, nofRows / nofParts);
+  for (auto& f : futures) {
+    PredicateCounts part = f.get();
+    counts._patternCounts.merge(part._patternCounts);
+    for (const auto& [predicate, count] : part._predicateCounts) {
+      counts._predicateCounts[predicate] += count;
+    }
+    counts._numEntitiesWithPatterns += part._numEntitiesWithPatterns;
+    counts._numListPredicates += part._numListPredicates;
+  }
+  return counts;
+}
+
+// The (predicate, count) pairs of counts after resolving the patterns to their
+// predicates, sorted by the predicate.
+inline vector<array<Id, 2>> predicateCountTable(
+    const PredicateCounts& counts,
+    const CompactStringVector<size_t, Id>& patterns) {
+  ad_utility::HashMap<Id, size_t> predicateCounts = counts._predicateCounts;
+  counts._patternCounts.forEach([&](size_t patternId, size_t count) {
+    std::pair<Id*, size_t> pattern = patterns[patternId];
+    for (size_t i = 0; i < pattern.second; i++) {
+      predicateCounts[pattern.first[i]] += count;
+    }
+  });
+  vector<array<Id, 2>> table;
+  table.reserve(predicateCounts.size());
+  for (const auto& [predicate, count] : predicateCounts) {
+    table.push_back({predicate, static_cast<Id>(count)});
+  }
+  std::sort(table.begin(), table.end());
+  return table;
+}
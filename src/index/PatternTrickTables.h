@@ -0,0 +1,118 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../global/Id.h"
+#include "../util/File.h"
+
+using std::array;
+using std::string;
+using std::vector;
+
+// Precomputed results of the pattern trick, which only depend on the index:
+// the predicate counts for all entities and for the entities of the most
+// frequent types (the objects of e.g. rdf:type). They are created by
+// Index::createPatternTrickTables and stored in <index>.index.pattern-trick.
+class PatternTrickTables {
+ public:
+  // The pairs (predicate, number of entities with this predicate), sorted by
+  // the predicate.
+  using Table = vector<array<Id, 2>>;
+
+  bool empty() const { return !_allEntities && _types.empty(); }
+
+  // The table for all entities or nullptr if it was not computed.
+  const Table* getAllEntities() const {
+    return _allEntities ? &_allEntities.value() : nullptr;
+  }
+
+  void setAllEntities(Table table) { _allEntities = std::move(table); }
+
+  // The table for the entities e with a triple (e, typePredicate, type) or
+  // nullptr if it was not computed.
+  const Table* getType(Id typePredicate, Id type) const {
+    auto it = _types.find({typePredicate, type});
+    return it == _types.end() ? nullptr : &it->second;
+  }
+
+  void addType(Id typePredicate, Id type, Table table) {
+    _types[{typePredicate, type}] = std::move(table);
+  }
+
+  size_t getNofTypes() const { return _types.size(); }
+
+  void writeToFile(const string& fileName) const {
+    ad_utility::File file(fileName, "w");
+    file.write(&VERSION, sizeof(VERSION));
+    bool hasAllEntities = _allEntities.has_value();
+    file.write(&hasAllEntities, sizeof(hasAllEntities));
+    if (hasAllEntities) {
+      writeTable(*_allEntities, &file);
+    }
+    size_t nofTypes = _types.size();
+    file.write(&nofTypes, sizeof(nofTypes));
+    for (const auto& [key, table] : _types) {
+      file.write(&key.first, sizeof(Id));
+      file.write(&key.second, sizeof(Id));
+      writeTable(table, &file);
+    }
+  }
+
+  void readFromFile(const string& fileName) {
+    ad_utility::File file(fileName, "r");
+    off_t off = 0;
+    uint32_t version;
+    off += file.read(&version, sizeof(version), off);
+    if (version != VERSION) {
+      std::ostringstream oss;
+      oss << "The pattern trick tables " << fileName << " have version "
+          << version << " but version " << VERSION
+          << " is expected. Recreate them with CreatePatternsMain";
+      throw std::runtime_error(oss.str());
+    }
+    _allEntities.reset();
+    _types.clear();
+    bool hasAllEntities;
+    off += file.read(&hasAllEntities, sizeof(hasAllEntities), off);
+    if (hasAllEntities) {
+      _allEntities = readTable(file, &off);
+    }
+    size_t nofTypes;
+    off += file.read(&nofTypes, sizeof(nofTypes), off);
+    for (size_t i = 0; i < nofTypes; ++i) {
+      std::pair<Id, Id> key;
+      off += file.read(&key.first, sizeof(Id), off);
+      off += file.read(&key.second, sizeof(Id), off);
+      _types[key] = readTable(file, &off);
+    }
+  }
+
+ private:
+  static constexpr uint32_t VERSION = 0;
+
+  static void writeTable(const Table& table, ad_utility::File* file) {
+    size_t size = table.size();
+    file->write(&size, sizeof(size));
+    file->write(table.data(), size * sizeof(Table::value_type));
+  }
+
+  static Table readTable(ad_utility::File& file, off_t* off) {
+    size_t size;
+    *off += file.read(&size, sizeof(size), *off);
+    Table table(size);
+    *off += file.read(table.data(), size * sizeof(Table::value_type), *off);
+    return table;
+  }
+
+  std::optional<Table> _allEntities;
+  std::map<std::pair<Id, Id>, Table> _types;
+};
@@ -0,0 +1,255 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../global/Id.h"
+#include "../util/File.h"
+
+using std::array;
+using std::string;
+using std::vector;
+
+// Statistics of the triples of a single predicate that the query planner uses
+// for the selectivity of filters on the object and for the number of distinct
+// subjects and objects (the multiplicities of a scan).
+struct PredicateStatistics {
+  size_t _nofTriples = 0;
+  size_t _nofDistinctSubjects = 0;
+  size_t _nofDistinctObjects = 0;
+  // Equi-depth histogram of the objects: the objects at the positions
+  // i * (_nofTriples - 1) / nofBuckets, i = 0, ..., nofBuckets, of the sorted
+  // objects. In particular, the first and the last entry are the smallest and
+  // the largest object. Bucket i contains the objects between entries i and
+  // i + 1.
+  vector<Id> _objectBounds;
+  // The most frequent objects and their number of triples, sorted by object.
+  vector<array<Id, 2>> _heavyHitters;
+
+  size_t getNofBuckets() const {
+    return _objectBounds.empty() ? 0 : _objectBounds.size() - 1;
+  }
+
+  // The estimated fraction of the triples whose object is in [lower, upper).
+  // Within a bucket, the objects are assumed to be distributed uniformly
+  // over the Ids.
+  double objectRangeSelectivity(Id lower, Id upper) const {
+    if (lower >= upper || _nofTriples == 0) {
+      return 0;
+    }
+    if (getNofBuckets() == 0) {
+      // A single triple.
+      return lower <= _objectBounds[0] && _objectBounds[0] < upper ? 1 : 0;
+    }
+    double nofBucketsCovered = 0;
+    for (size_t i = 0; i < getNofBuckets(); ++i) {
+      Id first = _objectBounds[i];
+      Id last = _objectBounds[i + 1];
+      if (last < lower || first >= upper) {
+        continue;
+      }
+      Id from = std::max(first, lower);
+      Id to = std::min(last, upper - 1);
+      nofBucketsCovered += (static_cast<double>(to - from) + 1) /
+                           (static_cast<double>(last - first) + 1);
+    }
+    return nofBucketsCovered / getNofBuckets();
+  }
+
+  // The estimated fraction of the triples with the given object: exact for
+  // the heavy hitters, the remaining triples are distributed uniformly over
+  // the remaining distinct objects.
+  double objectSelectivity(Id object) const {
+    if (_nofTriples == 0 || _objectBounds.empty() ||
+        object < _objectBounds.front() || object > _objectBounds.back()) {
+      return 0;
+    }
+    auto it = std::lower_bound(
+        _heavyHitters.begin(), _heavyHitters.end(), object,
+        [](const array<Id, 2>& a, Id b) { return a[0] < b; });
+    if (it != _heavyHitters.end() && (*it)[0] == object) {
+      return static_cast<double>((*it)[1]) / _nofTriples;
+    }
+    size_t nofHeavyTriples = 0;
+    for (const auto& heavyHitter : _heavyHitters) {
+      nofHeavyTriples += heavyHitter[1];
+    }
+    size_t nofOtherObjects =
+        std::max(_nofDistinctObjects, _heavyHitters.size() + 1) -
+        _heavyHitters.size();
+    return static_cast<double>(_nofTriples - nofHeavyTriples) /
+           nofOtherObjects / _nofTriples;
+  }
+};
+
+// Computes the PredicateStatistics from the objects of a predicate, which
+// have to be added in sorted order (e.g. while reading the POS permutation).
+class PredicateStatisticsBuilder {
+ public:
+  PredicateStatisticsBuilder(size_t nofTriples, size_t nofBuckets,
+                             size_t nofHeavyHitters)
+      : _nofBuckets(std::min(nofBuckets, nofTriples > 0 ? nofTriples - 1 : 0)),
+        _nofHeavyHitters(nofHeavyHitters) {
+    _stats._nofTriples = nofTriples;
+  }
+
+  void addObject(Id object) {
+    if (_nofObjects > 0 && object != _lastObject) {
+      finishRun();
+    }
+    if (_nofObjects == nextBoundPosition()) {
+      _stats._objectBounds.push_back(object);
+    }
+    _lastObject = object;
+    ++_runLength;
+    ++_nofObjects;
+  }
+
+  PredicateStatistics finish(size_t nofDistinctSubjects) {
+    if (_nofObjects != _stats._nofTriples) {
+      std::ostringstream oss;
+      oss << "Got " << _nofObjects << " objects for the statistics of a "
+          << "predicate with " << _stats._nofTriples << " triples";
+      throw std::runtime_error(oss.str());
+    }
+    if (_runLength > 0) {
+      finishRun();
+    }
+    _stats._nofDistinctSubjects = nofDistinctSubjects;
+    while (!_heavyHitters.empty()) {
+      _stats._heavyHitters.push_back(
+          {_heavyHitters.top().second, _heavyHitters.top().first});
+      _heavyHitters.pop();
+    }
+    std::sort(_stats._heavyHitters.begin(), _stats._heavyHitters.end());
+    return std::move(_stats);
+  }
+
+ private:
+  // The position of the next object in _stats._objectBounds.
+  size_t nextBoundPosition() const {
+    size_t i = _stats._objectBounds.size();
+    if (i > _nofBuckets) {
+      return _stats._nofTriples;
+    }
+    return _nofBuckets == 0 ? 0 : i * (_stats._nofTriples - 1) / _nofBuckets;
+  }
+
+  void finishRun() {
+    ++_stats._nofDistinctObjects;
+    if (_nofHeavyHitters > 0) {
+      _heavyHitters.emplace(_runLength, _lastObject);
+      if (_heavyHitters.size() > _nofHeavyHitters) {
+        _heavyHitters.pop();
+      }
+    }
+    _runLength = 0;
+  }
+
+  size_t _nofBuckets;
+  size_t _nofHeavyHitters;
+  PredicateStatistics _stats;
+  size_t _nofObjects = 0;
+  Id _lastObject = 0;
+  size_t _runLength = 0;
+  // The pairs (number of triples, object) of the most frequent objects so
+  // far, the least frequent one on top.
+  std::priority_queue<std::pair<size_t, Id>, vector<std::pair<size_t, Id>>,
+                      std::greater<std::pair<size_t, Id>>>
+      _heavyHitters;
+};
+
+// The PredicateStatistics of all predicates of the index. They are created by
+// Index::createRelationStatistics and stored in <index>.index.statistics.
+class RelationStatistics {
+ public:
+  bool empty() const { return _predicates.empty(); }
+
+  size_t size() const { return _predicates.size(); }
+
+  // The statistics of the predicate or nullptr if there are none.
+  const PredicateStatistics* get(Id predicate) const {
+    auto it = _predicates.find(predicate);
+    return it == _predicates.end() ? nullptr : &it->second;
+  }
+
+  void add(Id predicate, PredicateStatistics stats) {
+    _predicates[predicate] = std::move(stats);
+  }
+
+  void writeToFile(const string& fileName) const {
+    ad_utility::File file(fileName, "w");
+    file.write(&VERSION, sizeof(VERSION));
+    size_t nofPredicates = _predicates.size();
+    file.write(&nofPredicates, sizeof(nofPredicates));
+    for (const auto& [predicate, stats] : _predicates) {
+      file.write(&predicate, sizeof(predicate));
+      file.write(&stats._nofTriples, sizeof(stats._nofTriples));
+      file.write(&stats._nofDistinctSubjects,
+                 sizeof(stats._nofDistinctSubjects));
+      file.write(&stats._nofDistinctObjects, sizeof(stats._nofDistinctObjects));
+      writeVector(stats._objectBounds, &file);
+      writeVector(stats._heavyHitters, &file);
+    }
+  }
+
+  void readFromFile(const string& fileName) {
+    ad_utility::File file(fileName, "r");
+    off_t off = 0;
+    uint32_t version;
+    off += file.read(&version, sizeof(version), off);
+    if (version != VERSION) {
+      std::ostringstream oss;
+      oss << "The relation statistics " << fileName << " have version "
+          << version << " but version " << VERSION
+          << " is expected. Recreate the index";
+      throw std::runtime_error(oss.str());
+    }
+    _predicates.clear();
+    size_t nofPredicates;
+    off += file.read(&nofPredicates, sizeof(nofPredicates), off);
+    for (size_t i = 0; i < nofPredicates; ++i) {
+      Id predicate;
+      off += file.read(&predicate, sizeof(predicate), off);
+      PredicateStatistics& stats = _predicates[predicate];
+      off += file.read(&stats._nofTriples, sizeof(stats._nofTriples), off);
+      off += file.read(&stats._nofDistinctSubjects,
+                       sizeof(stats._nofDistinctSubjects), off);
+      off += file.read(&stats._nofDistinctObjects,
+                       sizeof(stats._nofDistinctObjects), off);
+      stats._objectBounds = readVector<Id>(file, &off);
+      stats._heavyHitters = readVector<array<Id, 2>>(file, &off);
+    }
+  }
+
+ private:
+  static constexpr uint32_t VERSION = 0;
+
+  template <class T>
+  static void writeVector(const vector<T>& v, ad_utility::File* file) {
+    size_t size = v.size();
+    file->write(&size, sizeof(size));
+    file->write(v.data(), size * sizeof(T));
+  }
+
+  template <class T>
+  static vector<T> readVector(ad_utility::File& file, off_t* off) {
+    size_t size;
+    *off += file.read(&size, sizeof(size), *off);
+    vector<T> v(size);
+    *off += file.read(v.data(), size * sizeof(T), *off);
+    return v;
+  }
+
+  std::map<Id, PredicateStatistics> _predicates;
+};
@@ -82,6 +82,10 @@ size_t TextMetaData::getBlockCount() const { return _blocks.size(); }
 
 // _____________________________________________________________________________
 ad_utility::File& operator<<(ad_utility::File& f, const TextMetaData& md) {
+  uint64_t magicNumber = MAGIC_NUMBER_TEXT_META_DATA_VERSION;
+  f.write(&magicNumber, sizeof(magicNumber));
+  uint64_t version = V_TEXT_CURRENT;
+  f.write(&version, sizeof(version));
   auto buf = md.getBlockCount();
   f.write(&buf, sizeof(md.getBlockCount()));
   for (const auto& b : md._blocks) {
@@ -100,13 +104,27 @@ ad_utility::File& operator<<(ad_utility::File& f, const TextMetaData& md) {
 
 // _____________________________________________________________________________
 TextMetaData& TextMetaData::createFromByteBuffer(unsigned char* buffer) {
-  size_t nofBlocks = *reinterpret_cast<size_t*>(buffer);
-  off_t offset = sizeof(size_t);
+  off_t offset = 0;
+  uint64_t version = V_TEXT_NO_VERSION;
+  if (*reinterpret_cast<uint64_t*>(buffer) ==
+      MAGIC_NUMBER_TEXT_META_DATA_VERSION) {
+    version = *reinterpret_cast<uint64_t*>(buffer + sizeof(uint64_t));
+    offset += 2 * sizeof(uint64_t);
+    if (version > V_TEXT_CURRENT) {
+      AD_THROW(ad_semsearch::Exception::BAD_INPUT,
+               "The text index has meta data version " +
+                   std::to_string(version) +
+                   " which is newer than this version of QLever. Please "
+                   "rebuild the text index.");
+    }
+  }
+  size_t nofBlocks = *reinterpret_cast<size_t*>(buffer + offset);
+  offset += sizeof(size_t);
   bool stepEntity = false;
   for (size_t i = 0; i < nofBlocks; ++i) {
     TextBlockMetaData tbmd;
-    tbmd.createFromByteBuffer(buffer + offset);
-    offset += TextBlockMetaData::sizeOnDisk();
+    tbmd.createFromByteBuffer(buffer + offset, version);
+    offset += TextBlockMetaData::sizeOnDisk(version);
     if (!stepEntity) {
       if (_blocks.size() == 0 ||
           _blocks.back()._lastWordId + 1 == tbmd._firstWordId) {
@@ -147,15 +165,15 @@ ad_utility::File& operator<<(ad_utility::File& f, const TextBlockMetaData& md) {
 
 // _____________________________________________________________________________
 TextBlockMetaData& TextBlockMetaData::createFromByteBuffer(
-    unsigned char* buffer) {
+    unsigned char* buffer, uint64_t version) {
   off_t offset = 0;
   _firstWordId = *reinterpret_cast<Id*>(buffer + offset);
   offset += sizeof(_firstWordId);
   _lastWordId = *reinterpret_cast<Id*>(buffer + offset);
   offset += sizeof(_lastWordId);
-  _cl.createFromByteBuffer(buffer + offset);
-  offset += ContextListMetaData::sizeOnDisk();
-  _entityCl.createFromByteBuffer(buffer + offset);
+  _cl.createFromByteBuffer(buffer + offset, version);
+  offset += ContextListMetaData::sizeOnDisk(version);
+  _entityCl.createFromByteBuffer(buffer + offset, version);
   return *this;
 }
 
@@ -167,12 +185,13 @@ ad_utility::File& operator<<(ad_utility::File& f,
   f.write(&md._startWordlist, sizeof(md._startWordlist));
   f.write(&md._startScorelist, sizeof(md._startScorelist));
   f.write(&md._lastByte, sizeof(md._lastByte));
+  f.write(&md._codec, sizeof(md._codec));
   return f;
 }
 
 // _____________________________________________________________________________
 ContextListMetaData& ContextListMetaData::createFromByteBuffer(
-    unsigned char* buffer) {
+    unsigned char* buffer, uint64_t version) {
   off_t offset = 0;
   _nofElements = *reinterpret_cast<size_t*>(buffer + offset);
   offset += sizeof(_nofElements);
@@ -183,6 +202,10 @@ ContextListMetaData& ContextListMetaData::createFromByteBuffer(
   _startScorelist = *reinterpret_cast<off_t*>(buffer + offset);
   offset += sizeof(_startScorelist);
   _lastByte = *reinterpret_cast<off_t*>(buffer + offset);
+  offset += sizeof(_lastByte);
+  _codec = version >= V_TEXT_LIST_CODEC
+               ? *reinterpret_cast<TextListCodec*>(buffer + offset)
+               : TextListCodec::Simple8b;
   return *this;
 }
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdio>
+#include <limits>
 #include <vector>
 #include "../global/Id.h"
 #include "../util/Exception.h"
@@ -11,6 +12,25 @@
 
 using std::vector;
 
+// Marks text meta data that starts with a version (older text indices start
+// directly with the number of blocks).
+const uint64_t MAGIC_NUMBER_TEXT_META_DATA_VERSION =
+    std::numeric_limits<uint64_t>::max();
+// constants for text meta data versions
+constexpr uint64_t V_TEXT_NO_VERSION = 0;
+// each context list stores the codec of its lists
+constexpr uint64_t V_TEXT_LIST_CODEC = 1;
+constexpr uint64_t V_TEXT_CURRENT = V_TEXT_LIST_CODEC;
+
+// The compression of the context, word and score lists of a context list.
+// The numeric values are part of the on-disk format, never change them.
+enum class TextListCodec : uint64_t {
+  // see Simple8bCode.h, the only codec of unversioned text indices
+  Simple8b = 0,
+  // see StreamVByteCode.h, only for lists whose values fit into 32 bits
+  StreamVByte = 1
+};
+
 class ContextListMetaData {
  public:
   ContextListMetaData()
@@ -33,15 +53,18 @@ class ContextListMetaData {
   off_t _startWordlist;
   off_t _startScorelist;
   off_t _lastByte;
+  TextListCodec _codec = TextListCodec::Simple8b;
 
   bool hasMultipleWords() const { return _startScorelist > _startWordlist; }
 
   // Restores meta data from raw memory.
   // Needed when registering an index on startup.
-  ContextListMetaData& createFromByteBuffer(unsigned char* buffer);
+  ContextListMetaData& createFromByteBuffer(unsigned char* buffer,
+                                            uint64_t version);
 
-  static constexpr size_t sizeOnDisk() {
-    return sizeof(size_t) + 4 * sizeof(off_t);
+  static constexpr size_t sizeOnDisk(uint64_t version) {
+    return sizeof(size_t) + 4 * sizeof(off_t) +
+           (version >= V_TEXT_LIST_CODEC ? sizeof(TextListCodec) : 0);
   }
 
   friend ad_utility::File& operator<<(ad_utility::File& f,
@@ -68,13 +91,14 @@ class TextBlockMetaData {
   ContextListMetaData _cl;
   ContextListMetaData _entityCl;
 
-  static constexpr size_t sizeOnDisk() {
-    return 2 * sizeof(Id) + 2 * ContextListMetaData::sizeOnDisk();
+  static constexpr size_t sizeOnDisk(uint64_t version) {
+    return 2 * sizeof(Id) + 2 * ContextListMetaData::sizeOnDisk(version);
   }
 
   // Restores meta data from raw memory.
   // Needed when registering an index on startup.
-  TextBlockMetaData& createFromByteBuffer(unsigned char* buffer);
+  TextBlockMetaData& createFromByteBuffer(unsigned char* buffer,
+                                          uint64_t version);
 
   friend ad_utility::File& operator<<(ad_utility::File& f,
                                       const TextBlockMetaData& md);
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -16,12 +17,14 @@
 
 #include "../global/Constants.h"
 #include "../global/Id.h"
+#include "../global/ValueId.h"
 #include "../util/Exception.h"
 #include "../util/HashMap.h"
 #include "../util/HashSet.h"
 #include "../util/Log.h"
 #include "../util/StringUtils.h"
 #include "./CompressedString.h"
+#include "./FrontCodedVocabulary.h"
 #include "./StringSortComparator.h"
 #include "ExternalVocabulary.h"
 
@@ -99,11 +102,22 @@ class Vocabulary {
   //! clear all the contents, but not the settings for prefixes etc
   void clear() {
     _words.clear();
+    _onDiskWords.reset();
     _externalLiterals.clear();
   }
   //! Read the vocabulary from file.
   void readFromFile(const string& fileName, const string& extLitsFileName = "");
 
+  //! Use a memory-mapped FrontCodedVocabulary (built from the file written by
+  //! readFromFile) for the internal words instead of reading all of them to
+  //! RAM.
+  template <typename U = StringType, typename = enable_if_compressed<U>>
+  void readFromFrontCodedFile(const string& fileName,
+                              const string& extLitsFileName = "");
+
+  //! True iff the internal words are read from a FrontCodedVocabulary.
+  bool wordsAreOnDisk() const { return _onDiskWords != nullptr; }
+
   //! Write the vocabulary to a file.
   // We don't need to write compressed vocabularies with the current index
   // building procedure
@@ -142,14 +156,16 @@ class Vocabulary {
   //! externalized words don't allow references
   template <typename U = StringType, typename = enable_if_compressed<U>>
   const std::optional<string> idToOptionalString(Id id) const {
-    if (id < _words.size()) {
+    if (ValueId::isValue(id)) {
+      return ValueId::toIndexWord(id);
+    } else if (id < size()) {
       // internal, prefixCompressed word
-      return expandPrefix(_words[static_cast<size_t>(id)]);
+      return at(id);
     } else if (id == ID_NO_VALUE) {
       return std::nullopt;
     } else {
       // this word must be externalized
-      id -= _words.size();
+      id -= size();
       AD_CHECK(id < _externalLiterals.size());
       return _externalLiterals[id];
     }
@@ -159,6 +175,9 @@ class Vocabulary {
   //! lvalue for compressedString and const& for string-based vocabulary
   AccessReturnType_t<StringType> at(Id id) const {
     if constexpr (_isCompressed) {
+      if (_onDiskWords) {
+        return expandPrefix(CompressedString::fromString((*_onDiskWords)[id]));
+      }
       return expandPrefix(_words[static_cast<size_t>(id)]);
     } else {
       return _words[static_cast<size_t>(id)];
@@ -168,7 +187,9 @@ class Vocabulary {
   // AccessReturnType_t<StringType> at(Id id) const { return operator[](id); }
 
   //! Get the number of words in the vocabulary.
-  size_t size() const { return _words.size(); }
+  size_t size() const {
+    return _onDiskWords ? _onDiskWords->size() : _words.size();
+  }
 
   //! Reserve space for the given number of words.
   void reserve(unsigned int n) { _words.reserve(n); }
@@ -176,15 +197,20 @@ class Vocabulary {
   //! Get an Id from the vocabulary for some "normal" word.
   //! Return value signals if something was found at all.
   bool getId(const string& word, Id* id) const {
+    if (auto valueId = ValueId::fromIndexWord(word)) {
+      // numbers and dates are not part of the vocabulary.
+      *id = *valueId;
+      return true;
+    }
     if (!shouldBeExternalized(word)) {
       // need the TOTAL level because we want the unique word.
       *id = lower_bound(word, SortLevel::TOTAL);
       // works for the case insensitive version because
       // of the strict ordering.
-      return *id < _words.size() && at(*id) == word;
+      return *id < size() && at(*id) == word;
     }
     bool success = _externalLiterals.getId(word, id);
-    *id += _words.size();
+    *id += size();
     return success;
   }
 
@@ -224,8 +250,8 @@ class Vocabulary {
     range->_last = prefixRange.second - 1;
 
     if (success) {
-      AD_CHECK_LT(range->_first, _words.size());
-      AD_CHECK_LT(range->_last, _words.size());
+      AD_CHECK_LT(range->_first, size());
+      AD_CHECK_LT(range->_last, size());
     }
     return success;
   }
@@ -326,16 +352,14 @@ class Vocabulary {
   /// level, due to limitations in the StringSortComparators
   std::pair<Id, Id> prefix_range(const string& prefix) const {
     if (prefix.empty()) {
-      return {0, _words.size()};
+      return {0, size()};
     }
     Id lb = lower_bound(prefix, SortLevel::PRIMARY);
     auto transformed = _caseComparator.transformToFirstPossibleBiggerValue(
         prefix, SortLevel::PRIMARY);
 
     auto pred = getLowerBoundLambda<decltype(transformed)>(SortLevel::PRIMARY);
-    auto ub = static_cast<Id>(
-        std::lower_bound(_words.begin(), _words.end(), transformed, pred) -
-        _words.begin());
+    auto ub = lowerBoundImpl(transformed, pred);
 
     return {lb, ub};
   }
@@ -347,19 +371,45 @@ class Vocabulary {
   // Wraps std::lower_bound and returns an index instead of an iterator
   Id lower_bound(const string& word,
                  const SortLevel level = SortLevel::QUARTERNARY) const {
-    return static_cast<Id>(std::lower_bound(_words.begin(), _words.end(), word,
-                                            getLowerBoundLambda(level)) -
-                           _words.begin());
+    return lowerBoundImpl(word, getLowerBoundLambda(level));
   }
 
   // _______________________________________________________________
   Id upper_bound(const string& word, const SortLevel level) const {
-    return static_cast<Id>(std::upper_bound(_words.begin(), _words.end(), word,
-                                            getUpperBoundLambda(level)) -
-                           _words.begin());
+    return upperBoundImpl(word, getUpperBoundLambda(level));
   }
 
  private:
+  // std::lower_bound on the internal words (either _words or _onDiskWords)
+  template <class R, class Comp>
+  Id lowerBoundImpl(const R& value, Comp comp) const {
+    if constexpr (_isCompressed) {
+      if (_onDiskWords) {
+        return _onDiskWords->partitionPoint([&](const string& w) {
+          return comp(CompressedString::fromString(w), value);
+        });
+      }
+    }
+    return static_cast<Id>(
+        std::lower_bound(_words.begin(), _words.end(), value, comp) -
+        _words.begin());
+  }
+
+  // std::upper_bound on the internal words (either _words or _onDiskWords)
+  template <class R, class Comp>
+  Id upperBoundImpl(const R& value, Comp comp) const {
+    if constexpr (_isCompressed) {
+      if (_onDiskWords) {
+        return _onDiskWords->partitionPoint([&](const string& w) {
+          return !comp(value, CompressedString::fromString(w));
+        });
+      }
+    }
+    return static_cast<Id>(
+        std::upper_bound(_words.begin(), _words.end(), value, comp) -
+        _words.begin());
+  }
+
   template <class R = std::string>
   auto getLowerBoundLambda(const SortLevel level) const {
     if constexpr (_isCompressed) {
@@ -403,6 +453,9 @@ class Vocabulary {
   vector<std::string> _internalizedLangs{"en"};
 
   vector<StringType> _words;
+  // If set, the internal words are stored here instead of in _words. The
+  // mapping is read-only, so copies of this vocabulary can share it.
+  std::shared_ptr<const FrontCodedVocabulary> _onDiskWords;
   ExternalVocabulary<ComparatorType> _externalLiterals;
   ComparatorType _caseComparator;
 };
@@ -14,6 +14,7 @@
 #include <vector>
 #include "./VocabularyGenerator.h"
 
+#include "../global/ValueId.h"
 #include "../util/Conversions.h"
 #include "../util/Exception.h"
 #include "../util/HashMap.h"
@@ -144,7 +145,11 @@ void VocabularyMerger::writeQueueWordsToIdVec(const std::vector<QueueWord>& buff
   writeBuf.reserve(bufSize);
   // avoid duplicates
   for (auto& top : buffer) {
-    if (top._value != _lastWritten) {
+    if (auto valueId = ValueId::fromIndexWord(top._value)) {
+      // numbers and dates are stored inline in their Id and are not part of
+      // the vocabulary (duplicates get the same Id anyway).
+      writeBuf.emplace_back(top._partialFileId, std::make_pair(top._partialWordId, *valueId));
+    } else if (top._value != _lastWritten) {
       _lastWritten = top._value;
 
       // TODO<optimization> If we aim to further speed this up, we could
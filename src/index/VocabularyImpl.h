@@ -22,6 +22,7 @@ void Vocabulary<S, C>::readFromFile(const string& fileName,
                                     const string& extLitsFileName) {
   LOG(INFO) << "Reading vocabulary from file " << fileName << "\n";
   _words.clear();
+  _onDiskWords.reset();
   std::fstream in(fileName.c_str(), std::ios_base::in);
   string line;
   [[maybe_unused]] bool first = true;
@@ -64,6 +65,24 @@ void Vocabulary<S, C>::readFromFile(const string& fileName,
   }
 }
 
+// _____________________________________________________________________________
+template <class S, class C>
+template <typename, typename>
+void Vocabulary<S, C>::readFromFrontCodedFile(const string& fileName,
+                                              const string& extLitsFileName) {
+  LOG(INFO) << "Mapping front coded vocabulary from file " << fileName << "\n";
+  _words.clear();
+  auto onDiskWords = std::make_shared<FrontCodedVocabulary>();
+  onDiskWords->initFromFile(fileName);
+  _onDiskWords = std::move(onDiskWords);
+  LOG(INFO) << "It contains " << size() << " elements\n";
+  if (extLitsFileName.size() > 0) {
+    LOG(INFO) << "Registering external vocabulary for literals.\n";
+    _externalLiterals.initFromFile(extLitsFileName);
+    LOG(INFO) << "Done registering external vocabulary for literals.\n";
+  }
+}
+
 // _____________________________________________________________________________
 template <class S, class C>
 template <typename, typename>
@@ -662,9 +662,8 @@ class TokenizerCtre {
   void skipWhitespace() {
     auto v = view();
     auto pos = v.find_first_not_of("\x20\x09\x0D\x0A");
-    if (pos != string::npos) {
-      _data.remove_prefix(pos);
-    }
+    // the input might also consist of whitespace only
+    _data.remove_prefix(pos != string::npos ? pos : v.size());
   }
 
   // ___________________________________________________________________________________
@@ -907,9 +906,8 @@ class Tokenizer {
   void skipWhitespace() {
     auto v = view();
     auto pos = v.find_first_not_of("\x20\x09\x0D\x0A");
-    if (pos != string::npos) {
-      _data.remove_prefix(pos);
-    }
+    // the input might also consist of whitespace only
+    _data.remove_prefix(pos != string::npos ? pos : v.size());
     // auto success = skip(_tokens.WsMultiple);
     // assert(success);
     return;
@@ -630,9 +630,217 @@ bool TurtleStreamParser<T>::getLine(std::array<string, 3>* triple) {
   return true;
 }
 
+// ______________________________________________________________________
+template <class T>
+size_t TurtleParallelParser<T>::findLastStatementEnd(std::string_view data) {
+  enum class State { Outside, Iri, Comment, Literal, LongLiteral };
+  State state = State::Outside;
+  char quote = '"';
+  auto isLongQuote = [&data, &quote](size_t i) {
+    return i + 2 < data.size() && data[i + 1] == quote && data[i + 2] == quote;
+  };
+  size_t lastEnd = 0;
+  for (size_t i = 0; i < data.size(); ++i) {
+    char c = data[i];
+    switch (state) {
+      case State::Outside:
+        if (c == '"' || c == '\'') {
+          quote = c;
+          if (isLongQuote(i)) {
+            state = State::LongLiteral;
+            i += 2;
+          } else {
+            state = State::Literal;
+          }
+        } else if (c == '<') {
+          state = State::Iri;
+        } else if (c == '#') {
+          state = State::Comment;
+        } else if (c == '\\') {
+          // an escaped character in a prefixed name
+          ++i;
+        } else if (c == '.' && i + 1 < data.size() &&
+                   (data[i + 1] == '\n' ||
+                    (data[i + 1] == '\r' && i + 2 < data.size() &&
+                     data[i + 2] == '\n'))) {
+          lastEnd = i + 1;
+        }
+        break;
+      case State::Iri:
+        if (c == '>') {
+          state = State::Outside;
+        }
+        break;
+      case State::Comment:
+        if (c == '\n') {
+          state = State::Outside;
+        }
+        break;
+      case State::Literal:
+        if (c == '\\') {
+          ++i;
+        } else if (c == quote) {
+          state = State::Outside;
+        }
+        break;
+      case State::LongLiteral:
+        if (c == '\\') {
+          ++i;
+        } else if (c == quote && isLongQuote(i)) {
+          state = State::Outside;
+          i += 2;
+        }
+        break;
+    }
+  }
+  return lastEnd;
+}
+
+// ______________________________________________________________________
+template <class T>
+void TurtleParallelParser<T>::initialize(const string& filename) {
+  this->clear();
+  _batchFutures.clear();
+  _remainder.clear();
+  _numBatches = 0;
+  _nextTriple = 0;
+  _fileBuffer = std::make_unique<ParallelFileBuffer>(_blockSize);
+  _fileBuffer->open(filename);
+  if (auto res = _fileBuffer->getNextBlock(); res && !res.value().empty()) {
+    _remainder = std::move(res.value());
+  } else {
+    LOG(WARN)
+        << "The input stream for the turtle parser seems to contain no data!\n";
+  }
+  parseDirectives();
+  for (size_t i = 0; i < _numThreads && submitNextBatch(); ++i) {
+  }
+}
+
+// ______________________________________________________________________
+template <class T>
+void TurtleParallelParser<T>::parseDirectives() {
+  // the directives are followed by the first statement terminator (unless
+  // there are only directives).
+  size_t end = readUntilStatementEnd();
+  _tok.reset(_remainder.data(), end);
+  while (true) {
+    _tok.skipWhitespaceAndComments();
+    auto position = _tok.data().begin();
+    if (!this->directive()) {
+      _tok.reset(position, _remainder.data() + end - position);
+      break;
+    }
+  }
+  _remainder.erase(_remainder.begin(),
+                   _remainder.begin() + (_tok.data().begin() - _remainder.data()));
+  _tok.reset(nullptr, 0);
+  _directives = std::make_shared<const Directives>(
+      Directives{this->_prefixMap, this->_baseIRI});
+}
+
+// ______________________________________________________________________
+template <class T>
+size_t TurtleParallelParser<T>::readUntilStatementEnd() {
+  while (!_isParserExhausted) {
+    // the state of the literals is only known from the beginning of
+    // _remainder on, so we always have to scan all of it.
+    size_t end = findLastStatementEnd(
+        std::string_view(_remainder.data(), _remainder.size()));
+    if (end > 0) {
+      return end;
+    }
+    auto nextBlock = _fileBuffer->getNextBlock();
+    if (!nextBlock || nextBlock.value().empty()) {
+      _isParserExhausted = true;
+      break;
+    }
+    if (_remainder.size() > BZIP2_MAX_TOTAL_BUFFER_SIZE) {
+      throw typename TurtleParser<T>::ParseException(
+          "Could not find the end of a turtle statement within " +
+          std::to_string(BZIP2_MAX_TOTAL_BUFFER_SIZE >> 20) +
+          " MB of input\n");
+    }
+    _remainder.insert(_remainder.end(), nextBlock.value().begin(),
+                      nextBlock.value().end());
+  }
+  // the rest of the input is the last batch
+  return _remainder.size();
+}
+
+// ______________________________________________________________________
+template <class T>
+bool TurtleParallelParser<T>::submitNextBatch() {
+  size_t end = readUntilStatementEnd();
+  if (end == 0) {
+    return false;
+  }
+  std::vector<char> batch(_remainder.begin(), _remainder.begin() + end);
+  _remainder.erase(_remainder.begin(), _remainder.begin() + end);
+  _batchFutures.push_back(std::async(std::launch::async, &parseBatch,
+                                     std::move(batch), _numBatches,
+                                     _directives));
+  _numBatches++;
+  return true;
+}
+
+// ______________________________________________________________________
+template <class T>
+std::vector<typename TurtleParallelParser<T>::Triple>
+TurtleParallelParser<T>::parseBatch(
+    std::vector<char> batch, size_t batchIndex,
+    std::shared_ptr<const Directives> directives) {
+  TurtleParallelParser<T> parser;
+  parser._prefixMap = directives->_prefixMap;
+  parser._baseIRI = directives->_baseIRI;
+  // blank nodes of different batches must not get the same name.
+  parser._anonNodePrefix =
+      ANON_NODE_PREFIX + ":" + std::to_string(batchIndex) + "_";
+  parser._tok.reset(batch.data(), batch.size());
+  while (parser.statement()) {
+  }
+  parser._tok.skipWhitespaceAndComments();
+  auto d = parser._tok.view();
+  if (!d.empty()) {
+    auto s = std::min(size_t(1000), size_t(d.size()));
+    throw typename TurtleParser<T>::ParseException(
+        "Parsing of a batch of turtle input has failed, remaining bytes: " +
+        std::to_string(d.size()) + ", first 1000 unparsed characters:\n" +
+        std::string(d.data(), s));
+  }
+  if (parser._prefixMap != directives->_prefixMap ||
+      parser._baseIRI != directives->_baseIRI) {
+    throw typename TurtleParser<T>::ParseException(
+        "The parallel turtle parser only supports @prefix and @base "
+        "directives at the beginning of the input. Please move the "
+        "directives or disable the setting \"parallel-parsing\"\n");
+  }
+  return std::move(parser._triples);
+}
+
+// ______________________________________________________________________
+template <class T>
+bool TurtleParallelParser<T>::getLine(std::array<string, 3>* triple) {
+  while (_nextTriple == _triples.size()) {
+    if (_batchFutures.empty()) {
+      return false;
+    }
+    _triples = _batchFutures.front().get();
+    _batchFutures.pop_front();
+    _nextTriple = 0;
+    // keep all threads busy
+    submitNextBatch();
+  }
+  *triple = std::move(_triples[_nextTriple]);
+  _nextTriple++;
+  return true;
+}
+
 template class TurtleParser<Tokenizer>;
 template class TurtleParser<TokenizerCtre>;
 template class TurtleStreamParser<Tokenizer>;
 template class TurtleStreamParser<TokenizerCtre>;
 template class TurtleMmapParser<Tokenizer>;
 template class TurtleMmapParser<TokenizerCtre>;
+template class TurtleParallelParser<Tokenizer>;
+template class TurtleParallelParser<TokenizerCtre>;
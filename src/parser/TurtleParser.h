@@ -7,7 +7,9 @@
 
 #include <gtest/gtest.h>
 #include <sys/mman.h>
+#include <algorithm>
 #include <codecvt>
+#include <deque>
 #include <exception>
 #include <future>
 #include <locale>
@@ -88,6 +90,7 @@ class TurtleParser {
   }
 
   bool statement();
+  bool directive();
   /* Data Members */
 
   // Stores the triples that have been parsed but not retrieved yet.
@@ -116,11 +119,13 @@ class TurtleParser {
   std::string _activeSubject;
   std::string _activePredicate;
   size_t _numBlankNodes = 0;
+  // the names of anonymous blank nodes are this prefix followed by
+  // _numBlankNodes, see createAnonNode()
+  std::string _anonNodePrefix = ANON_NODE_PREFIX + ":";
 
  private:
   /* private Member Functions */
 
-  bool directive();
   bool prefixID();
   bool base();
   bool sparqlPrefix();
@@ -211,7 +216,7 @@ class TurtleParser {
 
   // create a new, unused, unique blank node string
   string createAnonNode() {
-    string res = ANON_NODE_PREFIX + ":" + std::to_string(_numBlankNodes);
+    string res = _anonNodePrefix + std::to_string(_numBlankNodes);
     _numBlankNodes++;
     return res;
   }
@@ -399,3 +404,87 @@ class TurtleMmapParser : public TurtleParser<Tokenizer_T> {
   using TurtleParser<Tokenizer_T>::_isParserExhausted;
   using TurtleParser<Tokenizer_T>::_triples;
 };
+
+/**
+ * This class is a TurtleParser that reads an uncompressed .ttl or .nt file
+ * or stream in blocks and parses these blocks concurrently.
+ *
+ * The blocks are split at statement terminators (a '.' that is followed by a
+ * newline and is not part of a literal, an IRI or a comment), so each of them
+ * can be parsed independently. All directives (@prefix, @base, ...) have to
+ * stand at the beginning of the input, they are parsed before the first
+ * block and their state is copied to the parsers of all blocks. The triples
+ * are returned in the order of the input, independent of the number of
+ * threads.
+ */
+template <class Tokenizer_T>
+class TurtleParallelParser : public TurtleParser<Tokenizer_T> {
+ public:
+  using Triple = std::array<string, 3>;
+
+  explicit TurtleParallelParser(
+      const string& filename,
+      size_t numThreads = NUM_PARALLEL_PARSER_THREADS,
+      size_t blockSize = PARALLEL_PARSER_BLOCK_SIZE)
+      : _numThreads(std::max(numThreads, size_t(1))), _blockSize(blockSize) {
+    LOG(INFO) << "Initialize parallel turtle parsing with " << _numThreads
+              << " threads from uncompressed file or stream " << filename
+              << '\n';
+    initialize(filename);
+  }
+
+  // inherit the wrapper overload
+  using TurtleParser<Tokenizer_T>::getLine;
+
+  bool getLine(std::array<string, 3>* triple) override;
+
+  void initialize(const string& filename) override;
+
+  // The position directly after the last statement terminator in data or 0 if
+  // there is none. data has to begin at the beginning of a statement.
+  static size_t findLastStatementEnd(std::string_view data);
+
+ private:
+  using TurtleParser<Tokenizer_T>::_tok;
+  using TurtleParser<Tokenizer_T>::_triples;
+  using TurtleParser<Tokenizer_T>::_isParserExhausted;
+
+  // Only used for the parsers of single batches.
+  TurtleParallelParser() = default;
+
+  // Parse the directives at the beginning of the input.
+  void parseDirectives();
+
+  // Read blocks from _fileBuffer until _remainder contains a statement
+  // terminator and return the position after the last one. If the input is
+  // exhausted before, return _remainder.size().
+  size_t readUntilStatementEnd();
+
+  // Read blocks from _fileBuffer until the next batch ends at a statement
+  // terminator (or the input is exhausted) and start parsing it
+  // asynchronously. Return false iff there is no more input.
+  bool submitNextBatch();
+
+  // Parse a batch of complete statements with the directives that were parsed
+  // by parseDirectives(). Throws if the batch can not be parsed completely.
+  struct Directives {
+    ad_utility::HashMap<std::string, std::string> _prefixMap;
+    std::string _baseIRI;
+  };
+  static std::vector<Triple> parseBatch(
+      std::vector<char> batch, size_t batchIndex,
+      std::shared_ptr<const Directives> directives);
+
+  size_t _numThreads = 1;
+  size_t _blockSize = PARALLEL_PARSER_BLOCK_SIZE;
+  std::unique_ptr<ParallelBuffer> _fileBuffer;
+  // the bytes that were read but do not belong to a batch yet
+  std::vector<char> _remainder;
+  size_t _numBatches = 0;
+  // a copy of this parser's state after parseDirectives()
+  std::shared_ptr<const Directives> _directives;
+  // the batches that are currently parsed, in the order of the input
+  std::deque<std::future<std::vector<Triple>>> _batchFutures;
+  // the next triple of _triples that getLine() returns
+  size_t _nextTriple = 0;
+};
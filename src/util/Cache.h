@@ -6,8 +6,12 @@
 #pragma once
 
 #include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <utility>
 #include "./HashMap.h"
 #include "PriorityQueue.h"
@@ -42,14 +46,30 @@ struct DefaultSizeGetter {
   }
 };
 
+/**
+ * Has evicted(const Score&) if T (the ScoreCalculator of a FlexibleCache) wants
+ * to be informed about the score of every element that is removed from the
+ * cache because the capacity was exceeded.
+ */
+template <typename T, typename Score, typename = void>
+struct HasEvictedMember : std::false_type {};
+
+template <typename T, typename Score>
+struct HasEvictedMember<T, Score,
+                        std::void_t<decltype(std::declval<T&>().evicted(
+                            std::declval<const Score&>()))>>
+    : std::true_type {};
+
 /**
  * @brief Associative array for almost arbitrary keys and values that acts as a
  * cache with fixed capacity.
  *
  * The strategy that is used to determine which element is removed once the
  * capacity is exceeded can be customized (see documentation of the template
- * parameters). Currently capacity relates to numbers of elements. May be
- * changed to bytes and checking entry sizes in the future. This implementation
+ * parameters). The capacity is given as a maximal number of elements and
+ * additionally as a maximal total size of the (non-pinned) elements, as
+ * determined by the EntrySizeGetter. Single elements that are larger than
+ * maxSizeSingleEntry are not cached at all. This implementation
  * provides thread safety for the cache itself and also enforces read-only
  * access for all operations which can't guarantee only one thread getting write
  * access. It uses shared_ptrs so as to ensure that deletes do not free in-use
@@ -83,12 +103,18 @@ class FlexibleCache {
 
   using EntryValue = shared_ptr<const Value>;
 
+  using EntrySizeType = std::invoke_result_t<EntrySizeGetter, const Value&>;
+
   class Entry {
     Key mKey;
     EntryValue mValue;
+    // The size of the value when it was inserted or when
+    // recomputeSizeAndScore was called the last time.
+    EntrySizeType mSize{};
 
    public:
-    Entry(Key k, EntryValue v) : mKey(std::move(k)), mValue(std::move(v)) {}
+    Entry(Key k, EntryValue v, EntrySizeType size)
+        : mKey(std::move(k)), mValue(std::move(v)), mSize(size) {}
 
     Entry() = default;
 
@@ -99,6 +125,10 @@ class FlexibleCache {
     const EntryValue& value() const { return mValue; }
 
     EntryValue& value() { return mValue; }
+
+    const EntrySizeType& size() const { return mSize; }
+
+    EntrySizeType& size() { return mSize; }
   };
 
   using EmplacedValue = shared_ptr<Value>;
@@ -110,8 +140,6 @@ class FlexibleCache {
 
   using TryEmplaceResult = pair<EmplacedValue, EntryValue>;
 
-  using EntrySizeType = std::invoke_result_t<EntrySizeGetter, const Value&>;
-
  public:
   //! Typical constructor. A default value may be added in time.
   explicit FlexibleCache(size_t capacity, ScoreComparator scoreComparator,
@@ -146,10 +174,12 @@ class FlexibleCache {
 
     if (const auto pinnedIt = _pinnedMap.find(key);
         pinnedIt != _pinnedMap.end()) {
+      ++_numHits;
       return TryEmplaceResult(shared_ptr<Value>(nullptr), pinnedIt->second);
     }
 
     if (const auto mapIt = _accessMap.find(key); mapIt != _accessMap.end()) {
+      ++_numHits;
       auto& handle = mapIt->second;
       // Move element to the front as it is now least recently used
       // The handle changes. In the current implementation, only irrelevant
@@ -160,20 +190,19 @@ class FlexibleCache {
                               _accessMap[key].value().value());
     }
 
+    ++_numMisses;
     // Insert without taking mutex recursively
     EmplacedValue emplaced = make_shared<Value>(std::forward<Args>(args)...);
-
-    _accessMap[key] =
-        _data.insert(_scoreCalculator(*emplaced), Entry(key, emplaced));
-    if (_data.size() > _capacity) {
-      // Remove the last element.
-      // Since we are using shared_ptr this does not free the underlying
-      // memory if it is still accessible through a previously returned
-      // shared_ptr
-
-      _accessMap.erase(_data.pop().value().key());
+    auto size = _entrySizeGetter(*emplaced);
+    if (size > _maxSizeSingleEntry) {
+      // Too large to be cached, but the caller still gets its value.
+      return TryEmplaceResult(emplaced, emplaced);
     }
-    assert(_data.size() <= _capacity);
+
+    _accessMap[key] = _data.insert(_scoreCalculator(*emplaced),
+                                   Entry(key, emplaced, size));
+    _totalSize += size;
+    removeElementsIfNecessary();
     return TryEmplaceResult(emplaced, emplaced);
   }
 
@@ -187,12 +216,15 @@ class FlexibleCache {
 
     if (const auto pinnedIt = _pinnedMap.find(key);
         pinnedIt != _pinnedMap.end()) {
+      ++_numHits;
       return TryEmplaceResult(shared_ptr<Value>(nullptr), pinnedIt->second);
     }
 
     if (const auto mapIt = _accessMap.find(key); mapIt != _accessMap.end()) {
+      ++_numHits;
       auto handle = mapIt->second;
       const EntryValue cached = handle.value().value();
+      _totalSize -= handle.value().size();
       // Move the element to the _pinnedMap and remove
       // unnecessary _accessMap entry
       _pinnedMap[key] = cached;
@@ -203,6 +235,7 @@ class FlexibleCache {
       return TryEmplaceResult(shared_ptr<Value>(nullptr), std::move(cached));
     }
 
+    ++_numMisses;
     // Insert without taking mutex recursively
     EmplacedValue emplaced = make_shared<Value>(std::forward<Args>(args)...);
     _pinnedMap[key] = emplaced;
@@ -235,32 +268,75 @@ class FlexibleCache {
   // TODO(schnelle) add pinned variant and check pinned
   void insert(const Key& key, Value value) {
     std::lock_guard<std::mutex> lock(_lock);
+    auto size = _entrySizeGetter(value);
+    if (size > _maxSizeSingleEntry) {
+      return;
+    }
     Score s = _scoreCalculator(value);
     auto handle = _data.insert(
-        std::move(s), Entry(key, make_shared<const Value>(std::move(value))));
+        std::move(s),
+        Entry(key, make_shared<const Value>(std::move(value)), size));
     _accessMap[key] = handle;
-    // todo<joka921> : codeDuplication
-    if (_data.size() > _capacity) {
-      // Remove the last element.
-      // Since we are using shared_ptr this does not free the underlying
-      // memory if it is still accessible through a previously returned
-      // shared_ptr
+    _totalSize += size;
+    removeElementsIfNecessary();
+  }
 
-      _accessMap.erase(_data.pop().value().key());
+  // The value of an element can change after it was inserted via tryEmplace
+  // (e.g. a query result is computed only after it has been inserted). Then
+  // this function has to be called to update the size and the score of the
+  // element. If the element now is larger than maxSizeSingleEntry it is
+  // removed from the cache, other elements might be removed to meet the
+  // capacity. Does nothing for pinned elements and elements that are not in
+  // the cache (anymore).
+  void recomputeSizeAndScore(const Key& key) {
+    std::lock_guard<std::mutex> lock(_lock);
+    const auto mapIt = _accessMap.find(key);
+    if (mapIt == _accessMap.end()) {
+      return;
     }
-    assert(_data.size() <= _capacity);
+    auto& handle = mapIt->second;
+    auto newSize = _entrySizeGetter(*handle.value().value());
+    _totalSize -= handle.value().size();
+    if (newSize > _maxSizeSingleEntry) {
+      _data.erase(std::move(handle));
+      _accessMap.erase(mapIt);
+      return;
+    }
+    handle.value().size() = newSize;
+    _totalSize += newSize;
+    _data.updateKey(_scoreCalculator(*handle.value().value()), &handle);
+    removeElementsIfNecessary();
   }
 
-  //! Set the capacity.
+  //! Set the capacity (the maximal number of non-pinned elements).
   void setCapacity(const size_t nofElements) {
     std::lock_guard<std::mutex> lock(_lock);
     _capacity = nofElements;
-    while (_data.size() > _capacity) {
-      // Remove elements from the back until we meet the capacity requirement
-      // TODO<joka921> : code duplication
-      _accessMap.erase(_data.pop().value().key());
-    }
-    assert(_data.size() <= _capacity);
+    removeElementsIfNecessary();
+  }
+
+  //! Set the maximal total size of the non-pinned elements.
+  void setMaxSize(const EntrySizeType& maxSize) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _maxSize = maxSize;
+    removeElementsIfNecessary();
+  }
+
+  //! Elements that are larger than this are not stored in the cache. Does not
+  //! affect elements that already are in the cache.
+  void setMaxSizeSingleEntry(const EntrySizeType& maxSize) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _maxSizeSingleEntry = maxSize;
+  }
+
+  [[nodiscard]] EntrySizeType getMaxSize() const {
+    std::lock_guard lock(_lock);
+    return _maxSize;
+  }
+
+  [[nodiscard]] EntrySizeType getMaxSizeSingleEntry() const {
+    std::lock_guard lock(_lock);
+    return _maxSizeSingleEntry;
   }
 
   //! Checks if there is an entry with the given key.
@@ -284,6 +360,7 @@ class FlexibleCache {
       // Item already erased do nothing
       return;
     }
+    _totalSize -= mapIt->second.value().size();
     _data.erase(std::move(mapIt->second));
     _accessMap.erase(mapIt);
   }
@@ -296,6 +373,7 @@ class FlexibleCache {
     // shared_ptr
     _data.clear();
     _accessMap.clear();
+    _totalSize = EntrySizeType{};
   }
 
   /// Clear the cache AND the pinned elements
@@ -307,6 +385,7 @@ class FlexibleCache {
     _data.clear();
     _pinnedMap.clear();
     _accessMap.clear();
+    _totalSize = EntrySizeType{};
   }
 
   /// return the total size of the pinned elements
@@ -321,15 +400,12 @@ class FlexibleCache {
         });
   }
 
-  /// return the total size of the cached elements
+  /// return the total size of the cached elements. These are the sizes from
+  /// the insertion or the last call to recomputeSizeAndScore, the values
+  /// (which might still be written by another thread) are not accessed.
   [[nodiscard]] EntrySizeType cachedSize() const {
     std::lock_guard lock(_lock);
-    return std::accumulate(
-        _accessMap.begin(), _accessMap.end(), EntrySizeType{},
-        [this](const EntrySizeType& x, const auto& el) {
-          // elements of the pinned Map are shared_ptrs
-          return x + _entrySizeGetter(*el.second.value().value());
-        });
+    return _totalSize;
   }
 
   /// return the number of cached elements
@@ -338,8 +414,55 @@ class FlexibleCache {
   /// return the number of pinned elements
   [[nodiscard]] size_t numPinnedElements() const { return _pinnedMap.size(); }
 
+  /// The number of calls to tryEmplace(Pinned) that found an existing element.
+  [[nodiscard]] size_t numHits() const {
+    std::lock_guard lock(_lock);
+    return _numHits;
+  }
+
+  /// The number of calls to tryEmplace(Pinned) that created a new element.
+  [[nodiscard]] size_t numMisses() const {
+    std::lock_guard lock(_lock);
+    return _numMisses;
+  }
+
+  /// The number of elements that were removed because the capacity was
+  /// exceeded.
+  [[nodiscard]] size_t numEvictions() const {
+    std::lock_guard lock(_lock);
+    return _numEvictions;
+  }
+
  private:
+  // Remove the elements with the lowest score until the number and the total
+  // size of the non-pinned elements meet the capacity. Must be called with
+  // _lock held.
+  void removeElementsIfNecessary() {
+    while (_data.size() > _capacity ||
+           (_data.size() > 0 && _totalSize > _maxSize)) {
+      // Since we are using shared_ptr this does not free the underlying
+      // memory if it is still accessible through a previously returned
+      // shared_ptr
+      auto handle = _data.pop();
+      _totalSize -= handle.value().size();
+      _accessMap.erase(handle.value().key());
+      ++_numEvictions;
+      if constexpr (HasEvictedMember<ScoreCalculator, Score>::value) {
+        _scoreCalculator.evicted(handle.score());
+      }
+    }
+    assert(_data.size() <= _capacity);
+  }
+
   size_t _capacity;
+  EntrySizeType _maxSize = std::numeric_limits<EntrySizeType>::max();
+  EntrySizeType _maxSizeSingleEntry =
+      std::numeric_limits<EntrySizeType>::max();
+  // The total size of the non-pinned elements.
+  EntrySizeType _totalSize{};
+  size_t _numHits = 0;
+  size_t _numMisses = 0;
+  size_t _numEvictions = 0;
   EntryList _data;
   AccessUpdater _accessUpdater;
   ScoreCalculator _scoreCalculator;
@@ -430,6 +553,82 @@ class TreeBasedLRUCache
              detail::timeAsScore{}, EntrySizeGetter{}) {}
 };
 
+namespace detail {
+// The score of an element in a GreedyDualSizeCache is L + cost / size, where L
+// (the "inflation") is the score of the last element that was evicted. Thus
+// elements that are expensive to compute per byte stay longer in the cache,
+// and elements that were not accessed for a long time are evicted eventually
+// because L grows with every eviction. The score is recomputed on every
+// access from the size that is stored in the entry of the cache (the size when
+// the element was inserted or when recomputeSizeAndScore was called), the value
+// itself might still be written by another thread. The ScoreCalculator and the
+// AccessUpdater of the cache are copies of the same object which share L.
+template <typename CostGetter, typename EntrySizeGetter>
+class GreedyDualSizeScore {
+ public:
+  GreedyDualSizeScore() : _inflation(std::make_shared<double>(0.0)) {}
+
+  // The ScoreCalculator
+  template <typename Value>
+  double operator()(const Value& value) const {
+    return score(value, _sizeGetter(value));
+  }
+
+  // The AccessUpdater, entry is an Entry of the FlexibleCache
+  template <typename Entry>
+  double operator()([[maybe_unused]] double oldScore,
+                    const Entry& entry) const {
+    return score(*entry.value(), entry.size());
+  }
+
+  // Called by the FlexibleCache for each evicted element.
+  void evicted(double score) {
+    // Elements with an infinite cost (e.g. ones that are still computed) are
+    // only evicted if there is nothing else left, don't let them
+    // influence the scores of the other elements.
+    if (std::isfinite(score)) {
+      *_inflation = std::max(*_inflation, score);
+    }
+  }
+
+ private:
+  template <typename Value, typename Size>
+  double score(const Value& value, const Size& size) const {
+    return *_inflation +
+           _costGetter(value) / std::max(1.0, static_cast<double>(size));
+  }
+
+  std::shared_ptr<double> _inflation;
+  CostGetter _costGetter;
+  EntrySizeGetter _sizeGetter;
+};
+}  // namespace detail
+
+/// A cache that evicts elements according to the GreedyDual-Size strategy (see
+/// detail::GreedyDualSizeScore). CostGetter is a function Value -> double that
+/// returns the cost to recompute a value. The capacity is given as the maximal
+/// number of elements, the maximal total size can be set via setMaxSize.
+template <typename Key, typename Value, typename CostGetter,
+          typename EntrySizeGetter = DefaultSizeGetter<Value>>
+class GreedyDualSizeCache
+    : public HeapBasedCache<
+          Key, Value, double, std::less<>,
+          detail::GreedyDualSizeScore<CostGetter, EntrySizeGetter>,
+          detail::GreedyDualSizeScore<CostGetter, EntrySizeGetter>,
+          EntrySizeGetter> {
+  using Score = detail::GreedyDualSizeScore<CostGetter, EntrySizeGetter>;
+  using Base = HeapBasedCache<Key, Value, double, std::less<>, Score, Score,
+                              EntrySizeGetter>;
+
+ public:
+  explicit GreedyDualSizeCache(size_t capacity)
+      : GreedyDualSizeCache(capacity, Score{}) {}
+
+ private:
+  GreedyDualSizeCache(size_t capacity, const Score& score)
+      : Base(capacity, std::less<>(), score, score, EntrySizeGetter{}) {}
+};
+
 /// typedef for the simple name LRUCache that is fixed to one of the possible
 /// implementations at compiletime
 #ifdef _QLEVER_USE_TREE_BASED_CACHE
@@ -0,0 +1,115 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "../global/Constants.h"
+
+namespace ad_utility {
+
+// Thrown by the operations of a query that was cancelled or whose deadline
+// has passed.
+class CancellationException : public std::exception {
+ public:
+  explicit CancellationException(std::string what) : _what(std::move(what)) {}
+
+  const char* what() const noexcept override { return _what.c_str(); }
+
+ private:
+  std::string _what;
+};
+
+// The deadline of a query, which can also be cancelled explicitly. The long
+// loops of the operations call checkCancellation() (below) every
+// CANCELLATION_CHECK_INTERVAL rows, which throws a CancellationException for
+// the handle of the current thread. The exception aborts the operations (and
+// removes their unfinished results from the cache) like any other error.
+class CancellationHandle {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // A handle without a deadline.
+  CancellationHandle() : _deadline(Clock::time_point::max()) {}
+
+  explicit CancellationHandle(Clock::duration timeout)
+      : _deadline(Clock::now() + timeout), _timeout(timeout) {}
+
+  void cancel() { _cancelled = true; }
+
+  bool isCancelled() {
+    if (!_cancelled && Clock::now() >= _deadline) {
+      _cancelled = true;
+    }
+    return _cancelled;
+  }
+
+  void throwIfCancelled() {
+    if (!isCancelled()) {
+      return;
+    }
+    std::ostringstream os;
+    if (Clock::now() >= _deadline) {
+      os << "The query timed out after "
+         << std::chrono::duration<double>(_timeout).count() << " seconds";
+    } else {
+      os << "The query was cancelled";
+    }
+    throw CancellationException(os.str());
+  }
+
+  // The handle of the query that the current thread computes or nullptr.
+  static const std::shared_ptr<CancellationHandle>& current() {
+    return currentRef();
+  }
+
+  // Sets the handle of the current thread for the lifetime of this object.
+  // Threads that help with the computation of a query (e.g. the threads of a
+  // parallel join) set the handle of the query.
+  class Scope {
+   public:
+    explicit Scope(std::shared_ptr<CancellationHandle> handle)
+        : _previous(std::exchange(currentRef(), std::move(handle))) {}
+    ~Scope() { currentRef() = std::move(_previous); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    std::shared_ptr<CancellationHandle> _previous;
+  };
+
+ private:
+  static std::shared_ptr<CancellationHandle>& currentRef() {
+    thread_local std::shared_ptr<CancellationHandle> handle;
+    return handle;
+  }
+
+  std::atomic<bool> _cancelled{false};
+  const Clock::time_point _deadline;
+  const Clock::duration _timeout{Clock::duration::max()};
+};
+
+// Throws a CancellationException if the query of the current thread was
+// cancelled or has timed out.
+inline void checkCancellation() {
+  const auto& handle = CancellationHandle::current();
+  if (handle) {
+    handle->throwIfCancelled();
+  }
+}
+
+// The same, but only checks every CANCELLATION_CHECK_INTERVAL iterations of a
+// loop (which is cheap enough to be called for each row).
+inline void checkCancellation(size_t iteration) {
+  if (iteration % CANCELLATION_CHECK_INTERVAL == 0) {
+    checkCancellation();
+  }
+}
+
+}  // namespace ad_utility
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <absl/container/flat_hash_map.h>
+#include "./MemoryTracker.h"
 
 namespace ad_utility {
 // Wrapper for HashMaps to be used everywhere throughout code for the semantic
@@ -16,4 +17,12 @@ template <class K, class V,
           class EqualKey = absl::container_internal::hash_default_eq<K>,
           class Alloc = std::allocator<std::pair<const K, V>>>
 using HashMap = absl::flat_hash_map<K, V, HashFcn, EqualKey, Alloc>;
+
+// A HashMap whose memory is charged to the query of the current thread (see
+// MemoryTracker.h).
+template <class K, class V>
+using TrackedHashMap =
+    HashMap<K, V, absl::container_internal::hash_default_hash<K>,
+            absl::container_internal::hash_default_eq<K>,
+            TrackingAllocator<std::pair<const K, V>>>;
 }  // namespace ad_utility
@@ -6,6 +6,7 @@
 
 #include <absl/container/flat_hash_set.h>
 #include <string>
+#include "./MemoryTracker.h"
 
 using std::string;
 
@@ -18,4 +19,11 @@ template <class K,
           class EqualKey = absl::container_internal::hash_default_eq<K>,
           class Alloc = std::allocator<K>>
 using HashSet = absl::flat_hash_set<K, HashFcn, EqualKey, Alloc>;
+
+// A HashSet whose memory is charged to the query of the current thread (see
+// MemoryTracker.h).
+template <class K>
+using TrackedHashSet = HashSet<K, absl::container_internal::hash_default_hash<K>,
+                               absl::container_internal::hash_default_eq<K>,
+                               TrackingAllocator<K>>;
 }  // namespace ad_utility
@@ -0,0 +1,171 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "../global/Constants.h"
+#include "./StringUtils.h"
+
+using std::string;
+
+namespace ad_utility {
+
+//! A single HTTP request as needed by the server.
+struct HttpRequest {
+  // e.g. "GET /?query=... HTTP/1.1"
+  string _requestLine;
+  // all header lines after the request line, including the CRLFs.
+  string _headers;
+  // e.g. "HTTP/1.1", the last word of the request line.
+  string _httpVersion;
+  // false iff the connection has to be closed after the response.
+  bool _keepAlive = true;
+};
+
+/**
+ * @brief Incrementally splits the bytes received on one connection into HTTP
+ * requests. Supports several requests in one chunk of data (pipelining) as
+ * well as requests that are split over several chunks.
+ *
+ * Message bodies (as announced by the Content-Length header) are skipped, the
+ * server only needs the request line.
+ */
+class HttpRequestParser {
+ public:
+  enum class Status { COMPLETE, INCOMPLETE, INVALID };
+
+  explicit HttpRequestParser(size_t maxRequestSize = MAX_HTTP_REQUEST_SIZE)
+      : _maxRequestSize(maxRequestSize) {}
+
+  //! Append received bytes.
+  void append(const char* data, size_t nofBytes) {
+    _buffer.append(data, nofBytes);
+  }
+
+  //! If a complete request has been received, remove it from the buffer,
+  //! store it in request and return COMPLETE. Returns INVALID if the data
+  //! can not be parsed or the request is larger than the maximal request size
+  //! (the connection should then be closed).
+  Status next(HttpRequest* request) {
+    _requestTooLarge = false;
+    // Be lenient like most servers and ignore empty lines between requests.
+    size_t start = 0;
+    while (_buffer.compare(start, 2, "\r\n") == 0) {
+      start += 2;
+    }
+    _buffer.erase(0, start);
+
+    size_t endOfHeaders = _buffer.find("\r\n\r\n");
+    if (endOfHeaders == string::npos) {
+      _requestTooLarge = _buffer.size() > _maxRequestSize;
+      return _requestTooLarge ? Status::INVALID : Status::INCOMPLETE;
+    }
+    if (endOfHeaders + 4 > _maxRequestSize) {
+      _requestTooLarge = true;
+      return Status::INVALID;
+    }
+    size_t endOfRequestLine = _buffer.find("\r\n");
+    string requestLine = _buffer.substr(0, endOfRequestLine);
+    if (requestLine.find("HTTP/") == string::npos) {
+      return Status::INVALID;
+    }
+    // The headers including the final CRLF of the last header.
+    string headers = _buffer.substr(endOfRequestLine + 2,
+                                    endOfHeaders - endOfRequestLine);
+    string lowercaseHeaders = getLowercase(headers);
+
+    size_t contentLength = 0;
+    if (auto value = getHeaderValue(lowercaseHeaders, "content-length")) {
+      auto length = parseContentLength(*value);
+      if (!length.has_value()) {
+        return Status::INVALID;
+      }
+      contentLength = length.value();
+    }
+    // Reject the request before its body is buffered.
+    if (contentLength > _maxRequestSize - (endOfHeaders + 4)) {
+      _requestTooLarge = true;
+      return Status::INVALID;
+    }
+    size_t endOfRequest = endOfHeaders + 4 + contentLength;
+    if (_buffer.size() < endOfRequest) {
+      return Status::INCOMPLETE;
+    }
+
+    string httpVersion = requestLine.substr(requestLine.rfind(' ') + 1);
+    // HTTP/1.1 keeps the connection alive unless requested otherwise,
+    // HTTP/1.0 closes it unless requested otherwise.
+    bool keepAlive = httpVersion != "HTTP/1.0";
+    if (auto value = getHeaderValue(lowercaseHeaders, "connection")) {
+      if (value->find("close") != string::npos) {
+        keepAlive = false;
+      } else if (value->find("keep-alive") != string::npos) {
+        keepAlive = true;
+      }
+    }
+
+    request->_requestLine = std::move(requestLine);
+    request->_headers = std::move(headers);
+    request->_httpVersion = std::move(httpVersion);
+    request->_keepAlive = keepAlive;
+    _buffer.erase(0, endOfRequest);
+    return Status::COMPLETE;
+  }
+
+  //! The number of received bytes that are not yet part of a request.
+  size_t bufferedBytes() const { return _buffer.size(); }
+
+  //! True iff the last call to next() returned INVALID because the request
+  //! is larger than the maximal request size.
+  bool requestTooLarge() const { return _requestTooLarge; }
+
+ private:
+  // Get the value of the header with the given (lowercase) name from the
+  // lowercase headers, or std::nullopt if there is no such header.
+  static std::optional<string> getHeaderValue(const string& lowercaseHeaders,
+                                              std::string_view name) {
+    size_t pos = 0;
+    while (pos < lowercaseHeaders.size()) {
+      size_t endOfLine = lowercaseHeaders.find("\r\n", pos);
+      if (endOfLine == string::npos) {
+        endOfLine = lowercaseHeaders.size();
+      }
+      std::string_view line(lowercaseHeaders.data() + pos, endOfLine - pos);
+      if (line.size() > name.size() && line.substr(0, name.size()) == name &&
+          line[name.size()] == ':') {
+        return strip(string(line.substr(name.size() + 1)), ' ');
+      }
+      pos = endOfLine + 2;
+    }
+    return std::nullopt;
+  }
+
+  // Parse the value of a Content-Length header, which has to consist of
+  // digits only. Values larger than the maximal request size are returned as
+  // _maxRequestSize + 1, so that they can not overflow.
+  std::optional<size_t> parseContentLength(const string& value) const {
+    if (value.empty()) {
+      return std::nullopt;
+    }
+    size_t result = 0;
+    for (char c : value) {
+      if (c < '0' || c > '9') {
+        return std::nullopt;
+      }
+      if (result <= _maxRequestSize) {
+        result = std::min(result * 10 + (c - '0'), _maxRequestSize + 1);
+      }
+    }
+    return result;
+  }
+
+  size_t _maxRequestSize;
+  string _buffer;
+  bool _requestTooLarge = false;
+};
+}  // namespace ad_utility
@@ -0,0 +1,197 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../global/Constants.h"
+
+using std::string;
+
+namespace ad_utility {
+
+/**
+ * @brief The bytes of one HTTP response, passed from the thread that computes
+ * the response (the producer) to the event loop of the server that sends it
+ * (the consumer). The response does not have to be complete before the first
+ * bytes are sent.
+ *
+ * At most maxBufferedBytes wait to be taken by the consumer, further writes
+ * block until the consumer has taken data or closed the stream. This way a
+ * slow client does not make the server buffer a whole large result.
+ */
+class HttpResponseStream {
+ public:
+  // Called (by the producer) when data becomes available or the response is
+  // complete. Must not call any method of the stream.
+  using Notify = std::function<void()>;
+  enum class Status { PENDING, COMPLETE, ABORTED };
+
+  explicit HttpResponseStream(
+      size_t maxBufferedBytes = std::numeric_limits<size_t>::max(),
+      Notify notify = Notify())
+      : _maxBufferedBytes(maxBufferedBytes), _notify(std::move(notify)) {}
+
+  //! Producer: append data. Returns false iff the consumer has closed the
+  //! stream (e.g. the client has disconnected), the data is then discarded.
+  bool write(std::string_view data) {
+    bool wasEmpty;
+    {
+      std::unique_lock lock(_mutex);
+      _spaceAvailable.wait(lock, [this] {
+        return _closed || _buffer.size() < _maxBufferedBytes;
+      });
+      if (_closed) {
+        return false;
+      }
+      wasEmpty = _buffer.empty();
+      _buffer.append(data);
+    }
+    // If the buffer was not empty, the consumer already knows about it.
+    if (wasEmpty && _notify) {
+      _notify();
+    }
+    return true;
+  }
+
+  //! Producer: the response is complete, no more data will be written.
+  //! Has no effect after abort().
+  void finish() { end(Status::COMPLETE); }
+
+  //! Producer: the response could not be completed (e.g. an error after the
+  //! header was written). The connection is closed after the data written so
+  //! far has been sent.
+  void abort() { end(Status::ABORTED); }
+
+  //! Consumer: move all available data to the end of out. Returns PENDING if
+  //! more data may follow.
+  Status takeAvailable(string* out) {
+    Status status;
+    {
+      std::lock_guard lock(_mutex);
+      out->append(_buffer);
+      _buffer.clear();
+      status = _status;
+    }
+    _spaceAvailable.notify_all();
+    return status;
+  }
+
+  //! Consumer: no more data will be taken, unblocks and fails all further
+  //! writes.
+  void close() {
+    {
+      std::lock_guard lock(_mutex);
+      _closed = true;
+      _buffer.clear();
+    }
+    _spaceAvailable.notify_all();
+  }
+
+ private:
+  void end(Status status) {
+    {
+      std::lock_guard lock(_mutex);
+      if (_status != Status::PENDING) {
+        return;
+      }
+      _status = status;
+    }
+    if (_notify) {
+      _notify();
+    }
+  }
+
+  const size_t _maxBufferedBytes;
+  Notify _notify;
+  std::mutex _mutex;
+  std::condition_variable _spaceAvailable;
+  string _buffer;
+  Status _status = Status::PENDING;
+  bool _closed = false;
+};
+
+/**
+ * @brief A stream buffer for the body of an HTTP response whose size is not
+ * known in advance. The body is collected in a buffer of fixed size, each time
+ * it is full (or the ostream is flushed) its content is written to the
+ * HttpResponseStream. With chunked == true (HTTP/1.1, "Transfer-Encoding:
+ * chunked") each write is one chunk. Otherwise (HTTP/1.0) the data is written
+ * as it is and the end of the body is the end of the connection, so the
+ * connection must be closed after the response.
+ *
+ * If the HttpResponseStream is closed, the ostream goes into the bad state.
+ */
+class HttpBodyStreamBuf : public std::streambuf {
+ public:
+  explicit HttpBodyStreamBuf(HttpResponseStream* stream, bool chunked = true,
+                             size_t bufferSize = HTTP_CHUNK_SIZE)
+      : _stream(stream), _chunked(chunked), _buffer(bufferSize) {
+    setp(_buffer.data(), _buffer.data() + _buffer.size());
+  }
+
+  //! Write the buffered data (and the terminating empty chunk). Returns false
+  //! iff the stream has been closed.
+  bool finish() {
+    if (!writeBuffer()) {
+      return false;
+    }
+    if (_chunked) {
+      _closed = !_stream->write("0\r\n\r\n");
+    }
+    return !_closed;
+  }
+
+ protected:
+  int_type overflow(int_type c) override {
+    if (!writeBuffer()) {
+      return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  int sync() override { return writeBuffer() ? 0 : -1; }
+
+ private:
+  // Write the buffered data (as one chunk). Nothing is written if the buffer
+  // is empty, an empty chunk would end the body.
+  bool writeBuffer() {
+    size_t size = pptr() - pbase();
+    if (_closed || size == 0) {
+      return !_closed;
+    }
+    string data;
+    if (_chunked) {
+      char header[20];
+      int headerSize = std::snprintf(header, sizeof(header), "%zx\r\n", size);
+      data.reserve(headerSize + size + 2);
+      data.append(header, headerSize);
+      data.append(pbase(), size);
+      data.append("\r\n");
+    } else {
+      data.assign(pbase(), size);
+    }
+    setp(_buffer.data(), _buffer.data() + _buffer.size());
+    _closed = !_stream->write(data);
+    return !_closed;
+  }
+
+  HttpResponseStream* _stream;
+  bool _chunked;
+  std::vector<char> _buffer;
+  bool _closed = false;
+};
+}  // namespace ad_utility
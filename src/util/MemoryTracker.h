@@ -0,0 +1,160 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace ad_utility {
+
+// Thrown by MemoryTracker::allocate if an allocation would exceed the limit.
+class MemoryLimitExceededException : public std::exception {
+ public:
+  explicit MemoryLimitExceededException(std::string what)
+      : _what(std::move(what)) {}
+
+  const char* what() const noexcept override { return _what.c_str(); }
+
+ private:
+  std::string _what;
+};
+
+// Counts the bytes that are currently allocated (and their maximum) by the
+// TrackingAllocators of one query and enforces a limit. The global tracker
+// counts the allocations of all TrackingAllocators without a limit.
+class MemoryTracker {
+ public:
+  explicit MemoryTracker(size_t limit = std::numeric_limits<size_t>::max())
+      : _limit(limit) {}
+
+  // Throws a MemoryLimitExceededException (and counts nothing) if the
+  // allocation would exceed the limit.
+  void allocate(size_t bytes) {
+    size_t current = _current.fetch_add(bytes) + bytes;
+    if (current > _limit) {
+      _current.fetch_sub(bytes);
+      std::ostringstream os;
+      os << "Allocating " << bytes << " more bytes would exceed the memory "
+         << "limit of " << _limit << " bytes for a single query ("
+         << current - bytes << " bytes are allocated)";
+      throw MemoryLimitExceededException(os.str());
+    }
+    size_t peak = _peak;
+    while (current > peak && !_peak.compare_exchange_weak(peak, current)) {
+    }
+  }
+
+  void deallocate(size_t bytes) { _current.fetch_sub(bytes); }
+
+  size_t currentBytes() const { return _current; }
+  size_t peakBytes() const { return _peak; }
+  size_t limit() const { return _limit; }
+
+  static MemoryTracker& global() {
+    static MemoryTracker tracker;
+    return tracker;
+  }
+
+  // The tracker of the query that the current thread computes or nullptr.
+  static const std::shared_ptr<MemoryTracker>& current() {
+    return currentRef();
+  }
+
+  // Sets the tracker of the current thread for the lifetime of this object.
+  class Scope {
+   public:
+    explicit Scope(std::shared_ptr<MemoryTracker> tracker)
+        : _previous(std::exchange(currentRef(), std::move(tracker))) {}
+    ~Scope() { currentRef() = std::move(_previous); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    std::shared_ptr<MemoryTracker> _previous;
+  };
+
+ private:
+  static std::shared_ptr<MemoryTracker>& currentRef() {
+    thread_local std::shared_ptr<MemoryTracker> tracker;
+    return tracker;
+  }
+
+  std::atomic<size_t> _current{0};
+  std::atomic<size_t> _peak{0};
+  const size_t _limit;
+};
+
+// An allocator that charges its allocations to the MemoryTracker of the query
+// that was computed by the thread that created the allocator (and to the
+// global tracker). A container that is copied charges the query of the
+// copying thread. The tracker lives as long as memory is charged to it, e.g.
+// by a result in the cache.
+template <class T>
+class TrackingAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  TrackingAllocator() noexcept : _tracker(MemoryTracker::current()) {}
+
+  template <class U>
+  TrackingAllocator(const TrackingAllocator<U>& other) noexcept
+      : _tracker(other._tracker) {}
+
+  T* allocate(size_t n) {
+    size_t bytes = n * sizeof(T);
+    if (_tracker) {
+      _tracker->allocate(bytes);
+    }
+    MemoryTracker::global().allocate(bytes);
+    try {
+      return std::allocator<T>().allocate(n);
+    } catch (...) {
+      release(bytes);
+      throw;
+    }
+  }
+
+  void deallocate(T* p, size_t n) noexcept {
+    std::allocator<T>().deallocate(p, n);
+    release(n * sizeof(T));
+  }
+
+  TrackingAllocator select_on_container_copy_construction() const {
+    return TrackingAllocator();
+  }
+
+  template <class U>
+  bool operator==(const TrackingAllocator<U>& other) const {
+    return _tracker == other._tracker;
+  }
+
+  template <class U>
+  bool operator!=(const TrackingAllocator<U>& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  template <class U>
+  friend class TrackingAllocator;
+
+  void release(size_t bytes) const noexcept {
+    if (_tracker) {
+      _tracker->deallocate(bytes);
+    }
+    MemoryTracker::global().deallocate(bytes);
+  }
+
+  std::shared_ptr<MemoryTracker> _tracker;
+};
+
+}  // namespace ad_utility
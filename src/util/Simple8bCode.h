@@ -6,6 +6,9 @@
 #include <assert.h>
 #include <stdint.h>
 #include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace ad_utility {
 
@@ -15,7 +18,7 @@ static const uint64_t SIMPLE8B_SELECTOR_MASK = 0x000000000000000F;
 
 //! Selectors,
 //! see: Anh & Moffat: "Index compression using 64-bit words."
-static const struct {
+static constexpr struct {
   unsigned char _itemWidth;
   unsigned char _groupSize;
   unsigned char _wastedBits;
@@ -132,8 +135,72 @@ class Simple8bCode {
   // ! i.e. sizeof(Numeric) * (nofElements + 239).
   // ! The overhead is included so that no check for noundaries
   // ! is necessary inside the decoding of a single codeword.
+  // ! Each selector is decoded by its own unrolled code, which uses AVX2 for
+  // ! 64 bit outputs if available (see decodeWord).
   template <typename Numeric>
-  static void decode(uint64_t* encoded, size_t nofElements, Numeric* decoded) {
+  static void decode(const uint64_t* encoded, size_t nofElements,
+                     Numeric* decoded) {
+    size_t nofElementsDone(0);
+    while (nofElementsDone < nofElements) {
+      uint64_t word = *encoded++;
+      switch (word & SIMPLE8B_SELECTOR_MASK) {
+        case 0:
+          nofElementsDone += decodeWord<0>(word, decoded + nofElementsDone);
+          break;
+        case 1:
+          nofElementsDone += decodeWord<1>(word, decoded + nofElementsDone);
+          break;
+        case 2:
+          nofElementsDone += decodeWord<2>(word, decoded + nofElementsDone);
+          break;
+        case 3:
+          nofElementsDone += decodeWord<3>(word, decoded + nofElementsDone);
+          break;
+        case 4:
+          nofElementsDone += decodeWord<4>(word, decoded + nofElementsDone);
+          break;
+        case 5:
+          nofElementsDone += decodeWord<5>(word, decoded + nofElementsDone);
+          break;
+        case 6:
+          nofElementsDone += decodeWord<6>(word, decoded + nofElementsDone);
+          break;
+        case 7:
+          nofElementsDone += decodeWord<7>(word, decoded + nofElementsDone);
+          break;
+        case 8:
+          nofElementsDone += decodeWord<8>(word, decoded + nofElementsDone);
+          break;
+        case 9:
+          nofElementsDone += decodeWord<9>(word, decoded + nofElementsDone);
+          break;
+        case 10:
+          nofElementsDone += decodeWord<10>(word, decoded + nofElementsDone);
+          break;
+        case 11:
+          nofElementsDone += decodeWord<11>(word, decoded + nofElementsDone);
+          break;
+        case 12:
+          nofElementsDone += decodeWord<12>(word, decoded + nofElementsDone);
+          break;
+        case 13:
+          nofElementsDone += decodeWord<13>(word, decoded + nofElementsDone);
+          break;
+        case 14:
+          nofElementsDone += decodeWord<14>(word, decoded + nofElementsDone);
+          break;
+        default:
+          nofElementsDone += decodeWord<15>(word, decoded + nofElementsDone);
+          break;
+      }
+    }
+  }
+
+  // ! The straightforward decoder with one loop for all selectors. Same
+  // ! requirements as decode, only used as reference in tests and benchmarks.
+  template <typename Numeric>
+  static void decodeScalar(const uint64_t* encoded, size_t nofElements,
+                           Numeric* decoded) {
     // Handle trivial empty case
     if (!nofElements) {
       return;
@@ -154,5 +221,44 @@ class Simple8bCode {
       }
     }
   }
+
+ private:
+  // ! Decode all items of a single codeword with the given selector and
+  // ! return the number of items. Since the item width is known at compile
+  // ! time, the loop is fully unrolled (and vectorized by the compiler).
+  // ! With AVX2, four 64 bit items are extracted at once by shifting the
+  // ! codeword by four different amounts. This may write up to three items
+  // ! after the group, which is covered by the overhead required by decode.
+  template <size_t Selector, typename Numeric>
+  static size_t decodeWord(uint64_t word, Numeric* decoded) {
+    constexpr size_t width = SIMPLE8B_SELECTORS[Selector]._itemWidth;
+    constexpr size_t groupSize = SIMPLE8B_SELECTORS[Selector]._groupSize;
+    constexpr uint64_t mask = SIMPLE8B_SELECTORS[Selector]._mask;
+    if constexpr (width == 0) {
+      // Selectors 0 and 1 encode streaks of 0's.
+      std::fill(decoded, decoded + groupSize, Numeric(0));
+      return groupSize;
+    }
+    word >>= 4;
+#if defined(__AVX2__)
+    if constexpr (sizeof(Numeric) == sizeof(uint64_t) && groupSize >= 4) {
+      const __m256i packed = _mm256_set1_epi64x(word);
+      const __m256i masks = _mm256_set1_epi64x(mask);
+      for (size_t i = 0; i < groupSize; i += 4) {
+        const __m256i shifts =
+            _mm256_setr_epi64x(i * width, (i + 1) * width, (i + 2) * width,
+                               (i + 3) * width);
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(decoded + i),
+            _mm256_and_si256(_mm256_srlv_epi64(packed, shifts), masks));
+      }
+      return groupSize;
+    }
+#endif
+    for (size_t i = 0; i < groupSize; ++i) {
+      decoded[i] = static_cast<Numeric>((word >> (i * width)) & mask);
+    }
+    return groupSize;
+  }
 };
 }  // namespace ad_utility
@@ -115,6 +115,15 @@ class Socket {
   //! State if the socket's file descriptor is valid.
   bool isOpen() const { return _fd != -1; }
 
+  //! The underlying file descriptor, e.g. for registering it with epoll.
+  int getFd() const { return _fd; }
+
+  //! Make all operations on this socket non-blocking (for event loops).
+  bool setNonBlocking() const {
+    int flags = fcntl(_fd, F_GETFL, 0);
+    return flags != -1 && fcntl(_fd, F_SETFL, flags | O_NONBLOCK) != -1;
+  }
+
   //! Send some string.
   int send(const std::string& data) const {
     LOG(TRACE) << "Called send() ... data: " << data << std::endl;
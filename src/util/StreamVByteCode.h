@@ -0,0 +1,143 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+#include <stdint.h>
+#include <array>
+#include <cstring>
+#include <limits>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+namespace ad_utility {
+
+//! StreamVByte compression scheme for 32 bit values.
+//! See: Lemire, Kurz & Rupp: "Stream VByte: Faster Byte-Oriented Integer
+//! Compression."
+//! Each value is stored with 1 to 4 bytes (little endian). The lengths are
+//! stored as 2 bit codes, four per control byte, and all control bytes of a
+//! list are stored before all data bytes. This allows decoding four values
+//! at once with a single byte shuffle (SSSE3), the scalar fallback is used
+//! otherwise.
+class StreamVByteCode {
+ public:
+  // ! The maximal number of bytes of the encoding of nofElements values.
+  static size_t maxEncodedBytes(size_t nofElements) {
+    return numControlBytes(nofElements) + 4 * nofElements;
+  }
+
+  // ! True iff all values are small enough for this code.
+  template <typename Numeric>
+  static bool canEncode(const Numeric* plaintext, size_t nofElements) {
+    for (size_t i = 0; i < nofElements; ++i) {
+      if (static_cast<uint64_t>(plaintext[i]) >
+          std::numeric_limits<uint32_t>::max()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // ! Encodes a list of numeric values which all have to fit into 32 bits
+  // ! (see canEncode). Returns the number of bytes in the encoded array.
+  // ! Requires encoded to be preallocated with maxEncodedBytes(nofElements).
+  template <typename Numeric>
+  static size_t encode(const Numeric* plaintext, size_t nofElements,
+                       unsigned char* encoded) {
+    unsigned char* control = encoded;
+    unsigned char* data = encoded + numControlBytes(nofElements);
+    std::memset(control, 0, numControlBytes(nofElements));
+    for (size_t i = 0; i < nofElements; ++i) {
+      uint32_t value = static_cast<uint32_t>(plaintext[i]);
+      unsigned char nofBytes = value < (1u << 8)
+                                   ? 1
+                                   : value < (1u << 16)
+                                         ? 2
+                                         : value < (1u << 24) ? 3 : 4;
+      control[i / 4] |= (nofBytes - 1) << (2 * (i % 4));
+      for (unsigned char b = 0; b < nofBytes; ++b) {
+        *data++ = static_cast<unsigned char>(value >> (8 * b));
+      }
+    }
+    return static_cast<size_t>(data - encoded);
+  }
+
+  // ! Decodes a list of nofElements values from the nofBytes bytes at
+  // ! encoded. Requires decoded to be preallocated with sufficient space,
+  // ! i.e. sizeof(Numeric) * (nofElements + 3), because the values are
+  // ! decoded in groups of four.
+  template <typename Numeric>
+  static void decode(const unsigned char* encoded, size_t nofBytes,
+                     size_t nofElements, Numeric* decoded) {
+    const unsigned char* control = encoded;
+    const unsigned char* data = encoded + numControlBytes(nofElements);
+    size_t i = 0;
+#if defined(__SSSE3__)
+    const unsigned char* end = encoded + nofBytes;
+    const auto& table = shuffleTable();
+    // A group of four values needs at most 16 bytes of data, but the load
+    // always reads 16 bytes, so the last groups are decoded by the scalar
+    // code below.
+    for (; i + 4 <= nofElements && data + 16 <= end; i += 4) {
+      unsigned char c = control[i / 4];
+      __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+      __m128i out = _mm_shuffle_epi8(
+          in, _mm_loadu_si128(
+                  reinterpret_cast<const __m128i*>(table._shuffle[c].data())));
+      if constexpr (sizeof(Numeric) == sizeof(uint32_t)) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(decoded + i), out);
+      } else {
+        alignas(16) uint32_t values[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(values), out);
+        for (size_t j = 0; j < 4; ++j) {
+          decoded[i + j] = static_cast<Numeric>(values[j]);
+        }
+      }
+      data += table._length[c];
+    }
+#else
+    (void)nofBytes;
+#endif
+    for (; i < nofElements; ++i) {
+      unsigned char nofValueBytes =
+          ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+      uint32_t value = 0;
+      for (unsigned char b = 0; b < nofValueBytes; ++b) {
+        value |= static_cast<uint32_t>(*data++) << (8 * b);
+      }
+      decoded[i] = static_cast<Numeric>(value);
+    }
+  }
+
+ private:
+  static size_t numControlBytes(size_t nofElements) {
+    return (nofElements + 3) / 4;
+  }
+
+  // For each control byte: the number of data bytes of the four values and
+  // the byte shuffle that moves them to four 32 bit lanes (0xFF yields 0).
+  struct ShuffleTable {
+    std::array<std::array<unsigned char, 16>, 256> _shuffle;
+    std::array<unsigned char, 256> _length;
+  };
+
+  static const ShuffleTable& shuffleTable() {
+    static const ShuffleTable table = []() {
+      ShuffleTable t;
+      for (size_t c = 0; c < 256; ++c) {
+        unsigned char pos = 0;
+        for (size_t j = 0; j < 4; ++j) {
+          size_t nofBytes = ((c >> (2 * j)) & 3) + 1;
+          for (size_t b = 0; b < 4; ++b) {
+            t._shuffle[c][4 * j + b] = b < nofBytes ? pos++ : 0xFF;
+          }
+        }
+        t._length[c] = pos;
+      }
+      return t;
+    }();
+    return table;
+  }
+};
+}  // namespace ad_utility
@@ -156,6 +156,14 @@ inline string decodeUrl(const string& orig);
 inline size_t findLiteralEnd(std::string_view input,
                              std::string_view literalEnd);
 
+/**
+ * @brief Return a literal prefix that every string which matches the regex
+ * <pattern> (searched for anywhere in the string) must start with. This is
+ * only possible for patterns that are anchored with a leading '^'. Returns the
+ * empty string if no such prefix was found.
+ */
+inline string getLiteralPrefixOfRegex(std::string_view pattern);
+
 // *****************************************************************************
 // Definitions:
 // *****************************************************************************
@@ -696,6 +704,70 @@ inline size_t findLiteralEnd(const std::string_view input,
   return endPos;
 }
 
+// _____________________________________________________________________________
+string getLiteralPrefixOfRegex(std::string_view pattern) {
+  if (pattern.empty() || pattern[0] != '^') {
+    return "";
+  }
+  // With an alternation on the top level (e.g. ^abc|def) the pattern is only
+  // anchored in the first alternative.
+  size_t depth = 0;
+  for (size_t i = 1; i < pattern.size(); ++i) {
+    char c = pattern[i];
+    if (c == '\\') {
+      ++i;
+    } else if (c == '[') {
+      // skip the character class, a ']' directly after '[' or '[^' is a
+      // literal.
+      ++i;
+      if (i < pattern.size() && pattern[i] == '^') {
+        ++i;
+      }
+      if (i < pattern.size() && pattern[i] == ']') {
+        ++i;
+      }
+      while (i < pattern.size() && pattern[i] != ']') {
+        i += pattern[i] == '\\' ? 2 : 1;
+      }
+    } else if (c == '(') {
+      ++depth;
+    } else if (c == ')' && depth > 0) {
+      --depth;
+    } else if (c == '|' && depth == 0) {
+      return "";
+    }
+  }
+
+  string prefix;
+  // the start of the last UTF-8 codepoint in prefix.
+  size_t lastCharStart = 0;
+  for (size_t i = 1; i < pattern.size(); ++i) {
+    char c = pattern[i];
+    if (c == '\\') {
+      // escaped letters and digits are character classes (\d, \w) or
+      // assertions (\b)
+      if (i + 1 == pattern.size() ||
+          std::isalnum(static_cast<unsigned char>(pattern[i + 1]))) {
+        break;
+      }
+      c = pattern[++i];
+    } else if (std::string_view("[]^$.|?*+(){").find(c) !=
+               std::string_view::npos) {
+      // these quantifiers allow the previous character to be missing
+      if (c == '?' || c == '*' || c == '{') {
+        prefix.resize(lastCharStart);
+      }
+      break;
+    }
+    // UTF-8 continuation bytes are 10xxxxxx
+    if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+      lastCharStart = prefix.size();
+    }
+    prefix.push_back(c);
+  }
+  return prefix;
+}
+
 }  // namespace ad_utility
 
 // these overloads are missing in the STL
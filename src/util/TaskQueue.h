@@ -0,0 +1,109 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ad_utility {
+
+/**
+ * @brief A fixed number of worker threads that execute tasks from a bounded
+ * queue. When the queue is full, new tasks are rejected instead of blocking
+ * the caller, so the caller (e.g. the event loop of the server) can react
+ * immediately.
+ *
+ * The destructor waits until all queued tasks have been executed.
+ */
+class TaskQueue {
+ public:
+  using Task = std::function<void()>;
+
+  /// Start numThreads worker threads. At most maxQueueSize tasks that are not
+  /// yet picked up by a worker can be queued at the same time.
+  TaskQueue(size_t numThreads, size_t maxQueueSize)
+      : _maxQueueSize(maxQueueSize) {
+    for (size_t i = 0; i < numThreads; ++i) {
+      _threads.emplace_back(&TaskQueue::runWorker, this);
+    }
+  }
+
+  TaskQueue(const TaskQueue&) = delete;
+  TaskQueue& operator=(const TaskQueue&) = delete;
+
+  ~TaskQueue() {
+    {
+      std::lock_guard lock(_mutex);
+      _shutdown = true;
+    }
+    _cond.notify_all();
+    for (auto& thread : _threads) {
+      thread.join();
+    }
+  }
+
+  /// Add a task to the queue. Returns false (and does not execute the task) if
+  /// the queue is already full.
+  bool push(Task task) {
+    {
+      std::lock_guard lock(_mutex);
+      if (_tasks.size() >= _maxQueueSize) {
+        return false;
+      }
+      _tasks.push(std::move(task));
+    }
+    _cond.notify_one();
+    return true;
+  }
+
+  /// The number of tasks that wait for a free worker.
+  size_t queueSize() const {
+    std::lock_guard lock(_mutex);
+    return _tasks.size();
+  }
+
+  /// The number of tasks that are currently executed.
+  size_t numActive() const {
+    std::lock_guard lock(_mutex);
+    return _numActive;
+  }
+
+  size_t maxQueueSize() const { return _maxQueueSize; }
+
+  size_t numThreads() const { return _threads.size(); }
+
+ private:
+  void runWorker() {
+    while (true) {
+      Task task;
+      {
+        std::unique_lock lock(_mutex);
+        _cond.wait(lock, [this] { return _shutdown || !_tasks.empty(); });
+        if (_tasks.empty()) {
+          // _shutdown is set and there is nothing left to do.
+          return;
+        }
+        task = std::move(_tasks.front());
+        _tasks.pop();
+        ++_numActive;
+      }
+      task();
+      std::lock_guard lock(_mutex);
+      --_numActive;
+    }
+  }
+
+  const size_t _maxQueueSize;
+  std::queue<Task> _tasks;
+  size_t _numActive = 0;
+  bool _shutdown = false;
+  mutable std::mutex _mutex;
+  std::condition_variable _cond;
+  std::vector<std::thread> _threads;
+};
+}  // namespace ad_utility
@@ -164,7 +164,10 @@ function processQuery(query) {
         // Time
         res += "<div id=\"time\">";
         var nofRows = result.res.length;
-        res += "Number of rows (without LIMIT): " + result.resultsize + "<br/><br/>";
+        // With a LIMIT, the server may stop computing the result early.
+        var resultSize = (result.resultsizeIsLowerBound ? "at least " : "")
+            + result.resultsize;
+        res += "Number of rows (without LIMIT): " + resultSize + "<br/><br/>";
         res += "Time elapsed:<br>";
         res += "Total: " + result.time.total + "<br/>";
         res += "&nbsp;- Computation: " + result.time.computeResult + "<br/>";
@@ -175,7 +178,7 @@ function processQuery(query) {
         res += "</div>";
         if (maxSend > 0 && maxSend <= nofRows && maxSend < parseInt(result.resultsize)) {
             res += "<div>Only transmitted " + maxSend.toString()
-                + " rows out of the " + result.resultsize
+                + " rows out of the " + resultSize
                 + " that were computed server-side. " +
                 "<a href=\"" + window.location.href.substr(0, window.location.href.indexOf("&")) + "\">[show all]</a>";
         }
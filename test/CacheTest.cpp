@@ -214,6 +214,99 @@ TEST(LRUCacheTest, testDecreasingCapacity) {
   ASSERT_FALSE(cache["3"]);
   ASSERT_FALSE(cache["4"]);
 }
+
+// _____________________________________________________________________________
+TEST(LRUCacheTest, testMaxSize) {
+  LRUCache<string, string> cache(100);
+  cache.setMaxSize(10);
+  cache.setMaxSizeSingleEntry(6);
+  cache.insert("1", "xxx");
+  cache.insert("2", "xxx");
+  cache.insert("3", "xxx");
+  ASSERT_EQ(9u, cache.cachedSize());
+  // too large for a single entry, is not stored.
+  cache.insert("7", "xxxxxxx");
+  ASSERT_FALSE(cache.contains("7"));
+  cache.insert("4", "xxxx");
+  ASSERT_FALSE(cache.contains("1"));
+  ASSERT_TRUE(cache.contains("4"));
+  ASSERT_EQ(10u, cache.cachedSize());
+  ASSERT_EQ(1u, cache.numEvictions());
+
+  // change the value after it was emplaced.
+  auto [emplaced, existing] = cache.tryEmplace("5");
+  ASSERT_TRUE(emplaced);
+  *emplaced = "xxxxx";
+  cache.recomputeSizeAndScore("5");
+  ASSERT_TRUE(cache.contains("5"));
+  ASSERT_FALSE(cache.contains("2"));
+  ASSERT_FALSE(cache.contains("3"));
+  ASSERT_EQ(9u, cache.cachedSize());
+  *emplaced = "xxxxxxxxx";
+  cache.recomputeSizeAndScore("5");
+  ASSERT_FALSE(cache.contains("5"));
+  ASSERT_EQ(4u, cache.cachedSize());
+
+  ASSERT_FALSE(cache.tryEmplace("4").first);
+  ASSERT_EQ(1u, cache.numHits());
+  ASSERT_EQ(1u, cache.numMisses());
+}
+
+// _____________________________________________________________________________
+TEST(GreedyDualSizeCacheTest, evictsCheapEntriesPerByte) {
+  // The cost of a value is its first character.
+  struct CostGetter {
+    double operator()(const string& s) const { return s[0] - '0'; }
+  };
+  GreedyDualSizeCache<string, string, CostGetter> cache(100);
+  cache.setMaxSize(10);
+  cache.insert("cheap", "1xxx");
+  cache.insert("expensive", "9xxx");
+  // cost per byte is 2/2 = 1 > 1/4
+  cache.insert("small", "2x");
+  ASSERT_EQ(10u, cache.cachedSize());
+  cache.insert("other", "8x");
+  ASSERT_FALSE(cache.contains("cheap"));
+  ASSERT_TRUE(cache.contains("expensive"));
+  ASSERT_TRUE(cache.contains("small"));
+  ASSERT_TRUE(cache.contains("other"));
+
+  // Unlike LRU, a new entry is evicted first if it is the cheapest per byte
+  // (1/4 + 1/3 < 2/2).
+  cache.insert("new", "1xx");
+  ASSERT_FALSE(cache.contains("new"));
+  ASSERT_TRUE(cache.contains("small"));
+  ASSERT_EQ(2u, cache.numEvictions());
+}
+
+// _____________________________________________________________________________
+TEST(GreedyDualSizeCacheTest, accessDoesNotReadTheValue) {
+  // Counts how often the size of a value is computed.
+  static size_t nofSizeCalls = 0;
+  struct SizeGetter {
+    size_t operator()(const string& s) const {
+      ++nofSizeCalls;
+      return s.size();
+    }
+  };
+  struct CostGetter {
+    double operator()(const string&) const { return 1.0; }
+  };
+  GreedyDualSizeCache<string, string, CostGetter, SizeGetter> cache(100);
+  auto [emplaced, existing] = cache.tryEmplace("a");
+  ASSERT_TRUE(emplaced);
+  size_t nofCallsAfterEmplace = nofSizeCalls;
+  // The value is written (e.g. by the thread that computes a query result)
+  // while other threads access the entry, this must only use the size that
+  // is stored in the cache.
+  *emplaced = "xxxx";
+  ASSERT_TRUE(cache["a"]);
+  ASSERT_FALSE(cache.tryEmplace("a").first);
+  ASSERT_EQ(0u, cache.cachedSize());
+  ASSERT_EQ(nofCallsAfterEmplace, nofSizeCalls);
+  cache.recomputeSizeAndScore("a");
+  ASSERT_EQ(4u, cache.cachedSize());
+}
 }  // namespace ad_utility
 
 int main(int argc, char** argv) {
@@ -0,0 +1,54 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "../src/util/CancellationHandle.h"
+
+using ad_utility::CancellationException;
+using ad_utility::CancellationHandle;
+using ad_utility::checkCancellation;
+
+TEST(CancellationHandleTest, cancel) {
+  CancellationHandle handle;
+  ASSERT_FALSE(handle.isCancelled());
+  ASSERT_NO_THROW(handle.throwIfCancelled());
+  handle.cancel();
+  ASSERT_TRUE(handle.isCancelled());
+  ASSERT_THROW(handle.throwIfCancelled(), CancellationException);
+}
+
+TEST(CancellationHandleTest, timeout) {
+  CancellationHandle handle(std::chrono::milliseconds(20));
+  ASSERT_FALSE(handle.isCancelled());
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  ASSERT_TRUE(handle.isCancelled());
+  try {
+    handle.throwIfCancelled();
+    FAIL() << "Expected a CancellationException";
+  } catch (const CancellationException& e) {
+    ASSERT_NE(std::string::npos, std::string(e.what()).find("timed out"));
+  }
+}
+
+TEST(CancellationHandleTest, checkCancellationOfCurrentThread) {
+  // Without a handle, nothing is checked.
+  ASSERT_NO_THROW(checkCancellation());
+  auto handle = std::make_shared<CancellationHandle>();
+  {
+    CancellationHandle::Scope scope(handle);
+    ASSERT_EQ(handle, CancellationHandle::current());
+    ASSERT_NO_THROW(checkCancellation());
+    handle->cancel();
+    ASSERT_THROW(checkCancellation(), CancellationException);
+    // Only every CANCELLATION_CHECK_INTERVAL iterations are checked.
+    ASSERT_NO_THROW(checkCancellation(1));
+    ASSERT_THROW(checkCancellation(CANCELLATION_CHECK_INTERVAL),
+                 CancellationException);
+    // Other threads have their own handle.
+    std::thread([]() { ASSERT_NO_THROW(checkCancellation()); }).join();
+  }
+  ASSERT_EQ(nullptr, CancellationHandle::current());
+  ASSERT_NO_THROW(checkCancellation());
+}
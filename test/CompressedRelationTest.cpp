@@ -0,0 +1,151 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include "../src/index/CompressedRelation.h"
+#include "../src/index/IndexMetaData.h"
+
+namespace {
+// Encode and decode column with codec and check that we get the input back.
+void testRoundTrip(const vector<Id>& column, ColumnCodec codec) {
+  vector<unsigned char> encoded;
+  CompressedRelation::encodeColumn(column, codec, &encoded);
+  vector<Id> decoded(column.size());
+  const unsigned char* end = CompressedRelation::decodeColumn(
+      encoded.data(), codec, column.size(), decoded.data(), 1);
+  ASSERT_EQ(encoded.data() + encoded.size(), end);
+  ASSERT_EQ(column, decoded);
+}
+
+// Write data as a compressed relation, read it back and compare.
+void testWriteAndRead(const vector<array<Id, 2>>& data) {
+  string filename = "_compressedRelationTest.dat";
+  vector<BlockMetaData> blocks;
+  off_t offsetAfter;
+  {
+    ad_utility::File out(filename, "w");
+    // write some garbage first to test the handling of offsets
+    Id dummy = 42;
+    out.write(&dummy, sizeof(dummy));
+    offsetAfter =
+        CompressedRelation::writePairs(out, sizeof(dummy), data, &blocks);
+    ASSERT_EQ(offsetAfter, out.tell());
+  }
+  ad_utility::File in(filename, "r");
+  ASSERT_EQ(offsetAfter, in.sizeOfFile());
+  vector<array<Id, 2>> result(data.size());
+  CompressedRelation::readPairs(in, sizeof(Id), data.size(),
+                                result.data()->data());
+  ASSERT_EQ(data, result);
+
+  // Read it again block by block.
+  FullRelationMetaData rmd(0, sizeof(Id), data.size(), 1.0, 1.0, false,
+                           false);
+  CompressedRelation::PairReader reader(in, rmd, V_COMPRESSED_RELATIONS);
+  vector<array<Id, 2>> blockwise;
+  vector<array<Id, 2>> block(NOF_PAIRS_PER_COMPRESSED_BLOCK);
+  while (size_t nofPairs = reader.readNextBlock(block.data()->data())) {
+    blockwise.insert(blockwise.end(), block.begin(), block.begin() + nofPairs);
+  }
+  ASSERT_EQ(data, blockwise);
+
+  // Read only the pairs of some of the keys and a key that does not exist.
+  vector<Id> keys;
+  for (size_t i = 0; i < data.size(); i += 5) {
+    if (keys.empty() || keys.back() < data[i][0]) {
+      keys.push_back(data[i][0]);
+    }
+  }
+  keys.push_back(data.back()[0] + 1);
+  vector<array<Id, 2>> expected;
+  for (const auto& pair : data) {
+    if (std::binary_search(keys.begin(), keys.end(), pair[0])) {
+      expected.push_back(pair);
+    }
+  }
+  CompressedRelation::PairReader keyReader(in, rmd, V_COMPRESSED_RELATIONS);
+  vector<array<Id, 2>> withKeys;
+  ASSERT_EQ(0u,
+            CompressedRelation::readPairsWithKeys(&keyReader, keys, &withKeys));
+  ASSERT_EQ(expected, withKeys);
+
+  // Only the blocks that contain the last key are read.
+  Id lastKey = data.back()[0];
+  size_t nofBlocksWithLastKey = 0;
+  for (size_t i = 0; i < data.size(); i += NOF_PAIRS_PER_COMPRESSED_BLOCK) {
+    size_t end = std::min(data.size(), i + NOF_PAIRS_PER_COMPRESSED_BLOCK);
+    nofBlocksWithLastKey += data[end - 1][0] == lastKey;
+  }
+  CompressedRelation::PairReader lastKeyReader(in, rmd,
+                                               V_COMPRESSED_RELATIONS);
+  withKeys.clear();
+  ASSERT_EQ(blocks.size() - nofBlocksWithLastKey,
+            CompressedRelation::readPairsWithKeys(&lastKeyReader, {lastKey},
+                                                  &withKeys));
+  expected.clear();
+  std::copy_if(data.begin(), data.end(), std::back_inserter(expected),
+               [lastKey](const auto& pair) { return pair[0] == lastKey; });
+  ASSERT_EQ(expected, withKeys);
+
+  ASSERT_EQ((data.size() + NOF_PAIRS_PER_COMPRESSED_BLOCK - 1) /
+                NOF_PAIRS_PER_COMPRESSED_BLOCK,
+            blocks.size());
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    size_t start = i * NOF_PAIRS_PER_COMPRESSED_BLOCK;
+    ASSERT_EQ(data[start][0], blocks[i]._firstLhs);
+    off_t end = i + 1 < blocks.size() ? blocks[i + 1]._startOffset
+                                      : offsetAfter;
+    vector<unsigned char> buf(end - blocks[i]._startOffset);
+    in.read(buf.data(), buf.size(), blocks[i]._startOffset);
+    auto block = CompressedRelation::decompressBlock(buf.data());
+    ASSERT_EQ(std::min(data.size() - start, NOF_PAIRS_PER_COMPRESSED_BLOCK),
+              block.size());
+    ASSERT_EQ(data[start], block[0]);
+    ASSERT_EQ(data[start + block.size() - 1], block.back());
+  }
+  in.close();
+  remove(filename.c_str());
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(CompressedRelationTest, codecs) {
+  vector<Id> sorted{0, 0, 3, 17, 17, 18, 1000000, 1ul << 40};
+  vector<Id> unsorted{12, 5, 5, 7, 12, 5, 1ul << 62, 0};
+  vector<Id> constant{7, 7, 7, 7};
+  vector<Id> extreme{0, std::numeric_limits<Id>::max(), 3};
+
+  testRoundTrip(sorted, ColumnCodec::DeltaVarint);
+  for (const auto& column : {sorted, unsorted, constant, extreme}) {
+    testRoundTrip(column, ColumnCodec::FrameOfReference);
+    testRoundTrip(column, ColumnCodec::Dictionary);
+  }
+
+  // A constant column needs no bits per value.
+  vector<unsigned char> encoded;
+  CompressedRelation::encodeColumn(vector<Id>(1000, 5),
+                                   ColumnCodec::FrameOfReference, &encoded);
+  ASSERT_EQ(sizeof(Id) + 1, encoded.size());
+}
+
+// _____________________________________________________________________________
+TEST(CompressedRelationTest, writeAndReadPairs) {
+  testWriteAndRead({{3, 5}});
+  testWriteAndRead({{1, 5}, {1, 6}, {2, 5}, {17, 0}});
+
+  // Several blocks with a skewed second column and large Ids.
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<Id> dist(0, 20);
+  vector<array<Id, 2>> data;
+  Id lhs = 1ul << 50;
+  for (size_t i = 0; i < 3 * NOF_PAIRS_PER_COMPRESSED_BLOCK + 17; ++i) {
+    lhs += dist(gen) / 10;
+    data.push_back({lhs, dist(gen) == 0 ? std::numeric_limits<Id>::max()
+                                        : 1000 + dist(gen)});
+  }
+  testWriteAndRead(data);
+}
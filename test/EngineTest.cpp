@@ -106,6 +106,36 @@ TEST(EngineTest, joinTest) {
   ASSERT_EQ(2u, res(1, 1));
 };
 
+TEST(EngineTest, lazyJoinTest) {
+  // The left side is split into several blocks, some join ids are split
+  // between two blocks.
+  auto left = std::make_shared<ResultTable>();
+  left->_data.setCols(2);
+  for (size_t i = 0; i < 3 * LAZY_RESULT_BLOCK_SIZE + 17; ++i) {
+    left->_data.push_back({i / 7, i});
+  }
+  IdTable right(3);
+  for (size_t i = 0; i < LAZY_RESULT_BLOCK_SIZE; ++i) {
+    right.push_back({2 * i, i, 3 * i});
+    right.push_back({2 * i, i + 1, 3 * i});
+  }
+  IdTable expected(4);
+  Join::join<2, 3, 4>(left->_data, 0, right, 0, &expected);
+
+  std::unique_ptr<LazyResult> lazyLeft = LazyResult::fromResultTable(left);
+  IdTable block(2);
+  IdTable res(4);
+  size_t nofBlocks = 0;
+  while (lazyLeft->nextBlock(&block)) {
+    ASSERT_LE(block.size(), LAZY_RESULT_BLOCK_SIZE);
+    Join::joinBlock<2, 3, 4>(block, 0, right, 0, &res);
+    nofBlocks++;
+  }
+  ASSERT_EQ(4u, nofBlocks);
+  ASSERT_FALSE(lazyLeft->nextBlock(&block));
+  ASSERT_EQ(expected, res);
+}
+
 TEST(EngineTest, optionalJoinTest) {
   IdTable a(3);
   a.push_back({4, 1, 2});
@@ -0,0 +1,111 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "../src/engine/CallFixedSize.h"
+#include "../src/engine/ExternalSort.h"
+#include "../src/util/MemoryTracker.h"
+
+namespace {
+// A table with nofRows random rows, the first column has many duplicates.
+IdTable createRandomTable(size_t nofRows, size_t nofCols) {
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<Id> dist(0, 1000);
+  IdTable table(nofCols);
+  table.resize(nofRows);
+  for (size_t i = 0; i < nofRows; ++i) {
+    for (size_t j = 0; j < nofCols; ++j) {
+      table(i, j) = j == 0 ? dist(gen) % 10 : dist(gen);
+    }
+  }
+  return table;
+}
+
+auto lexicographic = [](const auto& a, const auto& b) {
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i] != b[i]) {
+      return a[i] < b[i];
+    }
+  }
+  return false;
+};
+
+void checkEqual(const IdTable& expected, const IdTable& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  ASSERT_EQ(expected.cols(), actual.cols());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    for (size_t j = 0; j < expected.cols(); ++j) {
+      ASSERT_EQ(expected(i, j), actual(i, j)) << i << ", " << j;
+    }
+  }
+}
+}  // namespace
+
+TEST(ExternalSortTest, sortsLikeInMemory) {
+  for (size_t cols : {1, 2, 3, 7}) {
+    IdTable input = createRandomTable(10000, cols);
+    IdTable expected(cols);
+    expected.insert(expected.end(), input.begin(), input.end());
+    int width = cols;
+    CALL_FIXED_SIZE_1(width, Engine::sort, &expected, lexicographic);
+    // In memory, with a few runs, and with one row per run.
+    for (size_t memoryLimit :
+         {size_t(1) << 30, 1000 * cols * sizeof(Id), cols * sizeof(Id)}) {
+      IdTable result(cols);
+      CALL_FIXED_SIZE_1(width, ad_utility::externalSort, input, &result,
+                        lexicographic, memoryLimit, "_externalSortTest");
+      checkEqual(expected, result);
+    }
+  }
+}
+
+TEST(ExternalSortTest, emptyInput) {
+  IdTable input(2);
+  IdTable result(2);
+  ad_utility::externalSort<2>(input, &result, lexicographic, 0,
+                              "_externalSortTest");
+  ASSERT_EQ(0u, result.size());
+  ASSERT_EQ(2u, result.cols());
+}
+
+TEST(ExternalSortTest, lazyInputLargerThanMemoryLimit) {
+  const size_t cols = 3;
+  const size_t nofRows = 1000 * 1000;
+  const size_t bytes = nofRows * cols * sizeof(Id);
+  const size_t sortMemoryLimit = bytes / 20;
+  IdTable expected = createRandomTable(nofRows, cols);
+  Engine::sort<cols>(&expected, lexicographic);
+
+  // The memory of the query only suffices for the result, the memory of the
+  // sort and a few blocks, but not for the input and the result at the same
+  // time. The input is computed block by block (the same rows as
+  // createRandomTable).
+  const size_t memoryLimit = bytes + 2 * sortMemoryLimit +
+                             4 * LAZY_RESULT_BLOCK_SIZE * cols * sizeof(Id);
+  ASSERT_LT(memoryLimit, 2 * bytes);
+  auto tracker = std::make_shared<ad_utility::MemoryTracker>(memoryLimit);
+  ad_utility::MemoryTracker::Scope scope(tracker);
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<Id> dist(0, 1000);
+  size_t nextRow = 0;
+  auto generator = [&gen, &dist, &nextRow, nofRows](IdTable* block) {
+    if (nextRow >= nofRows) {
+      return false;
+    }
+    size_t endRow = std::min(nofRows, nextRow + LAZY_RESULT_BLOCK_SIZE);
+    for (; nextRow < endRow; ++nextRow) {
+      block->push_back({dist(gen) % 10, dist(gen), dist(gen)});
+    }
+    return true;
+  };
+  auto input = std::make_unique<LazyResult>(
+      cols, vector<size_t>{}, vector<ResultTable::ResultType>{}, nullptr,
+      generator);
+  IdTable result(cols);
+  ad_utility::externalSort<cols>(std::move(input), &result, lexicographic,
+                                 sortMemoryLimit, "_externalSortTest");
+  checkEqual(expected, result);
+  ASSERT_LE(tracker->peakBytes(), memoryLimit);
+}
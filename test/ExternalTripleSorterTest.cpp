@@ -0,0 +1,98 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "../src/index/ExternalTripleSorter.h"
+#include "../src/index/StxxlSortFunctors.h"
+
+using Triple = array<Id, 3>;
+
+namespace {
+// Random triples with many duplicates.
+vector<Triple> createRandomTriples(size_t nofTriples) {
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<Id> dist(0, 20);
+  vector<Triple> triples(nofTriples);
+  for (auto& triple : triples) {
+    triple = {dist(gen), dist(gen), dist(gen)};
+  }
+  return triples;
+}
+
+// The interface of stxxl::vector::bufreader_type.
+struct VectorReader {
+  const vector<Triple>& _triples;
+  size_t _pos = 0;
+  bool empty() const { return _pos == _triples.size(); }
+  const Triple& operator*() const { return _triples[_pos]; }
+  VectorReader& operator++() {
+    ++_pos;
+    return *this;
+  }
+};
+
+// The interface of stxxl::vector::bufwriter_type.
+struct VectorWriter {
+  vector<Triple> _triples;
+  VectorWriter& operator<<(const Triple& triple) {
+    _triples.push_back(triple);
+    return *this;
+  }
+};
+
+template <typename Comparator>
+vector<Triple> sortUnique(vector<Triple> triples, Comparator comp) {
+  std::sort(triples.begin(), triples.end(), comp);
+  triples.erase(std::unique(triples.begin(), triples.end()), triples.end());
+  return triples;
+}
+}  // namespace
+
+TEST(ExternalTripleSorterTest, allOrdersInOnePass) {
+  auto triples = createRandomTriples(10000);
+  // much less memory than the triples need, such that there are many runs.
+  for (size_t memory : {size_t(1000), 3000 * sizeof(Triple), size_t(1) << 30}) {
+    ExternalTripleSorter sorter("_testExternalTripleSorter", memory, 4,
+                                SortByPSO(), SortBySPO(), SortByOSP());
+    VectorReader reader{triples};
+    sorter.createRuns(&reader);
+
+    VectorWriter pso;
+    VectorWriter spo;
+    VectorWriter osp;
+    size_t numTriples = sorter.merge<0>(&pso);
+    ASSERT_EQ(numTriples, pso._triples.size());
+    sorter.merge<1>(&spo);
+    sorter.merge<2>(&osp);
+    ASSERT_EQ(sortUnique(triples, SortByPSO()), pso._triples);
+    ASSERT_EQ(sortUnique(triples, SortBySPO()), spo._triples);
+    ASSERT_EQ(sortUnique(triples, SortByOSP()), osp._triples);
+  }
+}
+
+TEST(ExternalTripleSorterTest, parallelSort) {
+  auto triples = createRandomTriples(500000);
+  auto expected = triples;
+  std::sort(expected.begin(), expected.end(), SortByOPS());
+  for (size_t numThreads : {1, 3, 8}) {
+    auto result = triples;
+    ExternalTripleSorter<SortByOPS>::parallelSort(&result, SortByOPS(),
+                                                  numThreads);
+    ASSERT_TRUE(std::is_sorted(result.begin(), result.end(), SortByOPS()));
+    ASSERT_TRUE(std::is_permutation(result.begin(), result.end(),
+                                    expected.begin()));
+  }
+}
+
+TEST(ExternalTripleSorterTest, emptyInput) {
+  vector<Triple> triples;
+  ExternalTripleSorter sorter("_testExternalTripleSorterEmpty", 1000, 2,
+                              SortByPSO());
+  VectorReader reader{triples};
+  sorter.createRuns(&reader);
+  VectorWriter writer;
+  ASSERT_EQ(sorter.merge<0>(&writer), 0u);
+  ASSERT_TRUE(writer._triples.empty());
+}
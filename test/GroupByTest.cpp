@@ -3,7 +3,11 @@
 // Author: Florian Kramer (florian.kramer@mail.uni-freiburg.de)
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <random>
 #include "../src/engine/CallFixedSize.h"
 #include "../src/engine/GroupBy.h"
 
@@ -300,3 +304,150 @@ TEST_F(GroupByTest, doGroupBy) {
   std::memcpy(&buffer, &outTable._data[2][23], sizeof(float));
   ASSERT_FLOAT_EQ(616.5, buffer);
 }
+
+namespace {
+// Checks that the result of doHashGroupBy (in any order) has the same rows as
+// the result of doGroupBy, which is sorted by the group columns (the first
+// columns of the result). Float sums may differ slightly because they are
+// computed in a different order.
+void assertSameGroups(const IdTable& expected, IdTable actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  ASSERT_EQ(expected.cols(), actual.cols());
+  size_t cols = actual.cols();
+  std::sort(actual.begin(), actual.end(),
+            [cols](const auto& a, const auto& b) {
+              for (size_t col = 0; col < cols; ++col) {
+                if (a[col] != b[col]) {
+                  return a[col] < b[col];
+                }
+              }
+              return false;
+            });
+  for (size_t row = 0; row < expected.size(); ++row) {
+    for (size_t col = 0; col < expected.cols(); ++col) {
+      if (expected(row, col) == actual(row, col)) {
+        continue;
+      }
+      float expectedFloat;
+      float actualFloat;
+      std::memcpy(&expectedFloat, &expected(row, col), sizeof(float));
+      std::memcpy(&actualFloat, &actual(row, col), sizeof(float));
+      if (std::isnan(expectedFloat)) {
+        ASSERT_TRUE(std::isnan(actualFloat)) << row << ", " << col;
+      } else {
+        ASSERT_FLOAT_EQ(expectedFloat, actualFloat) << row << ", " << col;
+      }
+    }
+  }
+}
+}  // namespace
+
+TEST_F(GroupByTest, doHashGroupBy) {
+  Id floatBuffers[3];
+  float floatValues[3] = {-3, 2, 1231};
+  for (int i = 0; i < 3; i++) {
+    std::memcpy(&floatBuffers[i], &floatValues[i], sizeof(float));
+  }
+  auto& vocab = const_cast<RdfsVocabulary&>(_index.getVocab());
+  vocab.push_back("<entity1>");
+  vocab.push_back("<entity2>");
+  vocab.push_back("<entity3>");
+  vocab.push_back(ad_utility::convertFloatStringToIndexWord("1.1231"));
+  vocab.push_back(ad_utility::convertFloatStringToIndexWord("-5"));
+  vocab.push_back(ad_utility::convertFloatStringToIndexWord("17"));
+
+  // The same rows as in the doGroupBy test, but not sorted.
+  IdTable inputData(5);
+  //                   KB, KB, VERBATIM, TEXT, FLOAT
+  inputData.push_back({3, 9, 41223, 2, floatBuffers[2]});
+  inputData.push_back({2, 7, 123, 0, floatBuffers[0]});
+  inputData.push_back({1, 4, 123, 0, floatBuffers[0]});
+  inputData.push_back({2, 6, 41223, 2, floatBuffers[2]});
+  inputData.push_back({3, 8, 0, 1, floatBuffers[1]});
+  inputData.push_back({1, 5, 0, 1, floatBuffers[1]});
+  inputData.push_back({2, 7, 123, 0, floatBuffers[0]});
+  std::vector<ResultTable::ResultType> inputTypes = {
+      ResultTable::ResultType::KB, ResultTable::ResultType::KB,
+      ResultTable::ResultType::VERBATIM, ResultTable::ResultType::TEXT,
+      ResultTable::ResultType::FLOAT};
+
+  std::vector<size_t> groupByCols = {0};
+  std::vector<GroupBy::Aggregate> aggregates = {
+      // type                                in out userdata
+      {ParsedQuery::AggregateType::SAMPLE, 0, 0, nullptr},
+      {ParsedQuery::AggregateType::COUNT, 1, 1, nullptr}};
+  size_t outCol = 2;
+  for (auto type :
+       {ParsedQuery::AggregateType::MIN, ParsedQuery::AggregateType::MAX,
+        ParsedQuery::AggregateType::SUM, ParsedQuery::AggregateType::AVG}) {
+    for (size_t inCol = 1; inCol < 5; ++inCol) {
+      aggregates.push_back({type, inCol, outCol++, nullptr});
+    }
+  }
+
+  IdTable sortedInput = inputData;
+  std::sort(sortedInput.begin(), sortedInput.end(),
+            [](const auto& a, const auto& b) { return a[0] < b[0]; });
+  ResultTable inTable;
+  ResultTable outTable;
+  outTable._data.setCols(outCol);
+  int inWidth = inputData.cols();
+  int outWidth = outCol;
+  CALL_FIXED_SIZE_2(inWidth, outWidth, doGroupBy, sortedInput, inputTypes,
+                    groupByCols, aggregates, &outTable._data, &inTable,
+                    &outTable, this->_index);
+  ASSERT_EQ(3u, outTable._data.size());
+
+  for (size_t nofThreads : {1, 2, 3}) {
+    IdTable result(outCol);
+    CALL_FIXED_SIZE_2(inWidth, outWidth, doHashGroupBy, inputData, inputTypes,
+                      groupByCols, aggregates, &result, this->_index,
+                      nofThreads);
+    assertSameGroups(outTable._data, result);
+  }
+}
+
+TEST_F(GroupByTest, doHashGroupByTwoColumns) {
+  // Group 10000 random rows by the first two columns (with 5 * 7 groups) on
+  // several threads.
+  std::mt19937_64 gen(42);
+  IdTable inputData(3);
+  inputData.resize(10000);
+  for (size_t i = 0; i < inputData.size(); ++i) {
+    inputData(i, 0) = gen() % 5;
+    inputData(i, 1) = gen() % 7;
+    inputData(i, 2) = gen() % 100;
+  }
+  std::vector<ResultTable::ResultType> inputTypes(
+      3, ResultTable::ResultType::VERBATIM);
+  std::vector<size_t> groupByCols = {0, 1};
+  std::vector<GroupBy::Aggregate> aggregates = {
+      // type                                in out userdata
+      {ParsedQuery::AggregateType::SAMPLE, 0, 0, nullptr},
+      {ParsedQuery::AggregateType::SAMPLE, 1, 1, nullptr},
+      {ParsedQuery::AggregateType::COUNT, 2, 2, nullptr},
+      {ParsedQuery::AggregateType::SUM, 2, 3, nullptr},
+      {ParsedQuery::AggregateType::MIN, 2, 4, nullptr},
+      {ParsedQuery::AggregateType::MAX, 2, 5, nullptr},
+      {ParsedQuery::AggregateType::AVG, 2, 6, nullptr}};
+
+  IdTable sortedInput = inputData;
+  std::sort(sortedInput.begin(), sortedInput.end(),
+            [](const auto& a, const auto& b) {
+              return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]);
+            });
+  ResultTable inTable;
+  ResultTable outTable;
+  outTable._data.setCols(7);
+  CALL_FIXED_SIZE_2(3, 7, doGroupBy, sortedInput, inputTypes, groupByCols,
+                    aggregates, &outTable._data, &inTable, &outTable,
+                    this->_index);
+  ASSERT_EQ(35u, outTable._data.size());
+
+  for (size_t nofThreads : {1, 4}) {
+    IdTable result(7);
+    CALL_FIXED_SIZE_2(3, 7, doHashGroupBy, inputData, inputTypes, groupByCols,
+                      aggregates, &result, this->_index, nofThreads);
+    assertSameGroups(outTable._data, result);
+  }
+}
@@ -386,3 +386,58 @@ TEST(CountAvailablePredicates, patternTrickTest) {
   ASSERT_EQ(4u, result[4][0]);
   ASSERT_EQ(3u, result[4][1]);
 }
+
+TEST(CountAvailablePredicates, patternTrickParallel) {
+  // Every entity occurs three times, such that the parts of the threads start
+  // within the rows of an entity.
+  IdTable input(1);
+  for (Id i = 0; i < 20; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      input.push_back({i});
+    }
+  }
+  vector<PatternID> hasPattern = {0, NO_PATTERN, NO_PATTERN, 1, 0,
+                                  1, 1,          NO_PATTERN, 0, 1};
+  vector<vector<Id>> hasRelationSrc = {{},  {0, 3}, {0}, {}, {}, {}, {},
+                                       {2}, {},     {},  {}, {4}};
+  vector<vector<Id>> patternsSrc = {{0, 2, 3}, {1, 3, 4, 2, 0}};
+  CompactStringVector<Id, Id> hasRelation(hasRelationSrc);
+  CompactStringVector<size_t, Id> patterns(patternsSrc);
+
+  auto sorted = [](IdTable table) {
+    std::sort(table.begin(), table.end(),
+              [](const auto& a, const auto& b) { return a[0] < b[0]; });
+    return table;
+  };
+  RuntimeInformation runtimeInfo;
+  IdTable expected(2);
+  CountAvailablePredicates::computePatternTrick<1>(
+      input, &expected, hasPattern, hasRelation, patterns, 0, &runtimeInfo,
+      1, 1);
+  expected = sorted(std::move(expected));
+  ASSERT_EQ(5u, expected.size());
+  ASSERT_EQ(0u, expected(0, 0));
+  ASSERT_EQ(9u, expected(0, 1));
+  ASSERT_EQ(2u, expected(2, 0));
+  ASSERT_EQ(8u, expected(2, 1));
+  ASSERT_EQ(4u, expected(4, 0));
+  ASSERT_EQ(5u, expected(4, 1));
+
+  IdTable expectedAll(2);
+  CountAvailablePredicates::computePatternTrickAllEntities(
+      &expectedAll, hasPattern, hasRelation, patterns, 1, 1);
+  expectedAll = sorted(std::move(expectedAll));
+
+  for (size_t nofThreads : {2, 3, 4, 7}) {
+    IdTable result(2);
+    CountAvailablePredicates::computePatternTrick<1>(
+        input, &result, hasPattern, hasRelation, patterns, 0, &runtimeInfo,
+        nofThreads, 1);
+    ASSERT_EQ(expected, sorted(std::move(result)));
+
+    IdTable resultAll(2);
+    CountAvailablePredicates::computePatternTrickAllEntities(
+        &resultAll, hasPattern, hasRelation, patterns, nofThreads, 1);
+    ASSERT_EQ(expectedAll, sorted(std::move(resultAll)));
+  }
+}
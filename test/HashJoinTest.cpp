@@ -0,0 +1,98 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "../src/engine/CallFixedSize.h"
+#include "../src/engine/Engine.h"
+#include "../src/engine/HashJoin.h"
+#include "../src/engine/Join.h"
+
+namespace {
+// The rows of a table in lexicographical order.
+vector<vector<Id>> sortedRows(const IdTable& table) {
+  vector<vector<Id>> rows;
+  for (size_t i = 0; i < table.size(); ++i) {
+    rows.emplace_back(table.data() + i * table.cols(),
+                      table.data() + (i + 1) * table.cols());
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+IdTable createRandomTable(size_t nofRows, size_t nofCols, Id maxId) {
+  static std::mt19937_64 gen(42);
+  std::uniform_int_distribution<Id> dist(0, maxId);
+  IdTable table(nofCols);
+  table.resize(nofRows);
+  for (size_t i = 0; i < nofRows; ++i) {
+    for (size_t j = 0; j < nofCols; ++j) {
+      table(i, j) = dist(gen);
+    }
+  }
+  return table;
+}
+}  // namespace
+
+TEST(HashJoinTest, joinTest) {
+  IdTable a(2);
+  a.push_back({4, 1});
+  a.push_back({1, 1});
+  a.push_back({2, 1});
+  a.push_back({1, 3});
+  a.push_back({2, 2});
+  IdTable b(2);
+  b.push_back({1, 8});
+  b.push_back({4, 2});
+  b.push_back({3, 1});
+  b.push_back({1, 3});
+  IdTable res(3);
+  CALL_FIXED_SIZE_3(2, 2, 3, HashJoin::join, a, 0, b, 0, &res);
+
+  vector<vector<Id>> expected{
+      {1, 1, 3}, {1, 1, 8}, {1, 3, 3}, {1, 3, 8}, {4, 1, 2}};
+  ASSERT_EQ(expected, sortedRows(res));
+}
+
+TEST(HashJoinTest, sameResultAsMergeJoin) {
+  // Tables of different widths, join columns and sizes (the smaller one is
+  // used for the hash table), with and without partitioning.
+  for (size_t aCols : {1, 3}) {
+    for (size_t bCols : {2, 4}) {
+      for (size_t aSize : {100, 5000}) {
+        IdTable a = createRandomTable(aSize, aCols, 1000);
+        IdTable b = createRandomTable(2000, bCols, 1000);
+        size_t jc1 = aCols - 1;
+        size_t jc2 = 1;
+        int resCols = aCols + bCols - 1;
+
+        IdTable sortedA = a;
+        IdTable sortedB = b;
+        CALL_FIXED_SIZE_1(aCols, Engine::sort, &sortedA, jc1);
+        CALL_FIXED_SIZE_1(bCols, Engine::sort, &sortedB, jc2);
+        IdTable expected(resCols);
+        CALL_FIXED_SIZE_3(aCols, bCols, resCols, Join::join, sortedA, jc1,
+                          sortedB, jc2, &expected);
+        ASSERT_GT(expected.size(), 0u);
+
+        for (size_t nofPartitions : {0, 1, 3, 64}) {
+          IdTable res(resCols);
+          CALL_FIXED_SIZE_3(aCols, bCols, resCols, HashJoin::join, a, jc1, b,
+                            jc2, &res, nofPartitions);
+          ASSERT_EQ(sortedRows(expected), sortedRows(res));
+        }
+      }
+    }
+  }
+}
+
+TEST(HashJoinTest, emptyInput) {
+  IdTable a(2);
+  IdTable b = createRandomTable(10, 2, 10);
+  IdTable res(3);
+  HashJoin::join<2, 2, 3>(a, 0, b, 0, &res);
+  ASSERT_EQ(0u, res.size());
+  HashJoin::join<2, 2, 3>(b, 0, a, 0, &res);
+  ASSERT_EQ(0u, res.size());
+}
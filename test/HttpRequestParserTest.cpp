@@ -0,0 +1,112 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include "../src/util/HttpRequestParser.h"
+
+using ad_utility::HttpRequest;
+using ad_utility::HttpRequestParser;
+using Status = HttpRequestParser::Status;
+
+TEST(HttpRequestParserTest, pipelinedRequests) {
+  HttpRequestParser parser;
+  string data =
+      "GET /?query=a HTTP/1.1\r\nHost: localhost\r\n\r\n"
+      "GET /?cmd=stats HTTP/1.1\r\nConnection: Close\r\n\r\n"
+      "GET /?query=b HTTP/1.1\r\n";
+  parser.append(data.data(), data.size());
+  HttpRequest request;
+  ASSERT_EQ(Status::COMPLETE, parser.next(&request));
+  ASSERT_EQ("GET /?query=a HTTP/1.1", request._requestLine);
+  ASSERT_EQ("Host: localhost\r\n", request._headers);
+  ASSERT_TRUE(request._keepAlive);
+  ASSERT_EQ(Status::COMPLETE, parser.next(&request));
+  ASSERT_EQ("GET /?cmd=stats HTTP/1.1", request._requestLine);
+  ASSERT_FALSE(request._keepAlive);
+  ASSERT_EQ(Status::INCOMPLETE, parser.next(&request));
+
+  // The rest of the third request arrives in two parts.
+  parser.append("\r", 1);
+  ASSERT_EQ(Status::INCOMPLETE, parser.next(&request));
+  parser.append("\n", 1);
+  ASSERT_EQ(Status::COMPLETE, parser.next(&request));
+  ASSERT_EQ("GET /?query=b HTTP/1.1", request._requestLine);
+  ASSERT_EQ("", request._headers);
+  ASSERT_EQ(0u, parser.bufferedBytes());
+}
+
+TEST(HttpRequestParserTest, keepAliveAndBody) {
+  HttpRequestParser parser;
+  string data =
+      "GET / HTTP/1.0\r\n\r\n"
+      "GET / HTTP/1.0\r\nconnection: keep-alive\r\n\r\n"
+      "POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+      "GET /next HTTP/1.1\r\n\r\n";
+  parser.append(data.data(), data.size());
+  HttpRequest request;
+  ASSERT_EQ(Status::COMPLETE, parser.next(&request));
+  ASSERT_EQ("HTTP/1.0", request._httpVersion);
+  ASSERT_FALSE(request._keepAlive);
+  ASSERT_EQ(Status::COMPLETE, parser.next(&request));
+  ASSERT_TRUE(request._keepAlive);
+  ASSERT_EQ(Status::COMPLETE, parser.next(&request));
+  ASSERT_EQ("POST / HTTP/1.1", request._requestLine);
+  ASSERT_EQ("HTTP/1.1", request._httpVersion);
+  ASSERT_EQ(Status::COMPLETE, parser.next(&request));
+  ASSERT_EQ("GET /next HTTP/1.1", request._requestLine);
+  ASSERT_EQ(Status::INCOMPLETE, parser.next(&request));
+}
+
+TEST(HttpRequestParserTest, invalidRequests) {
+  {
+    HttpRequestParser parser;
+    string data = "this is not http\r\n\r\n";
+    parser.append(data.data(), data.size());
+    HttpRequest request;
+    ASSERT_EQ(Status::INVALID, parser.next(&request));
+  }
+  {
+    HttpRequestParser parser(10);
+    string data = "GET /?query=very-long HTTP/1.1\r\n";
+    parser.append(data.data(), data.size());
+    HttpRequest request;
+    ASSERT_EQ(Status::INVALID, parser.next(&request));
+  }
+}
+
+TEST(HttpRequestParserTest, invalidContentLength) {
+  for (string length : {"", "abc", "-1", "5x", "0x10", "1 2"}) {
+    HttpRequestParser parser;
+    string data =
+        "POST / HTTP/1.1\r\nContent-Length: " + length + "\r\n\r\nhello";
+    parser.append(data.data(), data.size());
+    HttpRequest request;
+    ASSERT_EQ(Status::INVALID, parser.next(&request)) << length;
+    ASSERT_FALSE(parser.requestTooLarge()) << length;
+  }
+}
+
+TEST(HttpRequestParserTest, contentLengthTooLarge) {
+  string headers = "POST / HTTP/1.1\r\nContent-Length: ";
+  // The headers have 39 bytes, so a body of 61 bytes exceeds the limit.
+  for (string length : {"61", "1000", "99999999999999999999999999"}) {
+    HttpRequestParser parser(99);
+    string data = headers + length + "\r\n\r\n";
+    parser.append(data.data(), data.size());
+    HttpRequest request;
+    // The request is rejected before its body has been received.
+    ASSERT_EQ(Status::INVALID, parser.next(&request)) << length;
+    ASSERT_TRUE(parser.requestTooLarge()) << length;
+  }
+  {
+    HttpRequestParser parser(99);
+    string data = headers + "60\r\n\r\n";
+    parser.append(data.data(), data.size());
+    HttpRequest request;
+    ASSERT_EQ(Status::INCOMPLETE, parser.next(&request));
+    data = string(60, 'x');
+    parser.append(data.data(), data.size());
+    ASSERT_EQ(Status::COMPLETE, parser.next(&request));
+    ASSERT_FALSE(parser.requestTooLarge());
+  }
+}
@@ -0,0 +1,82 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <ostream>
+#include <thread>
+#include "../src/util/HttpResponseStream.h"
+
+using ad_utility::HttpBodyStreamBuf;
+using ad_utility::HttpResponseStream;
+using Status = HttpResponseStream::Status;
+
+TEST(HttpResponseStreamTest, chunkedEncoding) {
+  HttpResponseStream stream;
+  HttpBodyStreamBuf chunks(&stream, true, 4);
+  std::ostream out(&chunks);
+  out << "HelloWorld" << 42;
+  string data;
+  ASSERT_EQ(Status::PENDING, stream.takeAvailable(&data));
+  // Only full chunks have been written so far.
+  ASSERT_EQ("4\r\nHell\r\n4\r\noWor\r\n", data);
+  ASSERT_TRUE(chunks.finish());
+  stream.finish();
+  data.clear();
+  ASSERT_EQ(Status::COMPLETE, stream.takeAvailable(&data));
+  ASSERT_EQ("4\r\nld42\r\n0\r\n\r\n", data);
+}
+
+TEST(HttpResponseStreamTest, closeDelimitedBody) {
+  HttpResponseStream stream;
+  HttpBodyStreamBuf body(&stream, false, 4);
+  std::ostream out(&body);
+  out << "HelloWorld" << 42;
+  string data;
+  ASSERT_EQ(Status::PENDING, stream.takeAvailable(&data));
+  ASSERT_EQ("HelloWor", data);
+  ASSERT_TRUE(body.finish());
+  stream.finish();
+  data.clear();
+  ASSERT_EQ(Status::COMPLETE, stream.takeAvailable(&data));
+  // No chunk framing and no terminating chunk.
+  ASSERT_EQ("ld42", data);
+}
+
+TEST(HttpResponseStreamTest, notifyAndAbort) {
+  size_t nofNotifications = 0;
+  HttpResponseStream stream(100, [&nofNotifications]() {
+    ++nofNotifications;
+  });
+  ASSERT_TRUE(stream.write("a"));
+  // The consumer has not taken the data yet, it already knows about it.
+  ASSERT_TRUE(stream.write("b"));
+  ASSERT_EQ(1u, nofNotifications);
+  stream.abort();
+  stream.finish();
+  ASSERT_EQ(2u, nofNotifications);
+  string data;
+  ASSERT_EQ(Status::ABORTED, stream.takeAvailable(&data));
+  ASSERT_EQ("ab", data);
+}
+
+TEST(HttpResponseStreamTest, backPressureAndClose) {
+  HttpResponseStream stream(4);
+  string data;
+  std::thread producer([&stream]() {
+    HttpBodyStreamBuf chunks(&stream, true, 2);
+    std::ostream out(&chunks);
+    // Blocks until the consumer takes data or closes the stream.
+    for (size_t i = 0; i < 1000 && out; ++i) {
+      out << "xy";
+    }
+    ASSERT_FALSE(out);
+    ASSERT_FALSE(chunks.finish());
+  });
+  while (data.empty()) {
+    stream.takeAvailable(&data);
+  }
+  stream.close();
+  producer.join();
+  ASSERT_EQ(0u, data.find("2\r\nxy\r\n"));
+  ASSERT_EQ(Status::PENDING, stream.takeAvailable(&data));
+}
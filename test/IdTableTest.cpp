@@ -582,6 +582,26 @@ TEST(IdTableTest, conversion) {
   }
 }
 
+TEST(IdTableTest, viewOfRows) {
+  IdTable table(2);
+  for (size_t i = 0; i < 10; ++i) {
+    table.push_back({i, 10 * i});
+  }
+  for (auto view : {table.asStaticView<2>(3, 7),
+                    table.asStaticView<2>().asStaticView<2>(3, 7)}) {
+    ASSERT_EQ(4u, view.size());
+    ASSERT_EQ(2u, view.cols());
+    for (size_t i = 0; i < view.size(); i++) {
+      ASSERT_EQ(i + 3, view(i, 0));
+      ASSERT_EQ(10 * (i + 3), view(i, 1));
+    }
+    ASSERT_EQ(3u, (*view.begin())[0]);
+  }
+  auto dynamicView = table.asStaticView<0>(10, 10);
+  ASSERT_EQ(0u, dynamicView.size());
+  ASSERT_EQ(2u, dynamicView.cols());
+}
+
 TEST(IdTableTest, staticAsserts) {
   static_assert(std::is_trivially_copyable_v<IdTableStatic<1>::iterator>);
   static_assert(std::is_trivially_copyable_v<IdTableStatic<1>::const_iterator>);
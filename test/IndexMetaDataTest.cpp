@@ -281,3 +281,28 @@ int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
 }
+
+TEST(IndexMetaDataTest, statisticsAreUpdatedByAdd) {
+  vector<BlockMetaData> bs;
+  off_t afterFI = 6 * 2 * sizeof(Id);
+  off_t afterLhs = afterFI + 4 * (sizeof(Id) + sizeof(off_t));
+  off_t afterRhs = afterLhs + 6 * sizeof(Id);
+  bs.push_back(BlockMetaData(10, afterFI));
+  bs.push_back(BlockMetaData(16, afterFI + 2 * (sizeof(Id) + sizeof(off_t))));
+  FullRelationMetaData rmdF(1, 0, 6, 1, 1, false, true);
+  BlockBasedRelationMetaData rmdB(afterLhs, afterRhs, bs);
+  FullRelationMetaData rmdF2(3, afterRhs, 1, 1, 1, true, false);
+  BlockBasedRelationMetaData rmdB2;
+  rmdB2._offsetAfter = afterRhs + 20;
+  IndexMetaDataHmap imd;
+  imd.add(rmdF, rmdB);
+  imd.add(rmdF2, rmdB2);
+  ASSERT_EQ(7u, imd.getNofTriples());
+
+  // the statistics that were collected by add are the same as the ones of
+  // a separate pass over all relations.
+  string onTheFly = imd.statistics();
+  imd.calculateExpensiveStatistics();
+  ASSERT_EQ(7u, imd.getNofTriples());
+  ASSERT_EQ(imd.statistics(), onTheFly);
+}
@@ -37,6 +37,24 @@ void writeStxxlConfigFile(const string& location, const string& tail) {
   stxxlConfig.writeLine(config.str());
 }
 
+// The relations of the permutations are stored in compressed blocks.
+// Decompress the pair indices of the relations relIds (in this order) and
+// concatenate them, s.t. the tests can check the Ids one by one.
+template <class MetaData>
+vector<Id> decompressPairs(const string& permutation, const MetaData& meta,
+                           const vector<Id>& relIds) {
+  ad_utility::File file(permutation, "r");
+  vector<Id> res;
+  for (Id relId : relIds) {
+    const FullRelationMetaData& rmd = meta.getRmd(relId)._rmdPairs;
+    size_t oldSize = res.size();
+    res.resize(oldSize + 2 * rmd.getNofElements());
+    CompressedRelation::readPairs(file, rmd._startFullIndex,
+                                  rmd.getNofElements(), res.data() + oldSize);
+  }
+  return res;
+}
+
 TEST(IndexTest, createFromTsvTest) {
   string location = "./";
   string tail = "";
@@ -82,11 +100,9 @@ TEST(IndexTest, createFromTsvTest) {
     ASSERT_TRUE(index.POS().metaData().getRmd(3).isFunctional());
     ASSERT_TRUE(index.POS().metaData().getRmd(4).isFunctional());
 
-    ad_utility::File psoFile("_testindex.index.pso", "r");
-    size_t nofbytes =
-        static_cast<size_t>(index._PSO.metaData().getOffsetAfter());
-    unsigned char* buf = new unsigned char[nofbytes];
-    psoFile.read(buf, nofbytes);
+    vector<Id> pairs =
+        decompressPairs("_testindex.index.pso", index._PSO.metaData(), {3, 4});
+    unsigned char* buf = reinterpret_cast<unsigned char*>(pairs.data());
 
     off_t bytesDone = 0;
     // Relation b
@@ -110,10 +126,7 @@ TEST(IndexTest, createFromTsvTest) {
     ASSERT_EQ(6u, *reinterpret_cast<Id*>(buf + bytesDone));
     bytesDone += sizeof(Id);
     // No LHS & RHS
-    ASSERT_EQ(index._PSO.metaData().getOffsetAfter(), bytesDone);
-
-    delete[] buf;
-    psoFile.close();
+    ASSERT_EQ(pairs.size() * sizeof(Id), static_cast<size_t>(bytesDone));
 
     remove("_testtmp2.tsv");
     std::remove(stxxlFileName.c_str());
@@ -166,11 +179,9 @@ TEST(IndexTest, createFromTsvTest) {
     ASSERT_TRUE(index.POS().metaData().relationExists(8));
     ASSERT_FALSE(index.POS().metaData().getRmd(8).isFunctional());
 
-    ad_utility::File psoFile("_testindex.index.pso", "r");
-    size_t nofbytes =
-        static_cast<size_t>(index._PSO.metaData().getOffsetAfter());
-    unsigned char* buf = new unsigned char[nofbytes];
-    psoFile.read(buf, nofbytes);
+    vector<Id> pairs =
+        decompressPairs("_testindex.index.pso", index._PSO.metaData(), {8});
+    unsigned char* buf = reinterpret_cast<unsigned char*>(pairs.data());
 
     off_t bytesDone = 0;
 
@@ -243,13 +254,9 @@ TEST(IndexTest, createFromTsvTest) {
     //    bytesDone += sizeof(Id);
     //    ASSERT_EQ(2u, *reinterpret_cast<Id*>(buf + bytesDone));
 
-    delete[] buf;
-    psoFile.close();
-
-    ad_utility::File posFile("_testindex.index.pos", "r");
-    nofbytes = static_cast<size_t>(index.POS().metaData().getOffsetAfter());
-    buf = new unsigned char[nofbytes];
-    posFile.read(buf, nofbytes);
+    pairs =
+        decompressPairs("_testindex.index.pos", index.POS().metaData(), {8});
+    buf = reinterpret_cast<unsigned char*>(pairs.data());
 
     bytesDone = 0;
 
@@ -330,8 +337,7 @@ TEST(IndexTest, createFromTsvTest) {
     //    bytesDone += sizeof(Id);
     //    ASSERT_EQ(5u, *reinterpret_cast<Id*>(buf + bytesDone));
 
-    delete[] buf;
-    psoFile.close();
+    ASSERT_EQ(pairs.size() * sizeof(Id), static_cast<size_t>(bytesDone));
 
     remove("_testtmp2.tsv");
     std::remove(stxxlFileName.c_str());
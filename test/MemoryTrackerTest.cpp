@@ -0,0 +1,86 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "../src/engine/IdTable.h"
+#include "../src/util/MemoryTracker.h"
+
+using ad_utility::MemoryLimitExceededException;
+using ad_utility::MemoryTracker;
+using ad_utility::TrackingAllocator;
+
+TEST(MemoryTrackerTest, allocateAndDeallocate) {
+  MemoryTracker tracker(100);
+  tracker.allocate(60);
+  ASSERT_EQ(60u, tracker.currentBytes());
+  tracker.allocate(40);
+  ASSERT_EQ(100u, tracker.currentBytes());
+  ASSERT_THROW(tracker.allocate(1), MemoryLimitExceededException);
+  ASSERT_EQ(100u, tracker.currentBytes());
+  tracker.deallocate(70);
+  ASSERT_EQ(30u, tracker.currentBytes());
+  ASSERT_EQ(100u, tracker.peakBytes());
+  tracker.allocate(10);
+  ASSERT_EQ(40u, tracker.currentBytes());
+  ASSERT_EQ(100u, tracker.peakBytes());
+}
+
+TEST(MemoryTrackerTest, scope) {
+  ASSERT_EQ(nullptr, MemoryTracker::current());
+  auto outer = std::make_shared<MemoryTracker>();
+  {
+    MemoryTracker::Scope outerScope(outer);
+    ASSERT_EQ(outer, MemoryTracker::current());
+    auto inner = std::make_shared<MemoryTracker>();
+    {
+      MemoryTracker::Scope innerScope(inner);
+      ASSERT_EQ(inner, MemoryTracker::current());
+    }
+    ASSERT_EQ(outer, MemoryTracker::current());
+  }
+  ASSERT_EQ(nullptr, MemoryTracker::current());
+}
+
+TEST(MemoryTrackerTest, trackingAllocator) {
+  auto tracker = std::make_shared<MemoryTracker>();
+  size_t globalBefore = MemoryTracker::global().currentBytes();
+  {
+    MemoryTracker::Scope scope(tracker);
+    std::vector<Id, TrackingAllocator<Id>> v;
+    v.reserve(100);
+    ASSERT_EQ(100 * sizeof(Id), tracker->currentBytes());
+    ASSERT_EQ(globalBefore + 100 * sizeof(Id),
+              MemoryTracker::global().currentBytes());
+    // A vector that is created outside of the scope is not charged to the
+    // tracker, but the memory of v stays charged to it.
+    std::vector<Id, TrackingAllocator<Id>> w;
+    {
+      MemoryTracker::Scope nullScope(nullptr);
+      std::vector<Id, TrackingAllocator<Id>> x;
+      x.reserve(10);
+      ASSERT_EQ(100 * sizeof(Id), tracker->currentBytes());
+      w = std::move(v);
+    }
+    ASSERT_EQ(100 * sizeof(Id), tracker->currentBytes());
+  }
+  ASSERT_EQ(0u, tracker->currentBytes());
+  ASSERT_EQ(100 * sizeof(Id), tracker->peakBytes());
+  ASSERT_EQ(globalBefore, MemoryTracker::global().currentBytes());
+}
+
+TEST(MemoryTrackerTest, idTableExceedsLimit) {
+  auto tracker = std::make_shared<MemoryTracker>(1000 * sizeof(Id));
+  MemoryTracker::Scope scope(tracker);
+  {
+    IdTable table(2);
+    table.resize(400);
+    ASSERT_EQ(800 * sizeof(Id), tracker->currentBytes());
+    ASSERT_THROW(table.resize(600), MemoryLimitExceededException);
+    // The table is unchanged.
+    ASSERT_EQ(400u, table.size());
+    ASSERT_EQ(800 * sizeof(Id), tracker->currentBytes());
+  }
+  ASSERT_EQ(0u, tracker->currentBytes());
+  ASSERT_EQ(800 * sizeof(Id), tracker->peakBytes());
+}
@@ -0,0 +1,141 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../src/index/NumberOrder.h"
+
+using ad_utility::convertValueLiteralToIndexWord;
+using std::string;
+using std::vector;
+
+namespace {
+string intWord(const string& number) {
+  return convertValueLiteralToIndexWord(
+      "\"" + number + "\"^^<http://www.w3.org/2001/XMLSchema#integer>");
+}
+
+string decimalWord(const string& number) {
+  return convertValueLiteralToIndexWord(
+      "\"" + number + "\"^^<http://www.w3.org/2001/XMLSchema#decimal>");
+}
+
+// A vocabulary with some other words before and after the numbers.
+struct VocabMock {
+  vector<string> _words;
+  std::pair<Id, Id> prefix_range(const string& prefix) const {
+    Id first = 0;
+    while (first < _words.size() && _words[first].find(prefix) != 0) {
+      ++first;
+    }
+    Id last = first;
+    while (last < _words.size() && _words[last].find(prefix) == 0) {
+      ++last;
+    }
+    return {first, last};
+  }
+  const string& at(Id id) const { return _words[id]; }
+};
+
+// A column of numbers in the vocabulary (Ids 1, 2, ...) and inline numbers
+// with the value of each Id.
+struct MixedColumn {
+  NumberOrder _order;
+  vector<std::pair<Id, double>> _values;
+
+  MixedColumn() {
+    // Too many digits to be stored inline, sorted by value.
+    vector<std::pair<string, double>> vocabNumbers = {
+        {intWord("-900000000000000001"), -900000000000000001.0},
+        {decimalWord("-1.00000000000000001"), -1.00000000000000001},
+        {decimalWord("3.00000000000000001"), 3.00000000000000001},
+        {decimalWord("3.1234567890123456"), 3.1234567890123456},
+        {intWord("140737488355329"), 140737488355329.0},
+        {intWord("900000000000000001"), 900000000000000001.0}};
+    VocabMock vocab;
+    vocab._words.push_back("<a>");
+    for (const auto& [word, value] : vocabNumbers) {
+      EXPECT_FALSE(ValueId::fromIndexWord(word).has_value()) << word;
+      _values.emplace_back(vocab._words.size(), value);
+      vocab._words.push_back(word);
+    }
+    vocab._words.push_back("<b>");
+    _order = NumberOrder::fromVocabulary(vocab);
+    for (const char* number : {"-5", "0", "3", "4", "100000"}) {
+      Id id = ValueId::fromIndexWord(intWord(number)).value();
+      _values.emplace_back(id, ValueId::toDouble(id));
+    }
+    for (const char* number : {"-1.0", "3.0", "3.5", "1.25"}) {
+      Id id = ValueId::fromIndexWord(decimalWord(number)).value();
+      _values.emplace_back(id, ValueId::toDouble(id));
+    }
+  }
+};
+}  // namespace
+
+TEST(NumberOrderTest, fromVocabulary) {
+  MixedColumn column;
+  ASSERT_EQ(6u, column._order.size());
+  ASSERT_FALSE(column._order.isVocabNumber(0));
+  ASSERT_TRUE(column._order.isVocabNumber(1));
+  ASSERT_TRUE(column._order.isVocabNumber(6));
+  ASSERT_FALSE(column._order.isVocabNumber(7));
+  ASSERT_FALSE(column._order.isVocabNumber(column._values.back().first));
+  ASSERT_TRUE(NumberOrder().empty());
+}
+
+TEST(NumberOrderTest, sortMixedColumn) {
+  MixedColumn column;
+  vector<std::pair<Id, double>> sorted = column._values;
+  std::reverse(sorted.begin(), sorted.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [&column](const auto& a, const auto& b) {
+              return column._order.less(a.first, b.first);
+            });
+  for (size_t i = 1; i < sorted.size(); ++i) {
+    ASSERT_LE(sorted[i - 1].second, sorted[i].second) << i;
+  }
+  // Non-numbers are ordered by Id.
+  ASSERT_TRUE(column._order.less(0, 1));
+  ASSERT_TRUE(column._order.less(7, 8));
+}
+
+TEST(NumberOrderTest, rangesMatchValues) {
+  MixedColumn column;
+  using Relation = NumberOrder::Relation;
+  auto matches = [](double value, Relation relation, double rhs) {
+    switch (relation) {
+      case Relation::LT:
+        return value < rhs;
+      case Relation::LE:
+        return value <= rhs;
+      case Relation::EQ:
+        return value == rhs;
+      case Relation::GE:
+        return value >= rhs;
+      default:
+        return value > rhs;
+    }
+  };
+  vector<double> rhsValues = {-1e30, -900000000000000001.0, -5, -1, 0,
+                              3,     3.00000000000000001,   3.2, 4,
+                              1.25,  140737488355329.0,     1e30};
+  for (double rhs : rhsValues) {
+    for (auto relation : {Relation::LT, Relation::LE, Relation::EQ,
+                          Relation::GE, Relation::GT}) {
+      auto vocabRange = column._order.vocabRange(relation, rhs);
+      auto inlineRange = NumberOrder::inlineRange(relation, rhs);
+      for (const auto& [id, value] : column._values) {
+        bool inRange =
+            (id >= vocabRange.first && id < vocabRange.second) ||
+            (id >= inlineRange.first && id < inlineRange.second);
+        ASSERT_EQ(matches(value, relation, rhs), inRange)
+            << id << " " << value << " " << rhs
+            << " relation " << static_cast<int>(relation);
+      }
+    }
+  }
+}
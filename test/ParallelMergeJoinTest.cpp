@@ -0,0 +1,127 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "../src/engine/CallFixedSize.h"
+#include "../src/engine/Engine.h"
+#include "../src/engine/Join.h"
+#include "../src/engine/MultiColumnJoin.h"
+#include "../src/engine/OptionalJoin.h"
+#include "../src/engine/ParallelMergeJoin.h"
+
+using ad_utility::ParallelJoinSettings;
+
+namespace {
+// A table that is sorted lexicographically, the first two columns contain
+// many duplicates.
+IdTable createSortedTable(size_t nofRows, size_t nofCols, std::mt19937* gen) {
+  std::uniform_int_distribution<Id> small(0, 30);
+  std::uniform_int_distribution<Id> large(0, 1000 * 1000);
+  IdTable table(nofCols);
+  table.resize(nofRows);
+  for (size_t i = 0; i < nofRows; ++i) {
+    for (size_t j = 0; j < nofCols; ++j) {
+      table(i, j) = j < 2 ? small(*gen) : large(*gen);
+    }
+  }
+  Engine::sort<0>(&table, [](const auto& a, const auto& b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+      if (a[i] != b[i]) {
+        return a[i] < b[i];
+      }
+    }
+    return false;
+  });
+  return table;
+}
+
+// Compute joinFunction once sequentially and once with several threads and
+// check that the results are equal (including the order).
+template <typename JoinFunction>
+void testParallelJoin(JoinFunction joinFunction, size_t resultCols) {
+  IdTable sequential(resultCols);
+  ParallelJoinSettings::setNofThreads(1);
+  joinFunction(&sequential);
+  ASSERT_GT(sequential.size(), 0u);
+  for (size_t nofThreads : {2, 3, 8}) {
+    IdTable parallel(resultCols);
+    ParallelJoinSettings::setNofThreads(nofThreads);
+    ParallelJoinSettings::setMinPartitionSize(10);
+    joinFunction(&parallel);
+    ASSERT_EQ(sequential, parallel) << nofThreads;
+  }
+  ParallelJoinSettings::setNofThreads(DEFAULT_NOF_JOIN_THREADS);
+  ParallelJoinSettings::setMinPartitionSize(DEFAULT_JOIN_MIN_PARTITION_SIZE);
+}
+}  // namespace
+
+TEST(ParallelMergeJoinTest, splitAtJoinIds) {
+  std::mt19937 gen(42);
+  IdTable a = createSortedTable(1000, 2, &gen);
+  IdTable b = createSortedTable(300, 3, &gen);
+  auto [aBounds, bBounds] = ad_utility::splitAtJoinIds(a, 0, b, 0, 8);
+  ASSERT_EQ(aBounds.size(), bBounds.size());
+  ASSERT_GT(aBounds.size(), 2u);
+  ASSERT_EQ(0u, aBounds.front());
+  ASSERT_EQ(a.size(), aBounds.back());
+  ASSERT_EQ(b.size(), bBounds.back());
+  // No join id is split between two partitions.
+  for (size_t i = 1; i + 1 < aBounds.size(); ++i) {
+    Id splitId = a(aBounds[i], 0);
+    ASSERT_LT(a(aBounds[i] - 1, 0), splitId);
+    ASSERT_TRUE(bBounds[i] == 0 || b(bBounds[i] - 1, 0) < splitId);
+    ASSERT_TRUE(bBounds[i] == b.size() || b(bBounds[i], 0) >= splitId);
+  }
+}
+
+TEST(ParallelMergeJoinTest, join) {
+  std::mt19937 gen(42);
+  IdTable a = createSortedTable(2000, 2, &gen);
+  IdTable b = createSortedTable(500, 3, &gen);
+  testParallelJoin(
+      [&](IdTable* res) { Join::join<2, 3, 4>(a, 0, b, 0, res); }, 4);
+  // The galloping join.
+  IdTable c = createSortedTable(20, 1, &gen);
+  IdTable d = createSortedTable(30000, 2, &gen);
+  testParallelJoin(
+      [&](IdTable* res) { Join::join<1, 2, 2>(c, 0, d, 0, res); }, 2);
+}
+
+TEST(ParallelMergeJoinTest, multiColumnJoin) {
+  std::mt19937 gen(42);
+  IdTable a = createSortedTable(2000, 3, &gen);
+  IdTable b = createSortedTable(1000, 3, &gen);
+  vector<array<Id, 2>> jcs{{0, 0}, {1, 1}};
+  testParallelJoin(
+      [&](IdTable* res) {
+        MultiColumnJoin::computeMultiColumnJoin<3, 3, 4>(a, b, jcs, res);
+      },
+      4);
+}
+
+TEST(ParallelMergeJoinTest, optionalJoin) {
+  std::mt19937 gen(42);
+  // Few matches on both join columns, such that many rows are optional.
+  IdTable a = createSortedTable(2000, 3, &gen);
+  IdTable b = createSortedTable(300, 3, &gen);
+  vector<array<Id, 2>> jcs{{0, 0}, {1, 1}};
+  for (auto optional : {std::pair{false, true}, {true, false}, {true, true}}) {
+    bool aOptional = optional.first;
+    bool bOptional = optional.second;
+    testParallelJoin(
+        [&](IdTable* res) {
+          OptionalJoin::optionalJoin<3, 3, 4>(a, b, aOptional, bOptional, jcs,
+                                              res);
+        },
+        4);
+  }
+  // One side is empty and optional.
+  IdTable empty(3);
+  testParallelJoin(
+      [&](IdTable* res) {
+        OptionalJoin::optionalJoin<3, 3, 4>(empty, b, true, false, jcs, res);
+      },
+      4);
+}
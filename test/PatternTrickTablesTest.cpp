@@ -0,0 +1,53 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "../src/index/PatternTrickTables.h"
+
+TEST(PatternTrickTablesTest, getTables) {
+  PatternTrickTables tables;
+  ASSERT_TRUE(tables.empty());
+  ASSERT_EQ(nullptr, tables.getAllEntities());
+  tables.addType(1, 5, {{2, 10}, {3, 1}});
+  ASSERT_FALSE(tables.empty());
+  ASSERT_EQ(nullptr, tables.getAllEntities());
+  ASSERT_EQ(nullptr, tables.getType(1, 6));
+  ASSERT_EQ(nullptr, tables.getType(5, 1));
+  ASSERT_NE(nullptr, tables.getType(1, 5));
+  ASSERT_EQ((PatternTrickTables::Table{{2, 10}, {3, 1}}),
+            *tables.getType(1, 5));
+  tables.setAllEntities({{2, 12}});
+  ASSERT_EQ((PatternTrickTables::Table{{2, 12}}), *tables.getAllEntities());
+  ASSERT_EQ(1u, tables.getNofTypes());
+}
+
+TEST(PatternTrickTablesTest, writeAndRead) {
+  const std::string fileName = "_testtmp.pattern-trick";
+  PatternTrickTables tables;
+  tables.setAllEntities({{1, 3}, {2, 7}, {4, 1}});
+  tables.addType(1, 5, {{2, 4}});
+  tables.addType(1, 6, {});
+  tables.addType(3, 5, {{1, 1}, {2, 1}});
+  tables.writeToFile(fileName);
+
+  PatternTrickTables read;
+  read.addType(7, 7, {{1, 1}});
+  read.readFromFile(fileName);
+  ASSERT_EQ(3u, read.getNofTypes());
+  ASSERT_EQ(nullptr, read.getType(7, 7));
+  ASSERT_EQ(*tables.getAllEntities(), *read.getAllEntities());
+  for (auto [predicate, type] : {std::pair{1, 5}, {1, 6}, {3, 5}}) {
+    ASSERT_NE(nullptr, read.getType(predicate, type));
+    ASSERT_EQ(*tables.getType(predicate, type), *read.getType(predicate, type));
+  }
+
+  // without the table for all entities
+  PatternTrickTables typesOnly;
+  typesOnly.addType(1, 5, {{2, 4}});
+  typesOnly.writeToFile(fileName);
+  read.readFromFile(fileName);
+  ASSERT_EQ(nullptr, read.getAllEntities());
+  ASSERT_EQ(1u, read.getNofTypes());
+  remove(fileName.c_str());
+}
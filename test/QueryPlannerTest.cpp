@@ -1072,15 +1072,14 @@ TEST(QueryExecutionTreeTest, testPoliticiansFriendWithScieManHatProj) {
 
         "{\n  TEXT OPERATION WITH FILTER: co-occurrence with words: "
         "\"manhattan project\" and 1 variables with textLimit = 1 filtered "
-        "by\n  {\n    JOIN\n    {\n      SCAN POS with P = \"<is-a>\", O = "
-        "\"<Scientist>\"\n      qet-width: 1 \n    } join-column: [0]\n    "
-        "|X|\n    {\n      SORT / ORDER BY on columns:asc(2) \n      {\n       "
-        " TEXT OPERATION "
+        "by\n  {\n    HASH_JOIN\n    {\n      SCAN POS with P = \"<is-a>\", "
+        "O = \"<Scientist>\"\n      qet-width: 1 \n    } join-column: [0]\n "
+        "   |X|\n    {\n      TEXT OPERATION "
         "WITH FILTER: co-occurrence with words: \"friend*\" and 2 variables "
-        "with textLimit = 1 filtered by\n        {\n          SCAN POS with P "
-        "= \"<is-a>\", O = \"<Politician>\"\n          qet-width: 1 \n        "
-        "}\n         filtered on column 0\n        qet-width: 4 \n      }\n    "
-        "  qet-width: 4 \n    } join-column: [2]\n    qet-width: 4 \n  }\n   "
+        "with textLimit = 1 filtered by\n      {\n        SCAN POS with P "
+        "= \"<is-a>\", O = \"<Politician>\"\n        qet-width: 1 \n      "
+        "}\n       filtered on column 0\n      qet-width: 4 \n    } "
+        "join-column: [2]\n    qet-width: 4 \n  }\n   "
         "filtered on column 0\n  qet-width: 6 \n}",
         qet.asString());
   } catch (const ad_semsearch::Exception& e) {
@@ -0,0 +1,95 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "../src/index/RelationStatistics.h"
+
+namespace {
+// The statistics of the sorted objects with the given number of subjects.
+PredicateStatistics compute(const vector<Id>& objects, size_t nofBuckets,
+                            size_t nofHeavyHitters) {
+  PredicateStatisticsBuilder builder(objects.size(), nofBuckets,
+                                     nofHeavyHitters);
+  for (Id object : objects) {
+    builder.addObject(object);
+  }
+  return builder.finish(7);
+}
+}  // namespace
+
+TEST(RelationStatisticsTest, build) {
+  // 0, ..., 99 once and 50 another 100 times.
+  vector<Id> objects;
+  for (Id i = 0; i < 100; ++i) {
+    objects.insert(objects.end(), i == 50 ? 101 : 1, i);
+  }
+  PredicateStatistics stats = compute(objects, 10, 2);
+  ASSERT_EQ(200u, stats._nofTriples);
+  ASSERT_EQ(7u, stats._nofDistinctSubjects);
+  ASSERT_EQ(100u, stats._nofDistinctObjects);
+  ASSERT_EQ(10u, stats.getNofBuckets());
+  ASSERT_EQ(0u, stats._objectBounds.front());
+  ASSERT_EQ(99u, stats._objectBounds.back());
+  ASSERT_TRUE(std::is_sorted(stats._objectBounds.begin(),
+                             stats._objectBounds.end()));
+  // The second heavy hitter is one of the objects that occur once.
+  ASSERT_EQ(2u, stats._heavyHitters.size());
+  ASSERT_EQ((array<Id, 2>{50, 101}), stats._heavyHitters[0]);
+  ASSERT_EQ(1u, stats._heavyHitters[1][1]);
+
+  // The equal bounds of the heavy hitter cover half of the buckets.
+  ASSERT_NEAR(0.5, stats.objectRangeSelectivity(50, 51), 0.1);
+  ASSERT_NEAR(0.25, stats.objectRangeSelectivity(0, 50), 0.1);
+  ASSERT_NEAR(1, stats.objectRangeSelectivity(0, 100), 0.001);
+  ASSERT_EQ(0, stats.objectRangeSelectivity(100, 200));
+  ASSERT_EQ(0, stats.objectRangeSelectivity(40, 40));
+
+  ASSERT_DOUBLE_EQ(101.0 / 200, stats.objectSelectivity(50));
+  // The remaining 200 - 102 triples of the 98 other objects.
+  ASSERT_DOUBLE_EQ(1.0 / 200, stats.objectSelectivity(20));
+  ASSERT_EQ(0, stats.objectSelectivity(100));
+}
+
+TEST(RelationStatisticsTest, buildSmall) {
+  PredicateStatistics empty = compute({}, 10, 2);
+  ASSERT_EQ(0u, empty._nofDistinctObjects);
+  ASSERT_EQ(0, empty.objectRangeSelectivity(0, 10));
+  ASSERT_EQ(0, empty.objectSelectivity(0));
+
+  PredicateStatistics single = compute({5}, 10, 2);
+  ASSERT_EQ(0u, single.getNofBuckets());
+  ASSERT_EQ(1, single.objectRangeSelectivity(0, 10));
+  ASSERT_EQ(0, single.objectRangeSelectivity(6, 10));
+  ASSERT_EQ(1, single.objectSelectivity(5));
+
+  PredicateStatistics three = compute({1, 2, 4}, 10, 0);
+  ASSERT_EQ(2u, three.getNofBuckets());
+  ASSERT_EQ((vector<Id>{1, 2, 4}), three._objectBounds);
+  ASSERT_TRUE(three._heavyHitters.empty());
+  ASSERT_DOUBLE_EQ(1.0 / 3, three.objectSelectivity(4));
+}
+
+TEST(RelationStatisticsTest, writeAndRead) {
+  const std::string fileName = "_testtmp.statistics";
+  RelationStatistics statistics;
+  ASSERT_TRUE(statistics.empty());
+  statistics.add(3, compute({1, 1, 2, 5, 5, 5}, 3, 1));
+  statistics.add(8, compute({4}, 3, 1));
+  statistics.writeToFile(fileName);
+
+  RelationStatistics read;
+  read.readFromFile(fileName);
+  ASSERT_EQ(2u, read.size());
+  ASSERT_EQ(nullptr, read.get(4));
+  const PredicateStatistics* stats = read.get(3);
+  ASSERT_NE(nullptr, stats);
+  ASSERT_EQ(6u, stats->_nofTriples);
+  ASSERT_EQ(7u, stats->_nofDistinctSubjects);
+  ASSERT_EQ(3u, stats->_nofDistinctObjects);
+  // The objects at the positions 0, 1, 3 and 5.
+  ASSERT_EQ((vector<Id>{1, 1, 5, 5}), stats->_objectBounds);
+  ASSERT_EQ((vector<array<Id, 2>>{{5, 3}}), stats->_heavyHitters);
+  ASSERT_EQ((vector<Id>{4}), read.get(8)->_objectBounds);
+  std::remove(fileName.c_str());
+}
@@ -3,6 +3,8 @@
 // Author: Björn Buchhold <buchholb>
 
 #include <gtest/gtest.h>
+#include <random>
+#include <vector>
 #include "../src/util/Simple8bCode.h"
 
 using std::string;
@@ -207,6 +209,38 @@ TEST(Simple8bTest, testEncodeDecode242times0) {
   delete[] encoded;
   delete[] decoded;
 }
+// _____________________________________________________________________________
+template <typename Numeric>
+void testDecodeEqualsScalar(uint64_t maxValue) {
+  // Mix all selectors: streaks of 0's, small and large values.
+  std::mt19937_64 gen(23);
+  std::uniform_int_distribution<uint64_t> value(0, maxValue);
+  std::uniform_int_distribution<size_t> streak(0, 300);
+  std::vector<Numeric> plain;
+  while (plain.size() < 100000) {
+    plain.resize(plain.size() + streak(gen), 0);
+    uint64_t max = value(gen);
+    for (size_t i = streak(gen); i > 0; --i) {
+      plain.push_back(static_cast<Numeric>(value(gen) % (max + 1)));
+    }
+  }
+  std::vector<uint64_t> encoded(plain.size());
+  Simple8bCode::encode(plain.data(), plain.size(), encoded.data());
+  std::vector<Numeric> decoded(plain.size() + 239);
+  std::vector<Numeric> reference(plain.size() + 239);
+  Simple8bCode::decode(encoded.data(), plain.size(), decoded.data());
+  Simple8bCode::decodeScalar(encoded.data(), plain.size(), reference.data());
+  for (size_t i = 0; i < plain.size(); ++i) {
+    ASSERT_EQ(plain[i], decoded[i]) << i;
+    ASSERT_EQ(reference[i], decoded[i]) << i;
+  }
+}
+
+TEST(Simple8bTest, decodeEqualsScalarDecode) {
+  testDecodeEqualsScalar<uint64_t>(0x0FFFFFFFFFFFFFFF);
+  testDecodeEqualsScalar<uint32_t>(0xFFFFFFFF);
+  testDecodeEqualsScalar<uint16_t>(0xFFFF);
+}
 }  // namespace ad_utility
 
 // _____________________________________________________________________________
@@ -0,0 +1,61 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "../src/util/StreamVByteCode.h"
+
+using ad_utility::StreamVByteCode;
+
+// _____________________________________________________________________________
+TEST(StreamVByteCodeTest, encode) {
+  std::vector<uint32_t> plain{1, 256, 65536, 16777216, 7};
+  std::vector<unsigned char> encoded(StreamVByteCode::maxEncodedBytes(5));
+  size_t nofBytes =
+      StreamVByteCode::encode(plain.data(), plain.size(), encoded.data());
+  // two control bytes and 1 + 2 + 3 + 4 + 1 data bytes
+  ASSERT_EQ(2u + 11u, nofBytes);
+  ASSERT_EQ(0b11100100, encoded[0]);
+  ASSERT_EQ(0b00000000, encoded[1]);
+  ASSERT_EQ(1, encoded[2]);
+  ASSERT_EQ(0, encoded[3]);
+  ASSERT_EQ(1, encoded[4]);
+  ASSERT_EQ(7, encoded[12]);
+}
+
+// _____________________________________________________________________________
+template <typename Numeric>
+void testEncodeDecode(size_t nofElements) {
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<size_t> nofBits(0, 32);
+  std::vector<Numeric> plain(nofElements);
+  for (auto& el : plain) {
+    el = static_cast<Numeric>(gen() & ((uint64_t(1) << nofBits(gen)) - 1));
+  }
+  ASSERT_TRUE(StreamVByteCode::canEncode(plain.data(), plain.size()));
+  std::vector<unsigned char> encoded(
+      StreamVByteCode::maxEncodedBytes(nofElements));
+  size_t nofBytes =
+      StreamVByteCode::encode(plain.data(), plain.size(), encoded.data());
+  std::vector<Numeric> decoded(nofElements + 3);
+  StreamVByteCode::decode(encoded.data(), nofBytes, nofElements,
+                          decoded.data());
+  for (size_t i = 0; i < nofElements; ++i) {
+    ASSERT_EQ(plain[i], decoded[i]) << i;
+  }
+}
+
+TEST(StreamVByteCodeTest, encodeDecode) {
+  for (size_t n : {0, 1, 3, 4, 5, 17, 1000, 100003}) {
+    testEncodeDecode<uint32_t>(n);
+    testEncodeDecode<uint64_t>(n);
+  }
+}
+
+// _____________________________________________________________________________
+TEST(StreamVByteCodeTest, canEncode) {
+  std::vector<uint64_t> plain{1, 2, uint64_t(1) << 32};
+  ASSERT_FALSE(StreamVByteCode::canEncode(plain.data(), plain.size()));
+  ASSERT_TRUE(StreamVByteCode::canEncode(plain.data(), plain.size() - 1));
+}
@@ -331,6 +331,31 @@ TEST(StringUtilsTest, splitWsWithEscape) {
   ASSERT_EQ("'\t\na'' a'", v2[4]);
 }
 
+
+TEST(StringUtilsTest, getLiteralPrefixOfRegex) {
+  ASSERT_EQ("", getLiteralPrefixOfRegex(""));
+  ASSERT_EQ("", getLiteralPrefixOfRegex("abc"));
+  ASSERT_EQ("abc", getLiteralPrefixOfRegex("^abc"));
+  ASSERT_EQ("abc", getLiteralPrefixOfRegex("^abc$"));
+  ASSERT_EQ("\"abc", getLiteralPrefixOfRegex("^\"abc.*d"));
+  ASSERT_EQ("ab", getLiteralPrefixOfRegex("^abc?"));
+  ASSERT_EQ("ab", getLiteralPrefixOfRegex("^abc*"));
+  ASSERT_EQ("ab", getLiteralPrefixOfRegex("^abc{0,2}"));
+  ASSERT_EQ("abc", getLiteralPrefixOfRegex("^abc+"));
+  ASSERT_EQ("ab", getLiteralPrefixOfRegex("^ab(c|d)"));
+  ASSERT_EQ("a.b", getLiteralPrefixOfRegex("^a\\.b"));
+  ASSERT_EQ("a", getLiteralPrefixOfRegex("^a\\.?b"));
+  ASSERT_EQ("a", getLiteralPrefixOfRegex("^a\\db"));
+  ASSERT_EQ("ab", getLiteralPrefixOfRegex("^ab[|]"));
+  ASSERT_EQ("ab", getLiteralPrefixOfRegex("^ab(c|d)[]|]"));
+  // the last character is a multibyte character
+  ASSERT_EQ("ab", getLiteralPrefixOfRegex("^ab\u00e4?"));
+  ASSERT_EQ("ab\u00e4", getLiteralPrefixOfRegex("^ab\u00e4c?"));
+  // only the first alternative is anchored.
+  ASSERT_EQ("", getLiteralPrefixOfRegex("^abc|def"));
+  ASSERT_EQ("", getLiteralPrefixOfRegex("^(?i)abc"));
+}
+
 }  // namespace ad_utility
 
 int main(int argc, char** argv) {
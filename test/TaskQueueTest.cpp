@@ -0,0 +1,45 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+#include "../src/util/TaskQueue.h"
+
+using ad_utility::TaskQueue;
+
+TEST(TaskQueueTest, executesAllTasks) {
+  std::atomic<size_t> sum = 0;
+  {
+    TaskQueue queue(4, 1000);
+    for (size_t i = 1; i <= 1000; ++i) {
+      ASSERT_TRUE(queue.push([&sum, i] { sum += i; }));
+    }
+    // The destructor waits for all the tasks.
+  }
+  ASSERT_EQ(500500u, sum);
+}
+
+TEST(TaskQueueTest, rejectsTasksWhenFull) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::promise<void> started;
+  std::atomic<size_t> nofExecuted = 0;
+  {
+    TaskQueue queue(1, 2);
+    // Block the only worker.
+    ASSERT_TRUE(queue.push([&] {
+      started.set_value();
+      released.wait();
+      ++nofExecuted;
+    }));
+    started.get_future().wait();
+    ASSERT_EQ(1u, queue.numActive());
+    ASSERT_TRUE(queue.push([&] { ++nofExecuted; }));
+    ASSERT_TRUE(queue.push([&] { ++nofExecuted; }));
+    ASSERT_EQ(2u, queue.queueSize());
+    ASSERT_FALSE(queue.push([&] { ++nofExecuted; }));
+    release.set_value();
+  }
+  ASSERT_EQ(3u, nofExecuted);
+}
@@ -2,7 +2,12 @@
 // Chair of Algorithms and Data Structures.
 // Author: Florian Kramer (florian.kramer@mail.uni-freiburg.de)
 
+#include <algorithm>
 #include <array>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -99,3 +104,137 @@ TEST(TransitivePathTest, computeTransitivePath) {
   std::sort(result.begin(), result.end(), cmp);
   ASSERT_EQ(expected, result);
 }
+
+TEST(TransitivePathTest, computeTransitivePathIsSorted) {
+  IdTable sub(2);
+  sub.push_back({7, 0});
+  sub.push_back({4, 7});
+  sub.push_back({0, 7});
+  sub.push_back({2, 4});
+  sub.push_back({0, 2});
+
+  IdTable result(2);
+  IdTable expected(2);
+  expected.push_back({0, 0});
+  expected.push_back({0, 2});
+  expected.push_back({0, 4});
+  expected.push_back({0, 7});
+  expected.push_back({2, 0});
+  expected.push_back({2, 2});
+  expected.push_back({2, 4});
+  expected.push_back({2, 7});
+  expected.push_back({4, 0});
+  expected.push_back({4, 2});
+  expected.push_back({4, 4});
+  expected.push_back({4, 7});
+  expected.push_back({7, 0});
+  expected.push_back({7, 2});
+  expected.push_back({7, 4});
+  expected.push_back({7, 7});
+
+  // The result is sorted by both columns without sorting it.
+  TransitivePath::computeTransitivePath<2>(&result, sub, true, true, 0, 1, 0, 0,
+                                           1,
+                                           std::numeric_limits<size_t>::max());
+  ASSERT_EQ(expected, result);
+
+  result.clear();
+  expected.clear();
+  expected.push_back({0, 2});
+  expected.push_back({2, 2});
+  expected.push_back({4, 2});
+  expected.push_back({7, 2});
+
+  TransitivePath::computeTransitivePath<2>(&result, sub, true, false, 0, 1, 0,
+                                           2, 1,
+                                           std::numeric_limits<size_t>::max());
+  ASSERT_EQ(expected, result);
+}
+
+TEST(TransitivePathTest, computeTransitivePathMinDist) {
+  IdTable sub(2);
+  sub.push_back({0, 1});
+  sub.push_back({1, 2});
+  sub.push_back({2, 3});
+  sub.push_back({0, 2});
+
+  IdTable result(2);
+  IdTable expected(2);
+  // 2 can be reached from 0 with one and with two edges.
+  expected.push_back({0, 2});
+  expected.push_back({0, 3});
+  expected.push_back({1, 3});
+
+  TransitivePath::computeTransitivePath<2>(&result, sub, true, true, 0, 1, 0, 0,
+                                           2, 2);
+  ASSERT_EQ(expected, result);
+}
+
+TEST(TransitivePathTest, computeTransitivePathManyStartNodes) {
+  // A random graph with enough start nodes for several threads.
+  const size_t nofNodes = 3000;
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<Id> nodeDist(0, nofNodes - 1);
+  IdTable sub(2);
+  std::map<Id, std::set<Id>> edges;
+  for (size_t i = 0; i < 3000; i++) {
+    Id from = nodeDist(gen);
+    Id to = nodeDist(gen);
+    sub.push_back({from, to});
+    edges[from].insert(to);
+  }
+
+  IdTable expected(2);
+  for (const auto& [start, targets] : edges) {
+    std::set<Id> reached;
+    std::vector<Id> stack(targets.begin(), targets.end());
+    while (!stack.empty()) {
+      Id node = stack.back();
+      stack.pop_back();
+      if (reached.insert(node).second && edges.count(node) > 0) {
+        stack.insert(stack.end(), edges[node].begin(), edges[node].end());
+      }
+    }
+    for (Id target : reached) {
+      expected.push_back({start, target});
+    }
+  }
+
+  IdTable result(2);
+  TransitivePath::computeTransitivePath<2>(&result, sub, true, true, 0, 1, 0, 0,
+                                           1,
+                                           std::numeric_limits<size_t>::max());
+  ASSERT_EQ(expected, result);
+}
+
+TEST(TransitivePathTest, computeTransitivePathLeftBound) {
+  IdTable sub(2);
+  sub.push_back({0, 2});
+  sub.push_back({2, 4});
+  sub.push_back({4, 7});
+  sub.push_back({7, 0});
+  sub.push_back({10, 11});
+
+  IdTable left(2);
+  left.push_back({100, 4});
+  left.push_back({101, 10});
+  left.push_back({102, 5});
+  left.push_back({103, 4});
+
+  IdTable result(3);
+  IdTable expected(3);
+  expected.push_back({4, 7, 100});
+  expected.push_back({4, 0, 100});
+  expected.push_back({10, 11, 101});
+  expected.push_back({4, 7, 103});
+  expected.push_back({4, 0, 103});
+
+  TransitivePath::computeTransitivePathLeftBound<2, 2, 3>(
+      &result, sub, left, 1, true, 0, 1, 0, 1, 2, 3);
+  auto cmp = [](const auto& a, const auto& b) {
+    return a[2] != b[2] ? a[2] < b[2] : a[1] < b[1];
+  };
+  std::sort(expected.begin(), expected.end(), cmp);
+  std::sort(result.begin(), result.end(), cmp);
+  ASSERT_EQ(expected, result);
+}
@@ -3,7 +3,9 @@
 // Author: Johannes Kalmbach(joka921) <johannes.kalmbach@gmail.com>
 //
 #include <gtest/gtest.h>
+#include <fstream>
 #include <iostream>
+#include <set>
 #include <string>
 #include "../src/parser/TurtleParser.h"
 
@@ -231,3 +233,56 @@ TEST(TurtleParserTest, predicateObjectList) {
   ASSERT_EQ(p._triples, exp);
   ASSERT_EQ(p.getPosition(), predL.size());
 }
+
+TEST(TurtleParserTest, findLastStatementEnd) {
+  using P = TurtleParallelParser<TokenizerCtre>;
+  ASSERT_EQ(P::findLastStatementEnd("<s> <p> <o> ."), 0u);
+  ASSERT_EQ(P::findLastStatementEnd("<s> <p> <o> .\n<s> <p>"), 13u);
+  ASSERT_EQ(P::findLastStatementEnd("<s> <p> <o> .\r\n<s> <p> <o> .\n"), 28u);
+  // terminators in literals, IRIs and comments
+  ASSERT_EQ(P::findLastStatementEnd("<s> <p> \"a .\n b\" .\n<s> <p> \"c .\n"),
+            18u);
+  ASSERT_EQ(P::findLastStatementEnd("<s> <p> \"\"\"a .\n b\"\"\" .\n<s> <p> 'x"),
+            22u);
+  ASSERT_EQ(P::findLastStatementEnd("<s> <p> \"\\\" .\n\" .\n"), 17u);
+  ASSERT_EQ(P::findLastStatementEnd("<s> <p> <o .\n> .\n# a comment .\n"), 16u);
+}
+
+TEST(TurtleParserTest, parallelParser) {
+  string filename = "_testTurtleParallelParser.ttl";
+  std::vector<std::array<string, 3>> expected;
+  {
+    std::ofstream f(filename);
+    f << "@prefix ex: <http://ex.org/> .\n";
+    for (size_t i = 0; i < 1000; ++i) {
+      auto s = std::to_string(i);
+      f << "ex:s" << s << " ex:p \"\"\"lit .\n" << s
+        << "\"\"\" ; ex:q [] ;\n ex:r ex:o" << s << " .\n";
+      expected.push_back({"<http://ex.org/s" + s + ">", "<http://ex.org/p>",
+                          "\"\"\"lit .\n" + s + "\"\"\""});
+    }
+  }
+  for (size_t numThreads : {1, 3, 8}) {
+    // small blocks, such that there are many batches
+    TurtleParallelParser<Tokenizer> p(filename, numThreads, 1000);
+    std::vector<std::array<string, 3>> result;
+    std::array<string, 3> triple;
+    while (p.getLine(triple)) {
+      result.push_back(triple);
+    }
+    ASSERT_EQ(result.size(), 3000u);
+    std::vector<std::array<string, 3>> literalTriples;
+    std::set<string> anonNodes;
+    for (const auto& t : result) {
+      if (t[1] == "<http://ex.org/p>") {
+        literalTriples.push_back(t);
+      } else if (t[1] == "<http://ex.org/q>") {
+        anonNodes.insert(t[2]);
+      }
+    }
+    // the order of the input is kept and blank nodes are unique
+    ASSERT_EQ(literalTriples, expected);
+    ASSERT_EQ(anonNodes.size(), 1000u);
+  }
+  ad_utility::deleteFile(filename);
+}
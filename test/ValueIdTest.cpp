@@ -0,0 +1,119 @@
+// Copyright 2020, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "../src/global/ValueId.h"
+
+using ad_utility::convertValueLiteralToIndexWord;
+using std::string;
+using std::vector;
+
+namespace {
+Id idOf(const string& literal) {
+  auto id = ValueId::fromIndexWord(convertValueLiteralToIndexWord(literal));
+  EXPECT_TRUE(id.has_value()) << literal;
+  return id.value_or(0);
+}
+}  // namespace
+
+TEST(ValueIdTest, numbersRoundTrip) {
+  vector<string> literals = {
+      "\"42\"^^<http://www.w3.org/2001/XMLSchema#int>",
+      "\"-17\"^^<http://www.w3.org/2001/XMLSchema#integer>",
+      "\"0\"^^<http://www.w3.org/2001/XMLSchema#int>",
+      "\"1.5\"^^<http://www.w3.org/2001/XMLSchema#float>",
+      "\"-0.00125\"^^<http://www.w3.org/2001/XMLSchema#double>",
+      "\"123456.75\"^^<http://www.w3.org/2001/XMLSchema#decimal>",
+      "\"1200\"^^<http://www.w3.org/2001/XMLSchema#double>"};
+  for (const auto& literal : literals) {
+    string word = convertValueLiteralToIndexWord(literal);
+    Id id = idOf(literal);
+    ASSERT_TRUE(ValueId::isValue(id));
+    ASSERT_EQ(ValueId::Datatype::NUMBER, ValueId::datatype(id));
+    ASSERT_EQ(word, ValueId::toIndexWord(id)) << literal;
+  }
+  ASSERT_EQ(42.0, ValueId::toDouble(idOf(
+                      "\"42\"^^<http://www.w3.org/2001/XMLSchema#int>")));
+  ASSERT_EQ(ad_utility::NumericType::INTEGER,
+            ValueId::numericType(
+                idOf("\"42\"^^<http://www.w3.org/2001/XMLSchema#int>")));
+  ASSERT_EQ(ad_utility::NumericType::FLOAT,
+            ValueId::numericType(
+                idOf("\"1.5\"^^<http://www.w3.org/2001/XMLSchema#float>")));
+}
+
+TEST(ValueIdTest, numbersAreOrdered) {
+  // Values whose mantissa fits into the bits that are stored.
+  vector<double> values = {-0x1p1000, -12345.5, -1,     -0x1p-10, 0,
+                           0x1p-1000, 0.5,      1,      2,        3.25,
+                           1000,      1e15,     0x1p1000};
+  vector<Id> ids;
+  for (double value : values) {
+    ids.push_back(ValueId::fromDouble(value, ad_utility::NumericType::DOUBLE));
+    ASSERT_EQ(value, ValueId::toDouble(ids.back()));
+  }
+  ASSERT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+  ASSERT_TRUE(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+  // Other values are rounded to 13 significant digits.
+  ASSERT_NEAR(1e300, ValueId::toDouble(ValueId::fromDouble(
+                         1e300, ad_utility::NumericType::DOUBLE)),
+              1e288);
+  ASSERT_EQ(ValueId::fromDouble(0.0, ad_utility::NumericType::DOUBLE),
+            ValueId::fromDouble(-0.0, ad_utility::NumericType::DOUBLE));
+
+  // The same value with different types.
+  Id asInt = ValueId::fromDouble(3, ad_utility::NumericType::INTEGER);
+  Id asFloat = ValueId::fromDouble(3, ad_utility::NumericType::FLOAT);
+  ASSERT_NE(asInt, asFloat);
+  ASSERT_EQ(ValueId::sameValueRange(asInt), ValueId::sameValueRange(asFloat));
+  ASSERT_LT(ValueId::sameValueRange(asInt).second,
+            ValueId::fromDouble(3.001, ad_utility::NumericType::INTEGER));
+
+  // Inline values are larger than all Ids of the vocabulary.
+  ASSERT_LT(Id(1000000000),
+            ValueId::fromDouble(-0x1p1000, ad_utility::NumericType::DOUBLE));
+  ASSERT_FALSE(ValueId::isValue(ID_NO_VALUE));
+}
+
+TEST(ValueIdTest, dates) {
+  vector<string> literals = {
+      "\"-500\"^^<http://www.w3.org/2001/XMLSchema#gYear>",
+      "\"1879-03-14\"^^<http://www.w3.org/2001/XMLSchema#date>",
+      "\"1879-03-14T10:20:30\"^^<http://www.w3.org/2001/XMLSchema#dateTime>",
+      "\"2020\"^^<http://www.w3.org/2001/XMLSchema#gYear>",
+      "\"2020-04\"^^<http://www.w3.org/2001/XMLSchema#gYearMonth>"};
+  vector<Id> ids;
+  for (const auto& literal : literals) {
+    string word = convertValueLiteralToIndexWord(literal);
+    ids.push_back(idOf(literal));
+    ASSERT_EQ(ValueId::Datatype::DATE, ValueId::datatype(ids.back()));
+    ASSERT_EQ(word, ValueId::toIndexWord(ids.back())) << literal;
+  }
+  ASSERT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+  auto date = ValueId::toDate(ids[2]);
+  ASSERT_EQ(1879, date._year);
+  ASSERT_EQ(3, date._month);
+  ASSERT_EQ(30, date._second);
+}
+
+TEST(ValueIdTest, wordsThatStayInTheVocabulary) {
+  ASSERT_FALSE(ValueId::fromIndexWord("<http://example.org/a>"));
+  ASSERT_FALSE(ValueId::fromIndexWord("\"12\"@en"));
+  ASSERT_FALSE(ValueId::fromIndexWord(":v:float:garbage"));
+  ASSERT_FALSE(ValueId::fromIndexWord(convertValueLiteralToIndexWord(
+      "\"1e400\"^^<http://www.w3.org/2001/XMLSchema#double>")));
+  ASSERT_FALSE(ValueId::fromIndexWord(convertValueLiteralToIndexWord(
+      "\"1.7976931348623157e308\""
+      "^^<http://www.w3.org/2001/XMLSchema#double>")));
+  // Numbers that can not be stored without losing precision.
+  ASSERT_FALSE(ValueId::fromIndexWord(convertValueLiteralToIndexWord(
+      "\"12345678901234567\"^^<http://www.w3.org/2001/XMLSchema#integer>")));
+  ASSERT_FALSE(ValueId::fromIndexWord(convertValueLiteralToIndexWord(
+      "\"3.14159265358979\"^^<http://www.w3.org/2001/XMLSchema#decimal>")));
+  // Years that do not fit into the 34 bits of the year.
+  ASSERT_FALSE(ValueId::fromIndexWord(convertValueLiteralToIndexWord(
+      "\"-99999999999\"^^<http://www.w3.org/2001/XMLSchema#gYear>")));
+}
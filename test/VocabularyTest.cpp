@@ -4,6 +4,7 @@
 
 #include <gtest/gtest.h>
 #include <cstdio>
+#include <fstream>
 #include <nlohmann/json.hpp>
 #include <vector>
 #include "../src/index/Vocabulary.h"
@@ -115,6 +116,79 @@ TEST(VocabularyTest, IncompleteLiterals) {
   ASSERT_TRUE(comp("\"fieldofwork", "\"GOLD\"@en"));
 }
 
+TEST(VocabularyTest, frontCodedOnDiskVocabulary) {
+  TripleComponentComparator comp("en", "US", false);
+  vector<string> words{"<http://example.org/a>", "<http://example.org/ab>",
+                       "<http://example.org/abc>", "<http://example.org/b>",
+                       "<http://other.org/x>",    "\"lit\"",
+                       "\"lit\"@en",              "\"literal\"",
+                       "<z>",                     "<zz>"};
+  std::sort(words.begin(), words.end(),
+            [&comp](const auto& a, const auto& b) {
+              return comp(a, b, TripleComponentComparator::Level::TOTAL);
+            });
+  {
+    std::ofstream f("_testtmp_vocfile_plain");
+    for (const auto& w : words) {
+      f << w << '\n';
+    }
+  }
+  vector<string> prefixes{"<http://example.org/"};
+  RdfsVocabulary::prefixCompressFile("_testtmp_vocfile_plain",
+                                     "_testtmp_vocfile", prefixes);
+  // a small bucket size, s.t. we also test words in the middle of buckets
+  FrontCodedVocabulary::buildFromTextFile("_testtmp_vocfile",
+                                          "_testtmp_vocfile.frontcoded", 3);
+
+  RdfsVocabulary inRam;
+  RdfsVocabulary onDisk;
+  for (auto* v : {&inRam, &onDisk}) {
+    v->setLocale("en", "US", false);
+    v->initializePrefixes(prefixes);
+  }
+  inRam.readFromFile("_testtmp_vocfile");
+  onDisk.readFromFrontCodedFile("_testtmp_vocfile.frontcoded");
+  ASSERT_FALSE(inRam.wordsAreOnDisk());
+  ASSERT_TRUE(onDisk.wordsAreOnDisk());
+  ASSERT_EQ(words.size(), onDisk.size());
+
+  for (size_t i = 0; i < words.size(); ++i) {
+    ASSERT_EQ(words[i], onDisk.at(i));
+    ASSERT_EQ(words[i], onDisk.idToOptionalString(i).value());
+    Id id;
+    ASSERT_TRUE(onDisk.getId(words[i], &id));
+    ASSERT_EQ(Id(i), id);
+  }
+  for (const string& w :
+       {string("<a>"), string("<http://example.org/aa>"), string("\"lit"),
+        string("<zzz>")}) {
+    Id id;
+    ASSERT_FALSE(onDisk.getId(w, &id));
+    for (auto level : {TripleComponentComparator::Level::PRIMARY,
+                       TripleComponentComparator::Level::TOTAL}) {
+      ASSERT_EQ(inRam.lower_bound(w, level), onDisk.lower_bound(w, level));
+      ASSERT_EQ(inRam.upper_bound(w, level), onDisk.upper_bound(w, level));
+    }
+    ASSERT_EQ(inRam.prefix_range(w), onDisk.prefix_range(w));
+  }
+  ASSERT_EQ(inRam.prefix_range("<http://example.org/a"),
+            onDisk.prefix_range("<http://example.org/a"));
+  auto range = onDisk.prefix_range("<http://example.org/a");
+  ASSERT_EQ(3u, range.second - range.first);
+
+  // Reading the same vocabulary into RAM replaces the words on disk.
+  onDisk.readFromFile("_testtmp_vocfile");
+  ASSERT_FALSE(onDisk.wordsAreOnDisk());
+  ASSERT_EQ(words.size(), onDisk.size());
+  for (size_t i = 0; i < words.size(); ++i) {
+    ASSERT_EQ(words[i], onDisk.at(i));
+  }
+
+  remove("_testtmp_vocfile_plain");
+  remove("_testtmp_vocfile");
+  remove("_testtmp_vocfile.frontcoded");
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();